@@ -0,0 +1,242 @@
+/*
+ * Binary Record Log for OmniLogger
+ * Fixed-size binary day file records and on-demand CSV conversion
+ *
+ * Copyright (C) 2024 NortonTech3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef BINLOG_H
+#define BINLOG_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include <cmath>
+#include "row_format.h"
+
+// File layout:
+//   [BinLogHeader][uint8 decimals per channel][CSV header text][record][record]...
+// Record layout (little endian, unaligned):
+//   uint32 timestamp | uint8 flags | validity bitmap (1 bit per channel) | int32 value per channel
+// Values are fixed point (value * 10^decimals of their channel), matching the
+// CSV format. Version 1 files have no decimals table; all channels use decimals.
+struct BinLogHeader {
+  char magic[4];        // "OMLB"
+  uint8_t version;
+  uint8_t decimals;     // Fixed-point decimal places (version 1: of every channel)
+  uint16_t channels;    // Value columns (CSV columns minus the timestamp)
+  uint16_t recordSize;  // Bytes per record
+  uint16_t textLength;  // Length of the CSV header text after the decimals table
+  uint32_t reserved;
+  // Not part of the fixed header: filled by readHeader()
+  uint8_t channelDecimals[64];
+};
+
+class BinLog {
+public:
+  static const uint8_t VERSION = 2;
+  static const uint8_t DECIMALS = 2;               // Channels without their own decimals
+  static const size_t HEADER_SIZE = 16;            // Fixed part of BinLogHeader on the card
+  static const uint8_t FLAG_TIME_UNSYNCED = 0x01;  // Timestamp is seconds since boot, not epoch
+  static const uint16_t MAX_CHANNELS = 64;
+  static const size_t MAX_RECORD_SIZE = 5 + (MAX_CHANNELS + 7) / 8 + 4 * MAX_CHANNELS;
+  static const size_t MAX_ROW_TEXT = 24 + 13 * MAX_CHANNELS;  // Formatted CSV row incl. CRLF
+  
+  static uint16_t recordSize(uint16_t channels) {
+    return 5 + (channels + 7) / 8 + 4 * channels;
+  }
+  
+  // Value columns in a CSV header ("Timestamp,a,b" -> 2)
+  static uint16_t channelCount(const String& csvHeader) {
+    uint16_t count = 0;
+    for (size_t i = 0; i < csvHeader.length(); i++) {
+      if (csvHeader[i] == ',') count++;
+    }
+    return std::min(count, MAX_CHANNELS);
+  }
+  
+  static bool isBinaryFile(const char* filename) {
+    size_t len = strlen(filename);
+    return len > 4 && strcmp(filename + len - 4, ".bin") == 0;
+  }
+  
+  static size_t dataOffset(const BinLogHeader& hdr) {
+    return HEADER_SIZE + (hdr.version >= 2 ? hdr.channels : 0) + hdr.textLength;
+  }
+  
+  // decimals per channel as in the file's schema (nullptr = DECIMALS for all)
+  static size_t encode(uint8_t* out, uint32_t timestamp, uint8_t flags,
+                       const float* values, const bool* valid, uint16_t channels,
+                       const uint8_t* decimals) {
+    memcpy(out, &timestamp, 4);
+    out[4] = flags;
+    
+    uint8_t* bitmap = out + 5;
+    size_t bitmapSize = (channels + 7) / 8;
+    memset(bitmap, 0, bitmapSize);
+    
+    uint8_t* p = bitmap + bitmapSize;
+    for (uint16_t i = 0; i < channels; i++) {
+      int32_t fixed = 0;
+      if (valid[i] && !isnan(values[i])) {
+        fixed = RowWriter::toFixed(values[i], decimals ? decimals[i] : DECIMALS);
+        bitmap[i / 8] |= (1 << (i % 8));
+      }
+      memcpy(p, &fixed, 4);
+      p += 4;
+    }
+    return p - out;
+  }
+  
+  static bool writeHeader(File& file, const String& csvHeader, const uint8_t* decimals) {
+    BinLogHeader hdr;
+    memcpy(hdr.magic, "OMLB", 4);
+    hdr.version = VERSION;
+    hdr.decimals = DECIMALS;
+    hdr.channels = channelCount(csvHeader);
+    hdr.recordSize = recordSize(hdr.channels);
+    hdr.textLength = csvHeader.length();
+    hdr.reserved = 0;
+    for (uint16_t i = 0; i < hdr.channels; i++) {
+      hdr.channelDecimals[i] = decimals ? decimals[i] : DECIMALS;
+    }
+    
+    return file.write((const uint8_t*)&hdr, HEADER_SIZE) == HEADER_SIZE &&
+           file.write(hdr.channelDecimals, hdr.channels) == hdr.channels &&
+           file.write((const uint8_t*)csvHeader.c_str(), hdr.textLength) == hdr.textLength;
+  }
+  
+  // Same decimals as the schema of a file (nullptr = DECIMALS for all)
+  static bool sameDecimals(const BinLogHeader& hdr, const uint8_t* decimals) {
+    for (uint16_t i = 0; i < hdr.channels; i++) {
+      if (hdr.channelDecimals[i] != (decimals ? decimals[i] : DECIMALS)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  
+  // Read and check the schema header; leaves the file positioned at the first record
+  static bool readHeader(File& file, BinLogHeader& hdr, String* text = nullptr) {
+    file.seek(0);
+    if (file.read((uint8_t*)&hdr, HEADER_SIZE) != HEADER_SIZE ||
+        memcmp(hdr.magic, "OMLB", 4) != 0 || hdr.version < 1 || hdr.version > VERSION ||
+        hdr.channels > MAX_CHANNELS || hdr.recordSize != recordSize(hdr.channels)) {
+      return false;
+    }
+    if (hdr.version >= 2) {
+      if (file.read(hdr.channelDecimals, hdr.channels) != hdr.channels) {
+        return false;
+      }
+    } else {
+      memset(hdr.channelDecimals, hdr.decimals, hdr.channels);
+    }
+    
+    if (text) {
+      *text = "";
+      text->reserve(hdr.textLength);
+      char buf[64];
+      size_t remaining = hdr.textLength;
+      while (remaining > 0) {
+        size_t chunk = std::min(remaining, sizeof(buf) - 1);
+        size_t got = file.read((uint8_t*)buf, chunk);
+        if (got == 0) return false;
+        buf[got] = '\0';
+        *text += buf;
+        remaining -= got;
+      }
+    } else {
+      file.seek(dataOffset(hdr));
+    }
+    return true;
+  }
+  
+  // Whole records in a file of the given size
+  static uint32_t recordCount(const BinLogHeader& hdr, size_t size) {
+    size_t start = dataOffset(hdr);
+    return size > start ? (size - start) / hdr.recordSize : 0;
+  }
+  
+  // Format one record as a CSV row (with CRLF, like println). Returns bytes written.
+  static size_t formatRow(const uint8_t* rec, const BinLogHeader& hdr, char* out, size_t outSize) {
+    if (outSize < MAX_ROW_TEXT) {
+      return 0;
+    }
+    
+    uint32_t ts;
+    memcpy(&ts, rec, 4);
+    uint8_t flags = rec[4];
+    const uint8_t* bitmap = rec + 5;
+    const uint8_t* values = bitmap + (hdr.channels + 7) / 8;
+    
+    char* p = out;
+    if (flags & FLAG_TIME_UNSYNCED) {
+      p += snprintf(p, 24, "UTC+%lu", (unsigned long)ts);
+    } else {
+      time_t t = ts;
+      struct tm timeinfo;
+      localtime_r(&t, &timeinfo);
+      p += strftime(p, 24, "%Y-%m-%d %H:%M:%S", &timeinfo);
+    }
+    
+    for (uint16_t i = 0; i < hdr.channels; i++) {
+      *p++ = ',';
+      if (bitmap[i / 8] & (1 << (i % 8))) {
+        int32_t fixed;
+        memcpy(&fixed, values + 4 * i, 4);
+        p = RowWriter::appendFixed(p, fixed, hdr.channelDecimals[i]);
+      }
+    }
+    *p++ = '\r';
+    *p++ = '\n';
+    return p - out;
+  }
+  
+  // Convert the records before end to CSV text, passed to emit(const char*, size_t)
+  // in chunks of at most bufSize bytes
+  template<typename Emit>
+  static bool toCsv(File& file, size_t end, char* buf, size_t bufSize, Emit emit) {
+    BinLogHeader hdr;
+    String text;
+    if (bufSize < MAX_ROW_TEXT + MAX_RECORD_SIZE || !readHeader(file, hdr, &text)) {
+      return false;
+    }
+    text += "\r\n";
+    emit(text.c_str(), text.length());
+    
+    // Records are read into the tail of buf, rows formatted at its head
+    uint8_t* rec = (uint8_t*)buf + bufSize - MAX_RECORD_SIZE;
+    size_t textCap = bufSize - MAX_RECORD_SIZE;
+    size_t used = 0;
+    
+    uint32_t records = recordCount(hdr, end);
+    for (uint32_t i = 0; i < records && file.read(rec, hdr.recordSize) == hdr.recordSize; i++) {
+      if (textCap - used < MAX_ROW_TEXT) {
+        emit(buf, used);
+        used = 0;
+      }
+      used += formatRow(rec, hdr, buf + used, textCap - used);
+    }
+    if (used > 0) {
+      emit(buf, used);
+    }
+    return true;
+  }
+};
+
+static_assert(offsetof(BinLogHeader, channelDecimals) == BinLog::HEADER_SIZE, "BinLog header layout");
+static_assert(sizeof(BinLogHeader::channelDecimals) == BinLog::MAX_CHANNELS, "BinLog decimals table");
+
+#endif // BINLOG_H
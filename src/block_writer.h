@@ -0,0 +1,132 @@
+/*
+ * Block Writer for OmniLogger
+ * Write-combining SD buffer with block-aligned writes and latency stats
+ *
+ * Copyright (C) 2024 NortonTech3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef BLOCK_WRITER_H
+#define BLOCK_WRITER_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include <esp_heap_caps.h>
+#include "metrics.h"
+
+// Collects records and writes them in whole blocks aligned to the file
+// offset, so the card sees full-sector writes instead of a read-modify-write
+// per record. Only the partial tail block is written at commit.
+class BlockWriter {
+public:
+  static const size_t BLOCK_SIZE = 4096;  // 8 sectors, one cluster on most cards
+  
+  BlockWriter() : file(nullptr), buf(nullptr), used(0), position(0) {}
+  
+  ~BlockWriter() {
+    if (buf) {
+      heap_caps_free(buf);
+    }
+  }
+  
+  // Internal DMA-capable RAM avoids a bounce-buffer copy in the SD driver
+  bool begin() {
+    if (!buf) {
+      buf = (uint8_t*)heap_caps_malloc(BLOCK_SIZE, MALLOC_CAP_DMA | MALLOC_CAP_8BIT);
+    }
+    return buf != nullptr;
+  }
+  
+  // Start writing at position of an open file (the caller has seeked there)
+  void attach(File* target, uint32_t startPosition) {
+    file = target;
+    used = 0;
+    position = startPosition;
+  }
+  
+  void detach() {
+    file = nullptr;
+    used = 0;
+  }
+  
+  size_t write(const uint8_t* data, size_t len) {
+    if (!file) {
+      return 0;
+    }
+    if (!buf) {
+      return timedWrite(data, len);  // No buffer - write through
+    }
+    
+    size_t remaining = len;
+    while (remaining > 0) {
+      // Fill up to the next block boundary, then write the block out
+      size_t room = blockRoom();
+      size_t chunk = std::min(remaining, room);
+      memcpy(buf + used, data, chunk);
+      used += chunk;
+      data += chunk;
+      remaining -= chunk;
+      if (chunk == room && !writeBuffer()) {
+        return 0;  // Caller rolls back to its last commit and reopens the file
+      }
+    }
+    return len;
+  }
+  
+  // Write out the partial block (before the file is flushed for a commit).
+  // On a failed write the bytes stay buffered and size() still counts them.
+  bool flush() {
+    return used == 0 || writeBuffer();
+  }
+  
+  // Logical end of the data, including bytes still buffered
+  uint32_t size() const {
+    return position + used;
+  }
+  
+  const LatencyStats& getWriteStats() const {
+    return writeStats;
+  }
+
+private:
+  File* file;
+  uint8_t* buf;
+  size_t used;        // Buffered bytes
+  uint32_t position;  // File offset of buf[0]
+  LatencyStats writeStats;
+  
+  size_t blockRoom() const {
+    // The first block after attach() fills only up to the next boundary
+    return BLOCK_SIZE - ((position + used) % BLOCK_SIZE);
+  }
+  
+  bool writeBuffer() {
+    if (timedWrite(buf, used) != used) {
+      return false;
+    }
+    position += used;
+    used = 0;
+    return true;
+  }
+  
+  size_t timedWrite(const uint8_t* data, size_t len) {
+    uint32_t start = micros();
+    size_t written = file->write(data, len);
+    writeStats.record(micros() - start);
+    return written;
+  }
+};
+
+#endif // BLOCK_WRITER_H
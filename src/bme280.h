@@ -0,0 +1,246 @@
+/*
+ * BME280 Driver for OmniLogger
+ * Forced-mode conversions read in one burst and compensated in integer math
+ *
+ * Copyright (C) 2024 NortonTech3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef BME280_H
+#define BME280_H
+
+#include <Arduino.h>
+#include <Wire.h>
+
+// The sensor sleeps between samples: trigger() starts one forced-mode
+// conversion, after which the chip returns to sleep on its own, and read()
+// fetches pressure, temperature and humidity with a single 8-byte burst
+// and compensates all three from it using the datasheet's integer formulas.
+class Bme280 {
+public:
+  static const uint8_t CHIP_ID = 0x60;
+  
+  Bme280() : wire(nullptr), address(0), ctrlMeas(0), osrs(1) {}
+  
+  // Check the chip, load its calibration and set the oversampling of all
+  // three measurements (1, 2, 4, 8 or 16 samples)
+  bool begin(TwoWire& bus, uint8_t addr, uint8_t oversampling) {
+    wire = &bus;
+    address = addr;
+    
+    uint8_t id;
+    if (!readRegisters(REG_CHIP_ID, &id, 1) || id != CHIP_ID) {
+      return false;
+    }
+    
+    // Soft reset, then wait for the calibration copy to NVM to finish
+    if (!writeRegister(REG_RESET, RESET_COMMAND)) {
+      return false;
+    }
+    delay(2);
+    uint8_t status = STATUS_IM_UPDATE;
+    for (int i = 0; i < 10 && (status & STATUS_IM_UPDATE); i++) {
+      if (!readRegisters(REG_STATUS, &status, 1)) {
+        return false;
+      }
+      delay(1);
+    }
+    if (!readCalibration()) {
+      return false;
+    }
+    
+    osrs = oversamplingCode(oversampling);
+    ctrlMeas = (osrs << 5) | (osrs << 2);  // Temperature and pressure, sleep mode
+    // Humidity oversampling is latched by the following ctrl_meas write
+    return writeRegister(REG_CONFIG, 0x00) &&                // Filter off
+           writeRegister(REG_CTRL_HUM, osrs) &&
+           writeRegister(REG_CTRL_MEAS, ctrlMeas);
+  }
+  
+  // Start one conversion; the chip sleeps again when it is done
+  bool trigger() {
+    return writeRegister(REG_CTRL_MEAS, ctrlMeas | MODE_FORCED);
+  }
+  
+  // Status poll: true once the conversion has finished
+  bool isReady() {
+    uint8_t status;
+    return readRegisters(REG_STATUS, &status, 1) && (status & STATUS_MEASURING) == 0;
+  }
+  
+  // Datasheet maximum measurement time at the configured oversampling
+  unsigned long conversionTimeMs() const {
+    uint32_t samples = 1u << (osrs - 1);
+    // 1.25ms + 2.3ms per temperature sample + (2.3ms per sample + 0.575ms) each for pressure and humidity
+    uint32_t us = 1250 + 2300 * samples + 2 * (2300 * samples + 575);
+    return (us + 999) / 1000;
+  }
+  
+  // Burst read of the last conversion: temperature (°C), humidity (%) and pressure (hPa)
+  bool read(float* out) {
+    uint8_t raw[8];
+    if (!readRegisters(REG_DATA, raw, sizeof(raw))) {
+      return false;
+    }
+    int32_t adcP = ((uint32_t)raw[0] << 12) | ((uint32_t)raw[1] << 4) | (raw[2] >> 4);
+    int32_t adcT = ((uint32_t)raw[3] << 12) | ((uint32_t)raw[4] << 4) | (raw[5] >> 4);
+    int32_t adcH = ((uint32_t)raw[6] << 8) | raw[7];
+    if (adcT == SKIPPED_20BIT) {
+      return false;  // No conversion since reset
+    }
+    
+    int32_t tFine = compensateTemperature(adcT);
+    out[0] = ((tFine * 5 + 128) >> 8) / 100.0f;
+    out[1] = adcH == SKIPPED_16BIT ? NAN : compensateHumidity(adcH, tFine) / 1024.0f;
+    out[2] = adcP == SKIPPED_20BIT ? NAN : compensatePressure(adcP, tFine) / 25600.0f;
+    return true;
+  }
+
+private:
+  static const uint8_t REG_CALIB_TP = 0x88;  // 0x88-0x9F temperature and pressure, 0xA1 H1
+  static const uint8_t REG_CALIB_H1 = 0xA1;
+  static const uint8_t REG_CHIP_ID = 0xD0;
+  static const uint8_t REG_RESET = 0xE0;
+  static const uint8_t REG_CALIB_H = 0xE1;   // 0xE1-0xE7 H2-H6
+  static const uint8_t REG_CTRL_HUM = 0xF2;
+  static const uint8_t REG_STATUS = 0xF3;
+  static const uint8_t REG_CTRL_MEAS = 0xF4;
+  static const uint8_t REG_CONFIG = 0xF5;
+  static const uint8_t REG_DATA = 0xF7;      // press_msb .. hum_lsb
+  static const uint8_t RESET_COMMAND = 0xB6;
+  static const uint8_t MODE_FORCED = 0x01;
+  static const uint8_t STATUS_MEASURING = 0x08;
+  static const uint8_t STATUS_IM_UPDATE = 0x01;
+  static const int32_t SKIPPED_20BIT = 0x80000;
+  static const int32_t SKIPPED_16BIT = 0x8000;
+  
+  struct Calibration {
+    uint16_t t1;
+    int16_t t2, t3;
+    uint16_t p1;
+    int16_t p2, p3, p4, p5, p6, p7, p8, p9;
+    uint8_t h1, h3;
+    int16_t h2, h4, h5;
+    int8_t h6;
+  };
+  
+  TwoWire* wire;
+  uint8_t address;
+  uint8_t ctrlMeas;
+  uint8_t osrs;
+  Calibration cal;
+  
+  // Register field for a sample count (x1 = 1 ... x16 = 5)
+  static uint8_t oversamplingCode(uint8_t samples) {
+    uint8_t code = 1;
+    while (samples > 1 && code < 5) {
+      code++;
+      samples >>= 1;
+    }
+    return code;
+  }
+  
+  static int16_t le16(const uint8_t* b) {
+    return (int16_t)(b[0] | (b[1] << 8));
+  }
+  
+  bool readCalibration() {
+    uint8_t tp[24];
+    uint8_t h[7];
+    if (!readRegisters(REG_CALIB_TP, tp, sizeof(tp)) ||
+        !readRegisters(REG_CALIB_H1, &cal.h1, 1) ||
+        !readRegisters(REG_CALIB_H, h, sizeof(h))) {
+      return false;
+    }
+    cal.t1 = (uint16_t)le16(tp);
+    cal.t2 = le16(tp + 2);
+    cal.t3 = le16(tp + 4);
+    cal.p1 = (uint16_t)le16(tp + 6);
+    cal.p2 = le16(tp + 8);
+    cal.p3 = le16(tp + 10);
+    cal.p4 = le16(tp + 12);
+    cal.p5 = le16(tp + 14);
+    cal.p6 = le16(tp + 16);
+    cal.p7 = le16(tp + 18);
+    cal.p8 = le16(tp + 20);
+    cal.p9 = le16(tp + 22);
+    cal.h2 = le16(h);
+    cal.h3 = h[2];
+    cal.h4 = (int16_t)(((int8_t)h[3] * 16) | (h[4] & 0x0F));
+    cal.h5 = (int16_t)(((int8_t)h[5] * 16) | (h[4] >> 4));
+    cal.h6 = (int8_t)h[6];
+    return true;
+  }
+  
+  // Datasheet section 4.2.3; returns t_fine (temperature in 1/5120 °C)
+  int32_t compensateTemperature(int32_t adcT) const {
+    int32_t var1 = ((((adcT >> 3) - ((int32_t)cal.t1 << 1))) * (int32_t)cal.t2) >> 11;
+    int32_t d = (adcT >> 4) - (int32_t)cal.t1;
+    int32_t var2 = (((d * d) >> 12) * (int32_t)cal.t3) >> 14;
+    return var1 + var2;
+  }
+  
+  // Pascal in Q24.8
+  uint32_t compensatePressure(int32_t adcP, int32_t tFine) const {
+    int64_t var1 = (int64_t)tFine - 128000;
+    int64_t var2 = var1 * var1 * (int64_t)cal.p6;
+    var2 = var2 + ((var1 * (int64_t)cal.p5) << 17);
+    var2 = var2 + ((int64_t)cal.p4 << 35);
+    var1 = ((var1 * var1 * (int64_t)cal.p3) >> 8) + ((var1 * (int64_t)cal.p2) << 12);
+    var1 = ((((int64_t)1 << 47) + var1) * (int64_t)cal.p1) >> 33;
+    if (var1 == 0) {
+      return 0;  // Avoid division by zero
+    }
+    int64_t p = 1048576 - adcP;
+    p = (((p << 31) - var2) * 3125) / var1;
+    var1 = ((int64_t)cal.p9 * (p >> 13) * (p >> 13)) >> 25;
+    var2 = ((int64_t)cal.p8 * p) >> 19;
+    p = ((p + var1 + var2) >> 8) + ((int64_t)cal.p7 << 4);
+    return (uint32_t)p;
+  }
+  
+  // %RH in Q22.10
+  uint32_t compensateHumidity(int32_t adcH, int32_t tFine) const {
+    int32_t v = tFine - 76800;
+    v = (((((adcH << 14) - ((int32_t)cal.h4 << 20) - ((int32_t)cal.h5 * v)) + 16384) >> 15) *
+         (((((((v * (int32_t)cal.h6) >> 10) * (((v * (int32_t)cal.h3) >> 11) + 32768)) >> 10) + 2097152) *
+           (int32_t)cal.h2 + 8192) >> 14));
+    v = v - (((((v >> 15) * (v >> 15)) >> 7) * (int32_t)cal.h1) >> 4);
+    v = v < 0 ? 0 : v;
+    v = v > 419430400 ? 419430400 : v;
+    return (uint32_t)(v >> 12);
+  }
+  
+  bool writeRegister(uint8_t reg, uint8_t value) {
+    wire->beginTransmission(address);
+    wire->write(reg);
+    wire->write(value);
+    return wire->endTransmission() == 0;
+  }
+  
+  bool readRegisters(uint8_t reg, uint8_t* out, size_t len) {
+    wire->beginTransmission(address);
+    wire->write(reg);
+    if (wire->endTransmission(false) != 0 || wire->requestFrom(address, (uint8_t)len) != len) {
+      return false;
+    }
+    for (size_t i = 0; i < len; i++) {
+      out[i] = wire->read();
+    }
+    return true;
+  }
+};
+
+#endif // BME280_H
@@ -0,0 +1,422 @@
+/*
+ * Day File Compaction for OmniLogger
+ * Closed CSV day files rewritten as gzip in small background slices
+ *
+ * Copyright (C) 2024 NortonTech3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef COMPACTOR_H
+#define COMPACTOR_H
+
+#include <Arduino.h>
+#include <SD.h>
+#include <rom/miniz.h>
+#include <esp_rom_crc.h>
+
+// "/data_20260104.csv" is compacted into "/data_20260104.csv.gz", a plain
+// gzip member any tool can read. Its header carries an extra field ("OL":
+// rows, first and last timestamp, little-endian) so the manifest can be
+// rebuilt without inflating the file.
+class Gzip {
+public:
+  static const size_t HEADER_SIZE = 28;  // Fixed header, XLEN and the "OL" subfield
+  
+  static bool isCompressed(const char* path) {
+    size_t len = strlen(path);
+    return len > 7 && strcmp(path + len - 7, ".csv.gz") == 0;
+  }
+  
+  static size_t writeHeader(uint8_t* h, uint32_t rows, uint32_t firstTs, uint32_t lastTs) {
+    memset(h, 0, HEADER_SIZE);
+    h[0] = 0x1f;
+    h[1] = 0x8b;
+    h[2] = 8;        // Deflate
+    h[3] = FEXTRA;
+    put32(h + 4, lastTs);
+    h[9] = 255;      // Unknown OS
+    h[10] = 16;      // XLEN
+    h[12] = 'O';
+    h[13] = 'L';
+    h[14] = 12;      // Subfield length
+    put32(h + 16, rows);
+    put32(h + 20, firstTs);
+    put32(h + 24, lastTs);
+    return HEADER_SIZE;
+  }
+  
+  // Row count and time range from the header; false if it has none
+  static bool readInfo(File& file, uint32_t& rows, uint32_t& firstTs, uint32_t& lastTs) {
+    uint8_t h[HEADER_SIZE];
+    file.seek(0);
+    if (file.read(h, sizeof(h)) != sizeof(h) || h[0] != 0x1f || h[1] != 0x8b || !(h[3] & FEXTRA) ||
+        h[12] != 'O' || h[13] != 'L' || h[14] != 12) {
+      return false;
+    }
+    rows = get32(h + 16);
+    firstTs = get32(h + 20);
+    lastTs = get32(h + 24);
+    return true;
+  }
+  
+  // Leave file at the start of the deflate data
+  static bool skipHeader(File& file) {
+    uint8_t h[10];
+    if (file.read(h, sizeof(h)) != sizeof(h) || h[0] != 0x1f || h[1] != 0x8b || h[2] != 8) {
+      return false;
+    }
+    if (h[3] & FEXTRA) {
+      uint8_t xlen[2];
+      if (file.read(xlen, 2) != 2) {
+        return false;
+      }
+      file.seek(file.position() + (xlen[0] | xlen[1] << 8));
+    }
+    if (h[3] & FNAME) {
+      while (file.read() > 0) {}
+    }
+    if (h[3] & FCOMMENT) {
+      while (file.read() > 0) {}
+    }
+    if (h[3] & FHCRC) {
+      file.seek(file.position() + 2);
+    }
+    return file.available() > 0;
+  }
+  
+  static void put32(uint8_t* p, uint32_t v) {
+    p[0] = v;
+    p[1] = v >> 8;
+    p[2] = v >> 16;
+    p[3] = v >> 24;
+  }
+  
+  static uint32_t get32(const uint8_t* p) {
+    return p[0] | p[1] << 8 | p[2] << 16 | (uint32_t)p[3] << 24;
+  }
+
+private:
+  static const uint8_t FHCRC = 0x02;
+  static const uint8_t FEXTRA = 0x04;
+  static const uint8_t FNAME = 0x08;
+  static const uint8_t FCOMMENT = 0x10;
+};
+
+// Streaming inflate of a .csv.gz file. The state (~47KB, PSRAM if there is
+// any) is only held between begin() and end().
+class GzipReader {
+public:
+  static const size_t IN_SIZE = 4096;
+  
+  GzipReader() : state(nullptr), file(nullptr) {}
+  
+  ~GzipReader() {
+    end();
+  }
+  
+  // file must stay open until end()
+  bool begin(File& source) {
+    end();
+    if (!Gzip::skipHeader(source)) {
+      return false;
+    }
+    state = (State*)(psramFound() ? ps_malloc(sizeof(State)) : malloc(sizeof(State)));
+    if (!state) {
+      Serial.println("Gzip: no memory to inflate");
+      return false;
+    }
+    tinfl_init(&state->inflator);
+    file = &source;
+    inLen = 0;
+    inPos = 0;
+    inEnd = false;
+    dictOfs = 0;
+    outPos = 0;
+    outLen = 0;
+    done = false;
+    return true;
+  }
+  
+  // Up to len inflated bytes; 0 at the end of the data (or a corrupt stream)
+  size_t read(uint8_t* dst, size_t len) {
+    size_t n = 0;
+    while (state && n < len) {
+      // Hand out what the last call wrote into the window first
+      if (outLen > 0) {
+        size_t take = outLen < len - n ? outLen : len - n;
+        memcpy(dst + n, state->dict + outPos, take);
+        outPos += take;
+        outLen -= take;
+        n += take;
+        continue;
+      }
+      if (done) {
+        break;
+      }
+      if (inPos == inLen && !inEnd) {
+        inLen = file->read(state->in, IN_SIZE);
+        inPos = 0;
+        inEnd = inLen == 0;
+      }
+      
+      size_t inSize = inLen - inPos;
+      size_t outSize = TINFL_LZ_DICT_SIZE - dictOfs;
+      tinfl_status status = tinfl_decompress(&state->inflator, state->in + inPos, &inSize, state->dict,
+                                             state->dict + dictOfs, &outSize,
+                                             inEnd ? 0 : TINFL_FLAG_HAS_MORE_INPUT);
+      inPos += inSize;
+      outPos = dictOfs;
+      outLen = outSize;
+      dictOfs = (dictOfs + outSize) & (TINFL_LZ_DICT_SIZE - 1);
+      if (status == TINFL_STATUS_DONE || status < 0) {
+        if (status < 0) {
+          Serial.printf("Gzip: corrupt data (%d)\n", status);
+        }
+        done = true;
+      }
+    }
+    return n;
+  }
+  
+  void end() {
+    free(state);
+    state = nullptr;
+    file = nullptr;
+  }
+
+private:
+  struct State {
+    tinfl_decompressor inflator;
+    uint8_t dict[TINFL_LZ_DICT_SIZE];  // Output window, wraps around
+    uint8_t in[IN_SIZE];
+  };
+  
+  State* state;
+  File* file;
+  size_t inLen;
+  size_t inPos;
+  bool inEnd;
+  size_t dictOfs;  // Where the next inflate call writes
+  size_t outPos;   // Inflated bytes not yet handed out
+  size_t outLen;
+  bool done;
+};
+
+// Rewrites one day file as gzip, a slice at a time: step() reads, deflates
+// and writes for at most the given time, so the storage task (and the lock
+// it holds meanwhile) is never tied up for long. The source is left alone
+// until replace() - a job cut short by a reset starts over from its temp file.
+class DayFileCompactor {
+public:
+  static const size_t CHUNK_SIZE = 4096;
+  static const int DEFLATE_FLAGS = TDEFL_DEFAULT_MAX_PROBES;  // Raw deflate, full parsing - time is not short here
+  
+  enum Status {
+    COMPACT_RUNNING = 0,
+    COMPACT_DONE,     // Ready for replace()
+    COMPACT_FAILED    // Job dropped, source untouched
+  };
+  
+  DayFileCompactor() : deflater(nullptr), in(nullptr), out(nullptr), inputBytes(0), outputBytes(0),
+                       active(false), finished(false) {
+    source[0] = '\0';
+  }
+  
+  ~DayFileCompactor() {
+    abort();
+  }
+  
+  // The deflate state needs ~300KB, so only boards with PSRAM compact
+  static bool available() {
+    return psramFound();
+  }
+  
+  bool busy() const {
+    return active;
+  }
+  
+  const char* getSource() const {
+    return source;
+  }
+  
+  uint32_t getInputBytes() const {
+    return inputBytes;
+  }
+  
+  uint32_t getOutputBytes() const {
+    return outputBytes;
+  }
+  
+  bool start(const char* path, uint32_t rows, uint32_t firstTs, uint32_t lastTs) {
+    abort();
+    if (!available() || strlen(path) + 8 > sizeof(source)) {
+      return false;
+    }
+    strcpy(source, path);
+    active = true;
+    finished = false;
+    
+    deflater = (tdefl_compressor*)ps_malloc(sizeof(tdefl_compressor));
+    in = (uint8_t*)ps_malloc(CHUNK_SIZE);
+    out = (uint8_t*)ps_malloc(CHUNK_SIZE);
+    src = SD.open(source, FILE_READ);
+    char tmp[sizeof(source) + 8];
+    tempPath(tmp, sizeof(tmp));
+    dst = src ? SD.open(tmp, FILE_WRITE) : File();
+    if (!deflater || !in || !out || !src || !dst) {
+      Serial.printf("Compaction of %s could not start\n", source);
+      abort();
+      return false;
+    }
+    tdefl_init(deflater, nullptr, nullptr, DEFLATE_FLAGS);
+    
+    inLen = 0;
+    inPos = 0;
+    inEnd = false;
+    crc = 0;
+    inputBytes = 0;
+    outputBytes = 0;
+    
+    uint8_t header[Gzip::HEADER_SIZE];
+    Gzip::writeHeader(header, rows, firstTs, lastTs);
+    if (!write(header, sizeof(header))) {
+      abort();
+      return false;
+    }
+    return true;
+  }
+  
+  Status step(uint32_t budgetUs) {
+    if (!active) {
+      return COMPACT_FAILED;
+    }
+    if (finished) {
+      return COMPACT_DONE;
+    }
+    uint32_t begin = micros();
+    while (micros() - begin < budgetUs) {
+      if (inPos == inLen && !inEnd) {
+        inLen = src.read(in, CHUNK_SIZE);
+        inPos = 0;
+        inEnd = inLen == 0;
+        crc = esp_rom_crc32_le(crc, in, inLen);
+        inputBytes += inLen;
+      }
+      size_t inSize = inLen - inPos;
+      size_t outSize = CHUNK_SIZE;
+      tdefl_status status = tdefl_compress(deflater, in + inPos, &inSize, out, &outSize,
+                                           inEnd ? TDEFL_FINISH : TDEFL_NO_FLUSH);
+      inPos += inSize;
+      if ((outSize > 0 && !write(out, outSize)) || status < 0) {
+        Serial.printf("Compaction of %s failed\n", source);
+        abort();
+        return COMPACT_FAILED;
+      }
+      if (status == TDEFL_STATUS_DONE) {
+        uint8_t trailer[8];
+        Gzip::put32(trailer, crc);
+        Gzip::put32(trailer + 4, inputBytes);
+        bool ok = write(trailer, sizeof(trailer));
+        dst.close();
+        src.close();
+        release();
+        if (!ok) {
+          abort();
+          return COMPACT_FAILED;
+        }
+        finished = true;
+        return COMPACT_DONE;
+      }
+    }
+    return COMPACT_RUNNING;
+  }
+  
+  // Swap the finished file in for the source. Nothing may have the source
+  // open. target gets the new path. Fails (dropping the job) if rows were
+  // appended to the source meanwhile or target already exists.
+  bool replace(char* target, size_t targetSize) {
+    if (!active || !finished || strlen(source) + 4 > targetSize) {
+      return false;
+    }
+    char tmp[sizeof(source) + 8];
+    tempPath(tmp, sizeof(tmp));
+    snprintf(target, targetSize, "%s.gz", source);
+    
+    File check = SD.open(source, FILE_READ);
+    bool unchanged = check && check.size() == inputBytes;
+    check.close();
+    bool ok = unchanged && SD.rename(tmp, target) && SD.remove(source);
+    if (!ok) {
+      Serial.printf("Compaction of %s: could not replace the source\n", source);
+    }
+    abort();
+    return ok;
+  }
+  
+  // Drop the job and its temp file
+  void abort() {
+    src.close();
+    dst.close();
+    release();
+    if (active) {
+      char tmp[sizeof(source) + 8];
+      tempPath(tmp, sizeof(tmp));
+      if (SD.exists(tmp)) {
+        SD.remove(tmp);
+      }
+    }
+    active = false;
+    finished = false;
+  }
+
+private:
+  char source[32];
+  File src;
+  File dst;
+  tdefl_compressor* deflater;
+  uint8_t* in;
+  uint8_t* out;
+  size_t inLen;
+  size_t inPos;
+  bool inEnd;
+  uint32_t crc;
+  uint32_t inputBytes;
+  uint32_t outputBytes;
+  bool active;
+  bool finished;  // Temp file complete and closed
+  
+  void tempPath(char* out, size_t outSize) const {
+    snprintf(out, outSize, "%s.gz.tmp", source);
+  }
+  
+  bool write(const uint8_t* data, size_t len) {
+    if (dst.write(data, len) != len) {
+      return false;
+    }
+    outputBytes += len;
+    return true;
+  }
+  
+  void release() {
+    free(deflater);
+    deflater = nullptr;
+    free(in);
+    in = nullptr;
+    free(out);
+    out = nullptr;
+  }
+};
+
+#endif // COMPACTOR_H
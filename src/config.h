@@ -23,7 +23,10 @@
 
 #include <Arduino.h>
 #include <Preferences.h>
+#include <esp_rom_crc.h>
+#include "metrics.h"
 #include <algorithm>
+#include <cstddef>
 
 // Pin definitions for ESP32-S2 Mini
 #define DEFAULT_SD_CS 12
@@ -36,7 +39,21 @@ enum SensorType {
   SENSOR_BME280 = 1,
   SENSOR_DHT22 = 2,
   SENSOR_DS18B20 = 3,
-  SENSOR_ANALOG = 4
+  SENSOR_ANALOG = 4,
+  SENSOR_ANALOG_FAST = 5,  // DMA-sampled analog input, logged as mean/min/max/RMS
+  SENSOR_TYPE_COUNT
+};
+
+// Storage used for buffered records
+enum BufferBackend {
+  BUFFER_FLASH = 0,  // Journal partition - survives reset and deep sleep
+  BUFFER_PSRAM = 1   // PSRAM ring - faster, lost on reset and deep sleep
+};
+
+// Day file format
+enum LogFormat {
+  LOG_CSV = 0,     // Text rows in .csv files
+  LOG_BINARY = 1   // Fixed-size records in .bin files, converted to CSV on download
 };
 
 struct SensorConfig {
@@ -44,6 +61,7 @@ struct SensorConfig {
   int pin;           // For digital sensors (DHT, DS18B20) or analog pin
   char name[32];     // Custom sensor name
   bool enabled;
+  unsigned int interval;  // Seconds between readings, 0 = measurement interval
 };
 
 class Config {
@@ -60,10 +78,39 @@ public:
   // Measurement settings
   unsigned int measurementInterval;  // Seconds between measurements
   bool deepSleepEnabled;
+  bool carryForward;  // Repeat a sensor's last value in rows where it wasn't read
   
   // Data buffering settings
   bool bufferingEnabled;
   unsigned int flushInterval;  // Seconds between buffer flushes to SD card
+  BufferBackend bufferBackend;
+  
+  // Day file format
+  LogFormat logFormat;
+  unsigned int sdPreallocKB;  // Day file preallocation step (0 = off)
+  unsigned int sdProbeInterval;  // Seconds between SD health probes (0 = off)
+  
+  // Group commit settings (day file stays open, records are committed in batches)
+  bool groupCommitEnabled;
+  unsigned int commitMaxRecords;  // Commit after this many records
+  unsigned int commitMaxBytes;    // Commit after this many bytes
+  unsigned int commitMaxLatency;  // Seconds a record may wait before commit
+  
+  // Fast analog sampling (total conversions per second, shared by all fast channels)
+  unsigned int fastAdcRateHz;
+  
+  // BME280 oversampling of temperature, pressure and humidity (1, 2, 4, 8 or 16)
+  uint8_t bmeOversampling;
+  
+  // Store-and-forward upload of logged rows by HTTP POST
+  bool uplinkEnabled;
+  char uplinkUrl[128];
+  char uplinkToken[64];             // Sent as a bearer token when set
+  unsigned int uplinkInterval;      // Seconds between uploads once caught up
+  unsigned int uplinkBatchRecords;  // Rows per POST
+  
+  // Gzip closed CSV day files once their last row is this many days old (0 = off)
+  unsigned int compactAfterDays;
   
   // Pin configuration
   int sdCardCS;
@@ -71,8 +118,11 @@ public:
   int i2cSCL;
   int batteryPin;
   
-  // Sensor configuration (support up to 8 sensors)
-  static const int MAX_SENSORS = 8;
+  // Sensor configuration. Channels are shared by all sensors, so e.g. 32
+  // DS18B20s fit but only 16 fast analog inputs.
+  static const int MAX_SENSORS = 32;
+  static const int MAX_CHANNELS = 64;
+  static_assert(MAX_SENSORS <= 32, "Due and sampled sensor masks are uint32_t");
   SensorConfig sensors[MAX_SENSORS];
   
   Config() {
@@ -85,9 +135,31 @@ public:
     timezoneOffset = 0;
     measurementInterval = 60;  // Default 60 seconds
     deepSleepEnabled = false;
+    carryForward = false;
     
     bufferingEnabled = false;
     flushInterval = 300;  // Default 5 minutes
+    bufferBackend = BUFFER_FLASH;
+    
+    logFormat = LOG_CSV;
+    sdPreallocKB = 0;
+    sdProbeInterval = 600;  // Default 10 minutes
+    
+    groupCommitEnabled = false;  // Commit every record by default
+    commitMaxRecords = 32;
+    commitMaxBytes = 4096;
+    commitMaxLatency = 30;
+    
+    fastAdcRateHz = 20000;
+    bmeOversampling = 1;
+    
+    uplinkEnabled = false;
+    strcpy(uplinkUrl, "");
+    strcpy(uplinkToken, "");
+    uplinkInterval = 900;  // Default 15 minutes
+    uplinkBatchRecords = 500;
+    
+    compactAfterDays = 7;
     
     sdCardCS = DEFAULT_SD_CS;
     i2cSDA = DEFAULT_I2C_SDA;
@@ -99,6 +171,7 @@ public:
       sensors[i].type = SENSOR_NONE;
       sensors[i].pin = -1;
       sensors[i].enabled = false;
+      sensors[i].interval = 0;
       snprintf(sensors[i].name, sizeof(sensors[i].name), "Sensor%d", i + 1);
     }
     
@@ -114,7 +187,373 @@ public:
     return prefs.begin("omnilogger", false);
   }
   
+  // Settings come from the config blob; a device that still has the
+  // per-field keys of older firmware is migrated to it once
   void load() {
+    bool migrate = false;
+    if (!loadBlob()) {
+      migrate = prefs.isKey("measInterval");
+      if (migrate) {
+        loadLegacyKeys();
+      }
+    }
+    sanitize();
+    
+    if (migrate) {
+      save();
+      if (stored) {
+        removeLegacyKeys();
+        Serial.println("Configuration migrated to a single NVS blob");
+      }
+    }
+  }
+  
+  // Writes the blob only if its content changed since the last load or save
+  void save() {
+    StoredConfig blob;
+    pack(blob);
+    if (stored && blob.crc == storedCrc) {
+      return;
+    }
+    ScopedTimer timer(METRIC_NVS_PUT);
+    if (prefs.putBytes(BLOB_KEY, &blob, sizeof(blob)) != sizeof(blob)) {
+      Serial.println("ERROR: Failed to save configuration");
+      return;
+    }
+    stored = true;
+    storedCrc = blob.crc;
+  }
+  
+  void reset() {
+    prefs.clear();
+    // Reinitialize with defaults
+    Config defaults;
+    *this = defaults;
+    save();
+  }
+  
+  // Validation methods
+  bool validateMeasurementInterval(unsigned int interval) const {
+    return interval >= 1 && interval <= 86400;  // Between 1 second and 24 hours
+  }
+  
+  bool validateSensorInterval(unsigned int interval) const {
+    return interval == 0 || validateMeasurementInterval(interval);  // 0 = measurement interval
+  }
+  
+  // Seconds between readings of a sensor
+  unsigned int sensorInterval(int index) const {
+    return sensors[index].interval > 0 ? sensors[index].interval : measurementInterval;
+  }
+  
+  bool validateFlushInterval(unsigned int interval) const {
+    return interval >= 1 && interval <= 3600;  // Between 1 second and 1 hour
+  }
+  
+  bool validateCommitMaxRecords(unsigned int records) const {
+    return records >= 1 && records <= 1000;
+  }
+  
+  bool validateCommitMaxBytes(unsigned int bytes) const {
+    return bytes >= 512 && bytes <= 65536;  // Between one sector and 64KB
+  }
+  
+  bool validateCommitMaxLatency(unsigned int seconds) const {
+    return seconds >= 1 && seconds <= 3600;  // Between 1 second and 1 hour
+  }
+  
+  bool validateBmeOversampling(unsigned int samples) const {
+    return samples == 1 || samples == 2 || samples == 4 || samples == 8 || samples == 16;
+  }
+  
+  bool validateUplinkInterval(unsigned int seconds) const {
+    return seconds >= 10 && seconds <= 86400;  // 10 seconds to 1 day
+  }
+  
+  bool validateUplinkBatchRecords(unsigned int records) const {
+    return records >= 1 && records <= 5000;
+  }
+  
+  bool validateCompactAfterDays(unsigned int days) const {
+    return days <= 365;  // 0 = off
+  }
+  
+  bool validateUplinkUrl(const char* url) const {
+    size_t len = strlen(url);
+    return len == 0 || (len < sizeof(uplinkUrl) &&
+                        (strncmp(url, "http://", 7) == 0 || strncmp(url, "https://", 8) == 0));
+  }
+  
+  bool validateFastAdcRate(unsigned int hz) const {
+    return hz >= 611 && hz <= 83333;  // ESP32-S2 ADC digital controller range
+  }
+  
+  bool validateSdProbeInterval(unsigned int seconds) const {
+    return seconds == 0 || (seconds >= 60 && seconds <= 86400);  // 1 minute to 1 day, 0 = off
+  }
+  
+  bool validatePreallocKB(unsigned int kb) const {
+    return kb <= 4096;  // Up to 4MB per step, 0 = off
+  }
+  
+  bool validateTimezoneOffset(int offset) const {
+    return offset >= -12 && offset <= 14;  // Valid timezone range
+  }
+  
+  bool validatePinNumber(int pin) const {
+    // ESP32-S2 has GPIOs 0-46, but not all are usable
+    // Common safe range for ESP32-S2 Mini
+    return pin >= 0 && pin <= 45;
+  }
+  
+  bool validateAPPassword(const char* password) const {
+    return strlen(password) >= 8 && strlen(password) < 64;
+  }
+
+private:
+  // Everything load() and save() keep, as one NVS blob. Fields may be
+  // appended: a shorter blob from older firmware loads with defaults for
+  // the rest (blobs of 8-sensor firmware end inside the sensors array and
+  // load as is). Any other layout change needs a new BLOB_VERSION.
+  struct __attribute__((packed)) SensorBlob {
+    uint8_t type;
+    int8_t pin;
+    char name[32];
+    uint8_t enabled;
+    uint32_t interval;
+  };
+  
+  struct __attribute__((packed)) ConfigBlob {
+    char wifiSSID[64];
+    char wifiPassword[64];
+    char apSSID[64];
+    char apPassword[64];
+    int8_t timezoneOffset;
+    uint32_t measurementInterval;
+    uint8_t deepSleepEnabled;
+    uint8_t carryForward;
+    uint8_t bufferingEnabled;
+    uint32_t flushInterval;
+    uint8_t bufferBackend;
+    uint8_t logFormat;
+    uint32_t sdPreallocKB;
+    uint32_t sdProbeInterval;
+    uint8_t groupCommitEnabled;
+    uint32_t commitMaxRecords;
+    uint32_t commitMaxBytes;
+    uint32_t commitMaxLatency;
+    uint32_t fastAdcRateHz;
+    int8_t sdCardCS;
+    int8_t i2cSDA;
+    int8_t i2cSCL;
+    int8_t batteryPin;
+    SensorBlob sensors[MAX_SENSORS];
+    uint8_t bmeOversampling;
+    uint8_t uplinkEnabled;
+    char uplinkUrl[128];
+    char uplinkToken[64];
+    uint32_t uplinkInterval;
+    uint32_t uplinkBatchRecords;
+    uint16_t compactAfterDays;
+  };
+  
+  struct __attribute__((packed)) StoredConfig {
+    uint16_t version;
+    uint16_t length;  // Bytes of data
+    uint32_t crc;     // CRC-32 of data
+    ConfigBlob data;
+  };
+  
+  static constexpr const char* BLOB_KEY = "config";
+  static const uint16_t BLOB_VERSION = 1;
+  static const size_t HEADER_SIZE = offsetof(StoredConfig, data);
+  static const size_t MAX_BLOB_SIZE = 2048;  // Room for fields added by newer firmware
+  static const int LEGACY_MAX_SENSORS = 8;   // Sensors of the per-field keys
+  static_assert(sizeof(StoredConfig) <= MAX_BLOB_SIZE, "Config blob too large");
+  
+  Preferences prefs;
+  bool stored = false;     // storedCrc is what NVS holds
+  uint32_t storedCrc = 0;
+  
+  // Load and check the blob; false (settings untouched) if missing or invalid
+  bool loadBlob() {
+    size_t size = prefs.getBytesLength(BLOB_KEY);
+    if (size < HEADER_SIZE || size > MAX_BLOB_SIZE) {
+      return false;
+    }
+    uint8_t* raw = (uint8_t*)malloc(size);
+    if (!raw) {
+      return false;
+    }
+    StoredConfig header;
+    memset(&header, 0, sizeof(header));
+    if (prefs.getBytes(BLOB_KEY, raw, size) == size) {
+      memcpy(&header, raw, HEADER_SIZE);
+    }
+    if (header.version != BLOB_VERSION || HEADER_SIZE + header.length != size ||
+        esp_rom_crc32_le(0, raw + HEADER_SIZE, header.length) != header.crc) {
+      Serial.println("Stored configuration is invalid - using defaults");
+      free(raw);
+      return false;
+    }
+    
+    // Start from the current values so fields the blob doesn't have keep them
+    StoredConfig blob;
+    pack(blob);
+    memcpy(&blob.data, raw + HEADER_SIZE, std::min((size_t)header.length, sizeof(blob.data)));
+    free(raw);
+    unpack(blob.data);
+    
+    // Unchanged settings don't rewrite a blob with the same length
+    stored = header.length == sizeof(blob.data);
+    storedCrc = header.crc;
+    return true;
+  }
+  
+  static void copyString(char* dst, const char* src, size_t size) {
+    strncpy(dst, src, size - 1);
+    dst[size - 1] = '\0';
+  }
+  
+  void pack(StoredConfig& blob) const {
+    memset(&blob, 0, sizeof(blob));  // Deterministic CRC: no stale bytes after strings
+    ConfigBlob& d = blob.data;
+    copyString(d.wifiSSID, wifiSSID, sizeof(d.wifiSSID));
+    copyString(d.wifiPassword, wifiPassword, sizeof(d.wifiPassword));
+    copyString(d.apSSID, apSSID, sizeof(d.apSSID));
+    copyString(d.apPassword, apPassword, sizeof(d.apPassword));
+    d.timezoneOffset = timezoneOffset;
+    d.measurementInterval = measurementInterval;
+    d.deepSleepEnabled = deepSleepEnabled;
+    d.carryForward = carryForward;
+    d.bufferingEnabled = bufferingEnabled;
+    d.flushInterval = flushInterval;
+    d.bufferBackend = bufferBackend;
+    d.logFormat = logFormat;
+    d.sdPreallocKB = sdPreallocKB;
+    d.sdProbeInterval = sdProbeInterval;
+    d.groupCommitEnabled = groupCommitEnabled;
+    d.commitMaxRecords = commitMaxRecords;
+    d.commitMaxBytes = commitMaxBytes;
+    d.commitMaxLatency = commitMaxLatency;
+    d.fastAdcRateHz = fastAdcRateHz;
+    d.sdCardCS = sdCardCS;
+    d.i2cSDA = i2cSDA;
+    d.i2cSCL = i2cSCL;
+    d.batteryPin = batteryPin;
+    for (int i = 0; i < MAX_SENSORS; i++) {
+      d.sensors[i].type = sensors[i].type;
+      d.sensors[i].pin = sensors[i].pin;
+      copyString(d.sensors[i].name, sensors[i].name, sizeof(d.sensors[i].name));
+      d.sensors[i].enabled = sensors[i].enabled;
+      d.sensors[i].interval = sensors[i].interval;
+    }
+    d.bmeOversampling = bmeOversampling;
+    d.uplinkEnabled = uplinkEnabled;
+    copyString(d.uplinkUrl, uplinkUrl, sizeof(d.uplinkUrl));
+    copyString(d.uplinkToken, uplinkToken, sizeof(d.uplinkToken));
+    d.uplinkInterval = uplinkInterval;
+    d.uplinkBatchRecords = uplinkBatchRecords;
+    d.compactAfterDays = compactAfterDays;
+    
+    blob.version = BLOB_VERSION;
+    blob.length = sizeof(blob.data);
+    blob.crc = esp_rom_crc32_le(0, (const uint8_t*)&blob.data, sizeof(blob.data));
+  }
+  
+  void unpack(const ConfigBlob& d) {
+    copyString(wifiSSID, d.wifiSSID, sizeof(wifiSSID));
+    copyString(wifiPassword, d.wifiPassword, sizeof(wifiPassword));
+    copyString(apSSID, d.apSSID, sizeof(apSSID));
+    copyString(apPassword, d.apPassword, sizeof(apPassword));
+    timezoneOffset = d.timezoneOffset;
+    measurementInterval = d.measurementInterval;
+    deepSleepEnabled = d.deepSleepEnabled;
+    carryForward = d.carryForward;
+    bufferingEnabled = d.bufferingEnabled;
+    flushInterval = d.flushInterval;
+    bufferBackend = (BufferBackend)d.bufferBackend;
+    logFormat = (LogFormat)d.logFormat;
+    sdPreallocKB = d.sdPreallocKB;
+    sdProbeInterval = d.sdProbeInterval;
+    groupCommitEnabled = d.groupCommitEnabled;
+    commitMaxRecords = d.commitMaxRecords;
+    commitMaxBytes = d.commitMaxBytes;
+    commitMaxLatency = d.commitMaxLatency;
+    fastAdcRateHz = d.fastAdcRateHz;
+    sdCardCS = d.sdCardCS;
+    i2cSDA = d.i2cSDA;
+    i2cSCL = d.i2cSCL;
+    batteryPin = d.batteryPin;
+    for (int i = 0; i < MAX_SENSORS; i++) {
+      sensors[i].type = (SensorType)d.sensors[i].type;
+      sensors[i].pin = d.sensors[i].pin;
+      copyString(sensors[i].name, d.sensors[i].name, sizeof(sensors[i].name));
+      sensors[i].enabled = d.sensors[i].enabled;
+      sensors[i].interval = d.sensors[i].interval;
+    }
+    bmeOversampling = d.bmeOversampling;
+    uplinkEnabled = d.uplinkEnabled;
+    copyString(uplinkUrl, d.uplinkUrl, sizeof(uplinkUrl));
+    copyString(uplinkToken, d.uplinkToken, sizeof(uplinkToken));
+    uplinkInterval = d.uplinkInterval;
+    uplinkBatchRecords = d.uplinkBatchRecords;
+    compactAfterDays = d.compactAfterDays;
+  }
+  
+  // Out-of-range values (from NVS or older firmware) fall back to defaults
+  void sanitize() {
+    // WPA2 requires at least 8 characters
+    if (strlen(apPassword) < 8) {
+      copyString(apPassword, "omnilogger123", sizeof(apPassword));
+    }
+    measurementInterval = std::max(1U, measurementInterval);
+    flushInterval = std::max(1U, flushInterval);
+    if (bufferBackend != BUFFER_FLASH && bufferBackend != BUFFER_PSRAM) {
+      bufferBackend = BUFFER_FLASH;
+    }
+    if (logFormat != LOG_CSV && logFormat != LOG_BINARY) {
+      logFormat = LOG_CSV;
+    }
+    if (!validatePreallocKB(sdPreallocKB)) {
+      sdPreallocKB = 0;
+    }
+    commitMaxRecords = std::max(1U, commitMaxRecords);
+    commitMaxBytes = std::max(512U, commitMaxBytes);
+    commitMaxLatency = std::max(1U, commitMaxLatency);
+    if (!validateSdProbeInterval(sdProbeInterval)) {
+      sdProbeInterval = 600;
+    }
+    if (!validateFastAdcRate(fastAdcRateHz)) {
+      fastAdcRateHz = 20000;
+    }
+    if (!validateBmeOversampling(bmeOversampling)) {
+      bmeOversampling = 1;
+    }
+    if (!validateUplinkInterval(uplinkInterval)) {
+      uplinkInterval = 900;
+    }
+    if (!validateUplinkBatchRecords(uplinkBatchRecords)) {
+      uplinkBatchRecords = 500;
+    }
+    if (!validateUplinkUrl(uplinkUrl)) {
+      uplinkUrl[0] = '\0';
+    }
+    if (!validateCompactAfterDays(compactAfterDays)) {
+      compactAfterDays = 7;
+    }
+    for (int i = 0; i < MAX_SENSORS; i++) {
+      if (!validateSensorInterval(sensors[i].interval)) {
+        sensors[i].interval = 0;
+      }
+      if (sensors[i].type < SENSOR_NONE || sensors[i].type >= SENSOR_TYPE_COUNT) {
+        sensors[i].type = SENSOR_NONE;
+      }
+    }
+  }
+  
+  // Per-field keys written by firmware before the config blob
+  void loadLegacyKeys() {
     // Load WiFi settings
     prefs.getString("wifiSSID", wifiSSID, sizeof(wifiSSID));
     wifiSSID[sizeof(wifiSSID) - 1] = '\0';
@@ -125,22 +564,34 @@ public:
     prefs.getString("apPass", apPassword, sizeof(apPassword));
     apPassword[sizeof(apPassword) - 1] = '\0';
     
-    // Validate AP password length (WPA2 requires min 8 characters)
-    if (strlen(apPassword) < 8) {
-      strncpy(apPassword, "omnilogger123", sizeof(apPassword) - 1);
-      apPassword[sizeof(apPassword) - 1] = '\0';
-    }
-    
     // Load time settings
     timezoneOffset = prefs.getInt("tzOffset", 0);
     
     // Load measurement settings
-    measurementInterval = std::max(1U, prefs.getUInt("measInterval", 60));
+    measurementInterval = prefs.getUInt("measInterval", 60);
     deepSleepEnabled = prefs.getBool("deepSleep", false);
+    carryForward = prefs.getBool("carryLast", false);
     
     // Load buffering settings
     bufferingEnabled = prefs.getBool("bufferEn", false);
-    flushInterval = std::max(1U, prefs.getUInt("flushInt", 300));
+    flushInterval = prefs.getUInt("flushInt", 300);
+    bufferBackend = (BufferBackend)prefs.getUInt("bufferBack", BUFFER_FLASH);
+    
+    // Load log format
+    logFormat = (LogFormat)prefs.getUInt("logFormat", LOG_CSV);
+    sdPreallocKB = prefs.getUInt("sdPrealloc", 0);
+    
+    // Load group commit settings
+    groupCommitEnabled = prefs.getBool("gcEn", false);
+    commitMaxRecords = prefs.getUInt("gcRecords", 32);
+    commitMaxBytes = prefs.getUInt("gcBytes", 4096);
+    commitMaxLatency = prefs.getUInt("gcLatency", 30);
+    
+    // Load SD health probe interval
+    sdProbeInterval = prefs.getUInt("sdProbeInt", 600);
+    
+    // Load fast analog sampling rate
+    fastAdcRateHz = prefs.getUInt("fastAdcRate", 20000);
     
     // Load pin configuration
     sdCardCS = prefs.getInt("sdCS", DEFAULT_SD_CS);
@@ -149,7 +600,7 @@ public:
     batteryPin = prefs.getInt("batteryPin", 1);
     
     // Load sensor configuration
-    for (int i = 0; i < MAX_SENSORS; i++) {
+    for (int i = 0; i < LEGACY_MAX_SENSORS; i++) {
       char key[16];
       snprintf(key, sizeof(key), "s%d_type", i);
       sensors[i].type = (SensorType)prefs.getUInt(key, sensors[i].type);
@@ -163,83 +614,35 @@ public:
       
       snprintf(key, sizeof(key), "s%d_en", i);
       sensors[i].enabled = prefs.getBool(key, sensors[i].enabled);
-    }
-  }
-  
-  void save() {
-    // Save WiFi settings
-    prefs.putString("wifiSSID", wifiSSID);
-    prefs.putString("wifiPass", wifiPassword);
-    prefs.putString("apSSID", apSSID);
-    prefs.putString("apPass", apPassword);
-    
-    // Save time settings
-    prefs.putInt("tzOffset", timezoneOffset);
-    
-    // Save measurement settings
-    prefs.putUInt("measInterval", measurementInterval);
-    prefs.putBool("deepSleep", deepSleepEnabled);
-    
-    // Save buffering settings
-    prefs.putBool("bufferEn", bufferingEnabled);
-    prefs.putUInt("flushInt", flushInterval);
-    
-    // Save pin configuration
-    prefs.putInt("sdCS", sdCardCS);
-    prefs.putInt("i2cSDA", i2cSDA);
-    prefs.putInt("i2cSCL", i2cSCL);
-    prefs.putInt("batteryPin", batteryPin);
-    
-    // Save sensor configuration
-    for (int i = 0; i < MAX_SENSORS; i++) {
-      char key[16];
-      snprintf(key, sizeof(key), "s%d_type", i);
-      prefs.putUInt(key, sensors[i].type);
       
-      snprintf(key, sizeof(key), "s%d_pin", i);
-      prefs.putInt(key, sensors[i].pin);
-      
-      snprintf(key, sizeof(key), "s%d_name", i);
-      prefs.putString(key, sensors[i].name);
-      
-      snprintf(key, sizeof(key), "s%d_en", i);
-      prefs.putBool(key, sensors[i].enabled);
+      snprintf(key, sizeof(key), "s%d_int", i);
+      sensors[i].interval = prefs.getUInt(key, 0);
     }
   }
   
-  void reset() {
-    prefs.clear();
-    // Reinitialize with defaults
-    Config defaults;
-    *this = defaults;
-    save();
-  }
-  
-  // Validation methods
-  bool validateMeasurementInterval(unsigned int interval) const {
-    return interval >= 1 && interval <= 86400;  // Between 1 second and 24 hours
-  }
-  
-  bool validateFlushInterval(unsigned int interval) const {
-    return interval >= 1 && interval <= 3600;  // Between 1 second and 1 hour
-  }
-  
-  bool validateTimezoneOffset(int offset) const {
-    return offset >= -12 && offset <= 14;  // Valid timezone range
-  }
-  
-  bool validatePinNumber(int pin) const {
-    // ESP32-S2 has GPIOs 0-46, but not all are usable
-    // Common safe range for ESP32-S2 Mini
-    return pin >= 0 && pin <= 45;
-  }
-  
-  bool validateAPPassword(const char* password) const {
-    return strlen(password) >= 8 && strlen(password) < 64;
+  void removeLegacyKeys() {
+    static const char* const keys[] = {
+      "wifiSSID", "wifiPass", "apSSID", "apPass", "tzOffset", "measInterval", "deepSleep",
+      "carryLast", "bufferEn", "flushInt", "bufferBack", "logFormat", "sdPrealloc", "gcEn",
+      "gcRecords", "gcBytes", "gcLatency", "sdProbeInt", "fastAdcRate", "sdCS", "i2cSDA",
+      "i2cSCL", "batteryPin"
+    };
+    static const char* const sensorKeys[] = {"type", "pin", "name", "en", "int"};
+    for (const char* key : keys) {
+      if (prefs.isKey(key)) {
+        prefs.remove(key);
+      }
+    }
+    for (int i = 0; i < LEGACY_MAX_SENSORS; i++) {
+      for (const char* suffix : sensorKeys) {
+        char key[16];
+        snprintf(key, sizeof(key), "s%d_%s", i, suffix);
+        if (prefs.isKey(key)) {
+          prefs.remove(key);
+        }
+      }
+    }
   }
-
-private:
-  Preferences prefs;
 };
 
 #endif // CONFIG_H
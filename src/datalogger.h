@@ -26,26 +26,47 @@
 #include <SPI.h>
 #include <WebServer.h>
 #include <Preferences.h>
+#include <unistd.h>
+#include <esp_task_wdt.h>
+#include "journal.h"
+#include "binlog.h"
+#include "manifest.h"
+#include "timeindex.h"
+#include "block_writer.h"
+#include "sd_clock.h"
 
 class DataLogger {
 public:
-  DataLogger() : initialized(false), fileOpen(false), totalDataPoints(0), 
-                 bufferEnabled(false), bufferCount(0), lastFlushTime(0), sdInitialized(false) {
-    // Initialize NVS buffer
-    if (bufferPrefs.begin("databuffer", false)) {
-      bufferCount = bufferPrefs.getUInt("count", 0);
-      Serial.printf("Restored %d buffered entries from NVS\n", bufferCount);
-    }
-  }
-  
-  ~DataLogger() {
-    bufferPrefs.end();
+  DataLogger() : initialized(false), fileOpen(false), sdSpi(FSPI), totalDataPoints(0), 
+                 bufferEnabled(false), lastFlushTime(0), sdInitialized(false),
+                 logFormat(LOG_CSV), binRecordSize(0),
+                 currentDayStart(0), currentDayEnd(0), renameCallback(nullptr),
+                 groupCommit(false), commitMaxRecords(1), commitMaxBytes(4096), commitMaxLatencyMs(0),
+                 pendingRecords(0), pendingBytes(0), firstPendingTime(0),
+                 pendingFirstTs(0), pendingLastTs(0), safeRecords(0),
+                 currentFileRows(0), currentFileBytes(0), pendingIndexCount(0),
+                 preallocBytes(0), physicalSize(0), healthy(false), usedBytes(0),
+                 usedBytesKnown(false), probesSinceScan(0), lastCompactionScan(0),
+                 compactedFiles(0), compactedSaved(0) {
+    currentFilename[0] = '\0';
+    memset(currentDecimals, BinLog::DECIMALS, sizeof(currentDecimals));
   }
   
-  bool begin(int csPin) {
+  bool begin(int csPin, BufferBackend backend = BUFFER_FLASH, LogFormat format = LOG_CSV) {
     this->csPin = csPin;
+    logFormat = format;  // Buffered records from the last boot are in this format
     lastFlushTime = millis();
     
+    // Open the buffer journal and pick up records left by the previous boot
+    if (!journal.begin(backend)) {
+      Serial.println("Buffer journal unavailable - buffered data will go straight to SD");
+    }
+    migrateLegacyBuffer();
+    
+    if (!blockWriter.begin()) {
+      Serial.println("No DMA memory for the SD block buffer - writing records directly");
+    }
+    
     // Don't initialize SD card here - lazy init when needed
     Serial.println("DataLogger initialized (SD card will be initialized on first flush)");
     initialized = true;
@@ -60,10 +81,11 @@ public:
     
     Serial.println("Initializing SD card...");
     
-    // Try multiple times - SD cards can be flaky
+    // Try multiple times - SD cards can be flaky. Always mount at the safe
+    // clock first; tune() below moves to the card's calibrated one.
     int retries = 3;
     while (retries > 0) {
-      if (SD.begin(csPin)) {
+      if (SD.begin(csPin, sdSpi, SdClockTuner::SAFE_HZ)) {
         break;
       }
       retries--;
@@ -104,141 +126,195 @@ public:
     uint64_t cardSize = SD.cardSize() / (1024 * 1024);
     Serial.printf("SD Card Size: %lluMB\n", cardSize);
     
+    if (!sdClock.tune(csPin, sdSpi)) {
+      Serial.println("SD card lost while setting its clock!");
+      sdInitialized = false;
+      return false;
+    }
+    
     sdInitialized = true;
+    healthy = true;
+    usedBytesKnown = false;  // Scanned by the next health probe
     
-    // Count existing data points
-    countDataPoints();
+    // Row counts come from the manifest; only changed files are rescanned
+    manifest.begin();
+    totalDataPoints = manifest.totalRows();
     
     return true;
   }
   
   bool logData(const String& data) {
+    return logData(data.c_str(), data.length(), time(nullptr));
+  }
+  
+  // Log one record in the current format: a CSV row without line ending,
+  // or a BinLog record. timestamp is the sample time. deferCommit leaves
+  // direct writes uncommitted for a batch that ends with commit().
+  bool logData(const char* data, size_t len, time_t sampleTime, bool deferCommit = false) {
     if (!initialized && !bufferEnabled) {
       Serial.println("DataLogger not initialized and buffering disabled!");
       return false;
     }
     
-    // If buffering is enabled, add to NVS buffer
+    // Before NTP sync the clock is meaningless - route by write time instead
+    time_t timestamp = sampleTime > MIN_VALID_TIME ? sampleTime : 0;
+    
+    // If buffering is enabled, append to the journal
     if (bufferEnabled) {
-      if (bufferCount < MAX_BUFFER_SIZE) {
-        // Store data point in NVS
-        char key[16];
-        snprintf(key, sizeof(key), "d%d", bufferCount);
-        bufferPrefs.putString(key, data);
-        bufferCount++;
-        bufferPrefs.putUInt("count", bufferCount);
-        
-        Serial.printf("Data buffered to NVS (count: %d/%d)\n", bufferCount, MAX_BUFFER_SIZE);
-        
-        // Check if buffer threshold reached (80% full)
-        if (bufferCount >= (MAX_BUFFER_SIZE * 80 / 100)) {
-          Serial.println("Buffer 80% full, triggering flush...");
-          flushBuffer();
-        }
-        
-        return true;
-      } else {
-        // Buffer full, force flush then add current data
+      if (!journal.append(data, len, timestamp)) {
+        // Journal full, force flush then retry
         Serial.println("Buffer full, forcing flush...");
-        if (!flushBuffer()) {
+        if (!flushBuffer() || !journal.append(data, len, timestamp)) {
           // Flush failed, try direct write to SD
           Serial.println("Flush failed, attempting direct SD write...");
-          return writeToSD(data);
+          return writeToSD(data, len, timestamp);
         }
-        
-        // After successful flush, bufferCount should be 0
-        // Store current data point
-        char key[16];
-        snprintf(key, sizeof(key), "d%d", bufferCount);
-        bufferPrefs.putString(key, data);
-        bufferCount++;
-        bufferPrefs.putUInt("count", bufferCount);
-        
+        safeRecords++;
         return true;
       }
+      safeRecords++;
+      
+      // Check if buffer threshold reached (80% full)
+      if (journal.usedBytes() >= (uint64_t)journal.capacityBytes() * 80 / 100) {
+        Serial.println("Buffer 80% full, triggering flush...");
+        flushBuffer();
+      }
+      
+      return true;
     }
     
     // Direct write to SD card (original behavior)
-    return writeToSD(data);
+    if (deferCommit) {
+      return appendRecord(data, len, timestamp);
+    }
+    return writeToSD(data, len, timestamp);
   }
   
   bool writeToSD(const String& data) {
-    // Lazy init SD card on first write
-    if (!sdInitialized && !initSDCard()) {
-      Serial.println("SD card not initialized and init failed!");
+    return writeToSD(data.c_str(), data.length(), 0);
+  }
+  
+  bool writeToSD(const char* data, size_t len, time_t timestamp) {
+    if (!appendRecord(data, len, timestamp)) {
       return false;
     }
     
-    // Get current date for filename
-    time_t now;
-    time(&now);
-    struct tm timeinfo;
-    localtime_r(&now, &timeinfo);
-    
-    char filename[32];
-    snprintf(filename, sizeof(filename), "/data_%04d%02d%02d.csv",
-             timeinfo.tm_year + 1900, timeinfo.tm_mon + 1, timeinfo.tm_mday);
-    
-    // Check if file exists, if not create with header
-    bool fileExists = SD.exists(filename);
-    
-    File dataFile = SD.open(filename, FILE_APPEND);
-    if (!dataFile) {
-      Serial.printf("Failed to open file: %s\n", filename);
-      return false;
+    // Without group commit every record is its own commit
+    if (!groupCommit || commitDue()) {
+      return commit();
     }
     
-    // Write header if new file
-    if (!fileExists) {
-      // Note: Header should be written by the caller based on sensor config
-      // For now, we'll skip the header as it's dynamic
+    return true;
+  }
+  
+  // decimals: per value column, stored in the schema of binary day files
+  bool writeHeader(const String& header, const uint8_t* decimals) {
+    // Header is cached and written when a new day file is created, so
+    // calling this every measurement costs no SD access
+    if (header != currentHeader) {
+      currentHeader = header;
+      binRecordSize = BinLog::recordSize(BinLog::channelCount(header));
     }
-    
-    // Write data
-    dataFile.println(data);
-    dataFile.close();
-    
-    totalDataPoints++;
-    
+    memcpy(currentDecimals, decimals, BinLog::channelCount(header));
     return true;
   }
   
-  bool writeHeader(const String& header) {
-    // Lazy init SD card
-    if (!sdInitialized && !initSDCard()) {
-      return false;
+  // Switch day file format. Buffered records are written out first so the
+  // journal never holds a mix of formats.
+  void setLogFormat(LogFormat format) {
+    if (format == logFormat) {
+      return;
     }
+    flush();
+    closeDayFile();
+    logFormat = format;
+    Serial.printf("Log format: %s\n", format == LOG_BINARY ? "binary" : "CSV");
+  }
+  
+  LogFormat getLogFormat() const {
+    return logFormat;
+  }
+  
+  void setCommitPolicy(bool enabled, uint32_t maxRecords, uint32_t maxBytes, uint32_t maxLatencySec) {
+    groupCommit = enabled;
+    commitMaxRecords = maxRecords > 0 ? maxRecords : 1;
+    commitMaxBytes = maxBytes > 0 ? maxBytes : 1;
+    commitMaxLatencyMs = maxLatencySec * 1000UL;
     
-    time_t now;
-    time(&now);
-    struct tm timeinfo;
-    localtime_r(&now, &timeinfo);
-    
-    char filename[32];
-    snprintf(filename, sizeof(filename), "/data_%04d%02d%02d.csv",
-             timeinfo.tm_year + 1900, timeinfo.tm_mon + 1, timeinfo.tm_mday);
-    
-    // Only write header if file doesn't exist
-    if (SD.exists(filename)) {
-      return true;  // File exists, don't overwrite
+    if (groupCommit) {
+      Serial.printf("Group commit enabled (%u records / %u bytes / %u s)\n",
+                    commitMaxRecords, commitMaxBytes, maxLatencySec);
+    } else {
+      // Don't leave records from a previous policy waiting
+      commit();
+    }
+  }
+  
+  // Told when a day file is moved aside for a schema change, so readers
+  // holding a position in it (the uplink cursor) can follow
+  void setRenameCallback(void (*callback)(const char* from, const char* to)) {
+    renameCallback = callback;
+  }
+  
+  // Preallocate day files in steps of kb (0 = off)
+  void setPreallocation(uint32_t kb) {
+    preallocBytes = kb * 1024;
+  }
+  
+  const LatencyStats& getWriteStats() const {
+    return blockWriter.getWriteStats();
+  }
+  
+  const LatencyStats& getCommitStats() const {
+    return commitStats;
+  }
+  
+  // Make all records written so far durable with a single flush
+  bool commit() {
+    if (!fileOpen || pendingRecords == 0) {
+      return true;
     }
     
-    File dataFile = SD.open(filename, FILE_WRITE);
-    if (!dataFile) {
+    // Write the partial block, then flush data and the directory entry
+    uint32_t start = micros();
+    bool ok = blockWriter.flush();
+    dataFile.flush();
+    commitStats.record(micros() - start);
+    if (!ok) {
+      Serial.printf("Failed to write to file: %s\n", currentFilename);
+      rollBack();
       return false;
     }
+    manifest.update(currentFilename, pendingRecords, currentFileBytes, pendingFirstTs, pendingLastTs);
+    writePendingIndex();  // After the data; seek() also ignores entries past the file end
     
-    dataFile.println(header);
-    dataFile.close();
-    
+    safeRecords += pendingRecords;
+    pendingRecords = 0;
+    pendingBytes = 0;
     return true;
   }
   
-  void flush() {
-    if (bufferEnabled && bufferCount > 0) {
-      flushBuffer();
+  // Called from the main loop so the latency limit holds even when no new records arrive
+  void commitIfDue() {
+    if (pendingRecords > 0 && commitDue()) {
+      commit();
     }
-    // SD library auto-flushes on close
+  }
+  
+  uint32_t getPendingRecords() const {
+    return pendingRecords;
+  }
+  
+  // Records that can no longer be lost to a failed write: committed to the
+  // card, in the journal, or dropped. Differences tell a caller that logged
+  // with deferCommit how many of its records are safe after commit().
+  uint32_t getSafeRecords() const {
+    return safeRecords;
+  }
+  
+  bool flush() {
+    bool ok = journal.count() == 0 || flushBuffer();
+    return commit() && ok;
   }
   
   void setBufferingEnabled(bool enabled) {
@@ -247,50 +323,81 @@ public:
   }
   
   bool flushBuffer() {
+    ScopedTimer timer(METRIC_BUFFER_FLUSH);
     // Lazy init SD card on flush
     if (!sdInitialized && !initSDCard()) {
       Serial.println("Cannot flush buffer - SD card init failed!");
       return false;
     }
     
-    if (bufferCount == 0) {
+    uint32_t totalCount = journal.count();
+    if (totalCount == 0) {
       return true;  // Nothing to flush
     }
     
-    Serial.printf("Flushing %d buffered data points from NVS to SD card...\n", bufferCount);
+    Serial.printf("Flushing %u buffered data points from journal to SD card...\n", totalCount);
     
-    int successCount = 0;
-    int totalCount = bufferCount;
+    uint8_t* record = (uint8_t*)malloc(RecordJournal::MAX_RECORD_SIZE);
+    if (!record) {
+      Serial.println("Cannot flush buffer - out of memory!");
+      return false;
+    }
     
-    // Read buffered data from NVS and write to SD
-    for (int i = 0; i < totalCount; i++) {
-      char key[16];
-      snprintf(key, sizeof(key), "d%d", i);
-      String data = bufferPrefs.getString(key, "");
-      
-      if (data.length() > 0) {
-        if (writeToSD(data)) {
-          successCount++;
-        }
+    // Records are only dropped from the journal once they were committed: a
+    // day change commits the records before it, a failed write rolls back
+    // everything since the last commit. safeRecords tells which happened.
+    if (!commit()) {
+      free(record);
+      return false;
+    }
+    uint32_t base = safeRecords;
+    uint32_t offset = journal.getTail();
+    uint32_t durableTail = offset;
+    uint32_t durableCount = 0;
+    uint32_t appended = 0;
+    uint32_t appendedTail = offset;
+    JournalRecordHeader hdr;
+    
+    while (appended < totalCount) {
+      uint32_t recordStart = offset;
+      if (!journal.read(offset, hdr, record, RecordJournal::MAX_RECORD_SIZE)) {
+        Serial.println("Journal record unreadable, stopping flush");
+        break;
+      }
+      bool ok = appendRecord((const char*)record, hdr.length, hdr.timestamp);
+      if (safeRecords - base == appended) {
+        durableTail = recordStart;  // Everything before this record is on the card
+        durableCount = appended;
+      }
+      if (!ok) {
+        break;  // Keep this and later records for the next attempt
+      }
+      appended++;
+      appendedTail = offset;
+      if (safeRecords - base == appended) {
+        durableTail = offset;  // A record dropped for a schema mismatch
+        durableCount = appended;
       }
     }
+    free(record);
     
-    // Clear NVS buffer
-    for (int i = 0; i < totalCount; i++) {
-      char key[16];
-      snprintf(key, sizeof(key), "d%d", i);
-      bufferPrefs.remove(key);
+    // One commit for the whole batch
+    if (appended > durableCount && commit() && safeRecords - base == appended) {
+      durableTail = appendedTail;
+      durableCount = appended;
     }
-    bufferCount = 0;
-    bufferPrefs.putUInt("count", 0);
+    if (durableCount > 0) {
+      journal.consume(durableTail, durableCount);
+    }
+    safeRecords = base;  // Journal records were counted when they were appended
     lastFlushTime = millis();
     
-    Serial.printf("Flushed %d/%d data points successfully\n", successCount, totalCount);
-    return successCount > 0;
+    Serial.printf("Flushed %u/%u data points successfully\n", durableCount, totalCount);
+    return durableCount > 0;
   }
   
   bool shouldFlush(unsigned long flushIntervalMs) {
-    if (!bufferEnabled || bufferCount == 0) {
+    if (!bufferEnabled || journal.count() == 0) {
       return false;
     }
     
@@ -309,11 +416,19 @@ public:
   }
   
   int getBufferCount() const {
-    return bufferCount;
+    return journal.count();
   }
   
   int getBufferCapacity() const {
-    return MAX_BUFFER_SIZE;
+    return journal.capacityRecords();
+  }
+  
+  bool isBufferPersistent() const {
+    return journal.isPersistent();
+  }
+  
+  BufferBackend getBufferBackend() const {
+    return journal.getBackend();
   }
   
   uint64_t getTotalSize() const {
@@ -321,37 +436,62 @@ public:
     return SD.cardSize();
   }
   
+  // Used space from the last FAT scan plus day file growth since; 0 until
+  // the first health probe after mounting
   uint64_t getUsedSize() const {
-    if (!sdInitialized) return 0;
-    return SD.usedBytes();
+    if (!sdInitialized || !usedBytesKnown) return 0;
+    return usedBytes;
   }
   
   uint64_t getFreeSize() const {
     if (!sdInitialized) return 0;
-    return SD.totalBytes() - SD.usedBytes();
+    uint64_t total = SD.totalBytes();
+    return total > getUsedSize() ? total - getUsedSize() : 0;
   }
   
   uint32_t getDataPointCount() const {
     return totalDataPoints;
   }
   
+  // Mounted, but the used space hasn't been scanned yet
+  bool needsUsedSizeScan() const {
+    return sdInitialized && !usedBytesKnown;
+  }
+  
+  // Result of the last health probe or write (no SD access)
   bool isHealthy() const {
+    return sdInitialized && healthy;
+  }
+  
+  // Basic health check - can we write a test file? Also rescans the FAT for
+  // the used space, on the first probe after mounting and every
+  // FAT_RESCAN_PROBES probes to pick up files the counter doesn't see
+  bool probeHealth() {
     if (!sdInitialized) return false;
     
-    // Basic health check - can we write a test file?
     File testFile = SD.open("/health_check.tmp", FILE_WRITE);
-    if (!testFile) {
-      return false;
+    healthy = testFile;
+    if (testFile) {
+      testFile.println("OK");
+      testFile.close();
+      SD.remove("/health_check.tmp");
+    } else {
+      sdClock.forget();  // Start from the safe clock on the next mount
     }
-    testFile.println("OK");
-    testFile.close();
-    SD.remove("/health_check.tmp");
     
-    return true;
+    if (healthy && (!usedBytesKnown || ++probesSinceScan >= FAT_RESCAN_PROBES)) {
+      usedBytes = SD.usedBytes();
+      usedBytesKnown = true;
+      probesSinceScan = 0;
+    }
+    return healthy;
   }
   
   void powerDown() {
     if (sdInitialized) {
+      closeDayFile();
+      compactor.abort();
+      manifest.close();
       SD.end();
       sdInitialized = false;
       Serial.println("SD card powered down");
@@ -380,148 +520,716 @@ public:
     }
     
     info += ", Size: " + String(SD.cardSize() / (1024 * 1024)) + "MB";
-    info += ", Used: " + String(SD.usedBytes() / (1024 * 1024)) + "MB";
+    info += ", Used: " + String(getUsedSize() / (1024 * 1024)) + "MB";
     
     return info;
   }
   
-  bool listFiles(String& output, const char* dirname = "/") {
+  // Day files from the manifest, one page at a time. Returns entries written to out.
+  uint32_t listFiles(ManifestEntry* out, uint32_t offset, uint32_t limit,
+                     ManifestSort sort = SORT_NAME, bool descending = false) const {
+    if (!sdInitialized) return 0;
+    return manifest.page(out, offset, limit, sort, descending);
+  }
+  
+  uint32_t getFileCount() const {
+    return sdInitialized ? manifest.size() : 0;
+  }
+  
+  bool fileExists(const char* filename) {
+    if (!sdInitialized && !initSDCard()) return false;
+    return SD.exists(filename);
+  }
+  
+  // Read rows with from <= time <= to (0 = unbounded) without loading the
+  // file: the index (CSV) or a binary search (binary) finds the first row;
+  // a compacted file is inflated from the start.
+  // emit(const char* row, size_t len) gets CSV rows without line ending.
+  template<typename Emit>
+  bool queryData(const char* filename, uint32_t from, uint32_t to, uint32_t skip, uint32_t limit,
+                 String& header, bool& more, Emit emit) {
     if (!sdInitialized) return false;
     
-    File root = SD.open(dirname);
-    if (!root) {
+    commit();
+    more = false;
+    
+    File file = SD.open(filename);
+    if (!file) {
       return false;
     }
     
-    if (!root.isDirectory()) {
-      root.close();
+    const size_t bufSize = 4096;
+    char* buf = (char*)(psramFound() ? ps_malloc(bufSize) : malloc(bufSize));
+    if (!buf) {
+      file.close();
       return false;
     }
     
-    output = "";
-    File file = root.openNextFile();
-    while (file) {
-      if (!file.isDirectory()) {
-        output += String(file.name()) + " (" + String(file.size()) + " bytes)\n";
-      }
-      file = root.openNextFile();
+    uint32_t end = readableSize(filename, file);
+    bool ok;
+    if (BinLog::isBinaryFile(filename)) {
+      ok = queryBinary(file, end, from, to, skip, limit, header, more, buf, bufSize, emit);
+    } else if (Gzip::isCompressed(filename)) {
+      ok = queryCompressed(file, from, to, skip, limit, header, more, buf, bufSize, emit);
+    } else {
+      ok = queryCsv(file, end, filename, from, to, skip, limit, header, more, buf, bufSize, emit);
     }
     
-    root.close();
-    return true;
+    free(buf);
+    file.close();
+    return ok;
   }
   
-  bool downloadFile(const char* filename, String& content) {
+  // Open a day file for a background download. Pending records are
+  // committed first; length is the readable size (a preallocated file has
+  // zeros past it).
+  bool openDownload(const char* filename, File& file, uint32_t& length) {
     if (!sdInitialized) return false;
     
-    File file = SD.open(filename);
+    commit();
+    
+    file = SD.open(filename);
     if (!file) {
       return false;
     }
-    
-    size_t fileSize = file.size();
-    
-    // Pre-allocate string buffer to avoid fragmentation
-    // Use PSRAM if available for large files
-    content = "";
-    if (psramFound() && fileSize > 4096) {
-      // For large files with PSRAM, read in larger chunks
-      content.reserve(fileSize + 1);
-      
-      // Use PSRAM buffer for reading
-      size_t bufSize = std::min((size_t)8192, fileSize);
-      char* buffer = (char*)ps_malloc(bufSize);
-      if (buffer) {
-        while (file.available()) {
-          size_t bytesRead = file.read((uint8_t*)buffer, bufSize - 1);
-          buffer[bytesRead] = '\0';
-          content += buffer;
-        }
-        free(buffer);
-      } else {
-        // Fallback to character-by-character if PSRAM alloc fails
-        while (file.available()) {
-          content += (char)file.read();
-        }
-      }
-    } else {
-      // Standard approach for smaller files or no PSRAM
-      content.reserve(fileSize + 1);
-      while (file.available()) {
-        content += (char)file.read();
-      }
-    }
-    
-    file.close();
+    length = readableSize(filename, file);
     return true;
   }
   
-  bool streamFile(const char* filename, WebServer& server) {
-    if (!sdInitialized) return false;
+  // Idle-time compaction: gzip one closed CSV day file whose last row is
+  // older than olderThan, budgetUs at a time. Files named keepFrom or later
+  // are left as they are (rows the uplink hasn't sent yet; nullptr = none).
+  // Nothing else may hold a day file open across calls - downloads read
+  // the source until it is replaced.
+  void serviceCompaction(time_t olderThan, const char* keepFrom, uint32_t budgetUs) {
+    if (!sdInitialized || !healthy) {
+      return;
+    }
+    if (!compactor.busy()) {
+      if (millis() - lastCompactionScan < COMPACTION_SCAN_MS && lastCompactionScan != 0) {
+        return;
+      }
+      lastCompactionScan = millis();
+      startCompaction(olderThan, keepFrom);
+      return;
+    }
     
-    File file = SD.open(filename);
-    if (!file) {
-      return false;
+    DayFileCompactor::Status status;
+    {
+      ScopedTimer timer(METRIC_COMPACT_SLICE);
+      status = compactor.step(budgetUs);
+    }
+    if (status != DayFileCompactor::COMPACT_DONE) {
+      return;
     }
     
-    size_t sent = server.streamFile(file, "text/csv");
-    file.close();
-    return sent > 0;
+    char source[32];
+    char target[32];
+    char index[32];
+    strncpy(source, compactor.getSource(), sizeof(source));
+    uint32_t before = compactor.getInputBytes();
+    uint32_t after = compactor.getOutputBytes();
+    if (!compactor.replace(target, sizeof(target))) {
+      return;
+    }
+    // The time index only serves seeks into the plain file
+    uint32_t indexBytes = 0;
+    if (TimeIndex::indexPath(source, index, sizeof(index)) && SD.exists(index)) {
+      File idx = SD.open(index, FILE_READ);
+      indexBytes = idx.size();
+      idx.close();
+      SD.remove(index);
+    }
+    manifest.rename(source, target);
+    manifest.update(target, 0, after, 0, 0);
+    addUsedBytes((int64_t)after - before - indexBytes);
+    compactedFiles++;
+    compactedSaved += before + indexBytes > after ? before + indexBytes - after : 0;
+    Serial.printf("Compacted %s: %u -> %u bytes\n", source, before, after);
+  }
+  
+  bool isCompacting() const {
+    return compactor.busy();
+  }
+  
+  // Drop a job in progress (compaction turned off)
+  void stopCompaction() {
+    if (compactor.busy()) {
+      compactor.abort();
+    }
+  }
+  
+  uint32_t getCompactedFiles() const {
+    return compactedFiles;
+  }
+  
+  uint64_t getCompactedBytesSaved() const {
+    return compactedSaved;
+  }
+  
+  // SPI clock and throughput of the mounted card
+  const SdClockProfile& getSdClock() const {
+    return sdClock.getProfile();
+  }
+  
+  bool isSdClockCalibrated() const {
+    return sdClock.isCalibrated();
   }
 
 private:
   bool initialized;
   bool fileOpen;
   int csPin;
+  SPIClass sdSpi;  // The card's own bus object, on the board's default SPI pins
+  SdClockTuner sdClock;
   uint32_t totalDataPoints;
   bool sdInitialized;
   
-  // Data buffering with NVS persistence
-  static const int MAX_BUFFER_SIZE = 100;  // Buffer up to 100 data points
-  Preferences bufferPrefs;  // NVS storage for buffer
-  int bufferCount;
+  // Day file format
+  LogFormat logFormat;
+  uint16_t binRecordSize;  // Expected BinLog record size for the current header
+  
+  // Data buffering in a flash partition or PSRAM ring
+  RecordJournal journal;
+  static const time_t MIN_VALID_TIME = 1577836800;  // 2020-01-01, clock is set after this
   bool bufferEnabled;
   unsigned long lastFlushTime;
   
-  void countDataPoints() {
-    totalDataPoints = 0;
-    
-    File root = SD.open("/");
-    if (!root) return;
-    
-    File file = root.openNextFile();
-    while (file) {
-      if (!file.isDirectory()) {
-        String filename = String(file.name());
-        if (filename.startsWith("/data_") && filename.endsWith(".csv")) {
-          // Store filename before any file handle changes
-          String fullPath = filename;
-          file.close();  // Close the directory entry file handle first
-          
-          // Now safely open the data file using the stored path
-          File dataFile = SD.open(fullPath);
-          if (dataFile) {
-            bool firstLine = true;
-            while (dataFile.available()) {
-              String line = dataFile.readStringUntil('\n');
-              if (!firstLine && line.length() > 0) {
-                totalDataPoints++;
-              }
-              firstLine = false;
-            }
-            dataFile.close();
-          }
-          
-          // Continue to next file
-          file = root.openNextFile();
+  // Append handle for the current day file
+  File dataFile;
+  char currentFilename[32];
+  time_t currentDayStart;  // Local midnight of the open file's day
+  time_t currentDayEnd;    // Next local midnight - rollover point
+  String currentHeader;
+  void (*renameCallback)(const char* from, const char* to);
+  uint8_t currentDecimals[BinLog::MAX_CHANNELS];
+  
+  // Group commit state
+  bool groupCommit;
+  uint32_t commitMaxRecords;
+  uint32_t commitMaxBytes;
+  unsigned long commitMaxLatencyMs;
+  uint32_t pendingRecords;
+  uint32_t pendingBytes;
+  unsigned long firstPendingTime;
+  uint32_t pendingFirstTs;  // Sample times of the uncommitted records, for the manifest
+  uint32_t pendingLastTs;
+  uint32_t safeRecords;     // Records committed, journaled or dropped since boot
+  
+  // Per-file rows, sizes and time ranges
+  FileManifest manifest;
+  
+  // Open day file position and index entries not yet on the card
+  static const uint8_t MAX_PENDING_INDEX = 16;
+  uint32_t currentFileRows;
+  uint32_t currentFileBytes;
+  TimeIndexEntry pendingIndex[MAX_PENDING_INDEX];
+  uint8_t pendingIndexCount;
+  
+  // Write combining and preallocation for the open day file
+  BlockWriter blockWriter;
+  uint32_t preallocBytes;  // Extent added when the file is opened or filled (0 = off)
+  uint32_t physicalSize;   // Allocated size of the open file, >= currentFileBytes
+  LatencyStats commitStats;
+  
+  // Card health and used space, kept current without touching the card
+  static const uint32_t FAT_RESCAN_PROBES = 12;
+  bool healthy;
+  uint64_t usedBytes;
+  bool usedBytesKnown;
+  uint32_t probesSinceScan;
+  
+  // Background gzip of closed day files
+  static const unsigned long COMPACTION_SCAN_MS = 60000;  // Between looks for a file to compact
+  DayFileCompactor compactor;
+  unsigned long lastCompactionScan;
+  uint32_t compactedFiles;
+  uint64_t compactedSaved;
+  
+  void addUsedBytes(int64_t delta) {
+    usedBytes = delta < 0 && (uint64_t)-delta > usedBytes ? 0 : usedBytes + delta;
+  }
+  
+  // Write one record to the day file without committing it.
+  // timestamp selects the day file (0 = now).
+  bool appendRecord(const char* data, size_t len, time_t timestamp) {
+    // Lazy init SD card on first write
+    if (!sdInitialized && !initSDCard()) {
+      Serial.println("SD card not initialized and init failed!");
+      return false;
+    }
+    
+    time_t now = timestamp;
+    if (now == 0) {
+      time(&now);
+    }
+    if (!openDayFile(now)) {
+      return false;
+    }
+    
+    // Sparse time index for CSV files (binary records are found by binary search)
+    if (logFormat == LOG_CSV && currentFileRows % TimeIndex::INTERVAL == 0) {
+      if (pendingIndexCount == MAX_PENDING_INDEX) {
+        writePendingIndex();
+      }
+      pendingIndex[pendingIndexCount++] = {(uint32_t)now, currentFileBytes, currentFileRows};
+    }
+    
+    if (logFormat == LOG_BINARY && len != binRecordSize) {
+      // Doesn't match the file schema - writing it would corrupt the file
+      Serial.printf("Dropping binary record of %u bytes (expected %u)\n", len, binRecordSize);
+      safeRecords++;
+      return true;
+    }
+    
+    size_t recordLen = logFormat == LOG_BINARY ? len : len + 2;
+    if (preallocBytes > 0 && currentFileBytes + recordLen > physicalSize && !extendPreallocation()) {
+      Serial.printf("Failed to write to file: %s\n", currentFilename);
+      rollBack();
+      return false;
+    }
+    
+    // Records are combined into block-aligned writes
+    size_t written = blockWriter.write((const uint8_t*)data, len);
+    if (logFormat == LOG_CSV && written == len) {
+      written += blockWriter.write((const uint8_t*)"\r\n", 2);
+    }
+    len = recordLen;
+    if (written < len) {
+      Serial.printf("Failed to write to file: %s\n", currentFilename);
+      rollBack();  // Reopen on next record
+      return false;
+    }
+    
+    if (pendingRecords == 0) {
+      firstPendingTime = millis();
+      pendingFirstTs = now;
+    }
+    pendingLastTs = now;
+    pendingRecords++;
+    pendingBytes += written;
+    currentFileRows++;
+    currentFileBytes += written;
+    totalDataPoints++;
+    if (currentFileBytes > physicalSize) {
+      addUsedBytes(currentFileBytes - physicalSize);
+      physicalSize = currentFileBytes;
+    }
+    
+    return true;
+  }
+  
+  template<typename Emit>
+  bool queryCsv(File& file, uint32_t end, const char* filename, uint32_t from, uint32_t to, uint32_t skip,
+                uint32_t limit, String& header, bool& more, char* buf, size_t bufSize, Emit emit) {
+    const char* line;
+    size_t len;
+    uint32_t dataStart;
+    {
+      LineReader headerReader(file, buf, bufSize, end);
+      if (!headerReader.next(line, len)) {
+        return false;  // Empty file
+      }
+      header = "";
+      header.concat(line, len);
+      dataStart = headerReader.tell();
+    }
+    
+    // Start at the last indexed row before the window
+    TimeIndexEntry start;
+    if (from > 0 && TimeIndex::seek(filename, from, end, start) && start.offset > dataStart) {
+      dataStart = start.offset;
+    }
+    file.seek(dataStart);
+    LineReader reader(file, buf, bufSize, end);
+    matchRows(reader, from, to, skip, limit, more, emit);
+    return true;
+  }
+  
+  // A compacted file has no index: inflate and scan from the first row
+  template<typename Emit>
+  bool queryCompressed(File& file, uint32_t from, uint32_t to, uint32_t skip, uint32_t limit,
+                       String& header, bool& more, char* buf, size_t bufSize, Emit emit) {
+    GzipReader inflater;
+    if (!inflater.begin(file)) {
+      return false;
+    }
+    LineReader reader(inflater, buf, bufSize);
+    const char* line;
+    size_t len;
+    if (!reader.next(line, len)) {
+      return false;
+    }
+    header = "";
+    header.concat(line, len);
+    matchRows(reader, from, to, skip, limit, more, emit);
+    return true;
+  }
+  
+  // Emit rows from reader inside [from, to] after skipping skip of them
+  template<typename Emit>
+  void matchRows(LineReader& reader, uint32_t from, uint32_t to, uint32_t skip, uint32_t limit,
+                 bool& more, Emit emit) {
+    const char* line;
+    size_t len;
+    
+    // Rows carry local time text, so compare against the bounds in the same form
+    char fromText[20] = "";
+    char toText[20] = "";
+    formatLocal(from, fromText, sizeof(fromText));
+    formatLocal(to, toText, sizeof(toText));
+    
+    uint32_t matched = 0;
+    uint32_t emitted = 0;
+    while (reader.next(line, len)) {
+      if (len == 0) continue;
+      
+      int cmpFrom = 0;
+      int cmpTo = 0;
+      if (len > 4 && strncmp(line, "UTC+", 4) == 0) {
+        // Clock wasn't set - seconds since boot
+        uint32_t ts = strtoul(line + 4, nullptr, 10);
+        cmpFrom = from > 0 && ts < from ? -1 : 0;
+        cmpTo = to > 0 && ts > to ? 1 : 0;
+      } else {
+        if (from > 0) cmpFrom = strncmp(line, fromText, 19);
+        if (to > 0) cmpTo = strncmp(line, toText, 19);
+      }
+      if (cmpFrom < 0) continue;
+      if (cmpTo > 0) break;  // Rows are in time order
+      
+      if (matched++ < skip) continue;
+      if (emitted == limit) {
+        more = true;
+        break;
+      }
+      emit(line, len);
+      emitted++;
+    }
+  }
+  
+  template<typename Emit>
+  bool queryBinary(File& file, uint32_t end, uint32_t from, uint32_t to, uint32_t skip, uint32_t limit,
+                   String& header, bool& more, char* buf, size_t bufSize, Emit emit) {
+    BinLogHeader hdr;
+    if (!BinLog::readHeader(file, hdr, &header)) {
+      return false;
+    }
+    
+    // Lower bound of the first record with timestamp >= from
+    uint32_t records = BinLog::recordCount(hdr, end);
+    uint32_t lo = 0;
+    uint32_t hi = records;
+    while (from > 0 && lo < hi) {
+      uint32_t mid = lo + (hi - lo) / 2;
+      uint32_t ts = 0;
+      file.seek(BinLog::dataOffset(hdr) + mid * hdr.recordSize);
+      file.read((uint8_t*)&ts, 4);
+      if (ts < from) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    
+    uint32_t first = lo + skip;
+    if (first >= records) {
+      return true;
+    }
+    file.seek(BinLog::dataOffset(hdr) + first * hdr.recordSize);
+    
+    uint8_t rec[BinLog::MAX_RECORD_SIZE];
+    uint32_t emitted = 0;
+    for (uint32_t i = first; i < records && file.read(rec, hdr.recordSize) == hdr.recordSize; i++) {
+      uint32_t ts;
+      memcpy(&ts, rec, 4);
+      if (to > 0 && ts > to) break;
+      if (emitted == limit) {
+        more = true;
+        break;
+      }
+      size_t len = BinLog::formatRow(rec, hdr, buf, bufSize);
+      emit(buf, len > 2 ? len - 2 : 0);  // Without CRLF
+      emitted++;
+    }
+    return true;
+  }
+  
+  // Oldest eligible CSV day file, in name (= date) order
+  void startCompaction(time_t olderThan, const char* keepFrom) {
+    if (!DayFileCompactor::available()) {
+      return;
+    }
+    ManifestEntry entries[8];
+    uint32_t offset = 0;
+    uint32_t n;
+    while ((n = manifest.page(entries, offset, 8, SORT_NAME, false)) > 0) {
+      for (uint32_t i = 0; i < n; i++) {
+        const ManifestEntry& e = entries[i];
+        if (keepFrom && strcmp(e.name, keepFrom) >= 0) {
+          return;
+        }
+        size_t len = strlen(e.name);
+        bool csv = len > 4 && strcmp(e.name + len - 4, ".csv") == 0;
+        if (!csv || e.lastTs == 0 || (time_t)e.lastTs >= olderThan || strcmp(e.name, currentFilename) == 0) {
+          continue;
+        }
+        // Late rows for a compacted day start a new plain file; it stays plain
+        char target[sizeof(e.name) + 4];
+        snprintf(target, sizeof(target), "%s.gz", e.name);
+        if (manifest.get(target)) {
           continue;
         }
+        if (compactor.start(e.name, e.rows, e.firstTs, e.lastTs)) {
+          Serial.printf("Compacting %s (%u bytes)\n", e.name, e.bytes);
+        }
+        return;
       }
-      file.close();
-      file = root.openNextFile();
+      offset += n;
+    }
+  }
+  
+  static void formatLocal(uint32_t ts, char* out, size_t outSize) {
+    if (ts == 0) return;
+    time_t t = ts;
+    struct tm timeinfo;
+    localtime_r(&t, &timeinfo);
+    strftime(out, outSize, "%Y-%m-%d %H:%M:%S", &timeinfo);
+  }
+  
+  // Move entries from the old key-per-record NVS buffer into the journal
+  void migrateLegacyBuffer() {
+    Preferences legacy;
+    if (!legacy.begin("databuffer", false)) {
+      return;
     }
     
-    root.close();
+    uint32_t count = legacy.getUInt("count", 0);
+    if (count > 0) {
+      uint32_t migrated = 0;
+      for (uint32_t i = 0; i < count; i++) {
+        char key[16];
+        snprintf(key, sizeof(key), "d%u", i);
+        String data = legacy.getString(key, "");
+        // Original sample time is unknown - these land in today's file
+        if (data.length() > 0 && journal.append(data.c_str(), data.length(), 0)) {
+          migrated++;
+        }
+      }
+      Serial.printf("Migrated %u/%u buffered entries from NVS to journal\n", migrated, count);
+    }
+    
+    legacy.clear();
+    legacy.end();
+  }
+  
+  bool commitDue() const {
+    // Unsigned subtraction handles millis() rollover
+    return pendingRecords >= commitMaxRecords ||
+           pendingBytes >= commitMaxBytes ||
+           (millis() - firstPendingTime) >= commitMaxLatencyMs;
+  }
+  
+  bool openDayFile(time_t now) {
+    // Fast path: same day as the open file, no name building or directory lookup
+    if (fileOpen && now >= currentDayStart && now < currentDayEnd) {
+      return true;
+    }
+    
+    // Day rolled over (or clock was changed) - commit and close the old file
+    closeDayFile();
+    ScopedTimer timer(METRIC_SD_OPEN);
+    
+    struct tm timeinfo;
+    localtime_r(&now, &timeinfo);
+    snprintf(currentFilename, sizeof(currentFilename), "/data_%04d%02d%02d.%s",
+             timeinfo.tm_year + 1900, timeinfo.tm_mon + 1, timeinfo.tm_mday,
+             logFormat == LOG_BINARY ? "bin" : "csv");
+    
+    if (logFormat == LOG_BINARY && !prepareBinaryFile()) {
+      return false;
+    }
+    
+    // Positioned writes ("r+") rather than append mode, so records can fill a
+    // preallocated extent. Files are trimmed on close, so size is the data end.
+    bool exists = SD.exists(currentFilename);
+    dataFile = SD.open(currentFilename, exists ? "r+" : FILE_WRITE);
+    if (!dataFile) {
+      Serial.printf("Failed to open file: %s\n", currentFilename);
+      return false;
+    }
+    
+    // Write header if new file
+    bool created = dataFile.size() == 0;
+    if (created) {
+      if (logFormat == LOG_BINARY) {
+        BinLog::writeHeader(dataFile, currentHeader, currentDecimals);
+      } else if (currentHeader.length() > 0) {
+        dataFile.println(currentHeader);
+      }
+      dataFile.flush();
+    }
+    
+    // Track size and rows locally; size() on an open file costs a stat call
+    currentFileBytes = dataFile.size();
+    physicalSize = currentFileBytes;
+    if (created) {
+      addUsedBytes(currentFileBytes);
+    }
+    const ManifestEntry* entry = manifest.get(currentFilename);
+    if (entry && entry->bytes < currentFileBytes) {
+      // Bytes past the last commit, left by a rollback whose trim failed
+      currentFileBytes = entry->bytes;
+    }
+    if (preallocBytes > 0) {
+      extendPreallocation();  // Leaves the writer at the data end
+    } else {
+      dataFile.seek(currentFileBytes);
+      blockWriter.attach(&dataFile, currentFileBytes);
+    }
+    currentFileRows = entry ? entry->rows : 0;
+    pendingIndexCount = 0;
+    
+    // Remember the day boundaries so later records only need a comparison
+    timeinfo.tm_hour = 0;
+    timeinfo.tm_min = 0;
+    timeinfo.tm_sec = 0;
+    timeinfo.tm_isdst = -1;
+    currentDayStart = mktime(&timeinfo);
+    timeinfo.tm_mday += 1;
+    currentDayEnd = mktime(&timeinfo);
+    
+    fileOpen = true;
+    Serial.printf("Opened data file: %s\n", currentFilename);
+    return true;
+  }
+  
+  // Binary records are only readable with a matching schema. If today's
+  // file was written with a different sensor setup, move it aside.
+  bool prepareBinaryFile() {
+    if (currentHeader.length() == 0) {
+      Serial.println("No schema yet - binary records stay buffered");
+      return false;
+    }
+    
+    File existing = SD.open(currentFilename, FILE_READ);
+    if (!existing) {
+      return true;  // New file
+    }
+    
+    BinLogHeader hdr;
+    String text;
+    bool matches = existing.size() == 0 ||
+                   (BinLog::readHeader(existing, hdr, &text) && text == currentHeader &&
+                    BinLog::sameDecimals(hdr, currentDecimals));
+    existing.close();
+    if (matches) {
+      return true;
+    }
+    
+    char renamed[40];
+    for (int n = 1; n < 100; n++) {
+      snprintf(renamed, sizeof(renamed), "%.*s-%d.bin",
+               (int)strlen(currentFilename) - 4, currentFilename, n);
+      if (!SD.exists(renamed)) {
+        Serial.printf("Schema changed, moving %s to %s\n", currentFilename, renamed);
+        if (!SD.rename(currentFilename, renamed)) {
+          return false;
+        }
+        manifest.rename(currentFilename, renamed);
+        if (renameCallback) {
+          renameCallback(currentFilename, renamed);
+        }
+        return true;
+      }
+    }
+    Serial.printf("Schema changed and no free name for %s\n", currentFilename);
+    return false;
+  }
+  
+  void writePendingIndex() {
+    if (pendingIndexCount > 0) {
+      TimeIndex::append(currentFilename, pendingIndex, pendingIndexCount);
+      pendingIndexCount = 0;
+    }
+  }
+  
+  void closeDayFile() {
+    if (!fileOpen) {
+      return;
+    }
+    ScopedTimer timer(METRIC_SD_CLOSE);
+    if (!commit()) {
+      return;  // Rolled back and closed
+    }
+    dataFile.close();
+    blockWriter.detach();
+    fileOpen = false;
+    
+    // Give the unused part of the preallocated extent back
+    if (physicalSize > currentFileBytes) {
+      trimDayFile();
+    }
+  }
+  
+  // A write failed: the uncommitted records may be partly on the card. Forget
+  // them, close the file and cut it back to the last commit; the caller keeps
+  // its copy (journal) or reports the failure.
+  void rollBack() {
+    healthy = false;
+    currentFileRows -= pendingRecords;
+    currentFileBytes -= pendingBytes;
+    totalDataPoints -= pendingRecords;
+    pendingRecords = 0;
+    pendingBytes = 0;
+    pendingIndexCount = 0;
+    blockWriter.detach();
+    dataFile.close();
+    fileOpen = false;
+    trimDayFile();
+  }
+  
+  void trimDayFile() {
+    String path = String("/sd") + currentFilename;
+    if (truncate(path.c_str(), currentFileBytes) != 0) {
+      Serial.printf("Failed to trim %s\n", currentFilename);
+    } else {
+      addUsedBytes(-(int64_t)(physicalSize - currentFileBytes));
+    }
+    physicalSize = currentFileBytes;
+  }
+  
+  // Grow the day file by one preallocation step with zeros, so later
+  // records overwrite allocated clusters instead of extending the FAT chain.
+  // False if the buffered block can't be written out.
+  bool extendPreallocation() {
+    static const uint8_t zeros[512] = {0};
+    
+    if (!blockWriter.flush()) {
+      return false;
+    }
+    dataFile.seek(physicalSize);
+    uint32_t target = std::max(physicalSize, currentFileBytes) + preallocBytes;
+    while (physicalSize < target) {
+      if (dataFile.write(zeros, sizeof(zeros)) != sizeof(zeros)) {
+        Serial.println("Preallocation stopped - card full?");
+        break;
+      }
+      physicalSize += sizeof(zeros);
+      addUsedBytes(sizeof(zeros));
+    }
+    dataFile.flush();
+    dataFile.seek(currentFileBytes);
+    blockWriter.attach(&dataFile, currentFileBytes);
+    return true;
+  }
+  
+  // Bytes of real data: the open day file may end in a preallocated extent
+  uint32_t readableSize(const char* filename, File& file) const {
+    if (fileOpen && strcmp(filename, currentFilename) == 0) {
+      return currentFileBytes;
+    }
+    return file.size();
   }
 };
 
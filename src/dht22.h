@@ -0,0 +1,218 @@
+/*
+ * DHT22 Reader for OmniLogger
+ * Captures the DHT22 pulse train with the RMT peripheral instead of bit-banging
+ *
+ * Copyright (C) 2024 NortonTech3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef DHT22_H
+#define DHT22_H
+
+#include <Arduino.h>
+#include <driver/gpio.h>
+#include <driver/rmt.h>
+#include <freertos/ringbuf.h>
+
+// One RMT receive channel timestamps every edge of a DHT22 transfer in
+// hardware; poll() decodes the captured frame once the line has gone idle.
+// Nothing runs with interrupts disabled and nothing busy-waits, so WiFi and
+// the web server keep running during the ~5ms transfer. Sensors on
+// different pins are read one after another: start() routes the channel
+// to the pin of the next transfer.
+class Dht22Reader {
+public:
+  enum Result : uint8_t {
+    DHT_PENDING,  // Transfer in progress, poll again
+    DHT_DONE,     // out holds temperature (°C) and humidity (%)
+    DHT_FAILED    // No answer, short frame or bad checksum
+  };
+  
+  static const unsigned long MIN_INTERVAL_MS = 2000;  // The sensor needs 2s between transfers
+  
+  Dht22Reader() : channel(RMT_CHANNEL_0), installed(false), ringbuf(nullptr), state(STATE_IDLE),
+                  pin(-1), startUs(0), releaseMs(0) {}
+  
+  ~Dht22Reader() {
+    end();
+  }
+  
+  bool begin(rmt_channel_t rxChannel, int firstPin) {
+    if (installed) {
+      return true;
+    }
+    channel = rxChannel;
+    
+    rmt_config_t config = {};
+    config.rmt_mode = RMT_MODE_RX;
+    config.channel = channel;
+    config.gpio_num = (gpio_num_t)firstPin;
+    config.clk_div = 80;        // 1us ticks from the 80MHz APB clock
+    config.mem_block_num = 1;   // 64 items; a frame is 43
+    config.rx_config.idle_threshold = IDLE_US;
+    config.rx_config.filter_en = true;
+    config.rx_config.filter_ticks_thresh = 100;  // Ignore glitches under 1.25us
+    if (rmt_config(&config) != ESP_OK || rmt_driver_install(channel, RINGBUF_SIZE, 0) != ESP_OK) {
+      Serial.println("DHT22: RMT receive channel unavailable");
+      return false;
+    }
+    rmt_get_ringbuf_handle(channel, &ringbuf);
+    installed = ringbuf != nullptr;
+    return installed;
+  }
+  
+  void end() {
+    if (installed) {
+      rmt_rx_stop(channel);
+      rmt_driver_uninstall(channel);
+      installed = false;
+      ringbuf = nullptr;
+    }
+    state = STATE_IDLE;
+  }
+  
+  // Idle between transfers: open drain, released and pulled up
+  static void preparePin(int dataPin) {
+    gpio_set_direction((gpio_num_t)dataPin, GPIO_MODE_INPUT_OUTPUT_OD);
+    gpio_pullup_en((gpio_num_t)dataPin);
+    gpio_set_level((gpio_num_t)dataPin, 1);
+  }
+  
+  bool busy() const {
+    return state != STATE_IDLE;
+  }
+  
+  // Begin a transfer with the host start pulse (line held low for 1.1ms)
+  bool start(int dataPin) {
+    if (!installed || busy()) {
+      return false;
+    }
+    pin = dataPin;
+    rmt_set_gpio(channel, RMT_MODE_RX, (gpio_num_t)pin, false);
+    gpio_set_direction((gpio_num_t)pin, GPIO_MODE_INPUT_OUTPUT_OD);  // rmt_set_gpio made it input only
+    gpio_set_level((gpio_num_t)pin, 0);
+    startUs = micros();
+    state = STATE_START_PULSE;
+    return true;
+  }
+  
+  Result poll(float* out) {
+    switch (state) {
+      case STATE_START_PULSE:
+        if (micros() - startUs < START_PULSE_US) {
+          return DHT_PENDING;
+        }
+        discardFrames();
+        rmt_rx_start(channel, true);
+        gpio_set_level((gpio_num_t)pin, 1);  // Release; the sensor answers within 40us
+        releaseMs = millis();
+        state = STATE_RECEIVING;
+        return DHT_PENDING;
+      
+      case STATE_RECEIVING: {
+        size_t size = 0;
+        rmt_item32_t* items = (rmt_item32_t*)xRingbufferReceive(ringbuf, &size, 0);
+        if (!items) {
+          if (millis() - releaseMs <= FRAME_TIMEOUT_MS) {
+            return DHT_PENDING;
+          }
+          rmt_rx_stop(channel);
+          state = STATE_IDLE;
+          return DHT_FAILED;
+        }
+        bool ok = decode(items, size / sizeof(rmt_item32_t), out);
+        vRingbufferReturnItem(ringbuf, items);
+        rmt_rx_stop(channel);
+        state = STATE_IDLE;
+        return ok ? DHT_DONE : DHT_FAILED;
+      }
+      
+      default:
+        return DHT_FAILED;
+    }
+  }
+
+private:
+  enum State : uint8_t {
+    STATE_IDLE,
+    STATE_START_PULSE,  // Line held low by the host
+    STATE_RECEIVING     // Released, RMT capturing the answer
+  };
+  
+  static const uint16_t IDLE_US = 150;             // Longest pulse in a frame is 80us
+  static const size_t RINGBUF_SIZE = 512;
+  static const unsigned long START_PULSE_US = 1100;
+  static const unsigned long FRAME_TIMEOUT_MS = 20;  // A frame takes under 6ms
+  static const uint16_t RESPONSE_MIN_US = 60;      // Sensor response: 80us low, 80us high
+  static const uint16_t BIT_ONE_MIN_US = 48;       // High time: 26-28us for 0, 70us for 1
+  
+  rmt_channel_t channel;
+  bool installed;
+  RingbufHandle_t ringbuf;
+  State state;
+  int pin;
+  unsigned long startUs;
+  unsigned long releaseMs;
+  
+  // Frames left over from an earlier transfer
+  void discardFrames() {
+    size_t size;
+    void* item;
+    while ((item = xRingbufferReceive(ringbuf, &size, 0)) != nullptr) {
+      vRingbufferReturnItem(ringbuf, item);
+    }
+  }
+  
+  // Skip to the 80us low / 80us high response, then read the high time
+  // of 40 bits: humidity, temperature (sign bit + magnitude, x10) and checksum
+  static bool decode(const rmt_item32_t* items, size_t count, float* out) {
+    uint8_t data[5] = {0};
+    int bits = 0;
+    bool synced = false;
+    bool longLow = false;
+    
+    for (size_t i = 0; i < count && bits < 40; i++) {
+      for (int half = 0; half < 2 && bits < 40; half++) {
+        uint32_t level = half ? items[i].level1 : items[i].level0;
+        uint32_t duration = half ? items[i].duration1 : items[i].duration0;
+        if (duration == 0) {
+          break;  // End of frame
+        }
+        if (!synced) {
+          if (level == 0) {
+            longLow = duration >= RESPONSE_MIN_US;
+          } else {
+            synced = longLow && duration >= RESPONSE_MIN_US;
+          }
+          continue;
+        }
+        if (level == 1) {
+          data[bits / 8] = (data[bits / 8] << 1) | (duration >= BIT_ONE_MIN_US ? 1 : 0);
+          bits++;
+        }
+      }
+    }
+    
+    if (bits < 40 || ((data[0] + data[1] + data[2] + data[3]) & 0xFF) != data[4]) {
+      return false;
+    }
+    float temp = (((data[2] & 0x7F) << 8) | data[3]) * 0.1f;
+    out[0] = (data[2] & 0x80) ? -temp : temp;
+    out[1] = ((data[0] << 8) | data[1]) * 0.1f;
+    return true;
+  }
+};
+
+#endif // DHT22_H
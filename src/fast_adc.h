@@ -0,0 +1,264 @@
+/*
+ * Fast ADC Sampler for OmniLogger
+ * Background DMA sampling of analog channels with per-interval statistics
+ *
+ * Copyright (C) 2024 NortonTech3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef FAST_ADC_H
+#define FAST_ADC_H
+
+#include <Arduino.h>
+#include <driver/adc.h>
+#include <esp_adc_cal.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#include <cmath>
+
+// Statistics of one channel over a measurement interval, in volts
+struct FastAdcStats {
+  uint32_t samples;
+  float mean;
+  float min;
+  float max;
+  float rms;
+};
+
+// Runs the ADC1 digital controller in continuous (DMA) mode. A small task
+// wakes once per DMA frame and folds the raw samples into running sums, so
+// the CPU is free between frames; takeStats() reduces them to mean/min/max/RMS
+// and starts the next interval. Only ADC1 (GPIO1-10) is used - ADC2 is
+// shared with WiFi.
+class FastAdcSampler {
+public:
+  static const int MAX_CHANNELS = 10;            // ADC1 channels on the ESP32-S2
+  static const uint32_t MIN_RATE_HZ = 611;       // Digital controller limits
+  static const uint32_t MAX_RATE_HZ = 83333;
+  static const UBaseType_t TASK_PRIORITY = 4;    // Above acquisition; runs briefly per frame
+  
+  FastAdcSampler() : channelMask(0), running(false), started(false), task(nullptr),
+                     ownerLock(nullptr), pauses(0) {
+    memset(slotOf, 0xFF, sizeof(slotOf));
+  }
+  
+  static bool isValidPin(int gpio) {
+    return gpio >= 1 && gpio <= MAX_CHANNELS;  // GPIOn is ADC1 channel n-1
+  }
+  
+  // Register a pin before begin()
+  bool addChannel(int gpio) {
+    if (started || !isValidPin(gpio)) {
+      return false;
+    }
+    channelMask |= 1UL << (gpio - 1);
+    return true;
+  }
+  
+  bool begin(uint32_t rateHz) {
+    if (started || channelMask == 0) {
+      return started;
+    }
+    rateHz = std::max(MIN_RATE_HZ, std::min(rateHz, MAX_RATE_HZ));
+    
+    // Same calibration as the battery reading; the calibrated voltage is
+    // linear in the raw value, so sums of raw values convert exactly
+    esp_adc_cal_characterize(ADC_UNIT_1, ADC_ATTEN_DB_12, ADC_WIDTH_BIT_13, 1100, &calibration);
+    
+    adc_digi_init_config_t initConfig = {};
+    initConfig.max_store_buf_size = DRIVER_BUFFER_BYTES;
+    initConfig.conv_num_each_intr = FRAME_BYTES;
+    initConfig.adc1_chan_mask = channelMask;
+    initConfig.adc2_chan_mask = 0;
+    if (adc_digi_initialize(&initConfig) != ESP_OK) {
+      Serial.println("Fast ADC: driver init failed");
+      return false;
+    }
+    
+    adc_digi_pattern_config_t pattern[MAX_CHANNELS] = {};
+    int count = 0;
+    for (int ch = 0; ch < MAX_CHANNELS; ch++) {
+      if (!(channelMask & (1UL << ch))) continue;
+      pattern[count].atten = ADC_ATTEN_DB_12;
+      pattern[count].channel = ch;
+      pattern[count].unit = 0;  // ADC1
+      pattern[count].bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+      slotOf[ch] = count++;
+    }
+    
+    adc_digi_configuration_t config = {};
+    config.conv_limit_en = false;
+    config.conv_limit_num = 250;
+    config.pattern_num = count;
+    config.adc_pattern = pattern;
+    config.sample_freq_hz = rateHz;  // Conversions per second, shared by all channels
+    config.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+    config.format = ADC_DIGI_OUTPUT_FORMAT_TYPE2;
+    if (adc_digi_controller_configure(&config) != ESP_OK) {
+      Serial.println("Fast ADC: controller config failed");
+      adc_digi_deinitialize();
+      return false;
+    }
+    
+    ownerLock = xSemaphoreCreateMutex();
+    if (!ownerLock) {
+      Serial.println("Fast ADC: no memory for the lock");
+      adc_digi_deinitialize();
+      return false;
+    }
+    resetAccumulators();
+    started = true;
+    if (xTaskCreate(taskEntry, "fast_adc", 3072, this, TASK_PRIORITY, &task) != pdPASS) {
+      Serial.println("Fast ADC: failed to start task");
+      adc_digi_deinitialize();
+      started = false;
+      return false;
+    }
+    adc_digi_start();
+    running = true;
+    Serial.printf("Fast ADC: %d channel(s) at %lu Hz total\n", count, (unsigned long)rateHz);
+    return true;
+  }
+  
+  // Stop conversions so one-shot reads (analogRead, battery) can use ADC1;
+  // every pause() is matched by a resume(). One-shot readers in different
+  // tasks (acquisition, storage) overlap: the first pause stops the DMA and
+  // the last resume restarts it, so it never runs under another reader.
+  void pause() {
+    if (!started) {
+      return;
+    }
+    xSemaphoreTake(ownerLock, portMAX_DELAY);
+    if (pauses++ == 0) {
+      adc_digi_stop();
+      running = false;
+    }
+    xSemaphoreGive(ownerLock);
+  }
+  
+  void resume() {
+    if (!started) {
+      return;
+    }
+    xSemaphoreTake(ownerLock, portMAX_DELAY);
+    if (pauses > 0 && --pauses == 0) {
+      adc_digi_start();
+      running = true;
+    }
+    xSemaphoreGive(ownerLock);
+  }
+  
+  // Statistics since the last call for a pin, then start a new interval.
+  // False if the pin isn't sampled or no samples arrived.
+  bool takeStats(int gpio, FastAdcStats& out) {
+    if (!isValidPin(gpio) || slotOf[gpio - 1] == 0xFF) {
+      return false;
+    }
+    
+    portENTER_CRITICAL(&lock);
+    Accumulator acc = accumulators[slotOf[gpio - 1]];
+    accumulators[slotOf[gpio - 1]] = Accumulator();
+    portEXIT_CRITICAL(&lock);
+    
+    out.samples = acc.count;
+    if (acc.count == 0) {
+      return false;
+    }
+    
+    // volts = a * raw + b, taken from two points of the calibration
+    float b = esp_adc_cal_raw_to_voltage(0, &calibration) / 1000.0f;
+    float a = (esp_adc_cal_raw_to_voltage(RAW_FULL_SCALE, &calibration) / 1000.0f - b) / RAW_FULL_SCALE;
+    double meanRaw = (double)acc.sum / acc.count;
+    double meanSquareRaw = (double)acc.sumSquares / acc.count;
+    
+    out.mean = a * meanRaw + b;
+    out.min = a * acc.min + b;
+    out.max = a * acc.max + b;
+    double meanSquare = a * a * meanSquareRaw + 2.0 * a * b * meanRaw + b * b;
+    out.rms = sqrt(std::max(0.0, meanSquare));
+    return true;
+  }
+
+private:
+  // TYPE2 output carries 11-bit data; it's scaled to the 13-bit range the
+  // calibration was made for
+  static const int RAW_SHIFT = 13 - 11;
+  static const uint32_t RAW_FULL_SCALE = 8191;
+  static const uint32_t FRAME_BYTES = 256;           // 128 conversions per wakeup
+  static const uint32_t DRIVER_BUFFER_BYTES = 4096;  // ~24ms at the maximum rate
+  
+  struct Accumulator {
+    uint32_t count = 0;
+    uint64_t sum = 0;
+    uint64_t sumSquares = 0;
+    uint16_t min = UINT16_MAX;
+    uint16_t max = 0;
+  };
+  
+  uint32_t channelMask;
+  uint8_t slotOf[MAX_CHANNELS];  // ADC channel -> accumulator index (0xFF = unused)
+  Accumulator accumulators[MAX_CHANNELS];
+  esp_adc_cal_characteristics_t calibration;
+  volatile bool running;
+  bool started;
+  TaskHandle_t task;
+  SemaphoreHandle_t ownerLock;  // Guards pauses and the start/stop calls
+  uint32_t pauses;              // One-shot readers holding ADC1
+  portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+  
+  void resetAccumulators() {
+    for (int i = 0; i < MAX_CHANNELS; i++) {
+      accumulators[i] = Accumulator();
+    }
+  }
+  
+  static void taskEntry(void* param) {
+    static_cast<FastAdcSampler*>(param)->run();
+  }
+  
+  void run() {
+    uint8_t frame[FRAME_BYTES];
+    while (true) {
+      // Blocks until the DMA delivers a frame; times out while paused
+      uint32_t length = 0;
+      esp_err_t err = adc_digi_read_bytes(frame, sizeof(frame), &length, 100);
+      if (err == ESP_OK || err == ESP_ERR_INVALID_STATE) {  // INVALID_STATE: driver buffer overflowed, data is still valid
+        accumulate(frame, length);
+      }
+    }
+  }
+  
+  void accumulate(const uint8_t* frame, uint32_t length) {
+    portENTER_CRITICAL(&lock);
+    for (uint32_t i = 0; i + 1 < length; i += 2) {
+      adc_digi_output_data_t out;
+      memcpy(&out, frame + i, sizeof(out));
+      if (out.type2.unit != 0 || out.type2.channel >= MAX_CHANNELS || slotOf[out.type2.channel] == 0xFF) {
+        continue;
+      }
+      uint16_t raw = out.type2.data << RAW_SHIFT;
+      Accumulator& acc = accumulators[slotOf[out.type2.channel]];
+      acc.count++;
+      acc.sum += raw;
+      acc.sumSquares += (uint32_t)raw * raw;
+      if (raw < acc.min) acc.min = raw;
+      if (raw > acc.max) acc.max = raw;
+    }
+    portEXIT_CRITICAL(&lock);
+  }
+};
+
+#endif // FAST_ADC_H
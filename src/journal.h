@@ -0,0 +1,349 @@
+/*
+ * Record Journal for OmniLogger
+ * Append-only ring of buffered records in a flash partition or PSRAM
+ *
+ * Copyright (C) 2024 NortonTech3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include <esp_partition.h>
+#include <esp_rom_crc.h>
+#include "config.h"
+
+// Record layout (both backends):
+//   [JournalRecordHeader][payload][pad to 4 bytes]
+// The payload is written before the header, so a record interrupted by
+// power loss leaves an erased header and is treated as the end of the log.
+struct JournalRecordHeader {
+  uint16_t magic;
+  uint16_t length;     // Payload bytes
+  uint32_t timestamp;  // Sample time (0 = unknown)
+  uint32_t crc;        // CRC32 of the payload
+};
+
+class RecordJournal {
+public:
+  static const uint32_t SECTOR_SIZE = 4096;            // Flash erase unit
+  static const uint32_t MAX_RECORD_SIZE = 1024;        // Largest payload accepted
+  static const uint32_t PSRAM_SIZE = 1024 * 1024;      // PSRAM ring size
+  static const uint32_t FALLBACK_SIZE = 16 * 1024;     // Internal RAM ring if nothing else works
+  static const uint32_t TYPICAL_RECORD_SIZE = 64;      // For capacity estimates before data exists
+  
+  RecordJournal() : backend(BUFFER_FLASH), partition(nullptr), ram(nullptr), size(0),
+                    head(0), tail(0), records(0) {}
+  
+  ~RecordJournal() {
+    if (ram) {
+      free(ram);
+    }
+  }
+  
+  bool begin(BufferBackend requested) {
+    backend = requested;
+    
+    if (backend == BUFFER_FLASH) {
+      partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, "journal");
+      if (partition) {
+        size = partition->size - (partition->size % SECTOR_SIZE);
+        cursorPrefs.begin("journal", false);
+        recover();
+        Serial.printf("Journal: flash partition (%u KB), restored %u records\n",
+                      size / 1024, records);
+        return true;
+      }
+      Serial.println("Journal: no 'journal' partition found, falling back to PSRAM");
+      backend = BUFFER_PSRAM;
+    }
+    
+    // RAM backends don't survive a reset, so there is nothing to recover
+    size = PSRAM_SIZE;
+    ram = psramFound() ? (uint8_t*)ps_malloc(size) : nullptr;
+    if (!ram) {
+      size = FALLBACK_SIZE;
+      ram = (uint8_t*)malloc(size);
+    }
+    if (!ram) {
+      size = 0;
+      Serial.println("Journal: failed to allocate buffer memory!");
+      return false;
+    }
+    head = tail = 0;
+    records = 0;
+    eraseSector(0);
+    Serial.printf("Journal: RAM ring (%u KB)\n", size / 1024);
+    return true;
+  }
+  
+  bool append(const char* data, size_t len, uint32_t timestamp) {
+    if (size == 0 || len == 0 || len > MAX_RECORD_SIZE) {
+      return false;
+    }
+    
+    uint32_t need = recordSize(len);
+    uint32_t pos = head;
+    
+    // Records never straddle the end of the ring
+    if (pos + need > size) {
+      if (pos + sizeof(JournalRecordHeader) <= size) {
+        if (!reserve(pos, sizeof(JournalRecordHeader))) {
+          return false;
+        }
+        JournalRecordHeader wrap = {WRAP_MAGIC, 0, 0, 0};
+        writeRaw(pos, &wrap, sizeof(wrap));
+      }
+      pos = 0;
+    }
+    
+    if (!reserve(pos, need)) {
+      return false;  // Journal full
+    }
+    
+    JournalRecordHeader hdr;
+    hdr.magic = RECORD_MAGIC;
+    hdr.length = len;
+    hdr.timestamp = timestamp;
+    hdr.crc = esp_rom_crc32_le(0, (const uint8_t*)data, len);
+    
+    // Payload first, header last (see record layout above)
+    if (!writeRaw(pos + sizeof(hdr), data, len) || !writeRaw(pos, &hdr, sizeof(hdr))) {
+      return false;
+    }
+    
+    head = pos + need;
+    if (head >= size) {
+      head = 0;
+    }
+    records++;
+    return true;
+  }
+  
+  // Read the record at offset into buf and advance offset past it.
+  // Start iteration at getTail(); read at most count() records.
+  bool read(uint32_t& offset, JournalRecordHeader& hdr, uint8_t* buf, size_t bufSize) {
+    if (!readHeader(offset, hdr)) {
+      return false;
+    }
+    if (hdr.length > bufSize || !readRaw(offset + sizeof(hdr), buf, hdr.length)) {
+      return false;
+    }
+    if (esp_rom_crc32_le(0, buf, hdr.length) != hdr.crc) {
+      return false;
+    }
+    offset += recordSize(hdr.length);
+    if (offset >= size) {
+      offset = 0;
+    }
+    return true;
+  }
+  
+  // Drop records up to newTail after they reached the SD card
+  void consume(uint32_t newTail, uint32_t count) {
+    tail = newTail;
+    records = count < records ? records - count : 0;
+    if (records == 0) {
+      tail = head;
+    }
+    if (backend == BUFFER_FLASH) {
+      cursorPrefs.putUInt("tail", tail);
+    }
+  }
+  
+  uint32_t count() const {
+    return records;
+  }
+  
+  uint32_t getTail() const {
+    return tail;
+  }
+  
+  uint32_t usedBytes() const {
+    return head >= tail ? head - tail : size - tail + head;
+  }
+  
+  // One sector is always kept free so the head never erases the tail
+  uint32_t capacityBytes() const {
+    return size > SECTOR_SIZE ? size - SECTOR_SIZE : 0;
+  }
+  
+  uint32_t capacityRecords() const {
+    uint32_t avg = records > 0 ? usedBytes() / records : TYPICAL_RECORD_SIZE;
+    return capacityBytes() / std::max(avg, (uint32_t)sizeof(JournalRecordHeader));
+  }
+  
+  BufferBackend getBackend() const {
+    return backend;
+  }
+  
+  bool isPersistent() const {
+    return backend == BUFFER_FLASH;
+  }
+
+private:
+  static const uint16_t RECORD_MAGIC = 0x4A52;  // "JR"
+  static const uint16_t WRAP_MAGIC = 0x5752;    // "WR" - continue at offset 0
+  static const uint16_t SKIP_MAGIC = 0x0000;    // Torn write - continue at next sector
+  
+  BufferBackend backend;
+  const esp_partition_t* partition;
+  uint8_t* ram;
+  uint32_t size;
+  uint32_t head;     // Next write offset
+  uint32_t tail;     // Oldest unflushed record
+  uint32_t records;
+  Preferences cursorPrefs;  // Persisted tail cursor (flash backend only)
+  
+  static uint32_t recordSize(size_t len) {
+    return (sizeof(JournalRecordHeader) + len + 3) & ~3U;
+  }
+  
+  bool readHeader(uint32_t& offset, JournalRecordHeader& hdr) {
+    // Follow at most a wrap and a skip marker before the next record
+    for (int hops = 0; hops < 3; hops++) {
+      if (offset + sizeof(hdr) > size) {
+        offset = 0;  // No room for a wrap marker - writer continued at 0
+      }
+      if (!readRaw(offset, &hdr, sizeof(hdr))) {
+        return false;
+      }
+      if (hdr.magic == WRAP_MAGIC) {
+        offset = 0;
+      } else if (hdr.magic == SKIP_MAGIC) {
+        offset = nextSector(offset);
+      } else {
+        break;
+      }
+    }
+    return hdr.magic == RECORD_MAGIC && hdr.length <= MAX_RECORD_SIZE &&
+           offset + recordSize(hdr.length) <= size;
+  }
+  
+  uint32_t nextSector(uint32_t offset) const {
+    uint32_t next = (offset / SECTOR_SIZE + 1) * SECTOR_SIZE;
+    return next >= size ? 0 : next;
+  }
+  
+  bool isErased(uint32_t offset, uint32_t len) {
+    uint8_t buf[64];
+    while (len > 0) {
+      uint32_t chunk = std::min(len, (uint32_t)sizeof(buf));
+      if (!readRaw(offset, buf, chunk)) return false;
+      for (uint32_t i = 0; i < chunk; i++) {
+        if (buf[i] != 0xFF) return false;
+      }
+      offset += chunk;
+      len -= chunk;
+    }
+    return true;
+  }
+  
+  // Erase sectors newly entered by [start, start + len); fails if that would hit the tail
+  bool reserve(uint32_t start, uint32_t len) {
+    uint32_t first = (start % SECTOR_SIZE == 0) ? start / SECTOR_SIZE : start / SECTOR_SIZE + 1;
+    uint32_t last = (start + len - 1) / SECTOR_SIZE;
+    for (uint32_t sector = first; sector <= last; sector++) {
+      if (records > 0 && tail / SECTOR_SIZE == sector) {
+        return false;
+      }
+      if (!eraseSector(sector)) {
+        return false;
+      }
+      if (records == 0) {
+        tail = start;  // Keep an empty journal's tail beside the head
+      }
+    }
+    return true;
+  }
+  
+  // Walk the log from the persisted tail to find the head after a reset
+  void recover() {
+    tail = cursorPrefs.getUInt("tail", 0);
+    if (tail >= size || tail % 4 != 0) {
+      tail = 0;
+    }
+    
+    uint32_t offset = tail;
+    uint32_t scanned = 0;
+    records = 0;
+    uint8_t buf[MAX_RECORD_SIZE];
+    JournalRecordHeader hdr;
+    
+    while (scanned < size) {
+      uint32_t start = offset;
+      if (!read(offset, hdr, buf, sizeof(buf))) {
+        offset = start;
+        break;
+      }
+      records++;
+      scanned += recordSize(hdr.length);
+    }
+    head = offset;
+    
+    // A write torn by power loss leaves programmed bytes at the head that can't
+    // be rewritten. Zeroing the magic (always possible on NOR flash) turns it
+    // into a skip marker and appending continues in the next sector.
+    uint32_t window = std::min(SECTOR_SIZE - head % SECTOR_SIZE,
+                               (uint32_t)sizeof(JournalRecordHeader) + MAX_RECORD_SIZE);
+    if (head + window <= size && !isErased(head, window)) {
+      uint16_t skip = SKIP_MAGIC;
+      writeRaw(head, &skip, sizeof(skip));
+      head = nextSector(head);
+      Serial.println("Journal: skipped torn record after power loss");
+    }
+    
+    if (records == 0) {
+      // Fresh or fully consumed journal - start clean at the head's sector
+      tail = head - (head % SECTOR_SIZE);
+      head = tail;
+      eraseSector(head / SECTOR_SIZE);
+      cursorPrefs.putUInt("tail", tail);
+    }
+  }
+  
+  bool readRaw(uint32_t offset, void* dst, size_t len) {
+    if (offset + len > size) return false;
+    if (backend == BUFFER_FLASH) {
+      return esp_partition_read(partition, offset, dst, len) == ESP_OK;
+    }
+    memcpy(dst, ram + offset, len);
+    return true;
+  }
+  
+  bool writeRaw(uint32_t offset, const void* src, size_t len) {
+    if (offset + len > size) return false;
+    if (backend == BUFFER_FLASH) {
+      return esp_partition_write(partition, offset, src, len) == ESP_OK;
+    }
+    memcpy(ram + offset, src, len);
+    return true;
+  }
+  
+  bool eraseSector(uint32_t sector) {
+    uint32_t offset = sector * SECTOR_SIZE;
+    if (offset >= size) return false;
+    uint32_t len = std::min(SECTOR_SIZE, size - offset);
+    if (backend == BUFFER_FLASH) {
+      return esp_partition_erase_range(partition, offset, len) == ESP_OK;
+    }
+    memset(ram + offset, 0xFF, len);
+    return true;
+  }
+};
+
+#endif // JOURNAL_H
@@ -0,0 +1,333 @@
+/*
+ * Streaming JSON for OmniLogger
+ * Writes JSON responses incrementally through a small fixed buffer
+ *
+ * Copyright (C) 2024 NortonTech3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef JSON_STREAM_H
+#define JSON_STREAM_H
+
+#include <Arduino.h>
+#include <WebServer.h>
+#include <cmath>
+
+// HTTP response with chunked transfer encoding. Content is collected in a
+// fixed buffer and sent one chunk at a time, so memory use doesn't depend
+// on the response size.
+class ChunkedResponse : public Print {
+public:
+  static const size_t BUFFER_SIZE = 1024;
+  
+  ChunkedResponse(WebServer& server, int code, const char* contentType)
+      : server(server), used(0), ended(false) {
+    server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    server.send(code, contentType, "");
+  }
+  
+  ~ChunkedResponse() {
+    end();
+  }
+  
+  size_t write(uint8_t c) override {
+    if (used == BUFFER_SIZE) {
+      sendBuffer();
+    }
+    buf[used++] = c;
+    return 1;
+  }
+  
+  size_t write(const uint8_t* data, size_t len) override {
+    size_t remaining = len;
+    while (remaining > 0) {
+      if (used == BUFFER_SIZE) {
+        sendBuffer();
+      }
+      size_t chunk = std::min(remaining, BUFFER_SIZE - used);
+      memcpy(buf + used, data, chunk);
+      used += chunk;
+      data += chunk;
+      remaining -= chunk;
+    }
+    return len;
+  }
+  
+  // Send what's buffered and the terminating empty chunk
+  void end() {
+    if (ended) {
+      return;
+    }
+    sendBuffer();
+    server.sendContent("");
+    ended = true;
+  }
+
+private:
+  WebServer& server;
+  char buf[BUFFER_SIZE];
+  size_t used;
+  bool ended;
+  
+  void sendBuffer() {
+    if (used > 0) {
+      server.sendContent(buf, used);
+      used = 0;
+    }
+  }
+};
+
+// Minimal JSON writer: tracks commas per nesting level, escapes strings,
+// writes straight to any Print (usually a ChunkedResponse)
+class JsonStreamWriter {
+public:
+  static const int MAX_DEPTH = 16;
+  
+  explicit JsonStreamWriter(Print& out) : out(out), depth(0), afterKey(false) {
+    first[0] = true;
+  }
+  
+  void beginObject(const char* name = nullptr) {
+    open(name, '{');
+  }
+  
+  void endObject() {
+    close('}');
+  }
+  
+  void beginArray(const char* name = nullptr) {
+    open(name, '[');
+  }
+  
+  void endArray() {
+    close(']');
+  }
+  
+  void key(const char* name) {
+    key(name, strlen(name));
+  }
+  
+  void key(const char* name, size_t len) {
+    separator();
+    writeString(name, len);
+    out.write(':');
+    afterKey = true;
+  }
+  
+  void value(const char* text) {
+    value(text, strlen(text));
+  }
+  
+  void value(const char* text, size_t len) {
+    separator();
+    writeString(text, len);
+  }
+  
+  void value(const String& text) {
+    value(text.c_str(), text.length());
+  }
+  
+  void value(bool b) {
+    separator();
+    out.print(b ? "true" : "false");
+  }
+  
+  // One overload per fundamental type, so intN_t maps to exactly one on any toolchain
+  void value(int n) {
+    value((long)n);
+  }
+  
+  void value(unsigned int n) {
+    value((unsigned long)n);
+  }
+  
+  void value(long n) {
+    char buf[24];
+    raw(buf, snprintf(buf, sizeof(buf), "%ld", n));
+  }
+  
+  void value(unsigned long n) {
+    char buf[24];
+    raw(buf, snprintf(buf, sizeof(buf), "%lu", n));
+  }
+  
+  void value(long long n) {
+    char buf[24];
+    raw(buf, snprintf(buf, sizeof(buf), "%lld", n));
+  }
+  
+  void value(unsigned long long n) {
+    char buf[24];
+    raw(buf, snprintf(buf, sizeof(buf), "%llu", n));
+  }
+  
+  void value(float f) {
+    value((double)f);
+  }
+  
+  void value(double d, int decimals = 2) {
+    if (isnan(d) || isinf(d)) {
+      raw("null", 4);
+      return;
+    }
+    char buf[32];
+    raw(buf, snprintf(buf, sizeof(buf), "%.*f", decimals, d));
+  }
+  
+  // Pre-formatted JSON (number, literal or nested document)
+  void raw(const char* json, size_t len) {
+    separator();
+    out.write((const uint8_t*)json, len);
+  }
+  
+  // key + value in one call
+  template<typename T>
+  void field(const char* name, T v) {
+    key(name);
+    value(v);
+  }
+  
+  void field(const char* name, double v, int decimals) {
+    key(name);
+    value(v, decimals);
+  }
+
+private:
+  Print& out;
+  int depth;
+  bool first[MAX_DEPTH];
+  bool afterKey;
+  
+  void separator() {
+    if (afterKey) {
+      afterKey = false;  // Value directly follows its key
+      return;
+    }
+    if (!first[depth]) {
+      out.write(',');
+    }
+    first[depth] = false;
+  }
+  
+  void open(const char* name, char bracket) {
+    if (name) {
+      key(name);
+    }
+    separator();
+    out.write(bracket);
+    if (depth < MAX_DEPTH - 1) {
+      depth++;
+    }
+    first[depth] = true;
+  }
+  
+  void close(char bracket) {
+    out.write(bracket);
+    afterKey = false;
+    if (depth > 0) {
+      depth--;
+    }
+  }
+  
+  void writeString(const char* s, size_t len) {
+    static const char hex[] = "0123456789abcdef";
+    out.write('"');
+    size_t start = 0;
+    for (size_t i = 0; i < len; i++) {
+      uint8_t c = s[i];
+      if (c != '"' && c != '\\' && c >= 0x20) {
+        continue;
+      }
+      // Write the clean run, then the escape
+      out.write((const uint8_t*)s + start, i - start);
+      start = i + 1;
+      switch (c) {
+        case '"':  out.print("\\\""); break;
+        case '\\': out.print("\\\\"); break;
+        case '\n': out.print("\\n"); break;
+        case '\r': out.print("\\r"); break;
+        case '\t': out.print("\\t"); break;
+        default: {
+          char esc[7] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF], 0};
+          out.print(esc);
+          break;
+        }
+      }
+    }
+    out.write((const uint8_t*)s + start, len - start);
+    out.write('"');
+  }
+};
+
+// CSV rows as JSON objects keyed by column name. The header is split on
+// the first row and the names are reused for every row after it, so the
+// header may still be empty when this is constructed (queryData fills it).
+class CsvRowObjects {
+public:
+  static const int MAX_COLUMNS = 65;  // Timestamp + BinLog::MAX_CHANNELS
+  
+  CsvRowObjects(JsonStreamWriter& json, const String& header) : json(json), header(header), columnCount(0) {}
+  
+  // One row (no line ending); values are trimmed, unnamed columns skipped
+  void write(const char* line, size_t len) {
+    if (columnCount == 0) {
+      columnCount = splitColumns(header, columns, MAX_COLUMNS);
+    }
+    
+    json.beginObject();
+    size_t start = 0;
+    for (int col = 0; col < columnCount && start <= len; col++) {
+      const char* comma = (const char*)memchr(line + start, ',', len - start);
+      size_t end = comma ? comma - line : len;
+      
+      // Trim spaces around the value
+      size_t valueStart = start;
+      size_t valueEnd = end;
+      while (valueStart < valueEnd && line[valueStart] == ' ') valueStart++;
+      while (valueEnd > valueStart && line[valueEnd - 1] == ' ') valueEnd--;
+      
+      if (columns[col].length() > 0) {
+        json.key(columns[col].c_str(), columns[col].length());
+        json.value(line + valueStart, valueEnd - valueStart);
+      }
+      
+      if (!comma) break;
+      start = end + 1;
+    }
+    json.endObject();
+  }
+  
+  static int splitColumns(const String& header, String* columns, int maxColumns) {
+    int count = 0;
+    int start = 0;
+    while (count < maxColumns && start <= (int)header.length()) {
+      int end = header.indexOf(',', start);
+      if (end == -1) end = header.length();
+      columns[count] = header.substring(start, end);
+      columns[count].trim();
+      count++;
+      start = end + 1;
+    }
+    return count;
+  }
+
+private:
+  JsonStreamWriter& json;
+  const String& header;
+  String columns[MAX_COLUMNS];
+  int columnCount;
+};
+
+#endif // JSON_STREAM_H
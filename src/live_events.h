@@ -0,0 +1,250 @@
+/*
+ * Live Events for OmniLogger
+ * Server-Sent Events stream pushing new samples to open dashboards
+ *
+ * Copyright (C) 2024 NortonTech3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIVE_EVENTS_H
+#define LIVE_EVENTS_H
+
+#include <Arduino.h>
+#include <WebServer.h>
+#include <WiFiClient.h>
+#include <lwip/sockets.h>
+
+// Fixed buffer for formatting one event payload with JsonStreamWriter
+class EventBuffer : public Print {
+public:
+  static const size_t CAPACITY = 768;
+  
+  EventBuffer() : used(0), overflow(false) {}
+  
+  size_t write(uint8_t c) override {
+    if (used == CAPACITY) {
+      overflow = true;
+      return 0;
+    }
+    buf[used++] = c;
+    return 1;
+  }
+  
+  size_t write(const uint8_t* data, size_t len) override {
+    size_t n = std::min(len, CAPACITY - used);
+    memcpy(buf + used, data, n);
+    used += n;
+    overflow |= n < len;
+    return n;
+  }
+  
+  const char* data() const {
+    return buf;
+  }
+  
+  size_t length() const {
+    return used;
+  }
+  
+  bool truncated() const {
+    return overflow;
+  }
+
+private:
+  char buf[CAPACITY];
+  size_t used;
+  bool overflow;
+};
+
+// /api/events keeps the connection of each subscriber and queues an
+// "event: <name>" / "data: <json>" pair for all of them per publish. The
+// synchronous WebServer drops its reference to the connection after the
+// handler returns; the copy held here keeps the socket open. Subscribing,
+// publishing and keepalives all run with the storage lock held, like every
+// web request, so the client list needs no lock of its own.
+//
+// Sockets are written with non-blocking sends, like downloads: publish()
+// runs from storeSample(), so a slow client must never hold up logging.
+// Each client has an outbox for one event; an event that doesn't fit is
+// dropped for that client, and a client that takes nothing for
+// STALL_TIMEOUT_MS is closed.
+class LiveEvents {
+public:
+  static const int MAX_CLIENTS = 4;
+  static const uint32_t KEEPALIVE_MS = 15000;      // Comment line so dead connections are noticed
+  static const uint32_t RETRY_MS = 5000;           // Browser reconnect delay
+  static const uint32_t STALL_TIMEOUT_MS = 30000;  // Drop clients that stop reading
+  static const size_t OUTBOX_SIZE = EventBuffer::CAPACITY + 64;  // One event with its framing
+  
+  LiveEvents() : lastKeepalive(0), droppedEvents(0) {
+    memset(active, 0, sizeof(active));
+    memset(used, 0, sizeof(used));
+    memset(sent, 0, sizeof(sent));
+  }
+  
+  // Take over the current request's connection. False if all slots are taken.
+  bool subscribe(WebServer& server) {
+    int slot = -1;
+    for (int i = 0; i < MAX_CLIENTS; i++) {
+      if (active[i] && !clients[i].connected()) {
+        drop(i);
+      }
+      if (!active[i] && slot < 0) {
+        slot = i;
+      }
+    }
+    if (slot < 0) {
+      return false;
+    }
+    
+    clients[slot] = server.client();
+    clients[slot].setNoDelay(true);
+    active[slot] = true;
+    used[slot] = 0;
+    sent[slot] = 0;
+    char head[160];
+    int len = snprintf(head, sizeof(head),
+                       "HTTP/1.1 200 OK\r\n"
+                       "Content-Type: text/event-stream\r\n"
+                       "Cache-Control: no-cache\r\n"
+                       "Connection: keep-alive\r\n"
+                       "\r\n"
+                       "retry: %u\n\n", RETRY_MS);
+    const char* parts[] = {head};
+    size_t lengths[] = {(size_t)len};
+    queue(slot, parts, lengths, 1);
+    send(slot);
+    Serial.printf("Live events: client %d subscribed\n", slot);
+    return true;
+  }
+  
+  void publish(const char* event, const char* data, size_t len) {
+    char head[40];
+    int headLen = snprintf(head, sizeof(head), "event: %s\ndata: ", event);
+    const char* parts[] = {head, data, "\n\n"};
+    size_t lengths[] = {(size_t)headLen, len, 2};
+    for (int i = 0; i < MAX_CLIENTS; i++) {
+      if (!active[i]) continue;
+      if (!queue(i, parts, lengths, 3)) {
+        droppedEvents++;  // Still sending an earlier one
+      }
+      send(i);
+    }
+    lastKeepalive = millis();
+  }
+  
+  // Queued bytes, keepalives and cleanup of closed connections; call often
+  void service() {
+    for (int i = 0; i < MAX_CLIENTS; i++) {
+      if (active[i] && sent[i] < used[i]) {
+        send(i);
+      }
+    }
+    if (millis() - lastKeepalive < KEEPALIVE_MS) {
+      return;
+    }
+    lastKeepalive = millis();
+    const char* parts[] = {":\n\n"};
+    size_t lengths[] = {3};
+    for (int i = 0; i < MAX_CLIENTS; i++) {
+      if (!active[i]) continue;
+      if (!clients[i].connected()) {
+        drop(i);
+        continue;
+      }
+      queue(i, parts, lengths, 1);
+      send(i);
+    }
+  }
+  
+  int clientCount() const {
+    int count = 0;
+    for (int i = 0; i < MAX_CLIENTS; i++) {
+      if (active[i]) count++;
+    }
+    return count;
+  }
+  
+  // Events not delivered to a client because its outbox was still full
+  uint32_t getDroppedEvents() const {
+    return droppedEvents;
+  }
+
+private:
+  WiFiClient clients[MAX_CLIENTS];
+  bool active[MAX_CLIENTS];
+  char outbox[MAX_CLIENTS][OUTBOX_SIZE];
+  size_t used[MAX_CLIENTS];  // Queued bytes in the outbox
+  size_t sent[MAX_CLIENTS];  // Of which already sent
+  unsigned long lastProgress[MAX_CLIENTS];
+  unsigned long lastKeepalive;
+  uint32_t droppedEvents;
+  
+  // Append all parts or none of them
+  bool queue(int i, const char* const* parts, const size_t* lengths, int count) {
+    if (sent[i] > 0) {
+      memmove(outbox[i], outbox[i] + sent[i], used[i] - sent[i]);
+      used[i] -= sent[i];
+      sent[i] = 0;
+    }
+    size_t total = 0;
+    for (int p = 0; p < count; p++) {
+      total += lengths[p];
+    }
+    if (total > OUTBOX_SIZE - used[i]) {
+      return false;
+    }
+    if (used[i] == 0) {
+      lastProgress[i] = millis();  // The stall clock runs while bytes wait
+    }
+    for (int p = 0; p < count; p++) {
+      memcpy(outbox[i] + used[i], parts[p], lengths[p]);
+      used[i] += lengths[p];
+    }
+    return true;
+  }
+  
+  // Non-blocking send: a full socket buffer means try again on the next call
+  void send(int i) {
+    while (sent[i] < used[i]) {
+      ssize_t n = ::send(clients[i].fd(), outbox[i] + sent[i], used[i] - sent[i], MSG_DONTWAIT);
+      if (n > 0) {
+        sent[i] += n;
+        lastProgress[i] = millis();
+        continue;
+      }
+      if ((n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) || !clients[i].connected()) {
+        drop(i);
+      } else if (millis() - lastProgress[i] > STALL_TIMEOUT_MS) {
+        Serial.printf("Live events: client %d stalled\n", i);
+        drop(i);
+      }
+      return;
+    }
+    used[i] = 0;
+    sent[i] = 0;
+  }
+  
+  void drop(int i) {
+    clients[i].stop();
+    clients[i] = WiFiClient();
+    active[i] = false;
+    used[i] = 0;
+    sent[i] = 0;
+    Serial.printf("Live events: client %d disconnected\n", i);
+  }
+};
+
+#endif // LIVE_EVENTS_H
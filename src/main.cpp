@@ -40,6 +40,9 @@
 #include <esp_sleep.h>
 #include <driver/rtc_io.h>
 #include <esp_task_wdt.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
 #include <esp_chip_info.h>
 #include <esp_flash.h>
 #include <esp_adc_cal.h>
@@ -49,6 +52,13 @@
 #include "sensors.h"
 #include "web_interface.h"
 #include "datalogger.h"
+#include "recent_samples.h"
+#include "scheduler.h"
+#include "rollup.h"
+#include "sample_batch.h"
+#include "status_cache.h"
+#include "uplink.h"
+#include "network_manager.h"
 
 // Watchdog timeout in seconds
 #define WDT_TIMEOUT_SEC 30
@@ -63,12 +73,32 @@ RTC_DATA_ATTR uint32_t rtcBootCount = 0;
 RTC_DATA_ATTR bool rtcTimeInitialized = false;
 RTC_DATA_ATTR time_t rtcLastTimestamp = 0;
 RTC_DATA_ATTR uint8_t rtcErrorCount = 0;  // Track errors across reboots
+RTC_DATA_ATTR uint32_t rtcScheduleTick = 0;  // Scheduler tick to resume at after waking
+RTC_DATA_ATTR uint32_t rtcSleepSeconds = 0;
+RTC_DATA_ATTR RollupState rtcRollupState;  // Open rollup buckets
+RTC_DATA_ATTR SampleBatch rtcSampleBatch;  // Samples from fast wakes not yet logged
+RTC_DATA_ATTR WakeStats rtcWakeStats;
+RTC_DATA_ATTR bool rtcFastWakeArmed = false;  // Set when a full boot goes to deep sleep
+RTC_DATA_ATTR time_t rtcNextFullWake = 0;  // Timer wakes before this take the fast path
+
+// Deep sleep: timer wakes only read sensors into the RTC batch; a full boot
+// with WiFi and NTP happens at this interval or on the GPIO 0 button
+const time_t FULL_WAKE_INTERVAL_SEC = 12 * 60 * 60;  // Same as the NTP resync
+const int UPLINK_BATCHES_BEFORE_SLEEP = 16;  // Backlog sent per full wake while the radio is on
+const uint32_t WAKE_NETWORK_WAIT_MS = 20000;  // Longest wait for WiFi and NTP before a full wake sleeps
 
 // Configuration stored in EEPROM/Flash
 Config deviceConfig;
 SensorManager sensorManager;
 DataLogger dataLogger;
 WebServerManager webServer;
+RecentSamples recentSamples;
+SensorScheduler scheduler;
+RollupManager rollups;
+StatusCache statusCache;
+Uplink uplink;
+NetworkManager network;
+unsigned int scheduledInterval = 0;  // Measurement interval the schedule was built with
 
 // Global state
 unsigned long lastMeasurement = 0;
@@ -90,15 +120,64 @@ const unsigned long DEBOUNCE_MS = 250;  // 250ms debounce
 // Error tracking for reliability
 uint32_t sensorErrors = 0;
 uint32_t sdErrors = 0;
-uint32_t wifiErrors = 0;
 uint32_t consecutiveErrors = 0;
 const uint32_t MAX_CONSECUTIVE_ERRORS = 5;  // Reset if too many errors
 
+// Task pipeline (continuous mode): the acquisition task samples on a fixed
+// schedule and queues records for the storage task; the web server runs in
+// its own task. Deep sleep mode keeps the single-threaded loop() since each
+// wake takes one measurement.
+const UBaseType_t ACQUISITION_PRIORITY = 3;
+const UBaseType_t STORAGE_PRIORITY = 2;
+const UBaseType_t NETWORK_PRIORITY = 1;
+const UBaseType_t SAMPLE_QUEUE_DEPTH = 32;
+const TickType_t WDT_FEED_TICKS = pdMS_TO_TICKS(10000);  // Well inside WDT_TIMEOUT_SEC
+const size_t SAMPLE_RECORD_MAX = 512;
+const uint32_t COMPACTION_SLICE_US = 10000;  // Longest compaction step under the storage lock
+const TickType_t COMPACTION_IDLE_TICKS = pdMS_TO_TICKS(20);  // Queue wait between steps while compacting
+
+// An encoded measurement on its way from acquisition to storage
+struct SampleRecord {
+  time_t timestamp;
+  uint32_t seq;  // Recent samples sequence number, for live events
+  LogFormat format;
+  uint16_t length;
+  char data[SAMPLE_RECORD_MAX];
+};
+
+QueueHandle_t sampleQueue = nullptr;
+SemaphoreHandle_t storageMutex = nullptr;  // Serializes SD access between storage and web tasks
+bool pipelineRunning = false;
+uint32_t samplesDropped = 0;
+
 // Forward declarations
-void setupWiFi();
-void syncTime();
-void takeMeasurement();
+void serviceNetwork();
+void takeMeasurement(uint32_t dueMask);
+bool acquireSample(SampleRecord& sample, uint32_t dueMask);
+void buildSchedule(uint32_t startTick);
+uint32_t nextScheduledSensors();
+void storeSample(const SampleRecord& sample);
+bool startPipeline();
+void acquisitionTask(void* param);
+void storageTask(void* param);
+void networkTask(void* param);
+void lockStorage();
+void unlockStorage();
+void serviceHousekeeping();
+void serviceStorage();
+void serviceUplink();
+void serviceCompaction();
+void writeRollups();
 void enterDeepSleep();
+void sleepUntilDue(bool fastWake);
+void fastWake();
+bool batchSample(uint32_t dueMask);
+void flushSampleBatch();
+void drainSampleBatch();
+void beginDataLogger();
+void onDayFileRenamed(const char* from, const char* to);
+void restoreTime();
+void formatTimestamp(time_t t, bool synced, char* out, size_t outSize);
 float readBatteryVoltage();
 void checkWiFiTimeout();
 void disableWiFi();
@@ -129,7 +208,7 @@ void logSystemStatus() {
   Serial.printf("[STATUS] CPU: %d MHz, ADC calibrated: %s\n",
                 getCpuFrequencyMhz(), adcCalibrated ? "Yes" : "No");
   Serial.printf("[STATUS] Errors - Sensor: %u, SD: %u, WiFi: %u\n",
-                sensorErrors, sdErrors, wifiErrors);
+                sensorErrors, sdErrors, network.getFailures());
 }
 
 // WiFi status getter for web interface
@@ -138,6 +217,12 @@ bool getWiFiEnabled() {
 }
 
 void setup() {
+  // Timer wakes between full boots skip everything but the sensors
+  esp_sleep_wakeup_cause_t wakeReason = esp_sleep_get_wakeup_cause();
+  if (wakeReason == ESP_SLEEP_WAKEUP_TIMER && rtcFastWakeArmed && time(nullptr) < rtcNextFullWake) {
+    fastWake();  // Doesn't return
+  }
+  
   Serial.begin(115200);
   delay(1000);
   
@@ -234,28 +319,19 @@ void setup() {
   rtcBootCount++;
   
   // Check wake reason - optimize startup for deep sleep wake
-  esp_sleep_wakeup_cause_t wakeReason = esp_sleep_get_wakeup_cause();
-  bool isDeepSleepWake = (wakeReason == ESP_SLEEP_WAKEUP_TIMER);
+  bool isDeepSleepWake = (wakeReason == ESP_SLEEP_WAKEUP_TIMER || wakeReason == ESP_SLEEP_WAKEUP_EXT0);
   
   if (isDeepSleepWake) {
-    Serial.println("Woke from deep sleep (timer)");
+    Serial.printf("Woke from deep sleep (%s)\n", wakeReason == ESP_SLEEP_WAKEUP_EXT0 ? "button" : "timer");
     // Use RTC values - faster than loading from NVS
     measurementCount = rtcMeasurementCount;
     timeInitialized = rtcTimeInitialized;
-    
-    // Restore approximate time from RTC memory
-    // This adds the sleep duration to the last saved timestamp
-    if (rtcTimeInitialized && rtcLastTimestamp > 0) {
-      struct timeval tv;
-      tv.tv_sec = rtcLastTimestamp + deviceConfig.measurementInterval;
-      tv.tv_usec = 0;
-      settimeofday(&tv, NULL);
-      Serial.println("Time restored from RTC memory");
-    }
+    restoreTime();
   } else {
     Serial.printf("Cold boot (reason: %d)\n", wakeReason);
-    // Reset error counter on cold boot
+    // Reset error counter and schedule on cold boot
     rtcErrorCount = 0;
+    rtcScheduleTick = 0;
   }
   
   Serial.printf("Boot count: %d\n", rtcBootCount);
@@ -299,30 +375,33 @@ void setup() {
     Serial.println("LittleFS mounted successfully");
   }
   
-  // Initialize DataLogger (SD card will be lazy-initialized on first flush)
-  pinMode(deviceConfig.sdCardCS, OUTPUT);
-  digitalWrite(deviceConfig.sdCardCS, HIGH);
+  beginDataLogger();
   
-  if (!dataLogger.begin(deviceConfig.sdCardCS)) {
-    Serial.println("WARNING: DataLogger initialization failed!");
-  } else {
-    Serial.println("DataLogger initialized successfully");
-  }
-  
-  // Configure data buffering
-  dataLogger.setBufferingEnabled(deviceConfig.bufferingEnabled);
-  if (deviceConfig.bufferingEnabled) {
-    Serial.printf("Data buffering enabled with %d second flush interval\n", deviceConfig.flushInterval);
-  }
+  statusCache.begin(&dataLogger, &deviceConfig, readBatteryVoltage);
   
   // Initialize sensors
   sensorManager.begin(deviceConfig);
   Serial.printf("Initialized %d sensors\n", sensorManager.getSensorCount());
+  recentSamples.begin();
+  rollups.begin(&rtcRollupState, isDeepSleepWake);
+  
+  // Per-sensor intervals; after a deep sleep wake the schedule resumes at the tick it slept until
+  sensorManager.setCarryForward(deviceConfig.carryForward);
+  buildSchedule(isDeepSleepWake ? rtcScheduleTick : 0);
   
-  // Setup WiFi
-  setupWiFi();
+  // Schema is known now, so buffered binary records can be flushed before the first measurement
+  dataLogger.writeHeader(sensorManager.getCSVHeader(), sensorManager.getChannelDecimals());
   
-  // Setup GPIO 0 button for WiFi re-enable
+  // Samples batched by fast wakes go first so the day files stay in time order
+  drainSampleBatch();
+  
+  // Connect (or open the access point) and start NTP in the background;
+  // sampling starts without waiting for either
+  Serial.println("\nConfiguring WiFi...");
+  network.begin(&deviceConfig);
+  
+  // Setup GPIO 0 button for WiFi re-enable (an RTC IO while it was the wake source)
+  rtc_gpio_deinit(GPIO_NUM_0);
   pinMode(0, INPUT_PULLUP);
   attachInterrupt(digitalPinToInterrupt(0), wifiButtonISR, FALLING);
   Serial.println("GPIO 0 button configured for WiFi re-enable");
@@ -330,23 +409,75 @@ void setup() {
   // Start WiFi timeout timer
   wifiTimeoutStart = millis();
   
-  // Sync time from NTP
-  if (WiFi.status() == WL_CONNECTED) {
-    syncTime();
-  }
-  
   // Start web server
-  webServer.begin(&deviceConfig, &sensorManager, &dataLogger, readBatteryVoltage, getWiFiEnabled);
+  webServer.begin(&deviceConfig, &sensorManager, &dataLogger, &recentSamples, readBatteryVoltage, getWiFiEnabled);
+  webServer.setWakeInfo(&rtcWakeStats, &rtcSampleBatch);
+  webServer.setStatusCache(&statusCache);
+  webServer.setNetwork(&network);
   Serial.println("Web server started");
   
+  // Push logged rows to the configured server from the saved cursor
+  uplink.begin(&deviceConfig, &dataLogger);
+  webServer.setUplink(&uplink);
+  
+  // Continuous mode runs as a task pipeline; deep sleep keeps loop()
+  if (!deviceConfig.deepSleepEnabled) {
+    startPipeline();
+  }
+  
   Serial.println("Setup complete!");
   Serial.println("========================================\n");
 }
 
 void loop() {
+  if (pipelineRunning) {
+    // The pipeline tasks do the work; this task is no longer needed
+    esp_task_wdt_delete(NULL);
+    vTaskDelete(NULL);
+  }
+  
   // Feed the watchdog to prevent reset
   esp_task_wdt_reset();
   
+  serviceHousekeeping();
+  serviceStorage();
+  
+  // Check if it's time for a measurement
+  unsigned long currentTime = millis();
+  unsigned long measurementElapsed;
+  
+  // Handle millis() rollover (occurs every ~49.7 days)
+  if (currentTime >= lastMeasurement) {
+    measurementElapsed = currentTime - lastMeasurement;
+  } else {
+    measurementElapsed = (0xFFFFFFFF - lastMeasurement) + currentTime + 1;
+  }
+  
+  if (measurementElapsed >= scheduler.getTickSeconds() * 1000UL) {
+    uint32_t dueMask = nextScheduledSensors();
+    if (dueMask != 0 || scheduler.isIdle()) {
+      takeMeasurement(dueMask);
+      
+      // If deep sleep is enabled and we're battery powered, enter sleep
+      if (deviceConfig.deepSleepEnabled && readBatteryVoltage() < 5.0) {
+        enterDeepSleep();
+      }
+    }
+    lastMeasurement = currentTime;
+  }
+  
+  // Use light sleep between loop iterations when WiFi is off (saves ~10mA)
+  if (!wifiEnabled && !deviceConfig.deepSleepEnabled) {
+    // Light sleep for 10ms instead of delay - wakes on any interrupt
+    esp_sleep_enable_timer_wakeup(10000);  // 10ms in microseconds
+    esp_light_sleep_start();
+  } else {
+    delay(10);
+  }
+}
+
+// WiFi button, health checks, web requests and time resync
+void serviceHousekeeping() {
   // Check for WiFi re-enable request from button
   if (wifiReenableRequested) {
     wifiReenableRequested = false;
@@ -388,10 +519,15 @@ void loop() {
   
   // Handle web server if WiFi is enabled
   if (wifiEnabled) {
+    serviceNetwork();
     webServer.handleClient();
     checkWiFiTimeout();
+    serviceUplink();
   }
-  
+}
+
+// Periodic buffer flush and group commit (caller holds the storage lock)
+void serviceStorage() {
   // Check if buffered data should be flushed
   if (deviceConfig.bufferingEnabled && 
       dataLogger.shouldFlush(deviceConfig.flushInterval * 1000UL)) {
@@ -399,124 +535,185 @@ void loop() {
     dataLogger.flushBuffer();
   }
   
-  // Check if it's time for a measurement
-  unsigned long currentTime = millis();
-  unsigned long measurementElapsed;
+  // Commit grouped records that have waited long enough
+  dataLogger.commitIfDue();
   
-  // Handle millis() rollover (occurs every ~49.7 days)
-  if (currentTime >= lastMeasurement) {
-    measurementElapsed = currentTime - lastMeasurement;
-  } else {
-    measurementElapsed = (0xFFFFFFFF - lastMeasurement) + currentTime + 1;
-  }
+  writeRollups();
+  serviceCompaction();
   
-  if (measurementElapsed >= deviceConfig.measurementInterval * 1000UL) {
-    takeMeasurement();
-    lastMeasurement = currentTime;
-    
-    // If deep sleep is enabled and we're battery powered, enter sleep
-    if (deviceConfig.deepSleepEnabled && readBatteryVoltage() < 5.0) {
-      enterDeepSleep();
-    }
+  // Battery and SD health for /api/status
+  statusCache.update();
+}
+
+// Gzip closed day files in the gaps between samples: a step only runs with
+// no sample waiting and no download reading the card
+void serviceCompaction() {
+  if (deviceConfig.compactAfterDays == 0 || deviceConfig.deepSleepEnabled) {
+    dataLogger.stopCompaction();
+    return;
   }
-  
-  // Resync time periodically (every 12 hours)
-  static unsigned long lastTimeSync = 0;
-  unsigned long currentMillis = millis();
-  unsigned long timeSyncElapsed;
-  if (currentMillis >= lastTimeSync) {
-    timeSyncElapsed = currentMillis - lastTimeSync;
-  } else {
-    timeSyncElapsed = (0xFFFFFFFF - lastTimeSync) + currentMillis + 1;
+  if (!timeInitialized || webServer.getActiveDownloads() > 0 ||
+      (sampleQueue && uxQueueMessagesWaiting(sampleQueue) > 0)) {
+    return;
   }
-  if (timeInitialized && wifiEnabled && timeSyncElapsed > 12 * 60 * 60 * 1000UL) {
-    syncTime();
-    lastTimeSync = currentMillis;
+  // Rows the uplink hasn't sent yet stay in plain files
+  const char* keepFrom = deviceConfig.uplinkEnabled ? uplink.getCursor().name : nullptr;
+  time_t olderThan = time(nullptr) - (time_t)deviceConfig.compactAfterDays * 86400;
+  dataLogger.serviceCompaction(olderThan, keepFrom, COMPACTION_SLICE_US);
+}
+
+// One uplink batch when due: rows are read under the storage lock, the POST
+// runs without it so storage and sampling go on meanwhile
+void serviceUplink() {
+  if (!wifiEnabled || !uplink.isDue()) {
+    return;
   }
-  
-  // Use light sleep between loop iterations when WiFi is off (saves ~10mA)
-  if (!wifiEnabled && !deviceConfig.deepSleepEnabled) {
-    // Light sleep for 10ms instead of delay - wakes on any interrupt
-    esp_sleep_enable_timer_wakeup(10000);  // 10ms in microseconds
-    esp_light_sleep_start();
-  } else {
-    delay(10);
+  lockStorage();
+  bool ready = uplink.prepare();
+  unlockStorage();
+  if (ready) {
+    esp_task_wdt_reset();
+    uplink.send();
   }
 }
 
-void setupWiFi() {
-  Serial.println("\nConfiguring WiFi...");
+// Append closed rollup buckets - at most one per minute
+void writeRollups() {
+  if (rollups.hasPending() && dataLogger.initSDCard()) {
+    rollups.writePending(sensorManager.getCSVHeader());
+  }
+}
+
+bool startPipeline() {
+  sampleQueue = xQueueCreate(SAMPLE_QUEUE_DEPTH, sizeof(SampleRecord));
+  storageMutex = xSemaphoreCreateMutex();
+  if (!sampleQueue || !storageMutex) {
+    Serial.println("ERROR: No memory for the task pipeline - using the main loop");
+    return false;
+  }
+  webServer.setStorageLock(storageMutex);
   
-  if (strlen(deviceConfig.wifiSSID) > 0) {
-    // Try to connect to configured WiFi
-    Serial.printf("Connecting to WiFi: %s\n", deviceConfig.wifiSSID);
-    WiFi.mode(WIFI_STA);
-    WiFi.begin(deviceConfig.wifiSSID, deviceConfig.wifiPassword);
-    
-    int attempts = 0;
-    while (WiFi.status() != WL_CONNECTED && attempts < 20) {
-      delay(500);
-      Serial.print(".");
-      attempts++;
+  if (xTaskCreate(storageTask, "storage", 8192, nullptr, STORAGE_PRIORITY, nullptr) != pdPASS ||
+      xTaskCreate(networkTask, "network", 10240, nullptr, NETWORK_PRIORITY, nullptr) != pdPASS ||
+      xTaskCreate(acquisitionTask, "acquisition", 6144, nullptr, ACQUISITION_PRIORITY, nullptr) != pdPASS) {
+    // Can't fall back once some tasks run - restart rather than share state unlocked
+    Serial.println("ERROR: Failed to start pipeline tasks - restarting");
+    delay(1000);
+    ESP.restart();
+  }
+  
+  pipelineRunning = true;
+  Serial.println("Task pipeline started (acquisition, storage, network)");
+  return true;
+}
+
+// Samples on an absolute schedule: a slow cycle doesn't shift the next ones.
+// Wakes every scheduler tick and reads only the sensors that are due.
+void acquisitionTask(void* param) {
+  esp_task_wdt_add(NULL);
+  TickType_t lastWake = xTaskGetTickCount();
+  SampleRecord sample;
+  
+  while (true) {
+    esp_task_wdt_reset();
+    uint32_t dueMask = nextScheduledSensors();
+    if ((dueMask != 0 || scheduler.isIdle()) && acquireSample(sample, dueMask) &&
+        xQueueSend(sampleQueue, &sample, 0) != pdTRUE) {
+      samplesDropped++;
+      Serial.printf("WARNING: Sample queue full - sample dropped (%u total)\n", samplesDropped);
     }
-    Serial.println();
     
-    if (WiFi.status() == WL_CONNECTED) {
-      Serial.println("WiFi connected!");
-      Serial.print("IP address: ");
-      Serial.println(WiFi.localIP());
-      
-      // Enable WiFi modem sleep to save power while maintaining connection
-      esp_wifi_set_ps(WIFI_PS_MIN_MODEM);
-      Serial.println("WiFi modem sleep enabled");
-      
-      return;
-    } else {
-      Serial.println("Failed to connect to WiFi");
+    // Long intervals are slept in steps so the watchdog is fed; the wake
+    // time stays lastWake + period
+    TickType_t period = pdMS_TO_TICKS(scheduler.getTickSeconds() * 1000UL);
+    while (period > WDT_FEED_TICKS && xTaskGetTickCount() - lastWake < period - WDT_FEED_TICKS) {
+      vTaskDelay(WDT_FEED_TICKS);
+      esp_task_wdt_reset();
     }
+    vTaskDelayUntil(&lastWake, period);
   }
-  
-  // Start in AP mode if no WiFi or connection failed
-  Serial.println("Starting Access Point mode...");
-  WiFi.mode(WIFI_AP);
-  WiFi.softAP(deviceConfig.apSSID, deviceConfig.apPassword);
-  Serial.print("AP IP address: ");
-  Serial.println(WiFi.softAPIP());
 }
 
-void syncTime() {
-  Serial.println("Syncing time from NTP...");
-  
-  configTime(deviceConfig.timezoneOffset * 3600, 0, 
-             "pool.ntp.org", "time.nist.gov", "time.google.com");
-  
-  // Wait for time to be set
-  int attempts = 0;
-  time_t now = 0;
-  struct tm timeinfo = {0};
-  
-  while (attempts < 10) {
-    time(&now);
-    localtime_r(&now, &timeinfo);
-    if (timeinfo.tm_year > (2020 - 1900)) {
-      break;
+// Drains the sample queue into the DataLogger
+void storageTask(void* param) {
+  esp_task_wdt_add(NULL);
+  SampleRecord sample;
+  
+  while (true) {
+    esp_task_wdt_reset();
+    // A compaction job runs in steps between samples, so don't idle long
+    TickType_t wait = dataLogger.isCompacting() ? COMPACTION_IDLE_TICKS : pdMS_TO_TICKS(1000);
+    bool received = xQueueReceive(sampleQueue, &sample, wait) == pdTRUE;
+    
+    lockStorage();
+    if (received) {
+      storeSample(sample);
     }
-    delay(500);
-    attempts++;
+    serviceStorage();
+    unlockStorage();
   }
+}
+
+void networkTask(void* param) {
+  esp_task_wdt_add(NULL);
   
-  if (timeinfo.tm_year > (2020 - 1900)) {
+  while (true) {
+    esp_task_wdt_reset();
+    serviceHousekeeping();
+    vTaskDelay(pdMS_TO_TICKS(wifiEnabled ? 2 : 10));
+  }
+}
+
+// No-ops until the pipeline runs
+void lockStorage() {
+  if (!storageMutex) return;
+  while (xSemaphoreTake(storageMutex, WDT_FEED_TICKS / 2) != pdTRUE) {
+    esp_task_wdt_reset();  // Held by a long download
+  }
+}
+
+void unlockStorage() {
+  if (storageMutex) {
+    xSemaphoreGive(storageMutex);
+  }
+}
+
+// Link, fallback and NTP events; the clock counts as set once NTP has answered
+void serviceNetwork() {
+  network.service();
+  if (network.isTimeSynced()) {
     timeInitialized = true;
-    char buffer[64];
-    strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &timeinfo);
-    Serial.printf("Time synchronized: %s\n", buffer);
-  } else {
-    Serial.println("Failed to sync time from NTP");
-    timeInitialized = false;
   }
 }
 
-void takeMeasurement() {
+void takeMeasurement(uint32_t dueMask) {
+  SampleRecord sample;
+  if (acquireSample(sample, dueMask)) {
+    storeSample(sample);
+  }
+}
+
+// Sensors that are never read (none, or failed to initialize) aren't scheduled
+void buildSchedule(uint32_t startTick) {
+  unsigned int periods[Config::MAX_SENSORS];
+  for (int i = 0; i < Config::MAX_SENSORS; i++) {
+    periods[i] = sensorManager.getSensorType(i) != SENSOR_NONE ? deviceConfig.sensorInterval(i) : 0;
+  }
+  scheduler.begin(periods, Config::MAX_SENSORS, deviceConfig.measurementInterval, startTick);
+  scheduledInterval = deviceConfig.measurementInterval;
+  Serial.printf("Sensor schedule: %u second tick\n", scheduler.getTickSeconds());
+}
+
+// Advance the schedule by one tick and return the sensors that are due
+uint32_t nextScheduledSensors() {
+  if (deviceConfig.measurementInterval != scheduledInterval) {
+    buildSchedule(0);  // Default interval changed in the settings - start over
+  }
+  return scheduler.advance();
+}
+
+// Read the due sensors and encode the record in the configured day file format
+bool acquireSample(SampleRecord& sample, uint32_t dueMask) {
   Serial.println("\n--- Taking Measurement ---");
   
   // Feed watchdog at start of measurement
@@ -525,31 +722,28 @@ void takeMeasurement() {
   // Get current time
   time_t now;
   time(&now);
-  struct tm timeinfo;
-  localtime_r(&now, &timeinfo);
-  
   char timestamp[32];
-  if (timeInitialized) {
-    strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", &timeinfo);
-  } else {
-    snprintf(timestamp, sizeof(timestamp), "UTC+%ld", now);
+  formatTimestamp(now, timeInitialized, timestamp, sizeof(timestamp));
+  
+  // Trigger all sensors at once and keep serving web requests while they
+  // convert (the network task does that when the pipeline runs)
+  sensorManager.startAcquisition(dueMask);
+  while (!sensorManager.pollAcquisition()) {
+    if (wifiEnabled && !pipelineRunning) {
+      webServer.handleClient();
+    }
+    delay(1);
   }
   
-  // Read all sensors with error tracking
-  sensorManager.readAllSensors();
-  
-  // Count valid readings
+  // Count valid readings of the sensors read this time
   int validReadings = 0;
   for (int i = 0; i < Config::MAX_SENSORS; i++) {
-    if (sensorManager.getSensorType(i) != SENSOR_NONE) {
-      SensorReading reading = sensorManager.getReading(i);
-      if (reading.valid) {
-        validReadings++;
-      }
+    if (sensorManager.wasSampled(i) && sensorManager.isReadingValid(i)) {
+      validReadings++;
     }
   }
   
-  if (validReadings == 0 && sensorManager.getSensorCount() > 0) {
+  if (validReadings == 0 && sensorManager.getSampledMask() != 0) {
     sensorErrors++;
     consecutiveErrors++;
     Serial.println("WARNING: All sensor readings failed!");
@@ -557,22 +751,66 @@ void takeMeasurement() {
     consecutiveErrors = 0;  // Reset on successful read
   }
   
-  // Write header for new files
-  dataLogger.writeHeader(sensorManager.getCSVHeader());
+  // Channel values feed the live view ring and the binary format
+  float values[BinLog::MAX_CHANNELS];
+  bool valid[BinLog::MAX_CHANNELS];
+  int channels = sensorManager.getChannelValues(values, valid, BinLog::MAX_CHANNELS);
+  recentSamples.push((uint32_t)now, timeInitialized, values, valid, channels);
+  sample.seq = recentSamples.lastSeq();
+  
+  // Rollups only get fresh readings (not carried-forward values) with real timestamps
+  if (timeInitialized) {
+    float freshValues[BinLog::MAX_CHANNELS];
+    bool fresh[BinLog::MAX_CHANNELS];
+    sensorManager.getChannelValues(freshValues, fresh, BinLog::MAX_CHANNELS, true);
+    rollups.add((uint32_t)now, freshValues, fresh, channels);
+  }
+  
+  sample.timestamp = now;
+  sample.format = dataLogger.getLogFormat();
+  if (sample.format == LOG_BINARY) {
+    sample.length = BinLog::encode((uint8_t*)sample.data, (uint32_t)now,
+                                   timeInitialized ? 0 : BinLog::FLAG_TIME_UNSYNCED,
+                                   values, valid, channels, sensorManager.getChannelDecimals());
+  } else {
+    sample.length = sensorManager.getCSVData(timestamp, sample.data, SAMPLE_RECORD_MAX);
+    if (sample.length == 0) {
+      Serial.printf("ERROR: CSV record longer than %u bytes\n", (unsigned)SAMPLE_RECORD_MAX);
+      return false;
+    }
+  }
+  
+  // Print to serial
+  Serial.printf("Timestamp: %s\n", timestamp);
+  sensorManager.printReadings();
+  Serial.printf("Battery: %.2fV, Free heap: %u bytes\n", readBatteryVoltage(), ESP.getFreeHeap());
+  Serial.println("--- Measurement Complete ---\n");
+  return true;
+}
+
+// Write an acquired record to the logger (with the storage lock held)
+void storeSample(const SampleRecord& sample) {
+  // Header for new day files (cached by the logger, no SD access)
+  dataLogger.writeHeader(sensorManager.getCSVHeader(), sensorManager.getChannelDecimals());
+  
+  if (sample.format != dataLogger.getLogFormat()) {
+    Serial.println("Log format changed since acquisition - sample dropped");
+    return;
+  }
   
   // Log to SD card with retry logic
-  String logEntry = sensorManager.getCSVData(timestamp);
   bool logSuccess = false;
   int retries = 3;
   
   while (!logSuccess && retries > 0) {
-    if (dataLogger.logData(logEntry)) {
+    if (dataLogger.logData(sample.data, sample.length, sample.timestamp)) {
       logSuccess = true;
       measurementCount++;
       rtcMeasurementCount = measurementCount;  // Fast RTC save
       
       // Only write to NVS every 10 measurements to reduce flash wear
       if (measurementCount % 10 == 0) {
+        ScopedTimer timer(METRIC_NVS_PUT);
         measurementPrefs.putUInt("count", measurementCount);
       }
       consecutiveErrors = 0;
@@ -588,21 +826,16 @@ void takeMeasurement() {
   
   if (logSuccess) {
     Serial.printf("Data logged successfully (count: %d)\n", measurementCount);
+    webServer.publishSample(sample.seq);
   } else {
     sdErrors++;
     consecutiveErrors++;
     Serial.println("ERROR: Failed to log data after retries");
   }
-  
-  // Print to serial
-  Serial.printf("Timestamp: %s\n", timestamp);
-  sensorManager.printReadings();
-  Serial.printf("Battery: %.2fV, Free heap: %u bytes\n", readBatteryVoltage(), ESP.getFreeHeap());
-  Serial.println("--- Measurement Complete ---\n");
 }
 
 void enterDeepSleep() {
-  Serial.printf("Entering deep sleep for %d seconds...\n", deviceConfig.measurementInterval);
+  Serial.println("Preparing for deep sleep...");
   
   // Run abbreviated health check before sleep (skip WiFi reconnect since we're sleeping)
   uint32_t freeHeap = ESP.getFreeHeap();
@@ -611,50 +844,305 @@ void enterDeepSleep() {
   }
   
   // Log error summary if any errors occurred
-  if (sensorErrors > 0 || sdErrors > 0 || wifiErrors > 0) {
+  if (sensorErrors > 0 || sdErrors > 0 || network.getFailures() > 0) {
     Serial.printf("[PRE-SLEEP STATUS] Errors - Sensor: %u, SD: %u, WiFi: %u\n",
-                  sensorErrors, sdErrors, wifiErrors);
+                  sensorErrors, sdErrors, network.getFailures());
   }
   
-  // Save time to RTC memory for faster wake
-  time_t now;
-  time(&now);
-  rtcLastTimestamp = now;
-  rtcTimeInitialized = timeInitialized;
-  rtcMeasurementCount = measurementCount;
-  
   // Sync final measurement count to NVS before sleep
   measurementPrefs.putUInt("count", measurementCount);
   
-  // Do NOT flush buffer - it persists in NVS across deep sleep
-  // Buffer will be flushed when threshold is reached or manually triggered
+  // The flash journal persists across deep sleep and is flushed when the
+  // threshold is reached or manually triggered. A PSRAM buffer is lost
+  // when the chip powers down, so write it out now.
+  if (!dataLogger.isBufferPersistent()) {
+    dataLogger.flush();
+  }
   
   // Close NVS properly to save data
   measurementPrefs.end();
   
+  // The link came up in the background while sampling; give it and NTP
+  // a bounded wait now, then send the uplink backlog while the radio is
+  // still on. The cursor in NVS picks up the rest on the next full wake.
+  if (wifiEnabled) {
+    network.waitForSync(WAKE_NETWORK_WAIT_MS);
+    serviceNetwork();
+  }
+  for (int i = 0; i < UPLINK_BATCHES_BEFORE_SLEEP && wifiEnabled && uplink.isDue(); i++) {
+    serviceUplink();
+  }
+  
   // Power down WiFi completely
   if (wifiEnabled) {
-    WiFi.disconnect(true);
-    WiFi.mode(WIFI_OFF);
+    network.stop();
     btStop();  // Also stop Bluetooth to save power
   }
   
+  // Open rollup buckets stay in RTC memory; closed ones go to the card now
+  writeRollups();
+  
   // Power down SD card
   dataLogger.powerDown();
   
-  // Hold GPIO states during deep sleep to prevent floating pins
-  gpio_hold_en(GPIO_NUM_0);  // WiFi button
+  sleepUntilDue(false);
+}
+
+// Save the wake state to RTC memory and sleep until the next tick with a
+// sensor due. The next timer wakes take the fast path until a full boot is due.
+void sleepUntilDue(bool fastWake) {
+  uint32_t sleepTicks = scheduler.ticksUntilDue();
+  uint32_t sleepSeconds = sleepTicks * scheduler.getTickSeconds();
+  
+  // Save time to RTC memory for faster wake
+  time_t now;
+  time(&now);
+  rtcLastTimestamp = now;
+  rtcTimeInitialized = timeInitialized;
+  rtcMeasurementCount = measurementCount;
+  rtcScheduleTick = scheduler.currentTick() + sleepTicks;
+  rtcSleepSeconds = sleepSeconds;
+  
+  rtcFastWakeArmed = true;
+  if (!fastWake) {
+    rtcNextFullWake = now + FULL_WAKE_INTERVAL_SEC;
+  }
+  
+  // Time since the app started, for energy per sample
+  uint32_t awakeUs = (uint32_t)esp_timer_get_time();
+  rtcWakeStats.record(fastWake, awakeUs);
+  Serial.printf("Awake %u ms (%s wake), %u sample(s) batched - sleeping %u seconds\n",
+                awakeUs / 1000, fastWake ? "fast" : "full", rtcSampleBatch.count, sleepSeconds);
+  
+  // GPIO 0 button wakes a full boot with WiFi; the RTC pull-up keeps it from floating
+  rtc_gpio_pullup_en(GPIO_NUM_0);
+  rtc_gpio_pulldown_dis(GPIO_NUM_0);
+  esp_sleep_enable_ext0_wakeup(GPIO_NUM_0, 0);
   gpio_deep_sleep_hold_en();
   
   // Configure wake up
-  esp_sleep_enable_timer_wakeup(deviceConfig.measurementInterval * 1000000ULL);
+  esp_sleep_enable_timer_wakeup(sleepSeconds * 1000000ULL);
   
   // Enter deep sleep
-  Serial.println("Entering deep sleep now...");
   Serial.flush();
   esp_deep_sleep_start();
 }
 
+// Headless timer wake: read the due sensors into the RTC batch and go back
+// to sleep. No diagnostics, LittleFS, WiFi or web server, and the SD card
+// only powers up when the batch is full.
+void fastWake() {
+  Serial.begin(115200);
+  
+  esp_task_wdt_init(WDT_TIMEOUT_SEC, true);
+  esp_task_wdt_add(NULL);
+  setCpuFrequencyMhz(80);
+  analogSetAttenuation(ADC_11db);
+  
+  rtcBootCount++;
+  measurementCount = rtcMeasurementCount;
+  timeInitialized = rtcTimeInitialized;
+  restoreTime();
+  
+  // Settings are still read from NVS (a few ms) so they can't go stale
+  deviceConfig.begin();
+  deviceConfig.load();
+  
+  sensorManager.begin(deviceConfig);
+  sensorManager.setCarryForward(deviceConfig.carryForward);
+  rollups.begin(&rtcRollupState, true);
+  buildSchedule(rtcScheduleTick);
+  
+  uint32_t dueMask = scheduler.advance();
+  if (dueMask != 0 || scheduler.isIdle()) {
+    batchSample(dueMask);
+  }
+  
+  // Write the batch out while the next sample still fits
+  if (!rtcSampleBatch.hasRoom(sensorManager.getChannelCount())) {
+    flushSampleBatch();
+  }
+  
+  sleepUntilDue(true);
+}
+
+// Read the due sensors and append the sample to the RTC batch
+bool batchSample(uint32_t dueMask) {
+  time_t now = time(nullptr);
+  
+  sensorManager.startAcquisition(dueMask);
+  while (!sensorManager.pollAcquisition()) {
+    delay(1);
+  }
+  
+  // Row values (with carry-forward) for the log, fresh flags for the rollups
+  float values[BatchedSample::MAX_CHANNELS];
+  float freshValues[BatchedSample::MAX_CHANNELS];
+  bool valid[BatchedSample::MAX_CHANNELS];
+  bool fresh[BatchedSample::MAX_CHANNELS];
+  int channels = sensorManager.getChannelValues(values, valid, BatchedSample::MAX_CHANNELS);
+  sensorManager.getChannelValues(freshValues, fresh, BatchedSample::MAX_CHANNELS, true);
+  
+  if (!rtcSampleBatch.push((uint32_t)now, timeInitialized, values, valid, fresh, channels)) {
+    Serial.println("WARNING: Sample batch full - sample dropped");
+    return false;
+  }
+  sensorManager.printReadings();
+  return true;
+}
+
+// Power up the card for the batch, then back down
+void flushSampleBatch() {
+  beginDataLogger();
+  dataLogger.writeHeader(sensorManager.getCSVHeader(), sensorManager.getChannelDecimals());
+  drainSampleBatch();
+  
+  // A PSRAM journal doesn't survive the sleep
+  if (!dataLogger.isBufferPersistent()) {
+    dataLogger.flush();
+  }
+  dataLogger.powerDown();
+  
+  if (measurementPrefs.begin("measurements", false)) {
+    measurementPrefs.putUInt("count", measurementCount);
+    measurementPrefs.end();
+  }
+  rtcWakeStats.batchFlushes++;
+}
+
+// Log the batched samples in the configured format, oldest first. Samples
+// that couldn't be written stay batched for the next attempt.
+void drainSampleBatch() {
+  if (rtcSampleBatch.used > SampleBatch::CAPACITY || rtcSampleBatch.count == 0) {
+    rtcSampleBatch.clear();  // Empty, or not initialized since power-on
+    return;
+  }
+  
+  Serial.printf("Logging %u batched sample(s)\n", rtcSampleBatch.count);
+  int channels = sensorManager.getChannelCount();
+  BatchedSample sample;
+  char record[SAMPLE_RECORD_MAX];
+  size_t offset = 0;
+  uint16_t logged = 0;
+  
+  // A failed write rolls back the records since the last commit, so only
+  // the samples up to the last safe one leave the batch
+  uint32_t safeBase = dataLogger.getSafeRecords();
+  uint32_t written = 0;
+  size_t safeOffset = 0;
+  uint16_t safeLogged = 0;
+  
+  while (size_t size = rtcSampleBatch.read(offset, sample)) {
+    esp_task_wdt_reset();
+    if (dataLogger.getSafeRecords() - safeBase == written) {
+      safeOffset = offset;
+      safeLogged = logged;
+    }
+    
+    // Sensors were reconfigured since the sample was taken
+    if (sample.channels != channels) {
+      Serial.println("Sensor layout changed - batched sample dropped");
+      offset += size;
+      logged++;
+      continue;
+    }
+    
+    size_t length;
+    if (dataLogger.getLogFormat() == LOG_BINARY) {
+      length = BinLog::encode((uint8_t*)record, sample.timestamp,
+                              sample.synced ? 0 : BinLog::FLAG_TIME_UNSYNCED,
+                              sample.values, sample.valid, sample.channels,
+                              sensorManager.getChannelDecimals());
+    } else {
+      char timestamp[32];
+      formatTimestamp(sample.timestamp, sample.synced, timestamp, sizeof(timestamp));
+      length = sensorManager.formatCSVRow(timestamp, sample.values, sample.valid, sample.channels,
+                                          record, sizeof(record));
+    }
+    if (length == 0) {
+      Serial.println("Batched sample too long for a CSV row - dropped");
+      offset += size;
+      logged++;
+      continue;
+    }
+    
+    if (!dataLogger.logData(record, length, sample.timestamp, true)) {
+      sdErrors++;
+      Serial.println("ERROR: Failed to log batched sample - keeping the rest");
+      break;
+    }
+    written++;
+    measurementCount++;
+    
+    if (sample.synced) {
+      rollups.add(sample.timestamp, sample.values, sample.fresh, sample.channels);
+      writeRollups();
+    }
+    offset += size;
+    logged++;
+  }
+  
+  if (dataLogger.commit() && dataLogger.getSafeRecords() - safeBase == written) {
+    safeOffset = offset;
+    safeLogged = logged;
+  } else if (safeLogged < logged) {
+    Serial.println("Batched samples rolled back by a failed write - keeping them");
+  }
+  rtcSampleBatch.consume(safeOffset, safeLogged);
+  rtcMeasurementCount = measurementCount;
+}
+
+// Logger setup shared by the full boot and batch flushes (SD card is lazy-initialized on first write)
+void beginDataLogger() {
+  pinMode(deviceConfig.sdCardCS, OUTPUT);
+  digitalWrite(deviceConfig.sdCardCS, HIGH);
+  
+  if (!dataLogger.begin(deviceConfig.sdCardCS, deviceConfig.bufferBackend, deviceConfig.logFormat)) {
+    Serial.println("WARNING: DataLogger initialization failed!");
+  } else {
+    Serial.println("DataLogger initialized successfully");
+  }
+  
+  // Configure data buffering
+  dataLogger.setBufferingEnabled(deviceConfig.bufferingEnabled);
+  if (deviceConfig.bufferingEnabled) {
+    Serial.printf("Data buffering enabled with %d second flush interval\n", deviceConfig.flushInterval);
+  }
+  
+  // Configure group commit for the day file writer
+  dataLogger.setCommitPolicy(deviceConfig.groupCommitEnabled, deviceConfig.commitMaxRecords,
+                             deviceConfig.commitMaxBytes, deviceConfig.commitMaxLatency);
+  dataLogger.setPreallocation(deviceConfig.sdPreallocKB);
+  dataLogger.setRenameCallback(onDayFileRenamed);
+}
+
+// The uplink cursor follows a day file moved aside for a schema change
+void onDayFileRenamed(const char* from, const char* to) {
+  uplink.fileRenamed(from, to);
+}
+
+// The RTC timer keeps the system time through deep sleep; the saved
+// timestamp only covers a clock that came back behind it
+void restoreTime() {
+  if (rtcTimeInitialized && time(nullptr) < rtcLastTimestamp) {
+    struct timeval tv;
+    tv.tv_sec = rtcLastTimestamp + rtcSleepSeconds;
+    tv.tv_usec = 0;
+    settimeofday(&tv, NULL);
+    Serial.println("Time restored from RTC memory");
+  }
+}
+
+void formatTimestamp(time_t t, bool synced, char* out, size_t outSize) {
+  if (synced) {
+    struct tm timeinfo;
+    localtime_r(&t, &timeinfo);
+    strftime(out, outSize, "%Y-%m-%d %H:%M:%S", &timeinfo);
+  } else {
+    snprintf(out, outSize, "UTC+%ld", t);
+  }
+}
+
 float readBatteryVoltage() {
   // ESP32-S2 has ADC on GPIO1-10
   // Using configured GPIO for battery voltage measurement with voltage divider
@@ -668,6 +1156,9 @@ float readBatteryVoltage() {
     return 0.0;
   }
   
+  // One-shot reads can't run while fast analog sampling holds ADC1
+  sensorManager.pauseFastAdc();
+  
   // Multisampling: take multiple readings and average
   uint32_t sum = 0;
   for (int i = 0; i < numSamples; i++) {
@@ -684,6 +1175,8 @@ float readBatteryVoltage() {
     delayMicroseconds(100);  // Small delay between samples
   }
   
+  sensorManager.resumeFastAdc();
+  
   // Average reading in millivolts
   float millivolts = sum / numSamples;
   
@@ -743,8 +1236,7 @@ void disableWiFi() {
   // Stop web server (there's no explicit stop method, but disconnecting WiFi will stop requests)
   
   // Disconnect and disable WiFi
-  WiFi.disconnect(true);
-  WiFi.mode(WIFI_OFF);
+  network.stop();
   
   wifiEnabled = false;
   
@@ -756,21 +1248,16 @@ void enableWiFi() {
   
   Serial.println("Re-enabling WiFi...");
   
-  // Restart WiFi setup
-  setupWiFi();
+  // Reconnect in the background
+  network.start();
   
   // Restart web server
-  webServer.begin(&deviceConfig, &sensorManager, &dataLogger, readBatteryVoltage, getWiFiEnabled);
+  webServer.begin(&deviceConfig, &sensorManager, &dataLogger, &recentSamples, readBatteryVoltage, getWiFiEnabled);
   
   // Reset timeout timer
   wifiTimeoutStart = millis();
   wifiEnabled = true;
   
-  // Sync time if connected
-  if (WiFi.status() == WL_CONNECTED) {
-    syncTime();
-  }
-  
   Serial.println("WiFi re-enabled successfully");
 }
 
@@ -807,34 +1294,8 @@ void checkSystemHealth() {
     rtcErrorCount++;
   }
   
-  // Check for WiFi connection issues in STA mode
-  if (wifiEnabled && strlen(deviceConfig.wifiSSID) > 0) {
-    if (WiFi.status() != WL_CONNECTED && WiFi.getMode() == WIFI_STA) {
-      wifiErrors++;
-      consecutiveErrors++;
-      Serial.println("WiFi connection lost, attempting reconnect...");
-      
-      // Try to reconnect
-      WiFi.disconnect();
-      WiFi.begin(deviceConfig.wifiSSID, deviceConfig.wifiPassword);
-      
-      int attempts = 0;
-      while (WiFi.status() != WL_CONNECTED && attempts < 10) {
-        delay(500);
-        esp_task_wdt_reset();  // Feed watchdog during reconnect
-        attempts++;
-      }
-      
-      if (WiFi.status() == WL_CONNECTED) {
-        Serial.println("WiFi reconnected successfully");
-        consecutiveErrors = 0;
-      } else {
-        Serial.println("WiFi reconnect failed, switching to AP mode");
-        WiFi.mode(WIFI_AP);
-        WiFi.softAP(deviceConfig.apSSID, deviceConfig.apPassword);
-      }
-    }
-  }
+  // WiFi reconnects and the access point fallback are handled by the
+  // network manager without blocking here
   
   // Check for too many consecutive errors - may indicate hardware issue
   if (consecutiveErrors >= MAX_CONSECUTIVE_ERRORS) {
@@ -842,6 +1303,8 @@ void checkSystemHealth() {
     rtcErrorCount += consecutiveErrors;
     
     // Save state before restart
+    lockStorage();
+    dataLogger.flush();
     measurementPrefs.putUInt("count", measurementCount);
     measurementPrefs.end();
     
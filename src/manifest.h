@@ -0,0 +1,477 @@
+/*
+ * File Manifest for OmniLogger
+ * Per-file row counts, sizes and time ranges kept on the SD card
+ *
+ * Copyright (C) 2024 NortonTech3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef MANIFEST_H
+#define MANIFEST_H
+
+#include <Arduino.h>
+#include <SD.h>
+#include <algorithm>
+#include <unistd.h>
+#include "binlog.h"
+#include "compactor.h"
+
+// One fixed-size entry per day file, so a commit rewrites only its own entry
+struct ManifestEntry {
+  char name[24];     // Full path, e.g. "/data_20260104.csv"
+  uint32_t rows;     // Data rows (header excluded)
+  uint32_t bytes;    // File size when last committed
+  uint32_t firstTs;  // Timestamp of the first row (0 = unknown)
+  uint32_t lastTs;   // Timestamp of the last row (0 = unknown)
+  uint32_t flags;    // Reserved
+};
+
+enum ManifestSort {
+  SORT_NAME = 0,
+  SORT_SIZE,
+  SORT_ROWS,
+  SORT_FIRST,
+  SORT_LAST
+};
+
+class FileManifest {
+public:
+  static constexpr const char* PATH = "/manifest.dat";
+  static const uint32_t MAGIC = 0x464D4D4F;  // "OMMF"
+  static const uint32_t VERSION = 1;
+  
+  FileManifest() : entries(nullptr), count(0), capacity(0), fileOpen(false) {}
+  
+  ~FileManifest() {
+    if (entries) {
+      free(entries);
+    }
+  }
+  
+  // Load the manifest and bring it in line with the card: only files whose
+  // size differs from their entry (or that have no entry) are rescanned
+  void begin() {
+    count = 0;
+    load();
+    
+    bool changed = false;
+    uint32_t rescanned = 0;
+    
+    // Mark every entry, unmark as files are found; marked entries are stale
+    for (uint32_t i = 0; i < count; i++) {
+      entries[i].flags |= FLAG_STALE;
+    }
+    
+    File root = SD.open("/");
+    if (root) {
+      File file = root.openNextFile();
+      while (file) {
+        char path[sizeof(ManifestEntry::name)];
+        if (!file.isDirectory() && dataFilePath(file.name(), path, sizeof(path))) {
+          uint32_t size = file.size();
+          int index = find(path);
+          if (index >= 0 && entries[index].bytes == size) {
+            entries[index].flags &= ~FLAG_STALE;
+          } else {
+            // A day file left open at power loss may end in preallocated zeros
+            uint32_t end = Gzip::isCompressed(path) ? size : dataEnd(file, path);
+            if (end < size) {
+              file.close();
+              String fullPath = String("/sd") + path;
+              if (truncate(fullPath.c_str(), end) == 0) {
+                Serial.printf("Manifest: trimmed %u padding bytes from %s\n", size - end, path);
+              }
+              file = SD.open(path, FILE_READ);
+            }
+            ManifestEntry entry;
+            scanFile(file, path, entry);
+            if (index >= 0) {
+              entries[index] = entry;
+            } else {
+              add(entry);
+            }
+            changed = true;
+            rescanned++;
+          }
+        }
+        file.close();
+        file = root.openNextFile();
+      }
+      root.close();
+    }
+    
+    // Drop entries for deleted files
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < count; i++) {
+      if (entries[i].flags & FLAG_STALE) {
+        changed = true;
+        continue;
+      }
+      entries[kept++] = entries[i];
+    }
+    count = kept;
+    
+    if (changed) {
+      save();
+    }
+    Serial.printf("Manifest: %u files, %u rows (%u rescanned)\n", count, totalRows(), rescanned);
+  }
+  
+  // Called after every commit of a day file
+  void update(const char* path, uint32_t rowsAdded, uint32_t bytes, uint32_t firstTs, uint32_t lastTs) {
+    int index = find(path);
+    if (index < 0) {
+      ManifestEntry entry;
+      memset(&entry, 0, sizeof(entry));
+      strncpy(entry.name, path, sizeof(entry.name) - 1);
+      index = add(entry);
+      if (index < 0) {
+        return;
+      }
+    }
+    
+    ManifestEntry& entry = entries[index];
+    if (entry.rows == 0 || entry.firstTs == 0) {
+      entry.firstTs = firstTs;
+    }
+    entry.rows += rowsAdded;
+    entry.bytes = bytes;
+    if (lastTs != 0) {
+      entry.lastTs = lastTs;
+    }
+    writeEntry(index);
+  }
+  
+  void rename(const char* from, const char* to) {
+    int index = find(from);
+    if (index < 0) {
+      return;
+    }
+    memset(entries[index].name, 0, sizeof(entries[index].name));
+    strncpy(entries[index].name, to, sizeof(entries[index].name) - 1);
+    writeEntry(index);
+  }
+  
+  void close() {
+    if (fileOpen) {
+      manifestFile.close();
+      fileOpen = false;
+    }
+  }
+  
+  uint32_t size() const {
+    return count;
+  }
+  
+  uint32_t totalRows() const {
+    uint32_t total = 0;
+    for (uint32_t i = 0; i < count; i++) {
+      total += entries[i].rows;
+    }
+    return total;
+  }
+  
+  const ManifestEntry* get(const char* path) const {
+    int index = find(path);
+    return index >= 0 ? &entries[index] : nullptr;
+  }
+  
+  // Fill out with up to limit entries starting at offset in the given order.
+  // Returns the number of entries written.
+  uint32_t page(ManifestEntry* out, uint32_t offset, uint32_t limit, ManifestSort sort, bool descending) const {
+    if (offset >= count || limit == 0) {
+      return 0;
+    }
+    
+    uint16_t* order = (uint16_t*)malloc(count * sizeof(uint16_t));
+    if (!order) {
+      return 0;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+      order[i] = i;
+    }
+    
+    const ManifestEntry* e = entries;
+    std::sort(order, order + count, [e, sort, descending](uint16_t a, uint16_t b) {
+      int cmp;
+      switch (sort) {
+        case SORT_SIZE:  cmp = compare(e[a].bytes, e[b].bytes); break;
+        case SORT_ROWS:  cmp = compare(e[a].rows, e[b].rows); break;
+        case SORT_FIRST: cmp = compare(e[a].firstTs, e[b].firstTs); break;
+        case SORT_LAST:  cmp = compare(e[a].lastTs, e[b].lastTs); break;
+        default:         cmp = 0; break;
+      }
+      if (cmp == 0) {
+        cmp = strcmp(e[a].name, e[b].name);
+      }
+      return descending ? cmp > 0 : cmp < 0;
+    });
+    
+    uint32_t n = std::min(limit, count - offset);
+    for (uint32_t i = 0; i < n; i++) {
+      out[i] = entries[order[offset + i]];
+    }
+    free(order);
+    return n;
+  }
+  
+  // "data_20260104.csv" or "/data_20260104.csv" -> "/data_20260104.csv"
+  // (also .bin and compacted .csv.gz files)
+  static bool dataFilePath(const char* name, char* path, size_t pathSize) {
+    const char* base = name[0] == '/' ? name + 1 : name;
+    size_t len = strlen(base);
+    if (strncmp(base, "data_", 5) != 0 || len < 9 || len + 2 > pathSize) {
+      return false;
+    }
+    const char* ext = base + len - 4;
+    if (strcmp(ext, ".csv") != 0 && strcmp(ext, ".bin") != 0 && !Gzip::isCompressed(base)) {
+      return false;
+    }
+    snprintf(path, pathSize, "/%s", base);
+    return true;
+  }
+  
+  // "2026-01-04 12:00:00" (local time) or "UTC+1234" -> seconds
+  static uint32_t parseTimestamp(const char* text) {
+    if (strncmp(text, "UTC+", 4) == 0) {
+      return strtoul(text + 4, nullptr, 10);
+    }
+    struct tm timeinfo;
+    memset(&timeinfo, 0, sizeof(timeinfo));
+    if (sscanf(text, "%d-%d-%d %d:%d:%d", &timeinfo.tm_year, &timeinfo.tm_mon, &timeinfo.tm_mday,
+               &timeinfo.tm_hour, &timeinfo.tm_min, &timeinfo.tm_sec) != 6) {
+      return 0;
+    }
+    timeinfo.tm_year -= 1900;
+    timeinfo.tm_mon -= 1;
+    timeinfo.tm_isdst = -1;
+    time_t t = mktime(&timeinfo);
+    return t > 0 ? (uint32_t)t : 0;
+  }
+
+private:
+  static const uint32_t FLAG_STALE = 0x80000000;  // In memory only, during begin()
+  static const uint32_t HEADER_SIZE = 8;           // MAGIC + VERSION
+  
+  ManifestEntry* entries;
+  uint32_t count;
+  uint32_t capacity;
+  File manifestFile;
+  bool fileOpen;
+  
+  static int compare(uint32_t a, uint32_t b) {
+    return a < b ? -1 : (a > b ? 1 : 0);
+  }
+  
+  int find(const char* path) const {
+    for (uint32_t i = 0; i < count; i++) {
+      if (strncmp(entries[i].name, path, sizeof(entries[i].name)) == 0) {
+        return i;
+      }
+    }
+    return -1;
+  }
+  
+  int add(const ManifestEntry& entry) {
+    if (count == capacity) {
+      uint32_t newCapacity = capacity ? capacity * 2 : 64;
+      size_t bytes = newCapacity * sizeof(ManifestEntry);
+      ManifestEntry* grown = (ManifestEntry*)(psramFound() ? ps_realloc(entries, bytes)
+                                                           : realloc(entries, bytes));
+      if (!grown) {
+        Serial.println("Manifest: out of memory");
+        return -1;
+      }
+      entries = grown;
+      capacity = newCapacity;
+    }
+    entries[count] = entry;
+    return count++;
+  }
+  
+  void load() {
+    File file = SD.open(PATH, FILE_READ);
+    if (!file) {
+      return;
+    }
+    
+    uint32_t header[2];
+    if (file.read((uint8_t*)header, sizeof(header)) != sizeof(header) ||
+        header[0] != MAGIC || header[1] != VERSION) {
+      Serial.println("Manifest: unknown format, rebuilding");
+      file.close();
+      return;
+    }
+    
+    ManifestEntry entry;
+    while (file.read((uint8_t*)&entry, sizeof(entry)) == sizeof(entry)) {
+      entry.name[sizeof(entry.name) - 1] = '\0';
+      if (add(entry) < 0) {
+        break;
+      }
+    }
+    file.close();
+  }
+  
+  // Rewrite the whole manifest (after reconciling at boot)
+  void save() {
+    close();
+    File file = SD.open(PATH, FILE_WRITE);
+    if (!file) {
+      Serial.println("Manifest: failed to write");
+      return;
+    }
+    uint32_t header[2] = {MAGIC, VERSION};
+    file.write((const uint8_t*)header, sizeof(header));
+    for (uint32_t i = 0; i < count; i++) {
+      ManifestEntry entry = entries[i];
+      entry.flags &= ~FLAG_STALE;
+      file.write((const uint8_t*)&entry, sizeof(entry));
+    }
+    file.close();
+  }
+  
+  // Update a single entry in place
+  void writeEntry(uint32_t index) {
+    if (!fileOpen) {
+      if (!SD.exists(PATH)) {
+        save();
+      }
+      manifestFile = SD.open(PATH, "r+");
+      fileOpen = manifestFile;
+      if (!fileOpen) {
+        return;
+      }
+    }
+    manifestFile.seek(HEADER_SIZE + index * sizeof(ManifestEntry));
+    manifestFile.write((const uint8_t*)&entries[index], sizeof(ManifestEntry));
+    manifestFile.flush();
+  }
+  
+  // End of the data before any zero padding: CSV text never contains zero
+  // bytes, so it ends after the last non-zero byte; a binary file ends at the
+  // record boundary after it
+  static uint32_t dataEnd(File& file, const char* path) {
+    uint8_t buf[512];
+    uint32_t end = file.size();
+    while (end > 0) {
+      uint32_t chunk = std::min(end, (uint32_t)sizeof(buf));
+      file.seek(end - chunk);
+      if (file.read(buf, chunk) != chunk) {
+        return file.size();  // Can't tell - leave the file alone
+      }
+      uint32_t i = chunk;
+      while (i > 0 && buf[i - 1] == 0) {
+        i--;
+      }
+      if (i > 0) {
+        end = end - chunk + i;
+        break;
+      }
+      end -= chunk;
+    }
+    
+    BinLogHeader hdr;
+    if (BinLog::isBinaryFile(path) && BinLog::readHeader(file, hdr)) {
+      uint32_t start = BinLog::dataOffset(hdr);
+      if (end > start) {
+        uint32_t records = (end - start + hdr.recordSize - 1) / hdr.recordSize;
+        end = std::min(file.size(), (size_t)(start + records * hdr.recordSize));
+      }
+    }
+    return end;
+  }
+  
+  // Build an entry from the file contents (boot-time fallback)
+  void scanFile(File& file, const char* path, ManifestEntry& entry) {
+    memset(&entry, 0, sizeof(entry));
+    strncpy(entry.name, path, sizeof(entry.name) - 1);
+    entry.bytes = file.size();
+    
+    if (Gzip::isCompressed(path)) {
+      Gzip::readInfo(file, entry.rows, entry.firstTs, entry.lastTs);
+      return;
+    }
+    
+    if (BinLog::isBinaryFile(path)) {
+      BinLogHeader hdr;
+      if (!BinLog::readHeader(file, hdr)) {
+        return;
+      }
+      entry.rows = BinLog::recordCount(hdr, file.size());
+      if (entry.rows > 0) {
+        uint32_t ts;
+        file.seek(BinLog::dataOffset(hdr));
+        file.read((uint8_t*)&ts, 4);
+        entry.firstTs = ts;
+        file.seek(BinLog::dataOffset(hdr) + (entry.rows - 1) * hdr.recordSize);
+        file.read((uint8_t*)&ts, 4);
+        entry.lastTs = ts;
+      }
+      return;
+    }
+    
+    // CSV: count newlines in chunks, remembering where the last two lines start
+    const size_t chunkSize = 4096;
+    uint8_t* buf = (uint8_t*)malloc(chunkSize);
+    if (!buf) {
+      return;
+    }
+    
+    uint32_t lines = 0;
+    uint32_t pos = 0;
+    uint32_t secondLine = 0;   // Start of the first data row
+    uint32_t lastLine = 0;     // Start of the last complete line
+    uint32_t prevLine = 0;
+    
+    file.seek(0);
+    size_t got;
+    while ((got = file.read(buf, chunkSize)) > 0) {
+      for (size_t i = 0; i < got; i++) {
+        if (buf[i] == '\n') {
+          lines++;
+          if (lines == 1) {
+            secondLine = pos + i + 1;
+          }
+          lastLine = prevLine;
+          prevLine = pos + i + 1;
+        }
+      }
+      pos += got;
+    }
+    free(buf);
+    
+    // The first line is the header
+    entry.rows = lines > 0 ? lines - 1 : 0;
+    if (entry.rows > 0) {
+      entry.firstTs = readTimestampAt(file, secondLine);
+      entry.lastTs = readTimestampAt(file, lastLine);
+    }
+  }
+  
+  uint32_t readTimestampAt(File& file, uint32_t offset) {
+    char text[24];
+    file.seek(offset);
+    size_t got = file.read((uint8_t*)text, sizeof(text) - 1);
+    text[got] = '\0';
+    char* comma = strchr(text, ',');
+    if (comma) {
+      *comma = '\0';
+    }
+    return parseTimestamp(text);
+  }
+};
+
+#endif // MANIFEST_H
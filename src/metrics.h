@@ -0,0 +1,197 @@
+/*
+ * Metrics for OmniLogger
+ * Latency histograms of hot paths and memory gauges for /api/metrics
+ *
+ * Copyright (C) 2024 NortonTech3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+
+// Latency of an operation, for comparing cards and sensors in the field
+struct LatencyStats {
+  static const int BUCKETS = 8;
+  
+  uint32_t count;
+  uint64_t totalUs;
+  uint32_t maxUs;
+  uint32_t histogram[BUCKETS];  // <1ms, <2ms, <5ms, <10ms, <20ms, <50ms, <100ms, >=100ms
+  
+  LatencyStats() {
+    reset();
+  }
+  
+  void reset() {
+    count = 0;
+    totalUs = 0;
+    maxUs = 0;
+    memset(histogram, 0, sizeof(histogram));
+  }
+  
+  void record(uint32_t us) {
+    count++;
+    totalUs += us;
+    if (us > maxUs) {
+      maxUs = us;
+    }
+    int bucket = 0;
+    while (bucket < BUCKETS - 1 && us >= limitUs(bucket)) {
+      bucket++;
+    }
+    histogram[bucket]++;
+  }
+  
+  uint32_t averageUs() const {
+    return count > 0 ? totalUs / count : 0;
+  }
+  
+  // Upper bound of a bucket (the last one has none)
+  static uint32_t limitUs(int bucket) {
+    static const uint32_t limits[BUCKETS - 1] = {1000, 2000, 5000, 10000, 20000, 50000, 100000};
+    return limits[bucket];
+  }
+};
+
+// Operations timed by ScopedTimer, in the order of their names below
+enum MetricId {
+  METRIC_ACQUISITION = 0,  // startAcquisition() until the last conversion is collected
+  METRIC_READ_BME280,
+  METRIC_READ_DHT22,
+  METRIC_READ_DS18B20,
+  METRIC_READ_ANALOG,
+  METRIC_READ_ANALOG_FAST,
+  METRIC_SD_OPEN,          // Day file open on rollover (sd_write/sd_commit live in DataLogger)
+  METRIC_SD_CLOSE,
+  METRIC_BUFFER_FLUSH,
+  METRIC_NVS_PUT,
+  METRIC_DOWNLOAD_SLICE,
+  METRIC_HTTP_ASSET,
+  METRIC_HTTP_STATUS,
+  METRIC_HTTP_SENSORS,
+  METRIC_HTTP_SETTINGS,
+  METRIC_HTTP_DATA,
+  METRIC_HTTP_RECENT,
+  METRIC_HTTP_EVENTS,
+  METRIC_HTTP_FILES,
+  METRIC_HTTP_DOWNLOAD,
+  METRIC_HTTP_ARCHIVE,
+  METRIC_HTTP_FLUSH,
+  METRIC_HTTP_METRICS,
+  METRIC_UPLINK_PREPARE,   // Reading an uplink batch from the card
+  METRIC_UPLINK_POST,      // Compressing and sending it, until the server's answer
+  METRIC_COMPACT_SLICE,    // One slice of gzipping a closed day file
+  METRIC_COUNT
+};
+
+// Fixed table of histograms in static storage, one per MetricId. Each
+// operation is timed from one task at a time; /api/metrics reads them
+// without a lock and may see a sample half recorded, which is fine for
+// a scraper.
+class Metrics {
+public:
+  static void record(MetricId id, uint32_t us) {
+    stats()[id].record(us);
+  }
+  
+  static const LatencyStats& get(MetricId id) {
+    return stats()[id];
+  }
+  
+  static const char* name(MetricId id) {
+    static const char* const names[METRIC_COUNT] = {
+      "acquisition", "read_bme280", "read_dht22", "read_ds18b20", "read_analog", "read_analog_fast",
+      "sd_open", "sd_close", "buffer_flush", "nvs_put", "download_slice",
+      "http_asset", "http_status", "http_sensors", "http_settings", "http_data", "http_recent",
+      "http_events", "http_files", "http_download", "http_archive", "http_flush", "http_metrics",
+      "uplink_prepare", "uplink_post", "compact_slice"
+    };
+    return names[id];
+  }
+  
+  // CPU cycles to microseconds (the cycle counter runs at the CPU clock)
+  static uint32_t cyclesToUs(uint32_t cycles) {
+    return cycles / getCpuFrequencyMhz();
+  }
+  
+  // Prometheus text format: one histogram family, labelled by operation
+  static void beginHistograms(Print& out) {
+    out.print("# HELP omnilogger_duration_seconds Duration of timed operations\n"
+              "# TYPE omnilogger_duration_seconds histogram\n");
+  }
+  
+  static void writeHistogram(Print& out, const char* op, const LatencyStats& stats) {
+    uint32_t cumulative = 0;
+    for (int i = 0; i < LatencyStats::BUCKETS - 1; i++) {
+      cumulative += stats.histogram[i];
+      out.printf("omnilogger_duration_seconds_bucket{op=\"%s\",le=\"%g\"} %lu\n",
+                 op, LatencyStats::limitUs(i) / 1e6, (unsigned long)cumulative);
+    }
+    out.printf("omnilogger_duration_seconds_bucket{op=\"%s\",le=\"+Inf\"} %lu\n", op, (unsigned long)stats.count);
+    out.printf("omnilogger_duration_seconds_sum{op=\"%s\"} %.6f\n", op, stats.totalUs / 1e6);
+    out.printf("omnilogger_duration_seconds_count{op=\"%s\"} %lu\n", op, (unsigned long)stats.count);
+  }
+  
+  static void writeGauge(Print& out, const char* name, const char* help, double value) {
+    out.printf("# HELP %s %s\n# TYPE %s gauge\n%s %.0f\n", name, help, name, name, value);
+  }
+  
+  static void writeCounter(Print& out, const char* name, const char* help, double value) {
+    out.printf("# HELP %s %s\n# TYPE %s counter\n%s %.0f\n", name, help, name, name, value);
+  }
+  
+  // Heap, PSRAM and largest free block (fragmentation) gauges
+  static void writeMemory(Print& out) {
+    writeGauge(out, "omnilogger_heap_free_bytes", "Free internal heap",
+               heap_caps_get_free_size(MALLOC_CAP_INTERNAL));
+    writeGauge(out, "omnilogger_heap_min_free_bytes", "Lowest free internal heap since boot",
+               heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL));
+    writeGauge(out, "omnilogger_heap_largest_free_block_bytes", "Largest free internal heap block",
+               heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL));
+    if (psramFound()) {
+      writeGauge(out, "omnilogger_psram_free_bytes", "Free PSRAM",
+                 heap_caps_get_free_size(MALLOC_CAP_SPIRAM));
+      writeGauge(out, "omnilogger_psram_largest_free_block_bytes", "Largest free PSRAM block",
+                 heap_caps_get_largest_free_block(MALLOC_CAP_SPIRAM));
+    }
+  }
+
+private:
+  static LatencyStats* stats() {
+    static LatencyStats all[METRIC_COUNT];
+    return all;
+  }
+};
+
+// Times its scope with the CPU cycle counter (a register read, unlike
+// micros()), so it can wrap the hot paths. Scopes must be shorter than one
+// counter wrap, about 53 seconds at 80MHz.
+class ScopedTimer {
+public:
+  explicit ScopedTimer(MetricId id) : id(id), start(ESP.getCycleCount()) {}
+  
+  ~ScopedTimer() {
+    Metrics::record(id, Metrics::cyclesToUs(ESP.getCycleCount() - start));
+  }
+
+private:
+  MetricId id;
+  uint32_t start;
+};
+
+#endif // METRICS_H
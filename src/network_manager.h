@@ -0,0 +1,326 @@
+/*
+ * Network Manager for OmniLogger
+ * Event-driven WiFi connect, reconnect, AP fallback and NTP sync
+ *
+ * Copyright (C) 2024 NortonTech3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef NETWORK_MANAGER_H
+#define NETWORK_MANAGER_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <esp_wifi.h>
+#include <esp_task_wdt.h>
+#include <esp_sntp.h>
+#include "config.h"
+
+enum NetState {
+  NET_OFF = 0,
+  NET_CONNECTING,  // Station started, waiting for an address
+  NET_CONNECTED,
+  NET_FALLBACK,    // Access point up, station retried on the backoff schedule
+  NET_AP_ONLY      // No network configured
+};
+
+// Nothing here waits for the network. The WiFi event and SNTP callbacks
+// (which run in the event and lwIP tasks) only set flags; service(), called
+// from the network task or loop(), acts on them and on the deadlines:
+//
+//   start -> CONNECTING --got IP--> CONNECTED --link lost--> CONNECTING
+//   CONNECTING --CONNECT_WINDOW_MS without an address--> FALLBACK
+//   FALLBACK: AP up; the station tries again after 30s, then 1, 2, 4, 8
+//   and 10 minutes, back to 30s once connected
+//
+// SNTP is started once and resyncs by itself every 12 hours; a reconnect
+// after the resync came due restarts it at once.
+class NetworkManager {
+public:
+  static const uint32_t CONNECT_WINDOW_MS = 15000;   // Per connect attempt before giving up on it
+  static const uint32_t REJOIN_DELAY_MS = 3000;      // Between joins within one attempt
+  static const uint32_t RETRY_MIN_MS = 30000;
+  static const uint32_t RETRY_MAX_MS = 600000;
+  static const uint32_t RESYNC_INTERVAL_MS = 12UL * 60 * 60 * 1000;
+  
+  NetworkManager() : config(nullptr), state(NET_OFF), stateSince(0), nextJoin(0), joinStart(0), joining(false),
+                     retryMs(RETRY_MIN_MS), failures(0), apUp(false), sntpStarted(false),
+                     timeSynced(false), lastSyncMs(0), timezoneOffset(0) {}
+  
+  void begin(const Config* cfg) {
+    config = cfg;
+    WiFi.onEvent(onWiFiEvent);
+    sntp_set_time_sync_notification_cb(onTimeSync);
+    start();
+  }
+  
+  // Bring the radio up and return at once; service() does the rest
+  void start() {
+    pending = 0;
+    joining = false;
+    retryMs = RETRY_MIN_MS;
+    if (strlen(config->wifiSSID) == 0) {
+      WiFi.mode(WIFI_AP);
+      startAP();
+      setState(NET_AP_ONLY);
+    } else {
+      Serial.printf("Connecting to WiFi: %s\n", config->wifiSSID);
+      WiFi.mode(WIFI_STA);
+      WiFi.setAutoReconnect(false);  // Reconnects follow the schedule above
+      apUp = false;
+      setState(NET_CONNECTING);
+      join();
+    }
+    startSntp();
+  }
+  
+  void stop() {
+    WiFi.disconnect(true);
+    WiFi.mode(WIFI_OFF);
+    apUp = false;
+    joining = false;
+    setState(NET_OFF);
+  }
+  
+  void service() {
+    uint32_t events = __atomic_exchange_n(&pending, 0, __ATOMIC_SEQ_CST);
+    unsigned long now = millis();
+    if (state == NET_OFF || state == NET_AP_ONLY) {
+      events &= EVENT_TIME_SYNC;
+    }
+    
+    if (events & EVENT_GOT_IP) {
+      connected();
+    }
+    // Both bits set: the link came up and went again since the last call
+    if ((events & EVENT_DISCONNECTED) && WiFi.status() != WL_CONNECTED) {
+      if (state == NET_CONNECTED) {
+        Serial.println("WiFi link lost - reconnecting in the background");
+        failures++;
+        setState(NET_CONNECTING);
+        join();
+      } else if (joining && state == NET_CONNECTING) {
+        // A failed join: try again shortly within this attempt
+        joining = false;
+        nextJoin = now + REJOIN_DELAY_MS;
+      } else if (joining && state == NET_FALLBACK) {
+        backOff(now);
+      }
+    }
+    
+    // A new offset from the settings page takes effect without a reboot
+    if (sntpStarted && config->timezoneOffset != timezoneOffset) {
+      configureTime();
+    }
+    
+    if (events & EVENT_TIME_SYNC) {
+      bool first = !timeSynced;
+      timeSynced = true;
+      lastSyncMs = now;
+      if (first) {
+        char text[24];
+        time_t t = time(nullptr);
+        struct tm timeinfo;
+        localtime_r(&t, &timeinfo);
+        strftime(text, sizeof(text), "%Y-%m-%d %H:%M:%S", &timeinfo);
+        Serial.printf("Time synchronized: %s\n", text);
+      }
+    }
+    
+    switch (state) {
+      case NET_CONNECTING:
+        if (now - stateSince >= CONNECT_WINDOW_MS) {
+          failures++;
+          Serial.printf("WiFi connect failed - access point up, retrying in %lus\n",
+                        (unsigned long)(retryMs / 1000));
+          WiFi.disconnect(false);
+          WiFi.mode(WIFI_AP_STA);
+          startAP();
+          joining = false;
+          nextJoin = now + retryMs;
+          setState(NET_FALLBACK);
+        } else if (!joining && (long)(now - nextJoin) >= 0) {
+          join();
+        }
+        break;
+      
+      case NET_FALLBACK:
+        if (joining && now - joinStart >= CONNECT_WINDOW_MS) {
+          WiFi.disconnect(false);
+          backOff(now);
+        } else if (!joining && (long)(now - nextJoin) >= 0) {
+          join();
+        }
+        break;
+      
+      case NET_CONNECTED:
+        // Keep the access point only while someone is using it
+        if (apUp && WiFi.softAPgetStationNum() == 0) {
+          WiFi.softAPdisconnect(true);
+          apUp = false;
+          esp_wifi_set_ps(WIFI_PS_MIN_MODEM);
+          Serial.println("Access point closed - station connected");
+        }
+        break;
+      
+      default:
+        break;
+    }
+  }
+  
+  // Deep sleep full wakes: give the link and the clock a bounded chance
+  // before the radio goes off. Samples have been taken already.
+  void waitForSync(uint32_t timeoutMs) {
+    unsigned long start = millis();
+    while (millis() - start < timeoutMs && state != NET_FALLBACK && state != NET_AP_ONLY &&
+           state != NET_OFF && !(state == NET_CONNECTED && syncedRecently())) {
+      service();
+      esp_task_wdt_reset();
+      delay(50);
+    }
+  }
+  
+  NetState getState() const {
+    return state;
+  }
+  
+  const char* getStateName() const {
+    switch (state) {
+      case NET_CONNECTING: return "connecting";
+      case NET_CONNECTED:  return "connected";
+      case NET_FALLBACK:   return "fallback";
+      case NET_AP_ONLY:    return "ap";
+      default:             return "off";
+    }
+  }
+  
+  bool isConnected() const {
+    return state == NET_CONNECTED;
+  }
+  
+  // NTP has set the clock at least once since boot
+  bool isTimeSynced() const {
+    return timeSynced;
+  }
+  
+  // Seconds since the last NTP sync, -1 if none since boot
+  int32_t getLastSyncAge() const {
+    return timeSynced ? (int32_t)((millis() - lastSyncMs) / 1000) : -1;
+  }
+  
+  // Lost links and connect attempts that ran out of time
+  uint32_t getFailures() const {
+    return failures;
+  }
+
+private:
+  static const uint32_t EVENT_GOT_IP = 0x01;
+  static const uint32_t EVENT_DISCONNECTED = 0x02;
+  static const uint32_t EVENT_TIME_SYNC = 0x04;
+  
+  static uint32_t pending;  // EVENT_* bits set by the callbacks
+  
+  const Config* config;
+  NetState state;
+  unsigned long stateSince;
+  unsigned long nextJoin;   // Next WiFi.begin() when not joining
+  unsigned long joinStart;
+  bool joining;             // WiFi.begin() issued, no result yet
+  uint32_t retryMs;         // Current fallback backoff
+  uint32_t failures;
+  bool apUp;
+  bool sntpStarted;
+  bool timeSynced;
+  unsigned long lastSyncMs;
+  int timezoneOffset;       // Offset SNTP was configured with
+  
+  static void onWiFiEvent(WiFiEvent_t event, WiFiEventInfo_t info) {
+    if (event == ARDUINO_EVENT_WIFI_STA_GOT_IP) {
+      __atomic_fetch_or(&pending, EVENT_GOT_IP, __ATOMIC_SEQ_CST);
+    } else if (event == ARDUINO_EVENT_WIFI_STA_DISCONNECTED) {
+      __atomic_fetch_or(&pending, EVENT_DISCONNECTED, __ATOMIC_SEQ_CST);
+    }
+  }
+  
+  static void onTimeSync(struct timeval* tv) {
+    __atomic_fetch_or(&pending, EVENT_TIME_SYNC, __ATOMIC_SEQ_CST);
+  }
+  
+  void setState(NetState next) {
+    state = next;
+    stateSince = millis();
+  }
+  
+  void join() {
+    WiFi.begin(config->wifiSSID, config->wifiPassword);
+    joining = true;
+    joinStart = millis();
+  }
+  
+  // A fallback join failed: wait longer before the next one
+  void backOff(unsigned long now) {
+    joining = false;
+    failures++;
+    retryMs = retryMs * 2 > RETRY_MAX_MS ? RETRY_MAX_MS : retryMs * 2;
+    nextJoin = now + retryMs;
+  }
+  
+  void startAP() {
+    WiFi.softAP(config->apSSID, config->apPassword);
+    apUp = true;
+    Serial.print("AP IP address: ");
+    Serial.println(WiFi.softAPIP());
+  }
+  
+  void connected() {
+    bool wasFallback = state == NET_FALLBACK;
+    setState(NET_CONNECTED);
+    joining = false;
+    retryMs = RETRY_MIN_MS;
+    Serial.print("WiFi connected, IP address: ");
+    Serial.println(WiFi.localIP());
+    if (!wasFallback) {
+      // Modem sleep saves power while keeping the connection; not with the AP up
+      esp_wifi_set_ps(WIFI_PS_MIN_MODEM);
+    }
+    // The periodic resync came due while the link was down
+    if (sntpStarted && timeSynced && millis() - lastSyncMs >= RESYNC_INTERVAL_MS) {
+      sntp_restart();
+    }
+  }
+  
+  void startSntp() {
+    if (sntpStarted) {
+      return;
+    }
+    sntp_set_sync_interval(RESYNC_INTERVAL_MS);
+    configureTime();
+    sntpStarted = true;
+  }
+  
+  // Starts SNTP (again); it keeps trying until a server answers
+  void configureTime() {
+    timezoneOffset = config->timezoneOffset;
+    configTime(timezoneOffset * 3600, 0, "pool.ntp.org", "time.nist.gov", "time.google.com");
+  }
+  
+  bool syncedRecently() const {
+    return timeSynced && millis() - lastSyncMs < RESYNC_INTERVAL_MS;
+  }
+};
+
+uint32_t NetworkManager::pending = 0;
+
+#endif // NETWORK_MANAGER_H
@@ -0,0 +1,130 @@
+/*
+ * Recent Samples for OmniLogger
+ * In-memory ring of the latest measurements for live views
+ *
+ * Copyright (C) 2024 NortonTech3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef RECENT_SAMPLES_H
+#define RECENT_SAMPLES_H
+
+#include <Arduino.h>
+#include <cmath>
+#include "config.h"
+
+// One measurement, channels in getCSVHeader column order
+struct RecentSample {
+  static const int MAX_CHANNELS = Config::MAX_CHANNELS;
+  
+  uint32_t seq;        // Monotonic since boot, first sample is 1
+  uint32_t timestamp;  // Epoch seconds, or seconds since boot when not synced
+  bool synced;
+  uint8_t channels;
+  uint64_t validMask;  // Bit per channel
+  float values[MAX_CHANNELS];
+};
+
+// Fixed-capacity ring of the last samples, so live views never touch the SD
+// card. Readers ask for everything after the last sequence number they saw.
+class RecentSamples {
+public:
+  static const uint32_t PSRAM_CAPACITY = 1024;  // ~290KB at 64 channels
+  static const uint32_t HEAP_CAPACITY = 64;
+  
+  RecentSamples() : ring(nullptr), capacity(0), nextSeq(1) {}
+  
+  ~RecentSamples() {
+    if (ring) {
+      free(ring);
+    }
+  }
+  
+  bool begin() {
+    if (ring) {
+      return true;
+    }
+    if (psramFound()) {
+      ring = (RecentSample*)ps_malloc(PSRAM_CAPACITY * sizeof(RecentSample));
+      capacity = ring ? PSRAM_CAPACITY : 0;
+    }
+    if (!ring) {
+      ring = (RecentSample*)malloc(HEAP_CAPACITY * sizeof(RecentSample));
+      capacity = ring ? HEAP_CAPACITY : 0;
+    }
+    if (!ring) {
+      Serial.println("No memory for recent samples");
+      return false;
+    }
+    Serial.printf("Recent samples: %u in %s\n", capacity, capacity == PSRAM_CAPACITY ? "PSRAM" : "heap");
+    return true;
+  }
+  
+  void push(uint32_t timestamp, bool synced, const float* values, const bool* valid, int channels) {
+    if (!ring) {
+      return;
+    }
+    // Writer and readers run in different tasks; a sample is small enough
+    // to copy inside a critical section
+    portENTER_CRITICAL(&lock);
+    RecentSample& sample = ring[nextSeq % capacity];
+    sample.seq = nextSeq;
+    sample.timestamp = timestamp;
+    sample.synced = synced;
+    sample.channels = std::min(channels, RecentSample::MAX_CHANNELS);
+    sample.validMask = 0;
+    for (int i = 0; i < sample.channels; i++) {
+      sample.values[i] = values[i];
+      if (valid[i] && !isnan(values[i])) {
+        sample.validMask |= (1ULL << i);
+      }
+    }
+    nextSeq++;
+    portEXIT_CRITICAL(&lock);
+  }
+  
+  // Sequence number of the newest sample (0 = none yet)
+  uint32_t lastSeq() const {
+    return nextSeq - 1;
+  }
+  
+  // Sequence number of the oldest sample still held
+  uint32_t firstSeq() const {
+    return nextSeq > capacity ? nextSeq - capacity : 1;
+  }
+  
+  // Copy of a sample by sequence number; false if not (or no longer) held
+  bool get(uint32_t seq, RecentSample& out) const {
+    portENTER_CRITICAL(&lock);
+    bool held = ring && seq != 0 && seq >= firstSeq() && seq <= lastSeq();
+    if (held) {
+      out = ring[seq % capacity];
+    }
+    portEXIT_CRITICAL(&lock);
+    return held;
+  }
+  
+  uint32_t getCapacity() const {
+    return capacity;
+  }
+
+private:
+  RecentSample* ring;
+  uint32_t capacity;
+  uint32_t nextSeq;
+  mutable portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+};
+
+#endif // RECENT_SAMPLES_H
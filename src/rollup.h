@@ -0,0 +1,447 @@
+/*
+ * Rollups for OmniLogger
+ * Per-minute and per-hour aggregates for long-range queries
+ *
+ * Copyright (C) 2024 NortonTech3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ROLLUP_H
+#define ROLLUP_H
+
+#include <Arduino.h>
+#include <SD.h>
+#include <cmath>
+#include "config.h"
+
+// Files: "/rollup_1m_YYYYMM.dat" (one record per minute) and
+// "/rollup_1h_YYYY.dat" (one record per hour), named by local time.
+//   [RollupFileHeader][CSV header text][record][record]...
+// Record layout (little endian):
+//   uint32 bucket start (epoch) | per channel: uint32 count, float mean, float min, float max
+// Records are appended when a bucket closes, so files are in time order.
+struct RollupFileHeader {
+  char magic[4];           // "OMLR"
+  uint8_t version;
+  uint8_t reserved;
+  uint16_t channels;
+  uint16_t recordSize;
+  uint16_t textLength;     // Length of the CSV header text after this struct
+  uint32_t bucketSeconds;
+};
+
+struct RollupChannel {
+  uint32_t count;  // Valid samples in the bucket, 0 = no data
+  float mean;
+  float min;
+  float max;
+};
+
+enum RollupTier : uint8_t {
+  ROLLUP_1M = 0,
+  ROLLUP_1H = 1,
+  ROLLUP_TIERS = 2
+};
+
+// Open buckets. Small enough for RTC memory, so deep sleep doesn't lose them.
+struct RollupState {
+  static const int MAX_CHANNELS = Config::MAX_CHANNELS;
+  
+  struct Accumulator {
+    uint32_t count;
+    float min;
+    float max;
+    double sum;
+  };
+  
+  uint16_t channels;
+  uint32_t bucketStart[ROLLUP_TIERS];  // 0 = no open bucket
+  Accumulator acc[ROLLUP_TIERS][MAX_CHANNELS];
+};
+
+class RollupManager {
+public:
+  static const uint8_t VERSION = 1;
+  static const int MAX_CHANNELS = RollupState::MAX_CHANNELS;
+  static const int PENDING_CAPACITY = 4;  // Closed buckets per tier waiting for the SD card
+  static const size_t MAX_RECORD_SIZE = 4 + sizeof(RollupChannel) * MAX_CHANNELS;
+  
+  RollupManager() : state(nullptr), pendingHead(0), pendingCount(0), dropped(0) {
+    verifiedPath[0][0] = '\0';
+    verifiedPath[1][0] = '\0';
+  }
+  
+  // state survives deep sleep when it lives in RTC memory; keep it only on a wake
+  void begin(RollupState* rtcState, bool keep) {
+    state = rtcState;
+    if (!keep) {
+      memset(state, 0, sizeof(RollupState));
+    }
+  }
+  
+  static uint32_t bucketSeconds(RollupTier tier) {
+    return tier == ROLLUP_1M ? 60 : 3600;
+  }
+  
+  static uint16_t recordSize(uint16_t channels) {
+    return 4 + sizeof(RollupChannel) * channels;
+  }
+  
+  static void filePath(RollupTier tier, uint32_t bucketStart, char* out, size_t outSize) {
+    time_t t = bucketStart;
+    struct tm timeinfo;
+    localtime_r(&t, &timeinfo);
+    if (tier == ROLLUP_1M) {
+      snprintf(out, outSize, "/rollup_1m_%04d%02d.dat", timeinfo.tm_year + 1900, timeinfo.tm_mon + 1);
+    } else {
+      snprintf(out, outSize, "/rollup_1h_%04d.dat", timeinfo.tm_year + 1900);
+    }
+  }
+  
+  // Fold one sample into both tiers: O(1) per channel, no SD access.
+  // Only call with a synchronized clock.
+  void add(uint32_t timestamp, const float* values, const bool* valid, int channels) {
+    if (!state) {
+      return;
+    }
+    channels = std::min(channels, MAX_CHANNELS);
+    
+    portENTER_CRITICAL(&lock);
+    if (state->channels != channels) {
+      // Different schema (first sample, or sensors changed) - start over
+      memset(state, 0, sizeof(RollupState));
+      state->channels = channels;
+    }
+    
+    for (int tier = 0; tier < ROLLUP_TIERS; tier++) {
+      uint32_t start = timestamp - timestamp % bucketSeconds((RollupTier)tier);
+      if (start != state->bucketStart[tier]) {
+        closeBucket((RollupTier)tier);  // Also when the clock went backwards
+        state->bucketStart[tier] = start;
+      }
+      
+      for (int i = 0; i < channels; i++) {
+        if (!valid[i] || isnan(values[i])) continue;
+        RollupState::Accumulator& a = state->acc[tier][i];
+        if (a.count == 0 || values[i] < a.min) a.min = values[i];
+        if (a.count == 0 || values[i] > a.max) a.max = values[i];
+        a.sum += values[i];
+        a.count++;
+      }
+    }
+    portEXIT_CRITICAL(&lock);
+  }
+  
+  bool hasPending() const {
+    return pendingCount > 0;
+  }
+  
+  // Append closed buckets to their files (caller holds the storage lock and
+  // has the SD card mounted). header is the day file CSV header.
+  void writePending(const String& header) {
+    uint8_t* record = (uint8_t*)malloc(MAX_RECORD_SIZE);
+    if (!record) {
+      return;
+    }
+    
+    while (true) {
+      RollupTier tier = ROLLUP_1M;
+      uint16_t size = 0;
+      portENTER_CRITICAL(&lock);
+      bool have = pendingCount > 0;
+      if (have) {
+        tier = pending[pendingHead].tier;
+        size = pending[pendingHead].size;
+        memcpy(record, pending[pendingHead].data, size);
+      }
+      portEXIT_CRITICAL(&lock);
+      if (!have) {
+        break;
+      }
+      
+      if (!appendRecord(tier, record, size, header)) {
+        break;  // Retried on the next call
+      }
+      
+      portENTER_CRITICAL(&lock);
+      pendingHead = (pendingHead + 1) % (PENDING_CAPACITY * ROLLUP_TIERS);
+      pendingCount--;
+      portEXIT_CRITICAL(&lock);
+    }
+    free(record);
+    
+    if (dropped > 0) {
+      Serial.printf("Rollups: %u closed buckets dropped while the SD card was unavailable\n", dropped);
+      dropped = 0;
+    }
+  }
+  
+  // Buckets with from <= start <= to across the tier's files.
+  // emit(uint32_t start, const RollupChannel* channels, uint16_t count) per bucket.
+  template<typename Emit>
+  static bool query(RollupTier tier, uint32_t from, uint32_t to, uint32_t skip, uint32_t limit,
+                    String& header, bool& more, Emit emit) {
+    more = false;
+    uint8_t* record = (uint8_t*)malloc(MAX_RECORD_SIZE);
+    RollupChannel* channels = (RollupChannel*)malloc(sizeof(RollupChannel) * MAX_CHANNELS);
+    if (!record || !channels) {
+      free(record);
+      free(channels);
+      return false;
+    }
+    
+    uint32_t matched = 0;
+    uint32_t emitted = 0;
+    char path[32];
+    
+    // One file per month or year; step through the range a file at a time
+    for (uint32_t t = from; t <= to; ) {
+      filePath(tier, t, path, sizeof(path));
+      if (!queryFile(path, from, to, skip, limit, matched, emitted, header, more, record, channels, emit)) {
+        break;
+      }
+      uint32_t next = nextFileStart(tier, t);
+      if (next <= t) break;  // Overflow
+      t = next;
+    }
+    
+    free(record);
+    free(channels);
+    return true;
+  }
+
+private:
+  struct PendingRecord {
+    RollupTier tier;
+    uint16_t size;
+    uint8_t data[MAX_RECORD_SIZE];
+  };
+  
+  RollupState* state;
+  PendingRecord pending[PENDING_CAPACITY * ROLLUP_TIERS];
+  int pendingHead;
+  int pendingCount;
+  uint32_t dropped;
+  char verifiedPath[ROLLUP_TIERS][32];  // File whose header matched the schema last time
+  portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+  
+  // Encode the open bucket of a tier into the pending queue (lock held)
+  void closeBucket(RollupTier tier) {
+    if (state->bucketStart[tier] == 0) {
+      return;
+    }
+    
+    if (pendingCount == PENDING_CAPACITY * ROLLUP_TIERS) {
+      pendingHead = (pendingHead + 1) % (PENDING_CAPACITY * ROLLUP_TIERS);  // Drop the oldest
+      pendingCount--;
+      dropped++;
+    }
+    PendingRecord& rec = pending[(pendingHead + pendingCount) % (PENDING_CAPACITY * ROLLUP_TIERS)];
+    pendingCount++;
+    
+    rec.tier = tier;
+    rec.size = recordSize(state->channels);
+    memcpy(rec.data, &state->bucketStart[tier], 4);
+    uint8_t* p = rec.data + 4;
+    for (int i = 0; i < state->channels; i++) {
+      RollupState::Accumulator& a = state->acc[tier][i];
+      RollupChannel ch = {a.count, 0, 0, 0};
+      if (a.count > 0) {
+        ch.mean = a.sum / a.count;
+        ch.min = a.min;
+        ch.max = a.max;
+      }
+      memcpy(p, &ch, sizeof(ch));
+      p += sizeof(ch);
+      a = RollupState::Accumulator();
+    }
+    state->bucketStart[tier] = 0;
+  }
+  
+  bool appendRecord(RollupTier tier, const uint8_t* record, uint16_t size, const String& header) {
+    uint32_t start;
+    memcpy(&start, record, 4);
+    char path[32];
+    filePath(tier, start, path, sizeof(path));
+    
+    if (strcmp(path, verifiedPath[tier]) != 0 && !prepareFile(tier, path, header, size)) {
+      return false;
+    }
+    
+    File file = SD.open(path, FILE_APPEND);
+    if (!file) {
+      Serial.printf("Rollups: failed to open %s\n", path);
+      return false;
+    }
+    bool ok = file.write(record, size) == size;
+    file.close();
+    return ok;
+  }
+  
+  // Create the file with a schema header, or move an older schema aside
+  bool prepareFile(RollupTier tier, const char* path, const String& header, uint16_t size) {
+    File existing = SD.open(path, FILE_READ);
+    if (existing) {
+      RollupFileHeader hdr;
+      String text;
+      bool empty = existing.size() == 0;
+      bool matches = !empty && readHeader(existing, hdr, text) && hdr.recordSize == size && text == header;
+      existing.close();
+      if (matches) {
+        strcpy(verifiedPath[tier], path);
+        return true;
+      }
+      if (!empty && !moveAside(path)) {
+        return false;
+      }
+    }
+    
+    // New file, or an empty one left by a failed create (FILE_WRITE truncates)
+    File file = SD.open(path, FILE_WRITE);
+    if (!file) {
+      Serial.printf("Rollups: failed to create %s\n", path);
+      return false;
+    }
+    RollupFileHeader hdr;
+    memcpy(hdr.magic, "OMLR", 4);
+    hdr.version = VERSION;
+    hdr.reserved = 0;
+    hdr.channels = (size - 4) / sizeof(RollupChannel);
+    hdr.recordSize = size;
+    hdr.textLength = header.length();
+    hdr.bucketSeconds = bucketSeconds(tier);
+    bool ok = file.write((const uint8_t*)&hdr, sizeof(hdr)) == sizeof(hdr) &&
+              file.write((const uint8_t*)header.c_str(), hdr.textLength) == hdr.textLength;
+    file.close();
+    if (ok) {
+      strcpy(verifiedPath[tier], path);
+    }
+    return ok;
+  }
+  
+  static bool moveAside(const char* path) {
+    char renamed[40];
+    for (int n = 1; n < 100; n++) {
+      snprintf(renamed, sizeof(renamed), "%.*s-%d.dat", (int)strlen(path) - 4, path, n);
+      if (!SD.exists(renamed)) {
+        Serial.printf("Rollups: schema changed, moving %s to %s\n", path, renamed);
+        return SD.rename(path, renamed);
+      }
+    }
+    Serial.printf("Rollups: schema changed and no free name for %s\n", path);
+    return false;
+  }
+  
+  // Leaves the file positioned at the first record
+  static bool readHeader(File& file, RollupFileHeader& hdr, String& text) {
+    file.seek(0);
+    if (file.read((uint8_t*)&hdr, sizeof(hdr)) != sizeof(hdr) ||
+        memcmp(hdr.magic, "OMLR", 4) != 0 || hdr.version != VERSION ||
+        hdr.channels > MAX_CHANNELS || hdr.recordSize != recordSize(hdr.channels)) {
+      return false;
+    }
+    text = "";
+    text.reserve(hdr.textLength);
+    char buf[64];
+    size_t remaining = hdr.textLength;
+    while (remaining > 0) {
+      size_t got = file.read((uint8_t*)buf, std::min(remaining, sizeof(buf) - 1));
+      if (got == 0) return false;
+      buf[got] = '\0';
+      text += buf;
+      remaining -= got;
+    }
+    return true;
+  }
+  
+  // Local midnight of the first day of the next month (1m) or year (1h)
+  static uint32_t nextFileStart(RollupTier tier, uint32_t t) {
+    time_t tt = t;
+    struct tm timeinfo;
+    localtime_r(&tt, &timeinfo);
+    timeinfo.tm_mday = 1;
+    timeinfo.tm_hour = 0;
+    timeinfo.tm_min = 0;
+    timeinfo.tm_sec = 0;
+    timeinfo.tm_isdst = -1;
+    if (tier == ROLLUP_1M) {
+      timeinfo.tm_mon += 1;
+    } else {
+      timeinfo.tm_mon = 0;
+      timeinfo.tm_year += 1;
+    }
+    return mktime(&timeinfo);
+  }
+  
+  // Returns false once the limit is reached or the range ends in this file
+  template<typename Emit>
+  static bool queryFile(const char* path, uint32_t from, uint32_t to, uint32_t skip, uint32_t limit,
+                        uint32_t& matched, uint32_t& emitted, String& header, bool& more,
+                        uint8_t* record, RollupChannel* channels, Emit emit) {
+    File file = SD.open(path, FILE_READ);
+    if (!file) {
+      return true;  // No data for this month or year
+    }
+    
+    RollupFileHeader hdr;
+    String text;
+    if (!readHeader(file, hdr, text) || (header.length() > 0 && text != header)) {
+      file.close();
+      return true;  // Unreadable or another schema than the first file - skip it
+    }
+    header = text;
+    
+    // Lower bound of the first bucket >= from
+    size_t dataStart = sizeof(hdr) + hdr.textLength;
+    uint32_t records = file.size() > dataStart ? (file.size() - dataStart) / hdr.recordSize : 0;
+    uint32_t lo = 0;
+    uint32_t hi = records;
+    while (lo < hi) {
+      uint32_t mid = lo + (hi - lo) / 2;
+      uint32_t start = 0;
+      file.seek(dataStart + mid * hdr.recordSize);
+      file.read((uint8_t*)&start, 4);
+      if (start < from) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    
+    file.seek(dataStart + lo * hdr.recordSize);
+    bool keepGoing = true;
+    for (uint32_t i = lo; i < records && file.read(record, hdr.recordSize) == hdr.recordSize; i++) {
+      uint32_t start;
+      memcpy(&start, record, 4);
+      if (start > to) {
+        keepGoing = false;
+        break;
+      }
+      if (matched++ < skip) continue;
+      if (emitted == limit) {
+        more = true;
+        keepGoing = false;
+        break;
+      }
+      memcpy(channels, record + 4, sizeof(RollupChannel) * hdr.channels);
+      emit(start, channels, hdr.channels);
+      emitted++;
+    }
+    file.close();
+    return keepGoing;
+  }
+};
+
+#endif // ROLLUP_H
@@ -0,0 +1,156 @@
+/*
+ * Row Formatting for OmniLogger
+ * Allocation-free text formatting into caller-provided buffers
+ *
+ * Copyright (C) 2024 NortonTech3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ROW_FORMAT_H
+#define ROW_FORMAT_H
+
+#include <Arduino.h>
+
+// Appends text and numbers to a fixed buffer. Floats are rounded to a
+// fixed-point integer and printed with integer arithmetic, which is much
+// cheaper than printf's float path on a core without an FPU. Anything past
+// the capacity is dropped and truncated() is set; the text always stays
+// NUL-terminated.
+class RowWriter {
+public:
+  static const uint8_t MAX_DECIMALS = 3;
+  static const size_t MAX_FIXED_TEXT = 15;  // "-21474836.470" plus margin
+  
+  RowWriter(char* buf, size_t capacity) : buf(buf), cap(capacity), used(0), overflow(false) {
+    if (cap > 0) {
+      buf[0] = '\0';
+    }
+  }
+  
+  RowWriter& text(const char* s) {
+    return text(s, strlen(s));
+  }
+  
+  RowWriter& text(const char* s, size_t len) {
+    if (cap == 0) {
+      overflow |= len > 0;
+      return *this;
+    }
+    size_t room = cap - used - 1;
+    if (len > room) {
+      len = room;
+      overflow = true;
+    }
+    memcpy(buf + used, s, len);
+    used += len;
+    buf[used] = '\0';
+    return *this;
+  }
+  
+  RowWriter& put(char c) {
+    return text(&c, 1);
+  }
+  
+  RowWriter& number(uint32_t v) {
+    char digits[10];
+    return text(digits, appendUnsigned(digits, v) - digits);
+  }
+  
+  // Float rounded to decimals (0..MAX_DECIMALS), e.g. 21.456 at 2 -> "21.46"
+  RowWriter& fixed(float value, uint8_t decimals) {
+    return fixedPoint(toFixed(value, decimals), decimals);
+  }
+  
+  // Already scaled value, e.g. -1234 at 2 decimals -> "-12.34"
+  RowWriter& fixedPoint(int32_t scaled, uint8_t decimals) {
+    char tmp[MAX_FIXED_TEXT];
+    return text(tmp, appendFixed(tmp, scaled, decimals) - tmp);
+  }
+  
+  const char* c_str() const {
+    return buf;
+  }
+  
+  size_t length() const {
+    return used;
+  }
+  
+  bool truncated() const {
+    return overflow;
+  }
+  
+  // value * 10^decimals rounded half away from zero, saturated to the int32
+  // range. NaN gives 0; callers treat it as a missing value.
+  static int32_t toFixed(float value, uint8_t decimals) {
+    static const float scales[MAX_DECIMALS + 1] = {1.0f, 10.0f, 100.0f, 1000.0f};
+    if (isnan(value)) {
+      return 0;
+    }
+    float scaled = value * scales[decimals > MAX_DECIMALS ? MAX_DECIMALS : decimals];
+    if (scaled > 2147483000.0f) scaled = 2147483000.0f;
+    if (scaled < -2147483000.0f) scaled = -2147483000.0f;
+    return (int32_t)lroundf(scaled);
+  }
+  
+  // Unchecked appends for callers that size their buffers up front (at
+  // most MAX_FIXED_TEXT bytes); return the new end, nothing is terminated
+  static char* appendFixed(char* p, int32_t scaled, uint8_t decimals) {
+    static const uint32_t divisors[MAX_DECIMALS + 1] = {1, 10, 100, 1000};
+    if (decimals > MAX_DECIMALS) {
+      decimals = MAX_DECIMALS;
+    }
+    
+    uint32_t mag;
+    if (scaled < 0) {
+      *p++ = '-';
+      mag = (uint32_t)(-(int64_t)scaled);
+    } else {
+      mag = (uint32_t)scaled;
+    }
+    
+    p = appendUnsigned(p, mag / divisors[decimals]);
+    if (decimals > 0) {
+      uint32_t frac = mag % divisors[decimals];
+      *p++ = '.';
+      for (int i = decimals - 1; i >= 0; i--) {
+        p[i] = '0' + frac % 10;
+        frac /= 10;
+      }
+      p += decimals;
+    }
+    return p;
+  }
+  
+  static char* appendUnsigned(char* p, uint32_t v) {
+    char digits[10];
+    int n = 0;
+    do {
+      digits[n++] = '0' + v % 10;
+      v /= 10;
+    } while (v > 0);
+    while (n > 0) {
+      *p++ = digits[--n];
+    }
+    return p;
+  }
+
+private:
+  char* buf;
+  size_t cap;
+  size_t used;
+  bool overflow;
+};
+
+#endif // ROW_FORMAT_H
@@ -0,0 +1,154 @@
+/*
+ * Sample Batch for OmniLogger
+ * RTC memory sample batching and wake statistics for deep sleep
+ *
+ * Copyright (C) 2024 NortonTech3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SAMPLE_BATCH_H
+#define SAMPLE_BATCH_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// One decoded batched sample, channels in getCSVHeader column order
+struct BatchedSample {
+  static const int MAX_CHANNELS = Config::MAX_CHANNELS;
+  
+  uint32_t timestamp;
+  bool synced;
+  uint8_t channels;
+  float values[MAX_CHANNELS];
+  bool valid[MAX_CHANNELS];  // Value for the row (may be carried forward)
+  bool fresh[MAX_CHANNELS];  // Read in this sample, for the rollups
+};
+
+// Samples from headless wakes, kept in RTC memory until the SD card is
+// powered up. Plain data without constructors so it can be RTC_DATA_ATTR.
+// Record layout: uint32 timestamp | uint8 synced | uint8 channels |
+//                uint64 valid bits | uint64 fresh bits | float per channel
+struct SampleBatch {
+  static const size_t CAPACITY = 2048;  // RTC slow memory is 8 KB, shared with the rollup buckets
+  static const size_t HEADER_SIZE = 22;
+  
+  uint16_t used;   // Bytes
+  uint16_t count;  // Samples
+  uint8_t data[CAPACITY];
+  
+  static size_t recordSize(int channels) {
+    return HEADER_SIZE + 4 * channels;
+  }
+  
+  void clear() {
+    used = 0;
+    count = 0;
+  }
+  
+  bool hasRoom(int channels) const {
+    return used <= CAPACITY && CAPACITY - used >= recordSize(channels);
+  }
+  
+  bool push(uint32_t timestamp, bool synced, const float* values, const bool* valid,
+            const bool* fresh, int channels) {
+    channels = std::min(channels, BatchedSample::MAX_CHANNELS);
+    if (!hasRoom(channels)) {
+      return false;
+    }
+    
+    uint64_t validBits = 0;
+    uint64_t freshBits = 0;
+    for (int i = 0; i < channels; i++) {
+      if (valid[i]) validBits |= 1ULL << i;
+      if (fresh[i]) freshBits |= 1ULL << i;
+    }
+    
+    uint8_t* p = data + used;
+    memcpy(p, &timestamp, 4);
+    p[4] = synced ? 1 : 0;
+    p[5] = channels;
+    memcpy(p + 6, &validBits, 8);
+    memcpy(p + 14, &freshBits, 8);
+    memcpy(p + HEADER_SIZE, values, 4 * channels);
+    used += recordSize(channels);
+    count++;
+    return true;
+  }
+  
+  // Decode the record at offset; returns its size, 0 at the end
+  size_t read(size_t offset, BatchedSample& out) const {
+    if (offset + HEADER_SIZE > used) {
+      return 0;
+    }
+    const uint8_t* p = data + offset;
+    uint64_t validBits;
+    uint64_t freshBits;
+    memcpy(&out.timestamp, p, 4);
+    out.synced = p[4] != 0;
+    out.channels = std::min((int)p[5], BatchedSample::MAX_CHANNELS);
+    memcpy(&validBits, p + 6, 8);
+    memcpy(&freshBits, p + 14, 8);
+    if (offset + recordSize(out.channels) > used) {
+      return 0;
+    }
+    memcpy(out.values, p + HEADER_SIZE, 4 * out.channels);
+    for (int i = 0; i < out.channels; i++) {
+      out.valid[i] = validBits & (1ULL << i);
+      out.fresh[i] = freshBits & (1ULL << i);
+    }
+    return recordSize(out.channels);
+  }
+  
+  // Drop the first bytes (samples) once they reached the logger
+  void consume(size_t bytes, uint16_t samples) {
+    bytes = std::min(bytes, (size_t)used);
+    memmove(data, data + bytes, used - bytes);
+    used -= bytes;
+    count -= std::min(samples, count);
+  }
+};
+
+// Time awake per wake, from app start to deep sleep, as a proxy for energy per sample
+struct WakeStats {
+  uint32_t fastWakes;
+  uint64_t fastAwakeUs;
+  uint32_t lastFastUs;
+  uint32_t fullWakes;
+  uint64_t fullAwakeUs;
+  uint32_t lastFullUs;
+  uint32_t batchFlushes;
+  
+  void record(bool fast, uint32_t awakeUs) {
+    if (fast) {
+      fastWakes++;
+      fastAwakeUs += awakeUs;
+      lastFastUs = awakeUs;
+    } else {
+      fullWakes++;
+      fullAwakeUs += awakeUs;
+      lastFullUs = awakeUs;
+    }
+  }
+  
+  uint32_t averageFastMs() const {
+    return fastWakes > 0 ? fastAwakeUs / fastWakes / 1000 : 0;
+  }
+  
+  uint32_t averageFullMs() const {
+    return fullWakes > 0 ? fullAwakeUs / fullWakes / 1000 : 0;
+  }
+};
+
+#endif // SAMPLE_BATCH_H
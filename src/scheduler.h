@@ -0,0 +1,159 @@
+/*
+ * Sensor Scheduler for OmniLogger
+ * Timer wheel deciding which sensors are due on each tick
+ *
+ * Copyright (C) 2024 NortonTech3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// Each sensor has its own period in seconds. The wheel ticks at the greatest
+// common divisor of all periods and every sensor is due on the multiples of
+// its period, counted from tick 0. Because the phase only depends on the tick
+// number, the schedule can be rebuilt at any tick (e.g. after a deep sleep
+// wake) and continues exactly where it left off.
+class SensorScheduler {
+public:
+  static const int WHEEL_SLOTS = 64;
+  
+  SensorScheduler() : tickSeconds(1), tick(0) {
+    clear();
+  }
+  
+  // periods[i] is sensor i's period in seconds, 0 = not scheduled. The first
+  // tick to be processed by advance() is startTick.
+  void begin(const unsigned int* periods, int count, unsigned int idlePeriod, uint32_t startTick) {
+    clear();
+    
+    tickSeconds = 0;
+    for (int i = 0; i < count && i < Config::MAX_SENSORS; i++) {
+      if (periods[i] > 0) {
+        tickSeconds = gcd(tickSeconds, periods[i]);
+      }
+    }
+    if (tickSeconds == 0) {
+      tickSeconds = std::max(1U, idlePeriod);  // Nothing scheduled
+    }
+    
+    tick = startTick - 1;
+    for (int i = 0; i < count && i < Config::MAX_SENSORS; i++) {
+      if (periods[i] == 0) continue;
+      entries[i].periodTicks = periods[i] / tickSeconds;
+      // First multiple of the period at or after startTick
+      uint32_t offset = startTick % entries[i].periodTicks;
+      entries[i].due = offset == 0 ? startTick : startTick + entries[i].periodTicks - offset;
+      insert(i);
+    }
+  }
+  
+  // Process the next tick. Returns a bit per sensor that is due.
+  uint32_t advance() {
+    tick++;
+    uint32_t dueMask = 0;
+    
+    // Entries of other rounds share the slot; only unlink the ones due now
+    int8_t* link = &slots[tick % WHEEL_SLOTS];
+    while (*link >= 0) {
+      int8_t index = *link;
+      if (entries[index].due == tick) {
+        dueMask |= 1UL << index;
+        *link = entries[index].next;
+      } else {
+        link = &entries[index].next;
+      }
+    }
+    
+    // Reinsert after the walk - a period that is a multiple of WHEEL_SLOTS
+    // lands in the same slot
+    for (int i = 0; i < Config::MAX_SENSORS; i++) {
+      if (dueMask & (1UL << i)) {
+        entries[i].due += entries[i].periodTicks;
+        insert(i);
+      }
+    }
+    return dueMask;
+  }
+  
+  // Ticks from the last processed tick to the next one with a sensor due (>= 1)
+  uint32_t ticksUntilDue() const {
+    uint32_t next = UINT32_MAX;
+    for (int i = 0; i < Config::MAX_SENSORS; i++) {
+      if (entries[i].periodTicks > 0) {
+        next = std::min(next, entries[i].due - tick);
+      }
+    }
+    return next == UINT32_MAX ? 1 : next;
+  }
+  
+  // No sensor scheduled - ticks run at the idle period and nothing is due
+  bool isIdle() const {
+    for (int i = 0; i < Config::MAX_SENSORS; i++) {
+      if (entries[i].periodTicks > 0) return false;
+    }
+    return true;
+  }
+  
+  uint32_t getTickSeconds() const {
+    return tickSeconds;
+  }
+  
+  // Last processed tick
+  uint32_t currentTick() const {
+    return tick;
+  }
+
+private:
+  struct Entry {
+    uint32_t periodTicks;  // 0 = not scheduled
+    uint32_t due;          // Absolute tick of the next reading
+    int8_t next;           // Next entry in the same slot, -1 = end
+  };
+  
+  Entry entries[Config::MAX_SENSORS];
+  int8_t slots[WHEEL_SLOTS];  // Head of each slot's list, -1 = empty
+  uint32_t tickSeconds;
+  uint32_t tick;
+  
+  void clear() {
+    memset(slots, -1, sizeof(slots));
+    for (int i = 0; i < Config::MAX_SENSORS; i++) {
+      entries[i].periodTicks = 0;
+      entries[i].due = 0;
+      entries[i].next = -1;
+    }
+  }
+  
+  void insert(int index) {
+    int8_t& head = slots[entries[index].due % WHEEL_SLOTS];
+    entries[index].next = head;
+    head = index;
+  }
+  
+  static uint32_t gcd(uint32_t a, uint32_t b) {
+    while (b != 0) {
+      uint32_t t = a % b;
+      a = b;
+      b = t;
+    }
+    return a;
+  }
+};
+
+#endif // SCHEDULER_H
@@ -0,0 +1,302 @@
+/*
+ * SD Clock Calibration for OmniLogger
+ * Fastest stable SPI clock per card, found with a pattern test and kept in NVS
+ *
+ * Copyright (C) 2024 NortonTech3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SD_CLOCK_H
+#define SD_CLOCK_H
+
+#include <Arduino.h>
+#include <SD.h>
+#include <SPI.h>
+#include <Preferences.h>
+#include <esp_rom_crc.h>
+#include <esp_task_wdt.h>
+
+// Clock and sequential throughput of the mounted card
+struct SdClockProfile {
+  uint32_t clockHz;    // Fastest clock that passed the pattern test
+  uint32_t readKBps;   // Measured at that clock (0 = not measured)
+  uint32_t writeKBps;
+};
+
+// The card is always mounted at SAFE_HZ first. tune() then reads its CID
+// and remounts at the clock stored for it, or calibrates: a test file is
+// written at SAFE_HZ, and at each faster clock it is first read back, then
+// overwritten in place and read back again, so the FAT is never extended
+// at a clock that hasn't been proven. The first clock that fails ends the
+// sweep and the fastest one that passed is stored under the CID.
+class SdClockTuner {
+public:
+  static const uint32_t SAFE_HZ = 4000000;    // SD library default
+  static const uint32_t TEST_BYTES = 131072;  // Pattern file size
+  static const size_t BLOCK_SIZE = 4096;
+  static const int CANDIDATES = 5;
+  static constexpr const char* TEST_PATH = "/sdclock.tmp";
+  
+  SdClockTuner() : calibrated(false) {
+    profile.clockHz = SAFE_HZ;
+    profile.readKBps = 0;
+    profile.writeKBps = 0;
+    key[0] = '\0';
+  }
+  
+  // Called with the card mounted at SAFE_HZ. False only if the card can't
+  // be mounted again afterwards.
+  bool tune(uint8_t csPin, SPIClass& spi) {
+    profile.clockHz = SAFE_HZ;
+    profile.readKBps = 0;
+    profile.writeKBps = 0;
+    calibrated = false;
+    
+    uint8_t cid[16];
+    if (!readCid(csPin, spi, cid)) {
+      Serial.println("SD clock: no CID from the card - staying at 4MHz");
+      key[0] = '\0';
+      return true;
+    }
+    snprintf(key, sizeof(key), "c%08lx", (unsigned long)esp_rom_crc32_le(0, cid, 15));
+    
+    SdClockProfile stored;
+    if (load(stored)) {
+      if (remount(csPin, spi, stored.clockHz)) {
+        profile = stored;
+        calibrated = true;
+        Serial.printf("SD clock: %lu kHz (stored for this card)\n", (unsigned long)(profile.clockHz / 1000));
+        return true;
+      }
+      Serial.println("SD clock: stored clock failed - recalibrating");
+      if (!remount(csPin, spi, SAFE_HZ)) {
+        return false;
+      }
+    }
+    return calibrate(csPin, spi);
+  }
+  
+  // Calibrate again on the next mount (the card misbehaved at its clock)
+  void forget() {
+    if (key[0] == '\0' || !calibrated) {
+      return;
+    }
+    Preferences prefs;
+    if (prefs.begin(PREFS_NAMESPACE, false)) {
+      prefs.remove(key);
+      prefs.end();
+    }
+    calibrated = false;
+  }
+  
+  const SdClockProfile& getProfile() const {
+    return profile;
+  }
+  
+  // The clock was found by a pattern test (now or on an earlier mount)
+  bool isCalibrated() const {
+    return calibrated;
+  }
+
+private:
+  static constexpr const char* PREFS_NAMESPACE = "sdclock";
+  
+  SdClockProfile profile;
+  bool calibrated;
+  char key[12];  // "c" + CRC-32 of the CID in hex
+  
+  static uint32_t candidate(int i) {
+    static const uint32_t clocks[CANDIDATES] = {8000000, 10000000, 16000000, 20000000, 40000000};
+    return clocks[i];
+  }
+  
+  bool calibrate(uint8_t csPin, SPIClass& spi) {
+    uint32_t* buf = (uint32_t*)malloc(BLOCK_SIZE);
+    if (!buf) {
+      return true;  // Stay at SAFE_HZ
+    }
+    
+    uint32_t seed = 1;
+    uint32_t readKBps;
+    uint32_t writeKBps;
+    bool ok = writePattern(buf, seed, true, writeKBps) && checkPattern(buf, seed, readKBps);
+    if (!ok) {
+      Serial.println("SD clock: pattern test failed at 4MHz - not calibrating");
+      free(buf);
+      SD.remove(TEST_PATH);
+      return true;
+    }
+    profile.readKBps = readKBps;
+    profile.writeKBps = writeKBps;
+    
+    uint32_t mounted = SAFE_HZ;
+    for (int i = 0; i < CANDIDATES; i++) {
+      esp_task_wdt_reset();
+      uint32_t hz = candidate(i);
+      mounted = hz;
+      if (!remount(csPin, spi, hz) || !checkPattern(buf, seed, readKBps) ||
+          !writePattern(buf, seed + 1, false, writeKBps) || !checkPattern(buf, seed + 1, readKBps)) {
+        Serial.printf("SD clock: %lu kHz failed\n", (unsigned long)(hz / 1000));
+        mounted = 0;
+        break;
+      }
+      seed++;
+      profile.clockHz = hz;
+      profile.readKBps = readKBps;
+      profile.writeKBps = writeKBps;
+    }
+    free(buf);
+    
+    if (mounted != profile.clockHz && !remount(csPin, spi, profile.clockHz)) {
+      return false;
+    }
+    SD.remove(TEST_PATH);
+    save();
+    calibrated = true;
+    Serial.printf("SD clock: %lu kHz, read %lu KB/s, write %lu KB/s\n", (unsigned long)(profile.clockHz / 1000),
+                  (unsigned long)profile.readKBps, (unsigned long)profile.writeKBps);
+    return true;
+  }
+  
+  static bool remount(uint8_t csPin, SPIClass& spi, uint32_t hz) {
+    SD.end();
+    return SD.begin(csPin, spi, hz) && SD.cardType() != CARD_NONE;
+  }
+  
+  // Pseudo-random words (xorshift32), the same sequence for the same seed
+  static uint32_t nextWord(uint32_t& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+  }
+  
+  static uint32_t kbps(uint32_t us) {
+    return us > 0 ? (uint32_t)((uint64_t)TEST_BYTES * 1000000 / 1024 / us) : 0;
+  }
+  
+  // create makes the file at SAFE_HZ; later passes overwrite it in place
+  static bool writePattern(uint32_t* buf, uint32_t seed, bool create, uint32_t& kbpsOut) {
+    File file = SD.open(TEST_PATH, create ? FILE_WRITE : "r+");
+    if (!file) {
+      return false;
+    }
+    uint32_t state = seed * 2654435761u | 1;
+    uint32_t start = micros();
+    bool ok = true;
+    for (uint32_t done = 0; ok && done < TEST_BYTES; done += BLOCK_SIZE) {
+      for (size_t i = 0; i < BLOCK_SIZE / 4; i++) {
+        buf[i] = nextWord(state);
+      }
+      ok = file.write((const uint8_t*)buf, BLOCK_SIZE) == BLOCK_SIZE;
+    }
+    file.close();
+    kbpsOut = kbps(micros() - start);
+    return ok;
+  }
+  
+  static bool checkPattern(uint32_t* buf, uint32_t seed, uint32_t& kbpsOut) {
+    File file = SD.open(TEST_PATH, FILE_READ);
+    if (!file || file.size() != TEST_BYTES) {
+      return false;
+    }
+    uint32_t state = seed * 2654435761u | 1;
+    uint32_t start = micros();
+    bool ok = true;
+    for (uint32_t done = 0; ok && done < TEST_BYTES; done += BLOCK_SIZE) {
+      ok = file.read((uint8_t*)buf, BLOCK_SIZE) == BLOCK_SIZE;
+      for (size_t i = 0; ok && i < BLOCK_SIZE / 4; i++) {
+        ok = buf[i] == nextWord(state);
+      }
+    }
+    file.close();
+    kbpsOut = kbps(micros() - start);
+    return ok;
+  }
+  
+  bool load(SdClockProfile& out) const {
+    Preferences prefs;
+    if (!prefs.begin(PREFS_NAMESPACE, true)) {
+      return false;
+    }
+    bool ok = prefs.getBytes(key, &out, sizeof(out)) == sizeof(out) && out.clockHz >= SAFE_HZ;
+    prefs.end();
+    return ok;
+  }
+  
+  void save() const {
+    Preferences prefs;
+    if (prefs.begin(PREFS_NAMESPACE, false)) {
+      prefs.putBytes(key, &profile, sizeof(profile));
+      prefs.end();
+    }
+  }
+  
+  // CMD10 (SEND_CID) on the bus the SD library has just initialised. The
+  // command carries a valid CRC7 in case the library turned CRC checks on;
+  // the CID is accepted only if its own CRC7 matches.
+  static bool readCid(uint8_t csPin, SPIClass& spi, uint8_t* cid) {
+    uint8_t cmd[6] = {0x40 | 10, 0, 0, 0, 0, 0};
+    cmd[5] = crc7(cmd, 5) << 1 | 1;
+    
+    spi.beginTransaction(SPISettings(SAFE_HZ, MSBFIRST, SPI_MODE0));
+    digitalWrite(csPin, LOW);
+    spi.transfer(0xFF);
+    for (int i = 0; i < 6; i++) {
+      spi.transfer(cmd[i]);
+    }
+    uint8_t r1 = 0xFF;
+    for (int i = 0; i < 8 && (r1 & 0x80); i++) {
+      r1 = spi.transfer(0xFF);
+    }
+    bool ok = false;
+    if (r1 == 0) {
+      uint8_t token = 0xFF;
+      unsigned long start = millis();
+      while (token == 0xFF && millis() - start < 100) {
+        token = spi.transfer(0xFF);
+      }
+      if (token == 0xFE) {
+        for (int i = 0; i < 16; i++) {
+          cid[i] = spi.transfer(0xFF);
+        }
+        spi.transfer(0xFF);  // Data CRC16
+        spi.transfer(0xFF);
+        ok = (crc7(cid, 15) << 1 | 1) == cid[15];
+      }
+    }
+    digitalWrite(csPin, HIGH);
+    spi.transfer(0xFF);
+    spi.endTransaction();
+    return ok;
+  }
+  
+  static uint8_t crc7(const uint8_t* data, size_t len) {
+    uint8_t crc = 0;
+    for (size_t i = 0; i < len; i++) {
+      uint8_t d = data[i];
+      for (int b = 0; b < 8; b++) {
+        crc <<= 1;
+        if ((d ^ crc) & 0x80) {
+          crc ^= 0x09;
+        }
+        d <<= 1;
+      }
+    }
+    return crc & 0x7F;
+  }
+};
+
+#endif // SD_CLOCK_H
@@ -0,0 +1,104 @@
+/*
+ * Sensor Types for OmniLogger
+ * Channel descriptors of every supported sensor type
+ *
+ * Copyright (C) 2024 NortonTech3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SENSOR_TYPES_H
+#define SENSOR_TYPES_H
+
+#include <Arduino.h>
+#include <cmath>
+#include "config.h"
+
+// One logged value of a sensor type
+struct ChannelInfo {
+  const char* suffix;  // CSV column after the sensor name, e.g. "_Temp_C"
+  const char* label;   // Status and serial text, e.g. "Temp"
+  const char* unit;    // Printed after the value, e.g. "°C"
+  uint8_t decimals;    // In CSV rows and status text
+  float minValid;      // Readings outside [minValid, maxValid] are rejected
+  float maxValid;
+};
+
+struct SensorTypeInfo {
+  const char* label;  // Web UI type list
+  uint8_t channelCount;
+  const ChannelInfo* channels;
+};
+
+// Every type declares its channels once here. Formatting, validation and
+// the JSON paths loop over this table instead of switching on the type, so
+// adding a type means one table entry plus its init and read code.
+class SensorTypes {
+public:
+  static const int MAX_TYPE_CHANNELS = 4;  // Fast analog has the most channels
+  
+  static const SensorTypeInfo& info(SensorType type) {
+    static const ChannelInfo bme280[] = {
+      {"_Temp_C", "Temp", "°C", 2, -40.0f, 85.0f},           // BME280 operating range
+      {"_Humidity_%", "Humidity", "%", 2, 0.0f, 100.0f},
+      {"_Pressure_hPa", "Pressure", "hPa", 2, 300.0f, 1100.0f}
+    };
+    static const ChannelInfo dht22[] = {
+      {"_Temp_C", "Temp", "°C", 2, -40.0f, 80.0f},           // DHT22 operating range
+      {"_Humidity_%", "Humidity", "%", 2, 0.0f, 100.0f}
+    };
+    static const ChannelInfo ds18b20[] = {
+      {"_Temp_C", "Temp", "°C", 2, -55.0f, 125.0f}           // DS18B20 operating range
+    };
+    static const ChannelInfo analog[] = {
+      {"_Value", "Value", "", 2, 0.0f, 3.3f}                 // Calibrated volts
+    };
+    static const ChannelInfo analogFast[] = {
+      {"_Mean_V", "Mean", "V", 3, -INFINITY, INFINITY},
+      {"_Min_V", "Min", "V", 3, -INFINITY, INFINITY},
+      {"_Max_V", "Max", "V", 3, -INFINITY, INFINITY},
+      {"_RMS_V", "RMS", "V", 3, -INFINITY, INFINITY}
+    };
+    static const SensorTypeInfo types[SENSOR_TYPE_COUNT] = {
+      {"None", 0, nullptr},
+      {"BME280 (I2C)", 3, bme280},
+      {"DHT22", 2, dht22},
+      {"DS18B20", 1, ds18b20},
+      {"Analog", 1, analog},
+      {"Analog (fast, DMA)", 4, analogFast}
+    };
+    return types[isKnown(type) ? type : SENSOR_NONE];
+  }
+  
+  static bool isKnown(int type) {
+    return type >= SENSOR_NONE && type < SENSOR_TYPE_COUNT;
+  }
+  
+  static int channelsOf(SensorType type) {
+    return info(type).channelCount;
+  }
+  
+  // True if every value is a number inside its channel's valid range
+  static bool inRange(SensorType type, const float* values) {
+    const SensorTypeInfo& t = info(type);
+    for (int c = 0; c < t.channelCount; c++) {
+      if (isnan(values[c]) || values[c] < t.channels[c].minValid || values[c] > t.channels[c].maxValid) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+#endif // SENSOR_TYPES_H
@@ -23,32 +23,32 @@
 
 #include <Arduino.h>
 #include <Wire.h>
-#include <Adafruit_BME280.h>
-#include <DHT.h>
 #include <OneWire.h>
 #include <DallasTemperature.h>
 #include <cmath>
 #include "config.h"
-
-// Sensor reading structure
-struct SensorReading {
-  bool valid;
-  float temperature;
-  float humidity;
-  float pressure;
-  float value;  // Generic value for analog sensors
-};
+#include "bme280.h"
+#include "dht22.h"
+#include "fast_adc.h"
+#include "metrics.h"
+#include "row_format.h"
+#include "sensor_types.h"
 
 class SensorManager {
 public:
-  SensorManager() : sensorCount(0), i2cInitialized(false) {
+  static const uint32_t ALL_SENSORS = 0xFFFFFFFFUL >> (32 - Config::MAX_SENSORS);
+  static const int MAX_CHANNELS = Config::MAX_CHANNELS;
+  static const int MAX_ONEWIRE_BUSES = 8;  // DS18B20 pins; each bus holds any number of sensors
+  
+  SensorManager() : dhtActive(-1), dhtStartUs(0), busCount(0), sensorCount(0), channelCount(0), i2cInitialized(false), acqCycles(0), acqTiming(false), sampledMask(0), carryForward(false) {
     for (int i = 0; i < Config::MAX_SENSORS; i++) {
-      readings[i].valid = false;
-      dhtSensors[i] = nullptr;
-      dallasSensors[i] = nullptr;
-      oneWireSensors[i] = nullptr;
+      readingValid[i] = false;
+      firstChannel[i] = 0;
+      dhtLastStart[i] = 0;
+      dallasBus[i] = -1;
       bmeSensors[i] = nullptr;
     }
+    memset(channelValues, 0, sizeof(channelValues));
   }
   
   ~SensorManager() {
@@ -75,15 +75,23 @@ public:
       }
       // Try to recover I2C bus if stuck (clock out any stuck slaves)
       recoverI2CBus(config.i2cSDA, config.i2cSCL);
+      Wire.setClock(I2C_CLOCK_HZ);
     }
     
     // Initialize each sensor
+    int channelsUsed = 0;
     for (int i = 0; i < Config::MAX_SENSORS; i++) {
       if (!config.sensors[i].enabled) continue;
       
+      int channels = SensorTypes::channelsOf(config.sensors[i].type);
+      if (channelsUsed + channels > MAX_CHANNELS) {
+        Serial.printf("Sensor %d skipped: all %d channels are in use\n", i, MAX_CHANNELS);
+        continue;
+      }
+      
       switch (config.sensors[i].type) {
         case SENSOR_BME280:
-          initBME280(i, config.sensors[i]);
+          initBME280(i, config.sensors[i], config.bmeOversampling);
           break;
         case SENSOR_DHT22:
           initDHT22(i, config.sensors[i]);
@@ -94,50 +102,165 @@ public:
         case SENSOR_ANALOG:
           initAnalog(i, config.sensors[i]);
           break;
+        case SENSOR_ANALOG_FAST:
+          initAnalogFast(i, config.sensors[i]);
+          break;
         default:
           break;
       }
+      if (sensorTypes[i] != SENSOR_NONE) {
+        channelsUsed += channels;
+      }
     }
     
+    // Background sampling for fast analog channels starts now, so the first
+    // interval runs up to the first measurement
+    fastAdc.begin(config.fastAdcRateHz);
+    
     sensorCount = 0;
     for (int i = 0; i < Config::MAX_SENSORS; i++) {
       if (config.sensors[i].enabled && config.sensors[i].type != SENSOR_NONE) {
         sensorCount++;
       }
     }
+    
+    // Columns only change here, so the layout and header are built once per configuration
+    buildLayout();
   }
   
-  void readAllSensors() {
+  // Two-phase acquisition: startAcquisition() triggers every sensor that
+  // converts on its own (DS18B20 buses, BME280 forced mode) and reads the
+  // analog ones meanwhile; pollAcquisition() collects each conversion once
+  // it is ready and runs the DHT22 transfers one after another on the RMT
+  // channel. A cycle takes as long as the slowest sensor.
+  // Only the sensors in dueMask are read; the others keep their last reading.
+  void startAcquisition(uint32_t dueMask = ALL_SENSORS) {
+    unsigned long now = millis();
+    sampledMask = 0;
+    acqCycles = ESP.getCycleCount();
+    acqTiming = true;
+    
+    uint32_t busesRequested = 0;
+    
     for (int i = 0; i < Config::MAX_SENSORS; i++) {
-      if (sensorTypes[i] == SENSOR_NONE) continue;
+      acqState[i] = ACQ_IDLE;
+      if (sensorTypes[i] == SENSOR_NONE || !(dueMask & (1UL << i))) continue;
       
-      readings[i].valid = false;
+      sampledMask |= 1UL << i;      
+      bool wasValid = readingValid[i];
+      readingValid[i] = false;
       
       switch (sensorTypes[i]) {
         case SENSOR_BME280:
-          readBME280(i);
+          if (triggerBME280(i)) {
+            acqState[i] = ACQ_CONVERTING;
+            acqStart[i] = now;
+          } else {
+            Serial.printf("BME280 sensor %d: Trigger failed\n", i);
+          }
+          break;
+        case SENSOR_DS18B20:
+          // One conversion command starts every device on the bus
+          if (!(busesRequested & (1UL << dallasBus[i]))) {
+            buses[dallasBus[i]].dallas->requestTemperatures();  // Returns at once (async mode)
+            busesRequested |= 1UL << dallasBus[i];
+          }
+          acqState[i] = ACQ_CONVERTING;
+          acqStart[i] = now;
           break;
         case SENSOR_DHT22:
-          readDHT22(i);
+          // Under 2s since the last transfer the sensor repeats its old
+          // reading, so keep that one instead
+          if (dhtLastStart[i] != 0 && now - dhtLastStart[i] < Dht22Reader::MIN_INTERVAL_MS) {
+            readingValid[i] = wasValid;
+          } else {
+            acqState[i] = ACQ_CONVERTING;  // Started in turn by pollAcquisition()
+          }
           break;
-        case SENSOR_DS18B20:
-          readDS18B20(i);
+        default:
           break;
+      }
+    }
+    
+    // Synchronous sensors are read while the others convert
+    for (int i = 0; i < Config::MAX_SENSORS; i++) {
+      if (!wasSampled(i)) continue;
+      switch (sensorTypes[i]) {
         case SENSOR_ANALOG:
           readAnalog(i);
           break;
+        case SENSOR_ANALOG_FAST:
+          readAnalogFast(i);
+          break;
         default:
           break;
       }
     }
   }
   
-  SensorReading getReading(int index) const {
-    if (index >= 0 && index < Config::MAX_SENSORS) {
-      return readings[index];
+  // Collect finished conversions; true once no sensor is pending
+  bool pollAcquisition() {
+    bool pending = false;
+    unsigned long now = millis();
+    
+    for (int i = 0; i < Config::MAX_SENSORS; i++) {
+      if (acqState[i] != ACQ_CONVERTING) continue;
+      
+      if (sensorTypes[i] == SENSOR_DHT22) {
+        pending |= !pollDHT22(i);
+        continue;
+      }
+      
+      unsigned long elapsed = now - acqStart[i];
+      bool bme = sensorTypes[i] == SENSOR_BME280;
+      
+      if (bme ? isBME280Ready(i, elapsed) : buses[dallasBus[i]].dallas->isConversionComplete()) {
+        if (bme) {
+          readBME280(i);
+        } else {
+          readDS18B20(i);
+        }
+        acqState[i] = ACQ_IDLE;
+      } else if (elapsed > (bme ? bmeSensors[i]->conversionTimeMs() + BME280_TIMEOUT_MARGIN_MS : DS18B20_TIMEOUT_MS)) {
+        Serial.printf("%s sensor %d: Conversion timeout\n", bme ? "BME280" : "DS18B20", i);
+        acqState[i] = ACQ_IDLE;
+      } else {
+        pending = true;
+      }
+    }
+    if (!pending && acqTiming) {
+      Metrics::record(METRIC_ACQUISITION, Metrics::cyclesToUs(ESP.getCycleCount() - acqCycles));
+      acqTiming = false;
     }
-    SensorReading invalid = {false, 0, 0, 0, 0};
-    return invalid;
+    return !pending;
+  }
+  
+  // Blocking acquisition of all sensors
+  void readAllSensors() {
+    startAcquisition();
+    while (!pollAcquisition()) {
+      delay(1);
+    }
+  }
+  
+  // Sensors read by the last acquisition
+  uint32_t getSampledMask() const {
+    return sampledMask;
+  }
+  
+  bool wasSampled(int index) const {
+    return sampledMask & (1UL << index);
+  }
+  
+  // Rows repeat the last value of sensors that weren't read instead of
+  // leaving their columns empty
+  void setCarryForward(bool enabled) {
+    carryForward = enabled;
+  }
+  
+  // Whether the sensor's last read gave a value
+  bool isReadingValid(int index) const {
+    return index >= 0 && index < Config::MAX_SENSORS && readingValid[index];
   }
   
   const char* getSensorName(int index) const {
@@ -154,160 +277,210 @@ public:
     return SENSOR_NONE;
   }
   
+  // One-shot ADC1 reads elsewhere (battery) must pause fast sampling;
+  // each pause is matched by a resume, from any task
+  void pauseFastAdc() {
+    fastAdc.pause();
+  }
+  
+  void resumeFastAdc() {
+    fastAdc.resume();
+  }
+  
   int getSensorCount() const {
     return sensorCount;
   }
   
   void printReadings() const {
     for (int i = 0; i < Config::MAX_SENSORS; i++) {
-      if (sensorTypes[i] == SENSOR_NONE || !readings[i].valid) continue;
+      if (sensorTypes[i] == SENSOR_NONE || !wasSampled(i) || !readingValid[i]) continue;
       
-      Serial.printf("Sensor %d (%s): ", i, sensorNames[i]);
-      
-      switch (sensorTypes[i]) {
-        case SENSOR_BME280:
-          Serial.printf("Temp=%.2f°C, Humidity=%.2f%%, Pressure=%.2fhPa\n",
-                       readings[i].temperature, readings[i].humidity, readings[i].pressure);
-          break;
-        case SENSOR_DHT22:
-          Serial.printf("Temp=%.2f°C, Humidity=%.2f%%\n",
-                       readings[i].temperature, readings[i].humidity);
-          break;
-        case SENSOR_DS18B20:
-          Serial.printf("Temp=%.2f°C\n", readings[i].temperature);
-          break;
-        case SENSOR_ANALOG:
-          Serial.printf("Value=%.2f\n", readings[i].value);
-          break;
-        default:
-          break;
-      }
+      char text[128];
+      formatReading(i, text, sizeof(text));
+      Serial.printf("Sensor %d (%s): %s\n", i, sensorNames[i], text);
     }
   }
   
-  String getCSVData(const char* timestamp) const {
-    // Pre-allocate string buffer to reduce memory fragmentation
-    String csv;
-    csv.reserve(256);  // Reserve reasonable size upfront
-    csv = timestamp;
-    
-    for (int i = 0; i < Config::MAX_SENSORS; i++) {
-      if (sensorTypes[i] == SENSOR_NONE) continue;
-      
-      if (!readings[i].valid) {
-        switch (sensorTypes[i]) {
-          case SENSOR_BME280:
-            csv += ",,,";  // temp, humidity, pressure
-            break;
-          case SENSOR_DHT22:
-            csv += ",,";  // temp, humidity
-            break;
-          case SENSOR_DS18B20:
-            csv += ",";  // temp
-            break;
-          case SENSOR_ANALOG:
-            csv += ",";  // value
-            break;
-          default:
-            break;
-        }
-      } else {
-        char buffer[32];
-        switch (sensorTypes[i]) {
-          case SENSOR_BME280:
-            snprintf(buffer, sizeof(buffer), ",%.2f,%.2f,%.2f", 
-                    readings[i].temperature, readings[i].humidity, readings[i].pressure);
-            csv += buffer;
-            break;
-          case SENSOR_DHT22:
-            snprintf(buffer, sizeof(buffer), ",%.2f,%.2f", 
-                    readings[i].temperature, readings[i].humidity);
-            csv += buffer;
-            break;
-          case SENSOR_DS18B20:
-            snprintf(buffer, sizeof(buffer), ",%.2f", readings[i].temperature);
-            csv += buffer;
-            break;
-          case SENSOR_ANALOG:
-            snprintf(buffer, sizeof(buffer), ",%.2f", readings[i].value);
-            csv += buffer;
-            break;
-          default:
-            break;
-        }
+  // Last reading of a sensor as text, e.g. "Temp: 21.50°C, Humidity: 40.20%"
+  size_t formatReading(int index, char* out, size_t outSize) const {
+    RowWriter text(out, outSize);
+    const SensorTypeInfo& type = SensorTypes::info(getSensorType(index));
+    for (int c = 0; c < type.channelCount; c++) {
+      const ChannelInfo& channel = type.channels[c];
+      if (c > 0) {
+        text.text(", ");
       }
+      text.text(channel.label).text(": ").fixed(channelValues[firstChannel[index] + c], channel.decimals).text(channel.unit);
     }
-    
-    return csv;
+    return text.length();
   }
   
-  String getCSVHeader() const {
-    String header = "Timestamp";
+  // Current readings as a CSV row (no line ending) in out. Returns the
+  // length, or 0 if the row does not fit in outSize bytes.
+  size_t getCSVData(const char* timestamp, char* out, size_t outSize) const {
+    float values[MAX_CHANNELS];
+    bool valid[MAX_CHANNELS];
+    int channels = getChannelValues(values, valid, MAX_CHANNELS);
+    return formatCSVRow(timestamp, values, valid, channels, out, outSize);
+  }
+  
+  // CSV row from channel values in getCSVHeader column order (a live
+  // reading or one batched in RTC memory). Invalid channels are left empty.
+  // Written straight into out with integer formatting, so a sample costs no
+  // heap allocation. Returns the length, or 0 if the row did not fit.
+  size_t formatCSVRow(const char* timestamp, const float* values, const bool* valid, int channels,
+                      char* out, size_t outSize) const {
+    RowWriter row(out, outSize);
+    row.text(timestamp);
     
-    for (int i = 0; i < Config::MAX_SENSORS; i++) {
-      if (sensorTypes[i] == SENSOR_NONE) continue;
-      
-      String prefix = String(sensorNames[i]);
-      
-      switch (sensorTypes[i]) {
-        case SENSOR_BME280:
-          header += "," + prefix + "_Temp_C";
-          header += "," + prefix + "_Humidity_%";
-          header += "," + prefix + "_Pressure_hPa";
-          break;
-        case SENSOR_DHT22:
-          header += "," + prefix + "_Temp_C";
-          header += "," + prefix + "_Humidity_%";
-          break;
-        case SENSOR_DS18B20:
-          header += "," + prefix + "_Temp_C";
-          break;
-        case SENSOR_ANALOG:
-          header += "," + prefix + "_Value";
-          break;
-        default:
-          break;
+    channels = std::min(channels, channelCount);
+    for (int n = 0; n < channels; n++) {
+      row.put(',');
+      if (valid[n] && !isnan(values[n])) {
+        row.fixed(values[n], channelDecimals[n]);
       }
     }
     
-    return header;
+    return row.truncated() ? 0 : row.length();
+  }
+  
+  // Channel values in getCSVHeader column order, for the binary log format.
+  // sampledOnly marks carried-forward values invalid. Returns the number of channels filled.
+  int getChannelValues(float* values, bool* valid, int maxChannels, bool sampledOnly = false) const {
+    // Readings are stored contiguously in column order already
+    int n = std::min(channelCount, maxChannels);
+    memcpy(values, channelValues, n * sizeof(float));
+    for (int c = 0; c < n; c++) {
+      int i = channelSensor[c];
+      valid[c] = sampledOnly ? readingValid[i] && wasSampled(i) : hasRowValue(i);
+    }
+    return n;
+  }
+  
+  // Column names of the current configuration, built by begin()
+  const String& getCSVHeader() const {
+    return csvHeader;
+  }
+  
+  // Decimal places of each value column, as in CSV rows
+  const uint8_t* getChannelDecimals() const {
+    return channelDecimals;
+  }
+  
+  // Value columns in the header (getChannelValues fills this many)
+  int getChannelCount() const {
+    return channelCount;
   }
 
 private:
-  Adafruit_BME280* bmeSensors[Config::MAX_SENSORS];
-  DHT* dhtSensors[Config::MAX_SENSORS];
-  DallasTemperature* dallasSensors[Config::MAX_SENSORS];
-  OneWire* oneWireSensors[Config::MAX_SENSORS];
+  enum AcquisitionState : uint8_t {
+    ACQ_IDLE,        // Nothing pending (read, timed out or not triggered)
+    ACQ_CONVERTING   // Conversion triggered, result not collected yet
+  };
+  
+  static const unsigned long BME280_TIMEOUT_MARGIN_MS = 40;  // Past the datasheet maximum
+  static const uint32_t I2C_CLOCK_HZ = 400000;               // BME280 fast mode
+  static const unsigned long DS18B20_TIMEOUT_MS = 300;       // 10-bit = ~187ms, add margin
+  static const rmt_channel_t DHT22_RMT_CHANNEL = RMT_CHANNEL_0;
+  
+  Bme280* bmeSensors[Config::MAX_SENSORS];
+  FastAdcSampler fastAdc;
+  
+  // All DHT22s share one RMT receive channel, one transfer at a time
+  Dht22Reader dhtReader;
+  int8_t dhtActive;  // Sensor whose transfer is running, -1 if none
+  unsigned long dhtStartUs;
+  unsigned long dhtLastStart[Config::MAX_SENSORS];
+  
+  // DS18B20s sharing a pin share one bus and are read by ROM address
+  struct OneWireBus {
+    int pin;
+    OneWire* wire;
+    DallasTemperature* dallas;
+    uint8_t assigned;  // Devices handed out to sensors, in search order
+  };
+  OneWireBus buses[MAX_ONEWIRE_BUSES];
+  int busCount;
+  int8_t dallasBus[Config::MAX_SENSORS];
+  DeviceAddress dallasAddresses[Config::MAX_SENSORS];
+  
+  // Channel values of all sensors in column order; a sensor's channels
+  // start at firstChannel
+  float channelValues[MAX_CHANNELS];
+  uint8_t channelDecimals[MAX_CHANNELS];
+  uint8_t channelSensor[MAX_CHANNELS];
+  uint8_t firstChannel[Config::MAX_SENSORS];
+  bool readingValid[Config::MAX_SENSORS];
   
-  SensorReading readings[Config::MAX_SENSORS];
   SensorType sensorTypes[Config::MAX_SENSORS] = {SENSOR_NONE};
   char sensorNames[Config::MAX_SENSORS][32];
   int sensorPins[Config::MAX_SENSORS] = {-1};
   int sensorCount;
+  String csvHeader;
+  int channelCount;
   bool i2cInitialized = false;
   
+  AcquisitionState acqState[Config::MAX_SENSORS] = {ACQ_IDLE};
+  unsigned long acqStart[Config::MAX_SENSORS];
+  uint32_t acqCycles;  // Cycle count at startAcquisition(), for METRIC_ACQUISITION
+  bool acqTiming;
+  uint32_t sampledMask;
+  bool carryForward;
+  
+  // Assign each sensor its channels and build the CSV header from the type table
+  void buildLayout() {
+    csvHeader = "Timestamp";
+    channelCount = 0;
+    
+    for (int i = 0; i < Config::MAX_SENSORS; i++) {
+      const SensorTypeInfo& type = SensorTypes::info(sensorTypes[i]);
+      firstChannel[i] = channelCount;
+      for (int c = 0; c < type.channelCount && channelCount < MAX_CHANNELS; c++) {
+        csvHeader += ',';
+        csvHeader += sensorNames[i];
+        csvHeader += type.channels[c].suffix;
+        channelDecimals[channelCount] = type.channels[c].decimals;
+        channelSensor[channelCount] = i;
+        channelCount++;
+      }
+    }
+  }
+  
+  // Validate against the type's channel ranges and keep the values
+  bool storeReading(int index, const float* values) {
+    SensorType type = sensorTypes[index];
+    readingValid[index] = SensorTypes::inRange(type, values);
+    if (readingValid[index]) {
+      memcpy(channelValues + firstChannel[index], values, SensorTypes::channelsOf(type) * sizeof(float));
+    }
+    return readingValid[index];
+  }
+  
+  // Whether a sensor's columns in the current row have a value
+  bool hasRowValue(int index) const {
+    return readingValid[index] && (wasSampled(index) || carryForward);
+  }
+  
   void cleanup() {
     for (int i = 0; i < Config::MAX_SENSORS; i++) {
       if (bmeSensors[i]) {
         delete bmeSensors[i];
         bmeSensors[i] = nullptr;
       }
-      if (dhtSensors[i]) {
-        delete dhtSensors[i];
-        dhtSensors[i] = nullptr;
-      }
-      if (dallasSensors[i]) {
-        delete dallasSensors[i];
-        dallasSensors[i] = nullptr;
-      }
-      if (oneWireSensors[i]) {
-        delete oneWireSensors[i];
-        oneWireSensors[i] = nullptr;
-      }
+      dhtLastStart[i] = 0;
+      dallasBus[i] = -1;
       // Reset sensor type to avoid stale readings
       sensorTypes[i] = SENSOR_NONE;
       sensorPins[i] = -1;
+      readingValid[i] = false;
+    }
+    for (int b = 0; b < busCount; b++) {
+      delete buses[b].dallas;
+      delete buses[b].wire;
     }
+    busCount = 0;
+    dhtReader.end();
+    dhtActive = -1;
   }
   
   // I2C bus recovery - clocks out stuck slaves by toggling SCL
@@ -343,20 +516,22 @@ private:
     Wire.begin(sdaPin, sclPin);
   }
   
-  void initBME280(int index, const SensorConfig& config) {
+  void initBME280(int index, const SensorConfig& config, uint8_t oversampling) {
     Serial.printf("Initializing BME280 sensor %d...\n", index);
     
-    bmeSensors[index] = new Adafruit_BME280();
+    bmeSensors[index] = new Bme280();
     
     // Use config.pin to determine address: 0 = 0x76, 1 = 0x77
     uint8_t addr = (config.pin == 1) ? 0x77 : 0x76;
     
-    if (bmeSensors[index]->begin(addr)) {
+    // Forced mode: one conversion per trigger, sleeping in between
+    if (bmeSensors[index]->begin(Wire, addr, oversampling)) {
       sensorTypes[index] = SENSOR_BME280;
       strncpy(sensorNames[index], config.name, sizeof(sensorNames[index]) - 1);
       sensorNames[index][sizeof(sensorNames[index]) - 1] = '\0';
       sensorPins[index] = config.pin;
-      Serial.printf("BME280 initialized successfully at address 0x%02X\n", addr);
+      Serial.printf("BME280 initialized successfully at address 0x%02X (x%u oversampling, %lums)\n",
+                    addr, oversampling, bmeSensors[index]->conversionTimeMs());
     } else {
       delete bmeSensors[index];
       bmeSensors[index] = nullptr;
@@ -368,8 +543,11 @@ private:
   void initDHT22(int index, const SensorConfig& config) {
     Serial.printf("Initializing DHT22 sensor %d on pin %d...\n", index, config.pin);
     
-    dhtSensors[index] = new DHT(config.pin, DHT22);
-    dhtSensors[index]->begin();
+    if (!dhtReader.begin(DHT22_RMT_CHANNEL, config.pin)) {
+      Serial.printf("Failed to initialize DHT22 sensor %d\n", index);
+      return;
+    }
+    Dht22Reader::preparePin(config.pin);
     
     sensorTypes[index] = SENSOR_DHT22;
     strncpy(sensorNames[index], config.name, sizeof(sensorNames[index]) - 1);
@@ -377,24 +555,63 @@ private:
     sensorPins[index] = config.pin;
   }
   
+  // The n-th DS18B20 configured on a pin takes the n-th device found on
+  // that bus (search order follows the ROM codes, so it is stable while
+  // the same devices are wired) and is read by its address from then on
   void initDS18B20(int index, const SensorConfig& config) {
     Serial.printf("Initializing DS18B20 sensor %d on pin %d...\n", index, config.pin);
     
-    oneWireSensors[index] = new OneWire(config.pin);
-    dallasSensors[index] = new DallasTemperature(oneWireSensors[index]);
-    dallasSensors[index]->begin();
+    int bus = oneWireBus(config.pin);
+    if (bus < 0) {
+      Serial.printf("DS18B20 sensor %d: too many OneWire pins (max %d)\n", index, MAX_ONEWIRE_BUSES);
+      return;
+    }
+    OneWireBus& b = buses[bus];
+    if (!b.dallas->getAddress(dallasAddresses[index], b.assigned)) {
+      Serial.printf("DS18B20 sensor %d: no device %u on pin %d (%u found)\n",
+                    index, b.assigned, config.pin, b.dallas->getDeviceCount());
+      return;
+    }
+    b.assigned++;
     
-    // Set to 10-bit resolution for faster reads (0.25°C precision, ~187ms vs 750ms for 12-bit)
-    dallasSensors[index]->setResolution(10);
-    // Enable async/non-blocking mode
-    dallasSensors[index]->setWaitForConversion(false);
+    Serial.printf("DS18B20 sensor %d: ROM ", index);
+    for (int i = 0; i < 8; i++) {
+      Serial.printf("%02X", dallasAddresses[index][i]);
+    }
+    Serial.println();
     
+    dallasBus[index] = bus;
     sensorTypes[index] = SENSOR_DS18B20;
     strncpy(sensorNames[index], config.name, sizeof(sensorNames[index]) - 1);
     sensorNames[index][sizeof(sensorNames[index]) - 1] = '\0';
     sensorPins[index] = config.pin;
   }
   
+  // Bus on a pin, set up on first use; -1 if all buses are taken
+  int oneWireBus(int pin) {
+    for (int b = 0; b < busCount; b++) {
+      if (buses[b].pin == pin) {
+        return b;
+      }
+    }
+    if (busCount == MAX_ONEWIRE_BUSES) {
+      return -1;
+    }
+    
+    OneWireBus& b = buses[busCount];
+    b.pin = pin;
+    b.wire = new OneWire(pin);
+    b.dallas = new DallasTemperature(b.wire);
+    b.dallas->begin();
+    b.assigned = 0;
+    
+    // Set to 10-bit resolution for faster reads (0.25°C precision, ~187ms vs 750ms for 12-bit)
+    b.dallas->setResolution(10);
+    // Enable async/non-blocking mode
+    b.dallas->setWaitForConversion(false);
+    return busCount++;
+  }
+  
   void initAnalog(int index, const SensorConfig& config) {
     Serial.printf("Initializing analog sensor %d on pin %d...\n", index, config.pin);
     
@@ -405,102 +622,123 @@ private:
     sensorPins[index] = config.pin;
   }
   
+  void initAnalogFast(int index, const SensorConfig& config) {
+    Serial.printf("Initializing fast analog sensor %d on pin %d...\n", index, config.pin);
+    
+    if (!fastAdc.addChannel(config.pin)) {
+      Serial.printf("Fast analog needs an ADC1 pin (GPIO1-10), got %d\n", config.pin);
+      sensorTypes[index] = SENSOR_NONE;
+      return;
+    }
+    sensorTypes[index] = SENSOR_ANALOG_FAST;
+    strncpy(sensorNames[index], config.name, sizeof(sensorNames[index]) - 1);
+    sensorNames[index][sizeof(sensorNames[index]) - 1] = '\0';
+    sensorPins[index] = config.pin;
+  }
+  
+  bool triggerBME280(int index) {
+    return bmeSensors[index] && bmeSensors[index]->trigger();
+  }
+  
+  // Status polls only start once the datasheet maximum has passed
+  bool isBME280Ready(int index, unsigned long elapsed) {
+    return elapsed >= bmeSensors[index]->conversionTimeMs() && bmeSensors[index]->isReady();
+  }
+  
+  // One burst read of all data registers, compensated from that single read
   void readBME280(int index) {
     if (index < 0 || index >= Config::MAX_SENSORS || !bmeSensors[index]) return;
+    ScopedTimer timer(METRIC_READ_BME280);
     
-    float temp = bmeSensors[index]->readTemperature();
-    float hum = bmeSensors[index]->readHumidity();
-    float pres = bmeSensors[index]->readPressure() / 100.0F;
-    
-    // Validate readings are within reasonable ranges
-    if (!isnan(temp) && !isnan(hum) && !isnan(pres) &&
-        temp >= -40.0 && temp <= 85.0 &&      // BME280 operating range
-        hum >= 0.0 && hum <= 100.0 &&         // Valid humidity range
-        pres >= 300.0 && pres <= 1100.0) {    // Valid pressure range
-      readings[index].temperature = temp;
-      readings[index].humidity = hum;
-      readings[index].pressure = pres;
-      readings[index].valid = true;
-    } else {
-      readings[index].valid = false;
+    float values[3];
+    if (!bmeSensors[index]->read(values) || !storeReading(index, values)) {
+      readingValid[index] = false;
       Serial.printf("BME280 sensor %d: Invalid readings detected\n", index);
     }
   }
   
-  void readDHT22(int index) {
-    if (index < 0 || index >= Config::MAX_SENSORS || !dhtSensors[index]) return;
-    
-    float temp = dhtSensors[index]->readTemperature();
-    float hum = dhtSensors[index]->readHumidity();
+  // Advance the DHT22 transfers: start this sensor's once the channel is
+  // free, decode it when the frame is in. True once the sensor is done.
+  bool pollDHT22(int index) {
+    if (dhtActive < 0) {
+      if (!dhtReader.start(sensorPins[index])) {
+        acqState[index] = ACQ_IDLE;
+        return true;
+      }
+      dhtActive = index;
+      dhtStartUs = micros();
+      dhtLastStart[index] = millis();
+    }
+    if (dhtActive != index) {
+      return false;  // Waiting for the channel
+    }
     
-    // Validate readings are within DHT22 specs
-    if (!isnan(temp) && !isnan(hum) &&
-        temp >= -40.0 && temp <= 80.0 &&      // DHT22 operating range
-        hum >= 0.0 && hum <= 100.0) {         // Valid humidity range
-      readings[index].temperature = temp;
-      readings[index].humidity = hum;
-      readings[index].valid = true;
-    } else {
-      readings[index].valid = false;
+    float values[2];
+    Dht22Reader::Result result = dhtReader.poll(values);
+    if (result == Dht22Reader::DHT_PENDING) {
+      return false;
+    }
+    // Whole transfer, start pulse to decoded frame; the CPU is free throughout
+    Metrics::record(METRIC_READ_DHT22, micros() - dhtStartUs);
+    if (result == Dht22Reader::DHT_FAILED) {
+      Serial.printf("DHT22 sensor %d: No valid frame\n", index);
+    } else if (!storeReading(index, values)) {
       Serial.printf("DHT22 sensor %d: Invalid readings detected\n", index);
     }
+    acqState[index] = ACQ_IDLE;
+    dhtActive = -1;
+    return true;
   }
   
+  // Read a finished conversion (started by startAcquisition)
   void readDS18B20(int index) {
-    if (index < 0 || index >= Config::MAX_SENSORS || !dallasSensors[index]) return;
-    
-    dallasSensors[index]->requestTemperatures();
-    
-    // Wait for conversion with timeout (10-bit = ~187ms, add margin)
-    unsigned long startTime = millis();
-    while (!dallasSensors[index]->isConversionComplete()) {
-      if (millis() - startTime > 300) {  // 300ms timeout
-        readings[index].valid = false;
-        Serial.printf("DS18B20 sensor %d: Conversion timeout\n", index);
-        return;
-      }
-      delay(10);  // Short delay to avoid busy-waiting
-    }
+    if (index < 0 || index >= Config::MAX_SENSORS || dallasBus[index] < 0) return;
+    ScopedTimer timer(METRIC_READ_DS18B20);
     
-    float temp = dallasSensors[index]->getTempCByIndex(0);
-    
-    // Validate temperature is within DS18B20 range
-    if (temp != DEVICE_DISCONNECTED_C && 
-        temp >= -55.0 && temp <= 125.0) {     // DS18B20 operating range
-      readings[index].temperature = temp;
-      readings[index].valid = true;
-    } else {
-      readings[index].valid = false;
-      if (temp == DEVICE_DISCONNECTED_C) {
-        Serial.printf("DS18B20 sensor %d: Device disconnected\n", index);
-      } else {
-        Serial.printf("DS18B20 sensor %d: Invalid reading\n", index);
-      }
+    float temp = buses[dallasBus[index]].dallas->getTempC(dallasAddresses[index]);
+    if (temp == DEVICE_DISCONNECTED_C) {
+      readingValid[index] = false;
+      Serial.printf("DS18B20 sensor %d: Device disconnected\n", index);
+    } else if (!storeReading(index, &temp)) {
+      Serial.printf("DS18B20 sensor %d: Invalid reading\n", index);
     }
   }
   
   void readAnalog(int index) {
     if (index < 0 || index >= Config::MAX_SENSORS || sensorPins[index] < 0) return;
+    ScopedTimer timer(METRIC_READ_ANALOG);
+    
+    // One-shot reads need ADC1, which the fast sampler holds while running
+    fastAdc.pause();
     
-    // Multisampling for noise reduction
+    // Multisampling for noise reduction; analogReadMilliVolts applies the eFuse calibration
     const int numSamples = 8;
     uint32_t sum = 0;
     for (int i = 0; i < numSamples; i++) {
-      sum += analogRead(sensorPins[index]);
+      sum += analogReadMilliVolts(sensorPins[index]);
       delayMicroseconds(50);
     }
-    int rawValue = sum / numSamples;
     
-    // ESP32-S2 ADC is 13-bit (0-8191), but analogRead returns 12-bit by default
-    // Using default 12-bit for compatibility
-    if (rawValue >= 0 && rawValue <= 4095) {
-      readings[index].value = rawValue * (3.3 / 4095.0);
-      readings[index].valid = true;
-    } else {
-      readings[index].valid = false;
+    fastAdc.resume();
+    
+    float volts = (sum / numSamples) / 1000.0f;
+    if (!storeReading(index, &volts)) {
       Serial.printf("Analog sensor %d: Invalid ADC reading\n", index);
     }
   }
+  
+  // Take the statistics of the interval since the last measurement
+  void readAnalogFast(int index) {
+    ScopedTimer timer(METRIC_READ_ANALOG_FAST);
+    FastAdcStats stats;
+    if (!fastAdc.takeStats(sensorPins[index], stats)) {
+      readingValid[index] = false;
+      Serial.printf("Fast analog sensor %d: No samples\n", index);
+      return;
+    }
+    float values[4] = {stats.mean, stats.min, stats.max, stats.rms};
+    storeReading(index, values);
+  }
 };
 
 #endif // SENSORS_H
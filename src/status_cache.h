@@ -0,0 +1,85 @@
+/*
+ * Status Cache for OmniLogger
+ * Periodically refreshed values for /api/status and background SD health probes
+ *
+ * Copyright (C) 2024 NortonTech3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef STATUS_CACHE_H
+#define STATUS_CACHE_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "datalogger.h"
+
+// The expensive parts of /api/status - the battery reading (16 ADC samples),
+// the SD write test and the FAT scan for used space - run here on a
+// schedule instead of once per request, so status requests only read RAM
+// however many dashboards poll. update() runs from the storage side with
+// the storage lock held, the same lock web requests run under.
+class StatusCache {
+public:
+  static const uint32_t REFRESH_MS = 5000;  // Dashboard polling period
+  
+  StatusCache() : logger(nullptr), config(nullptr), readBattery(nullptr), battery(0),
+                  lastRefresh(0), lastProbe(0), refreshed(false) {}
+  
+  void begin(DataLogger* log, const Config* cfg, float (*batteryFn)()) {
+    logger = log;
+    config = cfg;
+    readBattery = batteryFn;
+    lastProbe = millis();
+  }
+  
+  void update() {
+    unsigned long now = millis();
+    if (!refreshed || now - lastRefresh >= REFRESH_MS) {
+      battery = readBattery ? readBattery() : 0.0f;
+      lastRefresh = now;
+      refreshed = true;
+    }
+    
+    // Probe at the configured rate, and once after each mount so the used
+    // space is known
+    unsigned long probeMs = config->sdProbeInterval * 1000UL;
+    if (logger->needsUsedSizeScan() || (probeMs > 0 && now - lastProbe >= probeMs)) {
+      if (!logger->probeHealth()) {
+        Serial.println("WARNING: SD health probe failed");
+      }
+      lastProbe = now;
+    }
+  }
+  
+  float getBatteryVoltage() const {
+    return battery;
+  }
+  
+  // Milliseconds since the values were refreshed
+  uint32_t getAgeMs() const {
+    return refreshed ? millis() - lastRefresh : 0;
+  }
+
+private:
+  DataLogger* logger;
+  const Config* config;
+  float (*readBattery)();
+  float battery;
+  unsigned long lastRefresh;
+  unsigned long lastProbe;
+  bool refreshed;
+};
+
+#endif // STATUS_CACHE_H
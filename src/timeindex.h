@@ -0,0 +1,184 @@
+/*
+ * Time Index for OmniLogger
+ * Sparse timestamp -> file offset index for CSV day files
+ *
+ * Copyright (C) 2024 NortonTech3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef TIMEINDEX_H
+#define TIMEINDEX_H
+
+#include <Arduino.h>
+#include <SD.h>
+#include "compactor.h"
+
+// "/data_20260104.csv" has its index in "/data_20260104.idx": an array of
+// entries, one every TimeIndex::INTERVAL rows. The index is only a hint for
+// where to start reading - rows after the last entry are found by scanning,
+// so a missing or lagging index costs time, never correctness.
+struct TimeIndexEntry {
+  uint32_t timestamp;  // Sample time of the row
+  uint32_t offset;     // File offset of the row
+  uint32_t row;        // Row number within the file (0 = first data row)
+};
+
+class TimeIndex {
+public:
+  static const uint32_t INTERVAL = 64;  // Rows per index entry
+  
+  static bool indexPath(const char* dataPath, char* out, size_t outSize) {
+    size_t len = strlen(dataPath);
+    if (len < 5 || len + 1 > outSize) {
+      return false;
+    }
+    memcpy(out, dataPath, len - 4);
+    strcpy(out + len - 4, ".idx");
+    return true;
+  }
+  
+  static bool append(const char* dataPath, const TimeIndexEntry* entries, size_t count) {
+    char path[32];
+    if (count == 0 || !indexPath(dataPath, path, sizeof(path))) {
+      return false;
+    }
+    File file = SD.open(path, FILE_APPEND);
+    if (!file) {
+      return false;
+    }
+    size_t bytes = count * sizeof(TimeIndexEntry);
+    bool ok = file.write((const uint8_t*)entries, bytes) == bytes;
+    file.close();
+    return ok;
+  }
+  
+  // Find the last entry with timestamp < from (binary search over the file).
+  // Returns false if there is no index or no such entry - start at the first row.
+  static bool seek(const char* dataPath, uint32_t from, uint32_t dataSize, TimeIndexEntry& found) {
+    char path[32];
+    if (!indexPath(dataPath, path, sizeof(path))) {
+      return false;
+    }
+    File file = SD.open(path, FILE_READ);
+    if (!file) {
+      return false;
+    }
+    
+    int32_t lo = 0;
+    int32_t hi = (int32_t)(file.size() / sizeof(TimeIndexEntry)) - 1;
+    bool ok = false;
+    TimeIndexEntry entry;
+    
+    while (lo <= hi) {
+      int32_t mid = lo + (hi - lo) / 2;
+      file.seek(mid * sizeof(TimeIndexEntry));
+      if (file.read((uint8_t*)&entry, sizeof(entry)) != sizeof(entry)) {
+        break;
+      }
+      if (entry.timestamp < from && entry.offset < dataSize) {
+        found = entry;
+        ok = true;
+        lo = mid + 1;
+      } else {
+        hi = mid - 1;
+      }
+    }
+    
+    file.close();
+    return ok;
+  }
+};
+
+// Buffered line reader for scanning CSV files without a String per line
+class LineReader {
+public:
+  // Reads stop at end (the logical end of a preallocated file)
+  LineReader(File& file, char* buf, size_t bufSize, size_t end = SIZE_MAX)
+      : file(&file), inflater(nullptr), buf(buf), cap(bufSize), len(0), pos(0), end(end) {}
+  
+  // Lines of a compacted day file, as they are inflated
+  LineReader(GzipReader& source, char* buf, size_t bufSize)
+      : file(nullptr), inflater(&source), buf(buf), cap(bufSize), len(0), pos(0), end(SIZE_MAX) {}
+  
+  // File offset of the next unread line (plain files only)
+  size_t tell() {
+    return file ? file->position() - (len - pos) : 0;
+  }
+  
+  // Next line without its line ending; false at end of file.
+  // Lines longer than the buffer are truncated.
+  bool next(const char*& line, size_t& lineLen) {
+    while (true) {
+      char* nl = (char*)memchr(buf + pos, '\n', len - pos);
+      if (nl) {
+        line = buf + pos;
+        lineLen = nl - line;
+        pos = nl - buf + 1;
+        trimCR(line, lineLen);
+        return true;
+      }
+      
+      // Move the partial line to the front and refill
+      if (pos > 0) {
+        memmove(buf, buf + pos, len - pos);
+        len -= pos;
+        pos = 0;
+      }
+      if (len == cap) {
+        // No newline in a full buffer - return what fits
+        line = buf;
+        lineLen = len;
+        len = 0;
+        return true;
+      }
+      size_t got;
+      if (inflater) {
+        got = inflater->read((uint8_t*)buf + len, cap - len);
+      } else {
+        size_t position = file->position();
+        size_t want = position < end ? std::min(cap - len, end - position) : 0;
+        got = want > 0 ? file->read((uint8_t*)buf + len, want) : 0;
+      }
+      if (got == 0) {
+        if (len == 0) {
+          return false;
+        }
+        line = buf;  // Last line without newline
+        lineLen = len;
+        pos = len;
+        trimCR(line, lineLen);
+        return true;
+      }
+      len += got;
+    }
+  }
+
+private:
+  File* file;
+  GzipReader* inflater;
+  char* buf;
+  size_t cap;
+  size_t len;
+  size_t pos;
+  size_t end;
+  
+  static void trimCR(const char* line, size_t& lineLen) {
+    if (lineLen > 0 && line[lineLen - 1] == '\r') {
+      lineLen--;
+    }
+  }
+};
+
+#endif // TIMEINDEX_H
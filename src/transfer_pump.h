@@ -0,0 +1,498 @@
+/*
+ * Transfer Pump for OmniLogger
+ * Background file downloads sent in bounded slices with socket backpressure
+ *
+ * Copyright (C) 2024 NortonTech3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRANSFER_PUMP_H
+#define TRANSFER_PUMP_H
+
+#include <Arduino.h>
+#include <WebServer.h>
+#include <WiFiClient.h>
+#include <SD.h>
+#include <lwip/sockets.h>
+#include <rom/miniz.h>
+#include "binlog.h"
+#include "compactor.h"
+#include "metrics.h"
+
+// One file of a transfer, with the readable size taken when it started
+struct ArchiveEntry {
+  char name[24];
+  uint32_t size;
+  uint32_t mtime;  // Unix time for tar headers
+};
+
+enum TransferKind {
+  TRANSFER_RAW = 0,  // Bytes [offset, size) of one file
+  TRANSFER_CSV,      // Files as one CSV: binary files converted, compacted ones inflated, repeated headers dropped
+  TRANSFER_TAR       // Files as stored, in a ustar archive
+};
+
+// A download handler only validates the request, sends the headers and
+// hands the connection and the files to the pump; the request is then
+// done as far as the WebServer is concerned and it goes on serving others.
+// service() moves the bodies forward: each transfer refills a buffer from
+// the card (converting binary records to CSV rows on the way) and writes
+// only what the socket accepts without blocking, so a slow client costs no
+// waiting - and the whole call stops after SLICE_US. Like every request it
+// runs under the storage lock, which is free again between slices.
+class TransferPump {
+public:
+  static const int MAX_TRANSFERS = 3;
+  static const int MAX_COMPRESSED = 1;             // A deflate state is ~300KB of PSRAM
+  static const size_t BUFFER_SIZE = 4096;
+  static const uint32_t SLICE_US = 20000;          // Longest service() call
+  static const uint32_t STALL_TIMEOUT_MS = 30000;  // Drop clients that stop reading
+  static const int DEFLATE_FLAGS = 32 | TDEFL_GREEDY_PARSING_FLAG | TDEFL_WRITE_ZLIB_HEADER;
+  
+  TransferPump() {
+    for (int i = 0; i < MAX_TRANSFERS; i++) {
+      transfers[i].active = false;
+      transfers[i].buf = nullptr;
+      transfers[i].entries = nullptr;
+      transfers[i].deflater = nullptr;
+      transfers[i].in = nullptr;
+    }
+  }
+  
+  bool hasSlot() const {
+    return findSlot() >= 0;
+  }
+  
+  // Whether a new transfer could be deflated
+  bool canCompress() const {
+    if (!psramFound()) {
+      return false;
+    }
+    int count = 0;
+    for (int i = 0; i < MAX_TRANSFERS; i++) {
+      if (transfers[i].active && transfers[i].deflater) count++;
+    }
+    return count < MAX_COMPRESSED;
+  }
+  
+  // Take over the current request's connection and send the entries after
+  // head (status line and headers, ending with an empty line). The pump
+  // owns entries (malloc'd) from here on, and file: the first entry opened
+  // by the caller, or a closed File. Only deflate if canCompress().
+  bool start(WebServer& server, const String& head, TransferKind kind, ArchiveEntry* entries, uint32_t count,
+             File& file, uint32_t offset = 0, bool deflate = false) {
+    int slot = findSlot();
+    if (slot < 0 || !allocate(transfers[slot], deflate)) {
+      free(entries);
+      return false;
+    }
+    Transfer& t = transfers[slot];
+    
+    t.kind = kind;
+    t.entries = entries;
+    t.count = count;
+    t.next = 0;
+    t.part = PART_NONE;
+    t.file = file;
+    t.offset = offset;
+    t.header = "";
+    t.trailerSent = false;
+    t.used = 0;
+    t.sent = 0;
+    t.inLen = 0;
+    t.inPos = 0;
+    t.inEnd = false;
+    t.deflateDone = false;
+    
+    t.client = server.client();
+    t.client.print(head);
+    t.active = true;
+    t.lastProgress = millis();
+    Serial.printf("Download started: %lu file(s)%s\n", (unsigned long)count, deflate ? ", deflate" : "");
+    return true;
+  }
+  
+  // Move all transfers forward for at most SLICE_US
+  void service() {
+    if (activeCount() == 0) {
+      return;
+    }
+    ScopedTimer timer(METRIC_DOWNLOAD_SLICE);
+    uint32_t start = micros();
+    bool progress = true;
+    while (progress && micros() - start < SLICE_US) {
+      progress = false;
+      for (int i = 0; i < MAX_TRANSFERS; i++) {
+        if (transfers[i].active && step(transfers[i])) {
+          progress = true;
+        }
+      }
+    }
+  }
+  
+  int activeCount() const {
+    int count = 0;
+    for (int i = 0; i < MAX_TRANSFERS; i++) {
+      if (transfers[i].active) count++;
+    }
+    return count;
+  }
+  
+  // Body size of a tar archive of the entries
+  static uint32_t tarSize(const ArchiveEntry* entries, uint32_t count) {
+    uint32_t size = 1024;  // Two zero blocks end the archive
+    for (uint32_t i = 0; i < count; i++) {
+      size += 512 + (entries[i].size + 511) / 512 * 512;
+    }
+    return size;
+  }
+
+private:
+  enum Part {
+    PART_NONE = 0,  // Between files
+    PART_COPY,      // remaining bytes of file
+    PART_ROWS,      // Records of a binary file as CSV rows
+    PART_INFLATE,   // Rest of a compacted file, inflated
+    PART_ZEROS      // remaining zero bytes (tar padding and trailer)
+  };
+  
+  struct Transfer {
+    bool active;
+    TransferKind kind;
+    WiFiClient client;
+    unsigned long lastProgress;
+    
+    // Source files
+    ArchiveEntry* entries;
+    uint32_t count;
+    uint32_t next;         // Entry to start after the current part
+    Part part;
+    File file;
+    uint32_t offset;       // Raw: first byte to send
+    uint32_t remaining;
+    BinLogHeader hdr;      // Rows: schema, records read and total
+    uint32_t record;
+    uint32_t records;
+    String header;         // CSV: last header row sent
+    GzipReader inflater;   // CSV: compacted file being read
+    bool trailerSent;      // Tar: end blocks queued
+    
+    // Bytes of buf still to go on the socket
+    uint8_t* buf;
+    size_t used;
+    size_t sent;
+    
+    // Deflate: file data in in, compressed into buf
+    tdefl_compressor* deflater;
+    uint8_t* in;
+    size_t inLen;
+    size_t inPos;
+    bool inEnd;
+    bool deflateDone;
+  };
+  
+  Transfer transfers[MAX_TRANSFERS];
+  
+  int findSlot() const {
+    for (int i = 0; i < MAX_TRANSFERS; i++) {
+      if (!transfers[i].active) return i;
+    }
+    return -1;
+  }
+  
+  static uint8_t* allocBuffer(size_t size) {
+    return (uint8_t*)(psramFound() ? ps_malloc(size) : malloc(size));
+  }
+  
+  // Buffers are kept for the next transfer in the slot; the deflate state
+  // is only held while compressing
+  bool allocate(Transfer& t, bool deflate) {
+    if (!t.buf && !(t.buf = allocBuffer(BUFFER_SIZE))) {
+      return false;
+    }
+    if (deflate) {
+      if (!t.in && !(t.in = allocBuffer(BUFFER_SIZE))) {
+        return false;
+      }
+      t.deflater = (tdefl_compressor*)ps_malloc(sizeof(tdefl_compressor));
+      if (!t.deflater) {
+        return false;
+      }
+      tdefl_init(t.deflater, nullptr, nullptr, DEFLATE_FLAGS);
+    }
+    return true;
+  }
+  
+  // One buffer's worth of work. Returns whether anything moved.
+  bool step(Transfer& t) {
+    if (t.sent == t.used) {
+      t.sent = 0;
+      if (t.deflater) {
+        t.used = t.deflateDone ? 0 : compress(t);
+      } else {
+        t.used = produce(t, t.buf);
+      }
+      if (t.used == 0) {
+        if (t.deflater && !t.deflateDone) {
+          return true;  // Input taken, no output yet
+        }
+        finish(t, true);
+        return false;
+      }
+    }
+    
+    // Non-blocking send: a full socket buffer means try again next slice
+    ssize_t n = send(t.client.fd(), t.buf + t.sent, t.used - t.sent, MSG_DONTWAIT);
+    if (n > 0) {
+      t.sent += n;
+      t.lastProgress = millis();
+      return true;
+    }
+    if ((n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) || !t.client.connected()) {
+      finish(t, false);
+    } else if (millis() - t.lastProgress > STALL_TIMEOUT_MS) {
+      Serial.println("Download stalled - closing");
+      finish(t, false);
+    }
+    return false;
+  }
+  
+  // One deflate call on the next chunk of the body. Returns compressed bytes.
+  size_t compress(Transfer& t) {
+    if (t.inPos == t.inLen && !t.inEnd) {
+      t.inLen = produce(t, t.in);
+      t.inPos = 0;
+      t.inEnd = t.inLen == 0;
+    }
+    size_t inSize = t.inLen - t.inPos;
+    size_t outSize = BUFFER_SIZE;
+    tdefl_status status = tdefl_compress(t.deflater, t.in + t.inPos, &inSize, t.buf, &outSize,
+                                         t.inEnd ? TDEFL_FINISH : TDEFL_NO_FLUSH);
+    t.inPos += inSize;
+    if (status != TDEFL_STATUS_OKAY) {
+      t.deflateDone = true;  // Finished, or an error that ends the body early
+    }
+    return outSize;
+  }
+  
+  // Fill dst (BUFFER_SIZE) with the next bytes of the body; 0 at the end
+  size_t produce(Transfer& t, uint8_t* dst) {
+    for (;;) {
+      size_t n = 0;
+      switch (t.part) {
+        case PART_COPY:  n = copyBytes(t, dst); break;
+        case PART_ROWS:  n = fillRows(t, dst); break;
+        case PART_INFLATE: n = t.inflater.read(dst, BUFFER_SIZE); break;
+        case PART_ZEROS: n = zeros(t, dst); break;
+        case PART_NONE:  break;
+      }
+      if (n > 0) {
+        return n;
+      }
+      
+      t.inflater.end();
+      t.file.close();
+      if (t.part == PART_COPY && t.kind == TRANSFER_TAR) {
+        // File data is padded to whole blocks
+        t.part = PART_ZEROS;
+        t.remaining = (512 - t.entries[t.next - 1].size % 512) % 512;
+        continue;
+      }
+      t.part = PART_NONE;
+      if (!nextPart(t, dst, n)) {
+        return 0;
+      }
+      if (n > 0) {
+        return n;
+      }
+    }
+  }
+  
+  // Start on the next entry (or the tar trailer), writing any prefix for it
+  // to dst. False when there is nothing left.
+  bool nextPart(Transfer& t, uint8_t* dst, size_t& n) {
+    n = 0;
+    if (t.next == t.count) {
+      if (t.kind == TRANSFER_TAR && !t.trailerSent) {
+        t.trailerSent = true;
+        t.part = PART_ZEROS;
+        t.remaining = 1024;
+        return true;
+      }
+      return false;
+    }
+    const ArchiveEntry& entry = t.entries[t.next++];
+    if (!t.file) {
+      t.file = SD.open(entry.name);
+    }
+    
+    if (t.kind == TRANSFER_RAW) {
+      t.file.seek(t.offset);
+      t.part = PART_COPY;
+      t.remaining = entry.size > t.offset ? entry.size - t.offset : 0;
+      return true;
+    }
+    
+    if (t.kind == TRANSFER_TAR) {
+      // A file that can't be read any more is sent as zeros, so the
+      // archive stays consistent with its headers
+      t.part = PART_COPY;
+      t.remaining = entry.size;
+      n = tarHeader(dst, entry);
+      return true;
+    }
+    
+    // CSV: a header row only where the columns change. Unreadable files
+    // are skipped (part stays PART_NONE).
+    String text;
+    size_t dataStart = 0;
+    bool binary = BinLog::isBinaryFile(entry.name);
+    if (!t.file) {
+      return true;
+    }
+    if (Gzip::isCompressed(entry.name)) {
+      return startInflate(t, dst, n);
+    }
+    if (binary) {
+      if (!BinLog::readHeader(t.file, t.hdr, &text)) {
+        return true;
+      }
+      t.part = PART_ROWS;
+      t.record = 0;
+      t.records = BinLog::recordCount(t.hdr, entry.size);
+    } else {
+      text = t.file.readStringUntil('\n');
+      dataStart = text.length() + 1;
+      text.trim();
+      t.part = PART_COPY;
+      t.remaining = entry.size > dataStart ? entry.size - dataStart : 0;
+    }
+    
+    if (text != t.header) {
+      t.header = text;
+      text += "\r\n";
+      n = std::min((size_t)text.length(), BUFFER_SIZE);
+      memcpy(dst, text.c_str(), n);
+    }
+    return true;
+  }
+  
+  // The header is the first inflated line; the rows after it in the same
+  // chunk go out right behind it, so dst is read one byte short
+  bool startInflate(Transfer& t, uint8_t* dst, size_t& n) {
+    if (!t.inflater.begin(t.file)) {
+      return true;
+    }
+    size_t got = t.inflater.read(dst, BUFFER_SIZE - 1);
+    uint8_t* nl = (uint8_t*)memchr(dst, '\n', got);
+    if (!nl) {
+      t.inflater.end();
+      return true;
+    }
+    size_t lineLen = nl - dst;
+    String text;
+    text.concat((const char*)dst, lineLen);
+    text.trim();
+    t.part = PART_INFLATE;
+    
+    size_t rest = got - lineLen - 1;
+    String prefix;
+    if (text != t.header) {
+      t.header = text;
+      prefix = text + "\r\n";
+    }
+    memmove(dst + prefix.length(), nl + 1, rest);
+    memcpy(dst, prefix.c_str(), prefix.length());
+    n = prefix.length() + rest;
+    return true;
+  }
+  
+  size_t copyBytes(Transfer& t, uint8_t* dst) {
+    if (t.remaining == 0) {
+      return 0;
+    }
+    size_t want = std::min(t.remaining, (uint32_t)BUFFER_SIZE);
+    size_t got = t.file ? t.file.read(dst, want) : 0;
+    if (got == 0 && t.kind == TRANSFER_TAR) {
+      memset(dst, 0, want);
+      got = want;
+    }
+    t.remaining = got > 0 ? t.remaining - got : 0;
+    return got;
+  }
+  
+  size_t zeros(Transfer& t, uint8_t* dst) {
+    size_t n = std::min((size_t)t.remaining, BUFFER_SIZE);
+    memset(dst, 0, n);
+    t.remaining -= n;
+    return n;
+  }
+  
+  // Rows are formatted at the head of dst, each record read into its tail
+  size_t fillRows(Transfer& t, uint8_t* dst) {
+    uint8_t* rec = dst + BUFFER_SIZE - BinLog::MAX_RECORD_SIZE;
+    size_t textCap = BUFFER_SIZE - BinLog::MAX_RECORD_SIZE;
+    size_t used = 0;
+    while (t.record < t.records && textCap - used >= BinLog::MAX_ROW_TEXT) {
+      if (t.file.read(rec, t.hdr.recordSize) != t.hdr.recordSize) {
+        t.record = t.records;
+        break;
+      }
+      used += BinLog::formatRow(rec, t.hdr, (char*)dst + used, textCap - used);
+      t.record++;
+    }
+    return used;
+  }
+  
+  // ustar header block for a regular file
+  static size_t tarHeader(uint8_t* h, const ArchiveEntry& entry) {
+    memset(h, 0, 512);
+    const char* name = entry.name[0] == '/' ? entry.name + 1 : entry.name;
+    strncpy((char*)h, name, 99);
+    memcpy(h + 100, "0000644", 8);  // Mode
+    memcpy(h + 108, "0000000", 8);  // Owner
+    memcpy(h + 116, "0000000", 8);  // Group
+    snprintf((char*)h + 124, 12, "%011lo", (unsigned long)entry.size);
+    snprintf((char*)h + 136, 12, "%011lo", (unsigned long)entry.mtime);
+    h[156] = '0';                   // Regular file
+    memcpy(h + 257, "ustar", 6);
+    memcpy(h + 263, "00", 2);
+    
+    // Checksum of the block with the checksum field as spaces
+    memset(h + 148, ' ', 8);
+    unsigned int sum = 0;
+    for (int i = 0; i < 512; i++) {
+      sum += h[i];
+    }
+    snprintf((char*)h + 148, 7, "%06o", sum);
+    return 512;
+  }
+  
+  void finish(Transfer& t, bool complete) {
+    Serial.printf("Download %s\n", complete ? "complete" : "aborted");
+    t.inflater.end();
+    t.file.close();
+    t.client.stop();
+    t.client = WiFiClient();
+    free(t.entries);
+    t.entries = nullptr;
+    free(t.deflater);
+    t.deflater = nullptr;
+    t.header = "";
+    t.active = false;
+  }
+};
+
+#endif // TRANSFER_PUMP_H
@@ -0,0 +1,426 @@
+/*
+ * Uplink for OmniLogger
+ * Store-and-forward upload of logged rows in batched, compressed HTTP POSTs
+ *
+ * Copyright (C) 2024 NortonTech3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef UPLINK_H
+#define UPLINK_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <WiFiClient.h>
+#include <WiFiClientSecure.h>
+#include <HTTPClient.h>
+#include <Preferences.h>
+#include <SD.h>
+#include <rom/miniz.h>
+#include "config.h"
+#include "datalogger.h"
+#include "binlog.h"
+#include "metrics.h"
+#include "row_format.h"
+#include "transfer_pump.h"
+
+// Position of the first row not yet acknowledged by the server
+struct UplinkCursor {
+  char name[24];    // Day file path, "" before the first upload
+  uint32_t offset;  // Byte offset in that file (0 = start of its data)
+};
+
+// Reads the day files from a cursor kept in NVS, so uploads resume where
+// they stopped after a reconnect, reboot or deep sleep. prepare() copies
+// the next rows (binary files converted to CSV) with their header into a
+// batch buffer under the storage lock; send() deflates the batch and POSTs
+// it without the lock. Only a 2xx response moves the cursor, so a failed
+// or unanswered POST is sent again - the server can drop repeats by the
+// file and offset headers. A full batch is followed by the next at once;
+// otherwise the next upload waits for the interval.
+class Uplink {
+public:
+  static const size_t BATCH_SIZE = 32768;           // Raw CSV per POST with PSRAM
+  static const size_t BATCH_SIZE_NO_PSRAM = 8192;
+  static const uint32_t RETRY_MIN_MS = 30000;       // Backoff after a failure, doubled up to the interval
+  static const uint16_t HTTP_TIMEOUT_MS = 8000;     // Connect and response, inside the watchdog timeout
+  
+  Uplink() : config(nullptr), logger(nullptr), batch(nullptr), packed(nullptr), capacity(0),
+             batchLen(0), batchRecords(0), batchFull(false), nextAttemptMs(0), retryMs(RETRY_MIN_MS),
+             recordsSent(0), batchesSent(0), bytesSent(0), failures(0), lastStatus(0), lastSuccessMs(0),
+             everSent(false), cursorLoaded(false) {
+    cursor.name[0] = '\0';
+    cursor.offset = 0;
+    batchEnd = cursor;
+    batchStart = cursor;
+  }
+  
+  void begin(const Config* cfg, DataLogger* log) {
+    config = cfg;
+    logger = log;
+    if (!cursorLoaded) {
+      loadCursor();
+    }
+    if (config->uplinkEnabled) {
+      Serial.printf("Uplink enabled: %s, resuming at %s+%u\n", config->uplinkUrl,
+                    cursor.name[0] ? cursor.name : "(oldest file)", cursor.offset);
+    }
+  }
+  
+  // Enabled, configured, connected and not waiting for the interval or a backoff
+  bool isDue() const {
+    return config && config->uplinkEnabled && config->uplinkUrl[0] && WiFi.status() == WL_CONNECTED &&
+           (int32_t)(millis() - nextAttemptMs) >= 0;
+  }
+  
+  // Copy the rows after the cursor into the batch buffer. Call with the
+  // storage lock held. False if there is nothing new (or no card).
+  bool prepare() {
+    ScopedTimer timer(METRIC_UPLINK_PREPARE);
+    batchLen = 0;
+    batchRecords = 0;
+    batchFull = false;
+    if (!allocate()) {
+      scheduleNext(false);
+      return false;
+    }
+    
+    // The cursor's file, or the first file after it if that one is done
+    ManifestEntry files[FILES_PER_PAGE];
+    uint32_t page = 0;
+    uint32_t n;
+    while ((n = logger->listFiles(files, page, FILES_PER_PAGE, SORT_NAME)) > 0) {
+      for (uint32_t i = 0; i < n; i++) {
+        int cmp = strcmp(files[i].name, cursor.name);
+        if (cmp < 0) continue;
+        batchStart.offset = cmp == 0 ? cursor.offset : 0;
+        memcpy(batchStart.name, files[i].name, sizeof(batchStart.name));
+        if (readBatch(batchStart)) {
+          return true;
+        }
+      }
+      page += n;
+    }
+    scheduleNext(false);
+    return false;
+  }
+  
+  // POST the prepared batch; on a 2xx the cursor moves past it and is saved
+  bool send() {
+    ScopedTimer timer(METRIC_UPLINK_POST);
+    const uint8_t* body = (const uint8_t*)batch;
+    size_t bodyLen = batchLen;
+    size_t packedLen = compress();
+    if (packedLen > 0) {
+      body = packed;
+      bodyLen = packedLen;
+    }
+    
+    bool https = strncmp(config->uplinkUrl, "https://", 8) == 0;
+    if (https) {
+      secureClient.setInsecure();  // Encrypted, but the server certificate isn't checked
+    }
+    http.setReuse(true);  // Keep the connection for the next batch of a backlog
+    http.setTimeout(HTTP_TIMEOUT_MS);
+    if (!http.begin(https ? (WiFiClient&)secureClient : plainClient, config->uplinkUrl)) {
+      return failed(-1);
+    }
+    http.addHeader("Content-Type", "text/csv");
+    if (packedLen > 0) {
+      http.addHeader("Content-Encoding", "deflate");
+    }
+    if (config->uplinkToken[0]) {
+      http.addHeader("Authorization", String("Bearer ") + config->uplinkToken);
+    }
+    http.addHeader("X-OmniLogger-Device", config->apSSID);
+    http.addHeader("X-OmniLogger-File", batchStart.name[0] == '/' ? batchStart.name + 1 : batchStart.name);
+    http.addHeader("X-OmniLogger-Offset", String(batchStart.offset));
+    http.addHeader("X-OmniLogger-Records", String(batchRecords));
+    
+    int status = http.POST((uint8_t*)body, bodyLen);
+    http.end();
+    if (status < 200 || status >= 300) {
+      return failed(status);
+    }
+    
+    lastStatus = status;
+    cursor = batchEnd;
+    saveCursor();
+    recordsSent += batchRecords;
+    batchesSent++;
+    bytesSent += bodyLen;
+    failures = 0;
+    retryMs = RETRY_MIN_MS;
+    lastSuccessMs = millis();
+    everSent = true;
+    Serial.printf("Uplink: %u rows from %s sent (%u -> %u bytes)\n", batchRecords, batchStart.name,
+                  (unsigned int)batchLen, (unsigned int)bodyLen);
+    scheduleNext(batchFull);
+    return true;
+  }
+  
+  // A day file was moved aside for a schema change (a new file takes its
+  // name): the rows after the cursor are still in it, under the new name.
+  // May come before begin(), from the batch flush of a deep sleep wake.
+  void fileRenamed(const char* from, const char* to) {
+    if (!cursorLoaded) {
+      loadCursor();
+    }
+    if (strcmp(cursor.name, from) == 0) {
+      strncpy(cursor.name, to, sizeof(cursor.name) - 1);
+      saveCursor();
+      Serial.printf("Uplink: cursor follows %s to %s\n", from, to);
+    }
+    // A prepared batch being sent acknowledges rows of the renamed file
+    if (strcmp(batchStart.name, from) == 0) {
+      strncpy(batchStart.name, to, sizeof(batchStart.name) - 1);
+    }
+    if (strcmp(batchEnd.name, from) == 0) {
+      strncpy(batchEnd.name, to, sizeof(batchEnd.name) - 1);
+    }
+  }
+  
+  const UplinkCursor& getCursor() const {
+    return cursor;
+  }
+  
+  uint32_t getRecordsSent() const {
+    return recordsSent;
+  }
+  
+  uint32_t getBatchesSent() const {
+    return batchesSent;
+  }
+  
+  uint32_t getBytesSent() const {
+    return bytesSent;
+  }
+  
+  uint32_t getFailures() const {
+    return failures;
+  }
+  
+  int getLastStatus() const {
+    return lastStatus;
+  }
+  
+  // Seconds since the last acknowledged batch, -1 if none since boot
+  int32_t getLastSuccessAge() const {
+    return everSent ? (int32_t)((millis() - lastSuccessMs) / 1000) : -1;
+  }
+
+private:
+  static const uint32_t FILES_PER_PAGE = 8;
+  static constexpr const char* PREFS_NAMESPACE = "uplink";
+  static constexpr const char* CURSOR_KEY = "cursor";
+  
+  const Config* config;
+  DataLogger* logger;
+  HTTPClient http;
+  WiFiClient plainClient;
+  WiFiClientSecure secureClient;
+  
+  UplinkCursor cursor;      // Acknowledged by the server, persisted
+  UplinkCursor batchStart;  // First row of the prepared batch
+  UplinkCursor batchEnd;    // After its last row
+  char* batch;
+  uint8_t* packed;
+  size_t capacity;
+  size_t batchLen;
+  uint32_t batchRecords;
+  bool batchFull;           // Stopped at the row or size limit: more to send
+  
+  unsigned long nextAttemptMs;
+  uint32_t retryMs;
+  uint32_t recordsSent;
+  uint32_t batchesSent;
+  uint32_t bytesSent;
+  uint32_t failures;        // Since the last success
+  int lastStatus;           // HTTP status, or a negative HTTPClient error
+  unsigned long lastSuccessMs;
+  bool everSent;
+  bool cursorLoaded;
+  
+  // Buffers are kept between batches; the deflate state only while compressing
+  bool allocate() {
+    if (batch) {
+      return true;
+    }
+    capacity = psramFound() ? BATCH_SIZE : BATCH_SIZE_NO_PSRAM;
+    batch = (char*)(psramFound() ? ps_malloc(capacity) : malloc(capacity));
+    if (!batch) {
+      Serial.println("Uplink: no memory for the batch buffer");
+      return false;
+    }
+    return true;
+  }
+  
+  // Rows of one file from start into the batch, with its header row first.
+  // False if the file has no rows past start. Files are only compacted once
+  // the cursor has passed them, so a compacted file here predates the
+  // uplink being turned on and is skipped.
+  bool readBatch(const UplinkCursor& start) {
+    if (Gzip::isCompressed(start.name)) {
+      return false;
+    }
+    File file;
+    uint32_t length;
+    if (!logger->openDownload(start.name, file, length)) {
+      return false;
+    }
+    bool ok = BinLog::isBinaryFile(start.name) ? readBinary(file, length, start.offset)
+                                               : readCsv(file, length, start.offset);
+    file.close();
+    if (ok) {
+      memcpy(batchEnd.name, start.name, sizeof(batchEnd.name));
+    }
+    return ok;
+  }
+  
+  bool readCsv(File& file, uint32_t length, uint32_t offset) {
+    String header = file.readStringUntil('\n');
+    uint32_t dataStart = header.length() + 1;
+    uint32_t pos = offset > dataStart ? offset : dataStart;
+    if (pos >= length) {
+      return false;
+    }
+    header.trim();
+    RowWriter head(batch, capacity);
+    head.text(header.c_str()).text("\r\n");
+    batchLen = head.length();
+    
+    size_t want = length - pos;
+    if (want > capacity - batchLen) {
+      want = capacity - batchLen;
+    }
+    file.seek(pos);
+    size_t got = file.read((uint8_t*)batch + batchLen, want);
+    
+    // Whole rows only, up to the configured count
+    size_t end = 0;
+    for (size_t i = 0; i < got; i++) {
+      if (batch[batchLen + i] == '\n') {
+        end = i + 1;
+        if (++batchRecords == config->uplinkBatchRecords) {
+          break;
+        }
+      }
+    }
+    if (batchRecords == 0) {
+      batchLen = 0;
+      return false;
+    }
+    batchFull = batchRecords == config->uplinkBatchRecords || pos + end < length;
+    batchLen += end;
+    batchEnd.offset = pos + end;
+    return true;
+  }
+  
+  bool readBinary(File& file, uint32_t length, uint32_t offset) {
+    BinLogHeader hdr;
+    String header;
+    if (!BinLog::readHeader(file, hdr, &header)) {
+      return false;
+    }
+    uint32_t dataStart = BinLog::dataOffset(hdr);
+    uint32_t records = BinLog::recordCount(hdr, length);
+    uint32_t record = offset > dataStart ? (offset - dataStart) / hdr.recordSize : 0;
+    if (record >= records) {
+      return false;
+    }
+    RowWriter head(batch, capacity);
+    head.text(header.c_str()).text("\r\n");
+    batchLen = head.length();
+    
+    uint8_t rec[BinLog::MAX_RECORD_SIZE];
+    file.seek(dataStart + record * hdr.recordSize);
+    while (record < records && batchRecords < config->uplinkBatchRecords &&
+           capacity - batchLen >= BinLog::MAX_ROW_TEXT) {
+      if (file.read(rec, hdr.recordSize) != hdr.recordSize) {
+        break;
+      }
+      batchLen += BinLog::formatRow(rec, hdr, batch + batchLen, capacity - batchLen);
+      batchRecords++;
+      record++;
+    }
+    if (batchRecords == 0) {
+      batchLen = 0;
+      return false;
+    }
+    batchFull = record < records;
+    batchEnd.offset = dataStart + record * hdr.recordSize;
+    return true;
+  }
+  
+  // zlib stream of the batch, as HTTP's "deflate" coding. 0 if it can't be
+  // compressed here (no PSRAM for the deflate state) or doesn't shrink.
+  size_t compress() {
+    if (!psramFound()) {
+      return 0;
+    }
+    if (!packed && !(packed = (uint8_t*)ps_malloc(capacity))) {
+      return 0;
+    }
+    tdefl_compressor* deflater = (tdefl_compressor*)ps_malloc(sizeof(tdefl_compressor));
+    if (!deflater) {
+      return 0;
+    }
+    tdefl_init(deflater, nullptr, nullptr, TransferPump::DEFLATE_FLAGS);
+    size_t inSize = batchLen;
+    size_t outSize = capacity;
+    tdefl_status status = tdefl_compress(deflater, batch, &inSize, packed, &outSize, TDEFL_FINISH);
+    free(deflater);
+    return status == TDEFL_STATUS_DONE && inSize == batchLen ? outSize : 0;
+  }
+  
+  bool failed(int status) {
+    lastStatus = status;
+    failures++;
+    Serial.printf("Uplink: POST failed (%d), retrying in %us\n", status, retryMs / 1000);
+    nextAttemptMs = millis() + retryMs;
+    uint32_t maxRetryMs = config->uplinkInterval * 1000UL;
+    retryMs = retryMs * 2 > maxRetryMs ? maxRetryMs : retryMs * 2;
+    return false;
+  }
+  
+  // Backlog: next batch right away; caught up: after the interval
+  void scheduleNext(bool backlog) {
+    nextAttemptMs = millis() + (backlog ? 0 : config->uplinkInterval * 1000UL);
+  }
+  
+  void loadCursor() {
+    Preferences prefs;
+    if (prefs.begin(PREFS_NAMESPACE, true)) {
+      UplinkCursor stored;
+      if (prefs.getBytes(CURSOR_KEY, &stored, sizeof(stored)) == sizeof(stored)) {
+        stored.name[sizeof(stored.name) - 1] = '\0';
+        cursor = stored;
+      }
+      prefs.end();
+    }
+    cursorLoaded = true;
+  }
+  
+  void saveCursor() {
+    ScopedTimer timer(METRIC_NVS_PUT);
+    Preferences prefs;
+    if (prefs.begin(PREFS_NAMESPACE, false)) {
+      prefs.putBytes(CURSOR_KEY, &cursor, sizeof(cursor));
+      prefs.end();
+    }
+  }
+};
+
+#endif // UPLINK_H
@@ -0,0 +1,512 @@
+// Generated by tools/embed_web_assets.py from web/ - do not edit
+
+#ifndef WEB_ASSETS_H
+#define WEB_ASSETS_H
+
+#include <Arduino.h>
+
+// A gzip-compressed static file of the web UI
+struct WebAsset {
+  const char* path;
+  const char* contentType;
+  const uint8_t* data;
+  size_t length;
+  const char* etag;  // Strong ETag, quoted
+  bool versioned;    // Linked with ?v=<etag>, so it can be cached for good
+};
+
+// style.css: 3759 bytes, 1100 gzipped
+static const uint8_t WEB_STYLE_CSS[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xbd, 0x57, 0xdb, 0x8e, 0xdb, 0x36,
+  0x10, 0x7d, 0xdf, 0xaf, 0x20, 0x62, 0x04, 0xd9, 0x2d, 0x2c, 0x43, 0xb2, 0x2d, 0xaf, 0xe3, 0xa0,
+  0x40, 0xdf, 0x8a, 0x3c, 0xb7, 0xcd, 0x4b, 0xd1, 0x07, 0x4a, 0x1c, 0x49, 0xec, 0x52, 0xa4, 0x40,
+  0xd2, 0xf6, 0xba, 0x41, 0xfe, 0xbd, 0x43, 0xdd, 0x6f, 0xf6, 0xba, 0x40, 0xd2, 0x15, 0xb0, 0x91,
+  0xb8, 0xe4, 0x5c, 0xce, 0xcc, 0x39, 0xc3, 0xfc, 0x44, 0xbe, 0x3e, 0x10, 0xfc, 0xc9, 0xa9, 0x4e,
+  0xb9, 0x3c, 0x10, 0xff, 0x53, 0xf9, 0x59, 0x50, 0xc6, 0xb8, 0x4c, 0xdb, 0xef, 0x48, 0xbd, 0x7a,
+  0x86, 0xff, 0x53, 0x2e, 0x45, 0x4a, 0x33, 0xd0, 0x1e, 0x2e, 0x7d, 0x7a, 0xf8, 0xf6, 0xf0, 0x10,
+  0x29, 0x76, 0xa9, 0x8d, 0x24, 0x4a, 0x5a, 0x2f, 0xa1, 0x39, 0x17, 0x97, 0x03, 0xf9, 0xf0, 0x1b,
+  0xa4, 0x0a, 0xc8, 0x1f, 0x9f, 0x3f, 0x2c, 0xc9, 0xef, 0x34, 0x53, 0x39, 0x5d, 0x92, 0x5f, 0x41,
+  0xc2, 0x09, 0xff, 0xfd, 0x02, 0x9a, 0x51, 0x89, 0x2f, 0x86, 0x4a, 0xe3, 0x19, 0xd0, 0x3c, 0xa9,
+  0xfd, 0xd0, 0xf8, 0x25, 0xd5, 0xea, 0x28, 0xd9, 0x81, 0x08, 0x2e, 0x81, 0x6a, 0x2f, 0xd5, 0x94,
+  0x71, 0x90, 0xf6, 0x31, 0xd8, 0x84, 0x0c, 0xd2, 0x25, 0x59, 0xec, 0x76, 0xcf, 0x00, 0x94, 0xf8,
+  0xef, 0xf1, 0xfd, 0x79, 0xb7, 0x8d, 0xe8, 0x9a, 0x04, 0xbe, 0xff, 0xfe, 0xa9, 0x32, 0x91, 0x73,
+  0xe9, 0x65, 0xc0, 0xd3, 0xcc, 0x1e, 0xdc, 0xf2, 0x29, 0x1b, 0x65, 0xb4, 0xf6, 0x8b, 0x2a, 0xf0,
+  0x55, 0x8c, 0xe1, 0x52, 0x74, 0xa2, 0x5b, 0x0c, 0x5e, 0xbd, 0x33, 0x67, 0x36, 0xc3, 0x83, 0x6b,
+  0xbf, 0xdc, 0x36, 0x80, 0x86, 0xd0, 0xa3, 0x55, 0xd3, 0x38, 0xcf, 0x19, 0xb7, 0xd0, 0xc0, 0x54,
+  0x42, 0xe3, 0x22, 0x3e, 0x1a, 0xe7, 0xbe, 0xb1, 0x51, 0xe2, 0x97, 0x51, 0xa6, 0xce, 0xce, 0x8e,
+  0x5b, 0x27, 0x5b, 0xf7, 0x4b, 0xa7, 0x11, 0x7d, 0xf4, 0x97, 0xe5, 0xb3, 0x5a, 0xd7, 0x19, 0xa8,
+  0x13, 0xe8, 0x44, 0xb8, 0xad, 0x19, 0x67, 0x0c, 0x64, 0x19, 0x6d, 0x06, 0x94, 0xb5, 0x91, 0x7e,
+  0x07, 0x98, 0x62, 0x25, 0x94, 0x1e, 0x04, 0xdf, 0x22, 0xb4, 0x69, 0xc3, 0xb6, 0xf0, 0x6a, 0x3d,
+  0x2a, 0x78, 0x8a, 0xe9, 0xc7, 0x68, 0x1c, 0x74, 0x3f, 0x96, 0x2c, 0xe8, 0xd7, 0x1d, 0xdb, 0x03,
+  0x10, 0xdd, 0x55, 0x08, 0x79, 0x1f, 0x37, 0xec, 0x13, 0x6b, 0x55, 0xde, 0x80, 0x81, 0xa7, 0x25,
+  0x3d, 0xd5, 0xe7, 0x18, 0x37, 0x85, 0xa0, 0xd8, 0x2b, 0x89, 0x80, 0xd7, 0x29, 0xb0, 0x8b, 0x24,
+  0x74, 0xcf, 0x00, 0xda, 0xc6, 0xda, 0x1a, 0xc1, 0x33, 0x4a, 0x70, 0x46, 0x16, 0x8c, 0xb1, 0xaa,
+  0x9e, 0x96, 0x46, 0x5e, 0x64, 0x65, 0x13, 0x14, 0xda, 0x44, 0xaf, 0xa3, 0xdc, 0x82, 0xb0, 0x2b,
+  0x89, 0x33, 0x78, 0x20, 0x52, 0x49, 0x98, 0xfa, 0xee, 0x56, 0xe3, 0xa3, 0x36, 0x0e, 0xa9, 0x42,
+  0xf1, 0x0a, 0x80, 0x51, 0xc6, 0xc1, 0xae, 0xb1, 0x58, 0x2e, 0x9e, 0xeb, 0xd6, 0x0b, 0xfd, 0x9a,
+  0x3a, 0x56, 0x63, 0x8f, 0x73, 0xcb, 0x15, 0x62, 0x48, 0x85, 0x20, 0xfe, 0x6a, 0x63, 0x06, 0xf1,
+  0x1e, 0x32, 0x57, 0xf0, 0x99, 0xca, 0x2e, 0xc0, 0x77, 0xcf, 0x60, 0xf3, 0x8a, 0xc6, 0x96, 0x9f,
+  0x60, 0x66, 0xf7, 0xb4, 0x0d, 0x1b, 0xac, 0x36, 0x1d, 0x56, 0x55, 0x4f, 0x74, 0x16, 0x1d, 0x05,
+  0xb0, 0xae, 0xe3, 0x7a, 0x74, 0xd9, 0xcf, 0x34, 0x05, 0x95, 0x3c, 0xa7, 0x55, 0x3e, 0x09, 0xf6,
+  0xc1, 0x67, 0x39, 0x4a, 0xa9, 0xb6, 0x39, 0x8c, 0xb4, 0x35, 0x1d, 0x09, 0x15, 0xbf, 0x94, 0x9b,
+  0x7f, 0x79, 0x81, 0x4b, 0xa2, 0x69, 0x0e, 0xa6, 0xb1, 0x53, 0x17, 0x4e, 0xab, 0x9c, 0x7c, 0x25,
+  0xaa, 0xa0, 0x31, 0xb7, 0x17, 0x27, 0x41, 0xe4, 0x5b, 0x85, 0xa4, 0xea, 0x2f, 0x07, 0x6e, 0xd9,
+  0xf9, 0x34, 0x96, 0x5a, 0x83, 0xfd, 0x8f, 0xf9, 0x8d, 0x7c, 0xb9, 0xb5, 0x2a, 0x66, 0xf7, 0xe6,
+  0x59, 0xc8, 0x71, 0xdd, 0x02, 0x46, 0x28, 0x8e, 0xb9, 0x44, 0x82, 0x6a, 0x28, 0x80, 0xda, 0x47,
+  0xc7, 0x6b, 0x2f, 0xe1, 0x76, 0xe9, 0xc4, 0x03, 0x55, 0xe0, 0xb1, 0x64, 0xff, 0x92, 0x04, 0x89,
+  0x7e, 0xaa, 0xe9, 0x92, 0xd2, 0xa2, 0x91, 0x8e, 0xbe, 0x26, 0xb8, 0x15, 0x52, 0x57, 0xc8, 0xc5,
+  0xe1, 0xc5, 0x54, 0xb3, 0xff, 0x85, 0xa4, 0x6b, 0x7f, 0xd8, 0xc8, 0x33, 0xa2, 0x33, 0xc7, 0xde,
+  0xa9, 0x18, 0x6d, 0x31, 0x83, 0xdd, 0x58, 0x8a, 0x82, 0xa7, 0x71, 0x4e, 0xd9, 0x66, 0x4a, 0xf6,
+  0x60, 0x3b, 0xc4, 0x63, 0xc4, 0xf5, 0x52, 0xcb, 0xda, 0x2a, 0xae, 0x3e, 0xf6, 0x4c, 0x9e, 0xa8,
+  0x38, 0xc2, 0x8c, 0x7a, 0x6c, 0x67, 0xb9, 0x14, 0x29, 0x51, 0x53, 0x5c, 0xa3, 0xf2, 0x60, 0xfa,
+  0x66, 0x8e, 0x2d, 0xc9, 0x47, 0xf7, 0xdc, 0x0b, 0xd3, 0x7e, 0x14, 0xba, 0x55, 0x45, 0x6f, 0x36,
+  0x2c, 0x34, 0xc4, 0x1d, 0x2f, 0x1a, 0x41, 0xf6, 0x50, 0x50, 0xaa, 0x19, 0xd0, 0xdb, 0x82, 0x2d,
+  0x2f, 0x9a, 0x54, 0x9a, 0xe9, 0x81, 0x15, 0x1c, 0x38, 0xc5, 0x3a, 0x0a, 0x5a, 0x18, 0xcc, 0xb0,
+  0x79, 0x9b, 0xc8, 0x08, 0xe2, 0xe3, 0x84, 0xb3, 0x6f, 0x38, 0xc3, 0x9e, 0x68, 0xde, 0x9b, 0xa6,
+  0x6a, 0x13, 0x73, 0x65, 0xdb, 0xcf, 0x55, 0x5a, 0x3b, 0xcc, 0x66, 0x75, 0x20, 0x18, 0x69, 0x66,
+  0x19, 0xb1, 0x6b, 0x2d, 0xcf, 0x60, 0x95, 0xc0, 0xd1, 0xfe, 0xac, 0x69, 0x51, 0x97, 0x09, 0x24,
+  0xca, 0x9e, 0x87, 0x7f, 0xcd, 0x6f, 0x8b, 0xcd, 0x8c, 0xb4, 0x36, 0xec, 0x08, 0x6a, 0x76, 0xdc,
+  0x82, 0xbf, 0x5e, 0x17, 0x90, 0xd8, 0x2a, 0xa9, 0x19, 0xa5, 0x32, 0x60, 0xad, 0xab, 0xba, 0x97,
+  0x28, 0x9d, 0x13, 0x41, 0x23, 0x10, 0x57, 0x64, 0x65, 0x5c, 0xd0, 0x71, 0x4c, 0x2d, 0x16, 0xe1,
+  0x75, 0xd1, 0x9e, 0x7a, 0xe4, 0xb2, 0x38, 0xda, 0x3f, 0xed, 0xa5, 0x80, 0x9f, 0xdf, 0x39, 0xa8,
+  0xdf, 0xfd, 0xb5, 0xbc, 0xb5, 0xa5, 0xa0, 0xc6, 0x9c, 0x31, 0xad, 0x37, 0xb6, 0xc9, 0x63, 0x1e,
+  0x81, 0x9e, 0xd9, 0x64, 0x40, 0x40, 0x6c, 0xaf, 0xb5, 0x54, 0x87, 0xb7, 0x3f, 0x1e, 0x65, 0x73,
+  0x05, 0x1e, 0xe1, 0x3e, 0xcc, 0xbb, 0x4f, 0xe3, 0x69, 0xda, 0x2d, 0xe5, 0x07, 0x14, 0xb9, 0x86,
+  0x68, 0x07, 0x75, 0xad, 0x5a, 0x83, 0x12, 0xe2, 0xe8, 0xf2, 0x0a, 0x8d, 0x83, 0x43, 0x5f, 0x96,
+  0xa4, 0xfc, 0x32, 0x80, 0x83, 0x82, 0x75, 0xdf, 0x67, 0xaa, 0x25, 0xfa, 0x1e, 0xf7, 0x79, 0xe0,
+  0x26, 0x7d, 0xa7, 0x0b, 0x33, 0x53, 0xfb, 0x8e, 0x04, 0xdb, 0x11, 0x3d, 0x3b, 0xcc, 0x07, 0xed,
+  0x1a, 0xba, 0x96, 0x25, 0x6f, 0xce, 0xee, 0x5e, 0x3e, 0x73, 0x5a, 0xd4, 0xa4, 0x3e, 0x15, 0xf1,
+  0xd1, 0xe1, 0xeb, 0xc3, 0x3f, 0x0c, 0x77, 0x7b, 0xb6, 0xe9, 0x0e, 0xb4, 0x78, 0xcd, 0xfa, 0x8b,
+  0x9f, 0xc3, 0x67, 0x76, 0xcb, 0x5f, 0x7b, 0xfc, 0x86, 0x47, 0xba, 0x5b, 0xef, 0xf6, 0xdd, 0x91,
+  0x61, 0x45, 0x86, 0x5a, 0x9b, 0xc4, 0x81, 0xff, 0x3c, 0x2c, 0xb7, 0xdf, 0x90, 0xa7, 0x77, 0xf6,
+  0xd6, 0xdd, 0x86, 0xee, 0xeb, 0x03, 0x8b, 0x84, 0x0b, 0xf0, 0x04, 0x37, 0xf6, 0x87, 0xcb, 0x7a,
+  0xe9, 0xa9, 0xa0, 0x69, 0xef, 0xce, 0xdf, 0x13, 0x8b, 0xb7, 0xee, 0xbd, 0xab, 0xf2, 0xf8, 0x7f,
+  0x91, 0xc4, 0xf5, 0x58, 0x12, 0xf7, 0x57, 0x15, 0xb1, 0x6d, 0xdc, 0x99, 0x5b, 0xf1, 0xdf, 0x47,
+  0x63, 0x79, 0x72, 0x69, 0xae, 0x56, 0x07, 0x52, 0x0a, 0xb6, 0x17, 0x81, 0x3d, 0x83, 0xfb, 0xff,
+  0x41, 0x79, 0x2d, 0x73, 0xe1, 0x96, 0xc1, 0x99, 0x6b, 0x41, 0x47, 0x47, 0xa4, 0xaa, 0x1c, 0x33,
+  0xcc, 0x0d, 0xff, 0x2e, 0xd0, 0x3b, 0xdb, 0xf8, 0x2e, 0x2e, 0x6e, 0xaf, 0xd2, 0x6e, 0x2e, 0xae,
+  0x7b, 0xa8, 0xf0, 0x2f, 0xe2, 0x87, 0xd4, 0x7e, 0xaf, 0x0e, 0x00, 0x00,
+};
+
+// script.js: 16442 bytes, 3924 gzipped
+static const uint8_t WEB_SCRIPT_JS[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xcd, 0x5b, 0x51, 0x73, 0xdb, 0x36,
+  0x12, 0x7e, 0xf7, 0xaf, 0x40, 0x3d, 0x73, 0xa1, 0xd4, 0xd8, 0x92, 0x92, 0xb4, 0xb9, 0xab, 0x62,
+  0x39, 0xe3, 0xc4, 0xce, 0xc5, 0x57, 0x27, 0xf6, 0x58, 0x4e, 0xfb, 0x90, 0x66, 0x32, 0x10, 0x09,
+  0x59, 0xbc, 0x50, 0x04, 0x4b, 0x42, 0x76, 0x94, 0xd6, 0xbf, 0xe2, 0x1e, 0xee, 0xe5, 0x7e, 0xdd,
+  0xfd, 0x92, 0xdb, 0x5d, 0x80, 0x24, 0x40, 0x52, 0x36, 0x99, 0xa4, 0x9d, 0xcb, 0x4c, 0x12, 0x11,
+  0xc0, 0x7e, 0x58, 0x2c, 0x76, 0x17, 0x1f, 0x40, 0x30, 0x12, 0x8a, 0x65, 0x8a, 0xab, 0x55, 0x76,
+  0x1c, 0x2b, 0x91, 0x5e, 0xf1, 0xe8, 0xc9, 0x56, 0x54, 0x94, 0x9d, 0x89, 0x34, 0x94, 0x01, 0x9b,
+  0xb0, 0x91, 0x2e, 0x8d, 0xc2, 0x2b, 0x31, 0x95, 0xab, 0xd4, 0x17, 0x50, 0x16, 0xaf, 0x22, 0xd3,
+  0x78, 0xb6, 0x9a, 0xcf, 0x45, 0xfa, 0x9c, 0x27, 0xdc, 0x0f, 0xd5, 0xba, 0x6c, 0x9e, 0x0a, 0x5f,
+  0xc4, 0x6a, 0x2a, 0x7e, 0xad, 0x16, 0x3d, 0x97, 0xd1, 0x6a, 0x19, 0x67, 0x50, 0xfc, 0xf6, 0x9d,
+  0x5d, 0x7e, 0x2e, 0xaf, 0xed, 0xc2, 0x4c, 0xc4, 0x99, 0x4c, 0xa7, 0x91, 0x54, 0x19, 0x21, 0x30,
+  0x36, 0x1c, 0xb2, 0x29, 0x15, 0x32, 0x68, 0x9d, 0x86, 0x22, 0x63, 0x32, 0x66, 0x6a, 0x21, 0x4c,
+  0x69, 0xc6, 0x14, 0x9f, 0x6d, 0xf9, 0x32, 0xce, 0x14, 0x3b, 0x3f, 0x7a, 0x7e, 0xf4, 0xfa, 0xe2,
+  0xfd, 0xf9, 0xe9, 0xcf, 0x53, 0x10, 0x7e, 0x00, 0xfd, 0xeb, 0xf2, 0xe9, 0xc5, 0xc1, 0xc5, 0x9b,
+  0xe9, 0xfb, 0xb3, 0xd3, 0x93, 0x93, 0xf7, 0xaf, 0xb0, 0xea, 0xfb, 0xd1, 0x08, 0xa1, 0x11, 0xfb,
+  0xe7, 0x50, 0x2d, 0xe4, 0x4a, 0x8f, 0x93, 0x89, 0x2b, 0xe8, 0x23, 0x73, 0xa5, 0x4e, 0x8e, 0x7f,
+  0x3a, 0xd2, 0x52, 0x8f, 0x46, 0x5a, 0x0c, 0xa4, 0x9e, 0x71, 0x05, 0xa6, 0x5b, 0xef, 0x80, 0xd1,
+  0x64, 0xca, 0x2f, 0x05, 0xe3, 0x71, 0x00, 0x03, 0xe2, 0x41, 0x18, 0x5f, 0x66, 0xec, 0x7a, 0x11,
+  0x46, 0xc2, 0x46, 0x64, 0x3c, 0x4d, 0xe1, 0x69, 0x6b, 0x6b, 0xbe, 0x8a, 0x7d, 0x15, 0xc2, 0x00,
+  0xb2, 0x85, 0xbc, 0xbe, 0xe0, 0xb3, 0x1e, 0x28, 0xff, 0x9a, 0x2f, 0x45, 0x9f, 0xfd, 0xb6, 0xc5,
+  0xb4, 0x42, 0x2f, 0xc3, 0x00, 0xe0, 0xa2, 0x08, 0xc7, 0x95, 0x51, 0x61, 0x20, 0xfd, 0xd5, 0x12,
+  0x60, 0x06, 0xbf, 0xae, 0xa0, 0xcf, 0xa9, 0x88, 0x84, 0x0f, 0xbd, 0x1e, 0x44, 0x51, 0xcf, 0x1b,
+  0x40, 0xa3, 0x5d, 0x50, 0x57, 0x41, 0xb5, 0xd7, 0x1f, 0xcc, 0x65, 0x7a, 0xc4, 0xfd, 0x05, 0xa2,
+  0xb2, 0xc9, 0xbe, 0xc1, 0xc4, 0x3f, 0x50, 0x30, 0xf0, 0x23, 0x9e, 0x65, 0x27, 0x61, 0xa6, 0x06,
+  0xa9, 0x58, 0xca, 0x2b, 0xd1, 0xf3, 0x38, 0xe8, 0x72, 0x25, 0xbc, 0xfe, 0x13, 0x6a, 0x77, 0x63,
+  0xfe, 0xbf, 0xab, 0xbb, 0x99, 0x8a, 0xad, 0xae, 0xe0, 0xc9, 0xed, 0x0a, 0x0a, 0x5a, 0x77, 0x95,
+  0x8f, 0x79, 0x0a, 0xd6, 0x80, 0xa9, 0xc7, 0x9e, 0x44, 0x40, 0x13, 0xea, 0x28, 0x72, 0x29, 0xd4,
+  0x51, 0x24, 0xf0, 0xe7, 0xb3, 0xf5, 0x71, 0x50, 0xd8, 0xcc, 0xea, 0x86, 0x07, 0x41, 0xb5, 0x8f,
+  0x4d, 0xd2, 0x1e, 0x8e, 0xc1, 0x63, 0xf7, 0x59, 0x3b, 0x98, 0x5c, 0xc5, 0x13, 0xc9, 0x49, 0xb3,
+  0xdd, 0x2c, 0x11, 0x7e, 0x38, 0x0f, 0x7d, 0x16, 0x70, 0xc5, 0xa9, 0x36, 0x9c, 0xb3, 0x5c, 0x27,
+  0x36, 0x99, 0x4c, 0x98, 0x17, 0xf0, 0x6c, 0x31, 0x93, 0x3c, 0x0d, 0xbc, 0xbe, 0x65, 0x98, 0x08,
+  0x10, 0xa6, 0x14, 0x63, 0x3d, 0x83, 0x8d, 0x7f, 0x20, 0xea, 0x52, 0x75, 0x02, 0x1d, 0xe6, 0x85,
+  0x37, 0x4c, 0x44, 0x99, 0xb0, 0xe4, 0xc0, 0xc5, 0x12, 0xbb, 0x41, 0xa1, 0x55, 0x63, 0xdf, 0x3a,
+  0x80, 0x32, 0xa7, 0xe7, 0xa2, 0x77, 0x5d, 0x67, 0x03, 0x99, 0xde, 0x1a, 0x60, 0x94, 0x42, 0x5f,
+  0xde, 0x80, 0xa3, 0x2b, 0xdb, 0x00, 0xa1, 0x95, 0x6a, 0x20, 0xa9, 0x98, 0xa7, 0x22, 0x5b, 0xbc,
+  0x80, 0x30, 0x71, 0x41, 0xb4, 0x05, 0xb6, 0x6e, 0xb6, 0xb6, 0xc0, 0xe4, 0xaf, 0x05, 0x38, 0x05,
+  0x5f, 0x26, 0xd0, 0x08, 0x02, 0x48, 0xb0, 0x64, 0x95, 0x2d, 0xc0, 0x3d, 0x66, 0x6b, 0x36, 0xe4,
+  0x49, 0x38, 0xd4, 0xa1, 0xf5, 0x84, 0x72, 0xc1, 0x1c, 0x12, 0x93, 0x49, 0x60, 0x2c, 0xcc, 0x58,
+  0x22, 0xa3, 0x08, 0x5a, 0x66, 0x91, 0xbc, 0x8e, 0xd6, 0x08, 0xc5, 0x23, 0x09, 0xfa, 0x42, 0x64,
+  0xed, 0x50, 0xa4, 0x72, 0x45, 0x52, 0x32, 0x82, 0xa0, 0xe5, 0x4a, 0x40, 0xc0, 0x8a, 0x18, 0xe0,
+  0x52, 0x2a, 0x25, 0x5c, 0x00, 0x83, 0x70, 0x5e, 0x22, 0x58, 0x20, 0xaf, 0x63, 0x2b, 0x70, 0xcb,
+  0xf9, 0x32, 0x83, 0xc2, 0x21, 0x7f, 0x73, 0x1d, 0xc6, 0xd0, 0x6e, 0x70, 0x84, 0xb2, 0x3a, 0x5d,
+  0xda, 0x63, 0x46, 0x7d, 0xcc, 0xd4, 0xbb, 0xb9, 0xc8, 0x1a, 0x7b, 0x2a, 0xd4, 0x2a, 0x8d, 0x8d,
+  0x0f, 0x14, 0xc0, 0x65, 0xfa, 0xb5, 0xf1, 0xea, 0x6d, 0xdd, 0x34, 0x0d, 0x86, 0xb3, 0x34, 0xe9,
+  0x79, 0x96, 0xbd, 0x72, 0xbf, 0x2e, 0x05, 0xd0, 0xeb, 0xa9, 0x35, 0x86, 0x00, 0xd8, 0x21, 0xed,
+  0x79, 0xda, 0xea, 0xde, 0x0e, 0x13, 0x18, 0xdb, 0x32, 0xc6, 0xf1, 0x4e, 0xa9, 0xac, 0xf7, 0x8f,
+  0xe9, 0xe9, 0xeb, 0x41, 0xc2, 0xd3, 0x4c, 0xf4, 0xc4, 0x00, 0x27, 0xb7, 0xdf, 0xaf, 0x23, 0xca,
+  0x58, 0x26, 0x02, 0xf2, 0x02, 0x03, 0x23, 0x39, 0xc9, 0x01, 0xbd, 0xe7, 0x9c, 0xf2, 0x3e, 0x4c,
+  0x3b, 0xc5, 0xd5, 0x73, 0xae, 0xfc, 0x05, 0x5b, 0x25, 0x98, 0xd5, 0xf3, 0xc9, 0x5e, 0x86, 0x59,
+  0x06, 0xd3, 0xa7, 0xd3, 0x68, 0x10, 0x66, 0x90, 0xe0, 0x62, 0x4a, 0x0d, 0xb7, 0x18, 0xd4, 0xa4,
+  0xe9, 0x3c, 0x88, 0x1a, 0x54, 0x12, 0x69, 0x0a, 0x8b, 0x48, 0xae, 0xd3, 0x2d, 0x53, 0x42, 0x7a,
+  0x5d, 0x80, 0x27, 0xcc, 0x52, 0x58, 0x9c, 0xc0, 0x2b, 0x3e, 0x08, 0x91, 0x64, 0x68, 0xf4, 0x74,
+  0x0d, 0x6e, 0xbf, 0x75, 0xd7, 0x8c, 0xde, 0xd8, 0x79, 0xbe, 0x08, 0x5e, 0xcb, 0x5b, 0x9a, 0x27,
+  0xd5, 0x52, 0xd6, 0x8f, 0x64, 0xe6, 0xc4, 0x7b, 0xc3, 0x2a, 0xec, 0xfa, 0x89, 0xbb, 0xa0, 0xdb,
+  0xb0, 0x7e, 0x24, 0x78, 0x9a, 0x57, 0x54, 0xdb, 0x39, 0x79, 0xc8, 0xaa, 0x70, 0x7a, 0x29, 0xab,
+  0x6d, 0x72, 0x50, 0x44, 0x6a, 0x31, 0x56, 0xcb, 0x26, 0x09, 0x35, 0xb4, 0xc7, 0x5c, 0xc1, 0xbf,
+  0x77, 0xaf, 0x02, 0x09, 0xb9, 0xc2, 0x15, 0x6a, 0xf6, 0xf3, 0x16, 0xa3, 0xa9, 0xa8, 0xaa, 0x51,
+  0xed, 0x2a, 0x6b, 0x90, 0x90, 0xe6, 0x0a, 0xb0, 0x32, 0x3f, 0xef, 0xe4, 0xaa, 0xb8, 0x73, 0xe9,
+  0xc4, 0x01, 0xb9, 0xbe, 0x51, 0x75, 0xe3, 0x52, 0x83, 0x8d, 0x12, 0x19, 0x52, 0xd8, 0x0d, 0x94,
+  0xf8, 0x08, 0x2c, 0x88, 0x96, 0x6a, 0xe8, 0x19, 0xab, 0x06, 0x65, 0xfd, 0x40, 0xc9, 0x13, 0xe9,
+  0xf3, 0x48, 0x4c, 0x81, 0xe3, 0xc4, 0x97, 0xbd, 0xbb, 0x16, 0x31, 0xcd, 0xbf, 0x9a, 0x51, 0x0d,
+  0x37, 0x93, 0x2b, 0x28, 0xba, 0xcf, 0x3c, 0x36, 0x64, 0xb8, 0xdc, 0xb9, 0x8c, 0xcd, 0x5d, 0xdc,
+  0x0e, 0xd8, 0x25, 0x4f, 0x58, 0x0f, 0xc2, 0x83, 0x83, 0xcd, 0x67, 0x52, 0xaa, 0x3e, 0x5b, 0x0a,
+  0x0e, 0x74, 0x2d, 0x0f, 0xc9, 0x6b, 0x01, 0x09, 0xd8, 0xc4, 0xe5, 0x2e, 0x9b, 0x0b, 0x0c, 0x5a,
+  0x48, 0x96, 0x90, 0x20, 0x81, 0x2a, 0x01, 0xef, 0xd1, 0x93, 0x43, 0xbc, 0x09, 0x82, 0x26, 0xd7,
+  0x04, 0x7e, 0x3e, 0x29, 0x3c, 0xc0, 0xa2, 0x86, 0x30, 0xd9, 0x23, 0xf6, 0xfb, 0xef, 0xd8, 0xf4,
+  0xed, 0xe8, 0x1d, 0xfb, 0x06, 0x9e, 0xcb, 0xda, 0xfb, 0xec, 0x41, 0x7f, 0x53, 0xca, 0xb8, 0xc5,
+  0x33, 0x1c, 0x3a, 0x59, 0x3e, 0x0c, 0x40, 0x29, 0x9f, 0xab, 0xde, 0x5b, 0xe8, 0xeb, 0x5d, 0x7f,
+  0x90, 0x45, 0x21, 0x24, 0xc4, 0x5d, 0x8b, 0x29, 0x1a, 0x50, 0x9b, 0xb8, 0x6a, 0xb5, 0xf2, 0xf2,
+  0x38, 0x10, 0x69, 0xa9, 0x80, 0xed, 0x10, 0xf6, 0x8a, 0x6e, 0x34, 0x26, 0xcb, 0x98, 0x84, 0xab,
+  0xbd, 0xcd, 0xeb, 0x17, 0x4a, 0x0f, 0xc0, 0x62, 0x31, 0xd8, 0x21, 0x4b, 0xc0, 0x50, 0x94, 0x5a,
+  0xf3, 0xdf, 0x83, 0x7f, 0x66, 0x32, 0xee, 0xf5, 0xab, 0x4d, 0xd1, 0x88, 0x6e, 0x02, 0xfd, 0x63,
+  0xdd, 0xed, 0xce, 0x1e, 0x66, 0x9a, 0xf7, 0x6e, 0xf0, 0x3b, 0x5d, 0x09, 0xd8, 0x2f, 0xc2, 0x8f,
+  0x22, 0xe8, 0x3d, 0xec, 0xa3, 0xfb, 0xfd, 0xe4, 0xb5, 0xc4, 0x36, 0x54, 0xba, 0x19, 0xdb, 0x54,
+  0xbe, 0x41, 0xff, 0x2b, 0x7d, 0xda, 0xae, 0xba, 0x90, 0x8a, 0x47, 0x6e, 0x57, 0xb4, 0xa1, 0x08,
+  0x2e, 0x00, 0xad, 0x80, 0x09, 0x5e, 0x0a, 0x1e, 0xa9, 0xc5, 0x9a, 0x3d, 0x65, 0xde, 0x7f, 0xff,
+  0xf3, 0x2f, 0x66, 0x1e, 0x3d, 0x36, 0xc6, 0xe7, 0x7f, 0xb3, 0x23, 0x5c, 0x24, 0x2a, 0x1a, 0xa3,
+  0xf3, 0x56, 0xa4, 0x21, 0x7d, 0x99, 0x92, 0xe7, 0x91, 0xf4, 0x3f, 0x54, 0xf9, 0x0d, 0xe5, 0x1a,
+  0xdd, 0xf1, 0x7d, 0xe0, 0x40, 0xac, 0x87, 0xca, 0xf6, 0x6c, 0x09, 0x4c, 0xf1, 0xfe, 0x87, 0x1f,
+  0x5f, 0x7e, 0x82, 0x91, 0x3c, 0x80, 0x6d, 0x05, 0x99, 0x8a, 0xbd, 0x7a, 0xf9, 0xa9, 0x5f, 0xe9,
+  0xfc, 0xa6, 0xa5, 0xf1, 0x82, 0x05, 0xa9, 0x56, 0xb3, 0x9e, 0x56, 0xa3, 0xed, 0x14, 0x10, 0x41,
+  0xf4, 0x31, 0x73, 0x6c, 0x98, 0x06, 0x6a, 0x40, 0xa9, 0xa5, 0x25, 0xe4, 0x2a, 0x51, 0xe1, 0xb2,
+  0x3e, 0xa9, 0xb0, 0x7d, 0x58, 0x72, 0xf5, 0x86, 0x2a, 0xb5, 0x61, 0x74, 0xc3, 0xd6, 0x8e, 0xd8,
+  0x39, 0xff, 0xd9, 0x55, 0x4e, 0x12, 0x2c, 0x36, 0x2e, 0xd5, 0x2d, 0xed, 0x9d, 0x12, 0xe8, 0x5f,
+  0xd7, 0xb0, 0x17, 0xb0, 0x3d, 0x0c, 0x9f, 0x8f, 0x62, 0x3e, 0x43, 0xfe, 0x69, 0x7c, 0xcc, 0x3c,
+  0x16, 0x3e, 0x76, 0x18, 0x66, 0xba, 0x60, 0x83, 0x9b, 0xd9, 0x10, 0xb9, 0xa3, 0xc5, 0x42, 0x5d,
+  0xcb, 0xb4, 0xd1, 0xd1, 0x0a, 0x0d, 0x4a, 0x57, 0xb3, 0x45, 0x06, 0x98, 0x86, 0x44, 0xe1, 0x7f,
+  0x79, 0x29, 0x1a, 0x7b, 0xba, 0x8e, 0x7d, 0xad, 0x26, 0xe9, 0xb6, 0xc3, 0xc8, 0x29, 0x59, 0x2c,
+  0x21, 0x6c, 0xa8, 0xca, 0x23, 0xb7, 0xfc, 0x4c, 0x97, 0x44, 0xbd, 0xf2, 0x14, 0x58, 0x99, 0xa6,
+  0x5c, 0x65, 0x17, 0xd7, 0x79, 0x80, 0x55, 0xe9, 0x4d, 0x12, 0xa0, 0xe6, 0xf9, 0xb6, 0xba, 0x66,
+  0xfa, 0xbc, 0xe2, 0xe5, 0xc5, 0xab, 0x13, 0x00, 0xf5, 0xaa, 0x89, 0x86, 0x56, 0x20, 0xd3, 0xa6,
+  0xd8, 0xaf, 0x9a, 0x82, 0x7a, 0x56, 0xd5, 0xc9, 0xde, 0x42, 0x44, 0x73, 0xee, 0x05, 0xe1, 0x15,
+  0xa3, 0xfd, 0xe1, 0x64, 0x5b, 0xfb, 0xfe, 0x6e, 0xa8, 0xc4, 0x72, 0x7b, 0xbf, 0xd2, 0x57, 0xb3,
+  0xf0, 0xe2, 0xbb, 0x7d, 0x9c, 0x0d, 0x53, 0x31, 0x88, 0x71, 0x53, 0x04, 0xf6, 0xdc, 0x1b, 0x62,
+  0x45, 0x1b, 0x80, 0xc4, 0x91, 0xa7, 0xd5, 0x80, 0xe4, 0x93, 0x76, 0xe2, 0x43, 0xd0, 0xbe, 0xda,
+  0xf2, 0xa6, 0x6d, 0x84, 0xe5, 0x70, 0x30, 0x79, 0x21, 0xd0, 0xef, 0xd4, 0x58, 0xd9, 0xe9, 0x05,
+  0x96, 0x70, 0x54, 0xf2, 0xb5, 0x34, 0xe7, 0x36, 0xe5, 0x11, 0x08, 0xbf, 0xe2, 0x61, 0x84, 0x2e,
+  0x5c, 0x51, 0xf6, 0xc6, 0x5a, 0xe2, 0x7c, 0xa4, 0xfe, 0x3d, 0xa0, 0xe5, 0x38, 0x19, 0xc8, 0x1d,
+  0x64, 0x24, 0x06, 0xc4, 0xd2, 0x7b, 0x1e, 0xe5, 0x61, 0x5a, 0x60, 0x71, 0xb2, 0xb4, 0x1b, 0x8d,
+  0x71, 0x43, 0x92, 0xa6, 0x7d, 0x7b, 0x67, 0xee, 0xb2, 0x83, 0xea, 0xe2, 0x9c, 0xd7, 0x94, 0xa7,
+  0x2b, 0xa7, 0x71, 0xb4, 0x2e, 0x48, 0x0d, 0xec, 0x93, 0x68, 0xcf, 0xc7, 0xf5, 0x81, 0x12, 0x4c,
+  0xb3, 0x02, 0x92, 0x27, 0x60, 0x30, 0xb0, 0x79, 0xc1, 0x1d, 0x27, 0x8c, 0x4a, 0xd5, 0x96, 0x75,
+  0xcd, 0x14, 0x9e, 0x46, 0xe1, 0x32, 0x54, 0x13, 0x9c, 0x1f, 0xfb, 0xd8, 0x09, 0xa6, 0xe7, 0x5e,
+  0x16, 0x42, 0xec, 0x4c, 0xf4, 0xcc, 0x19, 0x52, 0xf1, 0xd5, 0x39, 0x40, 0x91, 0x2c, 0x40, 0x1a,
+  0x77, 0xa4, 0xfd, 0x46, 0x6f, 0x76, 0x0f, 0xde, 0xa8, 0xbd, 0xaf, 0x1f, 0x9f, 0x6c, 0x68, 0x6d,
+  0x1d, 0xc7, 0x6d, 0x0e, 0xf9, 0x3b, 0xa8, 0x96, 0x5e, 0x29, 0xb4, 0x8d, 0x6f, 0x61, 0x5c, 0xf6,
+  0x50, 0x2c, 0x90, 0x48, 0xc4, 0x97, 0x6a, 0xc1, 0xf6, 0xd9, 0x68, 0xf3, 0x98, 0x0c, 0x4d, 0x2b,
+  0x84, 0xde, 0xd6, 0xe5, 0x77, 0xd9, 0x83, 0x77, 0x05, 0x89, 0xdb, 0x34, 0x0c, 0x97, 0xda, 0x7d,
+  0x99, 0x8f, 0x6a, 0x15, 0x72, 0xdf, 0xb2, 0x7c, 0xd5, 0x76, 0x4a, 0xb7, 0x4b, 0x6b, 0x7b, 0x54,
+  0x1f, 0x00, 0x91, 0x64, 0xdb, 0x04, 0xb7, 0x44, 0xaa, 0xaf, 0x8f, 0xff, 0xec, 0x38, 0xcd, 0xe3,
+  0xd2, 0xb8, 0xfa, 0x5a, 0xa8, 0x4a, 0x24, 0x36, 0x9c, 0x21, 0x40, 0x4e, 0x5d, 0xa8, 0x65, 0x44,
+  0xd2, 0x0a, 0x83, 0x77, 0x7f, 0x4f, 0xa5, 0xf0, 0x77, 0xb1, 0x7f, 0x01, 0xab, 0xc5, 0xde, 0x10,
+  0x7e, 0x78, 0x36, 0x5b, 0x36, 0xae, 0x55, 0xe4, 0x56, 0xf0, 0x2d, 0x34, 0x13, 0x61, 0x50, 0x02,
+  0x42, 0x01, 0x08, 0x03, 0x2c, 0xa7, 0xbc, 0x85, 0xcf, 0xc6, 0xd0, 0x65, 0xa3, 0x21, 0xf4, 0xe1,
+  0xc0, 0x92, 0x15, 0xb4, 0xdb, 0xf4, 0xc1, 0xbf, 0xaf, 0x04, 0x1e, 0x36, 0x94, 0x27, 0x8e, 0xb4,
+  0xbf, 0xb0, 0xe3, 0xc1, 0xea, 0x0f, 0xb5, 0x0d, 0xa8, 0x4f, 0x6c, 0xf6, 0xf6, 0x81, 0xde, 0x5b,
+  0xe0, 0x56, 0x16, 0x56, 0x39, 0x3c, 0x16, 0x39, 0x84, 0x15, 0x25, 0xaf, 0xfa, 0x56, 0x33, 0xaf,
+  0x82, 0x0b, 0xe3, 0x20, 0x73, 0x3e, 0x8c, 0xeb, 0xe1, 0xae, 0x5e, 0xfe, 0x40, 0xc1, 0xc0, 0x31,
+  0x9c, 0xbc, 0x36, 0xda, 0x3d, 0x2c, 0x95, 0xba, 0xaa, 0x0c, 0xdc, 0x28, 0x71, 0x65, 0xf7, 0x7f,
+  0x55, 0x03, 0xb5, 0x9c, 0xae, 0xd1, 0x1e, 0x37, 0x0d, 0xc6, 0xa2, 0x79, 0xf1, 0xee, 0xd8, 0x1e,
+  0x36, 0xba, 0x04, 0xa2, 0x34, 0x6c, 0x60, 0xf2, 0x43, 0xc1, 0xa6, 0x1d, 0x4c, 0x7e, 0x98, 0xf8,
+  0xb5, 0xd3, 0x97, 0xed, 0x6a, 0x4d, 0xcb, 0xb6, 0xe9, 0xb8, 0x30, 0x6f, 0x4f, 0x17, 0xec, 0xc0,
+  0x76, 0x33, 0x10, 0x1f, 0xfb, 0xcd, 0xab, 0x77, 0x69, 0xa5, 0x0e, 0xab, 0x76, 0x29, 0x04, 0x8b,
+  0xb2, 0x79, 0xd1, 0x40, 0x53, 0x47, 0x3d, 0xe9, 0xcd, 0xe8, 0x2d, 0x6b, 0x76, 0x29, 0x0e, 0xab,
+  0x9d, 0x88, 0xf6, 0x0d, 0x6f, 0x1b, 0xef, 0x0d, 0xf5, 0xf3, 0xad, 0x22, 0x61, 0x9c, 0xac, 0x14,
+  0x53, 0xeb, 0x44, 0x4c, 0xb6, 0xfd, 0x85, 0xf0, 0x3f, 0xcc, 0xe4, 0xc7, 0x6d, 0x16, 0x06, 0xa0,
+  0x35, 0xaa, 0x90, 0x6b, 0xe0, 0xbd, 0x17, 0x1a, 0x75, 0x5b, 0x6b, 0xa6, 0x87, 0x34, 0x10, 0x25,
+  0xcb, 0x24, 0x61, 0xc3, 0x30, 0xb5, 0x7f, 0xed, 0xef, 0xcd, 0xd2, 0x36, 0xfa, 0xe2, 0x41, 0x6d,
+  0x77, 0x65, 0x91, 0xcd, 0x35, 0x2a, 0x8a, 0x14, 0x67, 0x9b, 0x5d, 0xf1, 0x68, 0x05, 0xad, 0xb0,
+  0xca, 0xe8, 0x9a, 0x53, 0x9f, 0xed, 0xb6, 0x7a, 0x5d, 0x40, 0x3f, 0xed, 0xf4, 0xd2, 0xaf, 0x0d,
+  0x9a, 0x94, 0x41, 0x5d, 0x1b, 0xe7, 0x9c, 0x5c, 0x0c, 0x6b, 0x4b, 0x07, 0xc3, 0xa7, 0x66, 0xaf,
+  0x72, 0x7b, 0x93, 0x09, 0x05, 0x8e, 0x35, 0x42, 0x94, 0x1c, 0x84, 0xb4, 0x2b, 0xdd, 0xb6, 0xa7,
+  0x47, 0x23, 0x42, 0xf4, 0xe7, 0x0d, 0x60, 0x9e, 0x8a, 0x77, 0x1c, 0xf6, 0x4c, 0x15, 0x20, 0x34,
+  0x58, 0xed, 0x6c, 0xba, 0x9b, 0x26, 0xdd, 0xab, 0xfc, 0xad, 0x92, 0x1e, 0x74, 0x07, 0x6d, 0xad,
+  0x7c, 0x16, 0xc6, 0xac, 0x07, 0x26, 0x60, 0x41, 0x78, 0x19, 0xc2, 0xf6, 0x79, 0xc8, 0x63, 0x1e,
+  0xc9, 0x4b, 0x33, 0x6b, 0x59, 0xbf, 0xbb, 0x67, 0xc4, 0xab, 0xe5, 0x4c, 0xa4, 0x8d, 0xbe, 0x91,
+  0x84, 0x71, 0x93, 0x6b, 0x40, 0x71, 0x27, 0xcf, 0x28, 0x4e, 0xef, 0xc0, 0xd0, 0xb0, 0x20, 0x07,
+  0xd9, 0x0e, 0x1b, 0x41, 0x1a, 0x59, 0x0a, 0x9e, 0xad, 0x52, 0x4a, 0x81, 0xd0, 0xa7, 0x39, 0x10,
+  0xfc, 0xaa, 0xfa, 0xe7, 0xa8, 0xdb, 0x6c, 0x19, 0xc6, 0x93, 0xed, 0x11, 0xfc, 0xcf, 0x3f, 0x4e,
+  0xb6, 0xff, 0xf6, 0xf8, 0xbb, 0xd1, 0xc8, 0x19, 0x58, 0xee, 0x01, 0xb9, 0x00, 0xd2, 0x64, 0xbd,
+  0xc1, 0xbf, 0x23, 0x03, 0xb5, 0xe1, 0xeb, 0xee, 0x0b, 0x52, 0x27, 0x59, 0x6a, 0xe2, 0xd0, 0x69,
+  0xab, 0x8f, 0xef, 0x0e, 0xe7, 0xe1, 0x65, 0xe3, 0x42, 0xf1, 0x85, 0x94, 0x5d, 0x2b, 0xb5, 0x81,
+  0x07, 0x65, 0xfc, 0x4a, 0x54, 0x17, 0x9e, 0xf2, 0xf5, 0xaf, 0xcd, 0x40, 0xd1, 0x3b, 0x7b, 0x58,
+  0x15, 0xea, 0xf7, 0xc1, 0x21, 0xdb, 0xb3, 0x6d, 0x00, 0x05, 0xf7, 0xef, 0x3b, 0xc7, 0x85, 0xd0,
+  0x34, 0xcf, 0x8c, 0x93, 0x5b, 0x86, 0x4f, 0x73, 0x6b, 0x27, 0x57, 0x7b, 0x31, 0x46, 0x46, 0x66,
+  0x8a, 0xab, 0x24, 0x34, 0x37, 0x36, 0xbe, 0x8c, 0xea, 0xd5, 0xb3, 0x85, 0x91, 0x1a, 0xe7, 0x3f,
+  0x06, 0x26, 0x35, 0xef, 0xd4, 0x5a, 0x62, 0x4a, 0x1c, 0xb7, 0x52, 0x10, 0x5b, 0xc2, 0x0c, 0x91,
+  0x87, 0xd5, 0x71, 0xd0, 0x6f, 0xc7, 0x8c, 0xde, 0xc8, 0x40, 0x68, 0xf4, 0xda, 0x00, 0xa2, 0x48,
+  0x0e, 0xd8, 0xaf, 0x23, 0x42, 0x44, 0x76, 0x04, 0x04, 0x89, 0x5b, 0xf0, 0xf2, 0x38, 0xe8, 0x08,
+  0x9a, 0x8b, 0x15, 0xc8, 0x14, 0x47, 0x1b, 0x83, 0xe3, 0xc6, 0x62, 0xb2, 0x1b, 0x89, 0xcc, 0x8e,
+  0x35, 0x9b, 0x4b, 0xa1, 0x16, 0x12, 0x66, 0xca, 0x3b, 0x3b, 0x9d, 0x5e, 0x78, 0xa5, 0xda, 0x0b,
+  0xd8, 0xc3, 0x02, 0xe5, 0x1c, 0xb3, 0xdf, 0x3c, 0x73, 0x62, 0xb1, 0x8b, 0xab, 0x91, 0x07, 0x2d,
+  0x79, 0x92, 0x00, 0xf1, 0xe3, 0xe8, 0xc2, 0x43, 0xa4, 0x3b, 0xde, 0x4d, 0x29, 0x36, 0x93, 0xc1,
+  0x7a, 0xcc, 0xe8, 0xf5, 0x58, 0x46, 0x24, 0x32, 0x9c, 0xaf, 0x7b, 0xbf, 0xe5, 0x61, 0x90, 0xfb,
+  0x8d, 0x09, 0x26, 0xf3, 0x5f, 0x4b, 0x36, 0xb5, 0x89, 0x49, 0x01, 0x67, 0x4d, 0xcd, 0x76, 0x6b,
+  0x29, 0xb2, 0x8c, 0x5f, 0x8a, 0xe2, 0xfd, 0xfa, 0x56, 0x3d, 0x5c, 0xab, 0x72, 0x26, 0x60, 0x21,
+  0x14, 0xed, 0x78, 0x25, 0x8a, 0x81, 0x11, 0x5b, 0x32, 0xd0, 0x3a, 0x63, 0xcc, 0x5f, 0xff, 0x36,
+  0x52, 0xc6, 0xfc, 0xc5, 0xf1, 0x9f, 0x76, 0xec, 0x8d, 0xa7, 0x49, 0xd3, 0xe9, 0xf1, 0x61, 0xee,
+  0x28, 0xf6, 0x51, 0x1c, 0x96, 0xd3, 0x31, 0x45, 0xdb, 0x53, 0x68, 0x14, 0x3a, 0x03, 0xe6, 0x78,
+  0x2d, 0xf1, 0xf5, 0x7d, 0x01, 0xd8, 0x5a, 0x9e, 0x27, 0x4d, 0xaa, 0xe8, 0xd2, 0x4e, 0x8a, 0xf0,
+  0xe4, 0x4b, 0xd4, 0xd0, 0xc7, 0x96, 0x30, 0x11, 0xf9, 0xe1, 0x63, 0x3f, 0xcf, 0x44, 0xee, 0xc1,
+  0x66, 0xd9, 0x02, 0x95, 0x9b, 0xf3, 0x28, 0x13, 0x2d, 0x7b, 0x98, 0x47, 0x90, 0x01, 0x8f, 0x2b,
+  0x31, 0x9a, 0x83, 0x3b, 0x95, 0x88, 0xfc, 0x68, 0x34, 0xea, 0xa4, 0xf9, 0x33, 0x0e, 0xba, 0xc6,
+  0x41, 0x15, 0xd7, 0xa9, 0xa4, 0x7c, 0xd0, 0x12, 0xf5, 0x32, 0x95, 0xab, 0xe4, 0xb9, 0x5c, 0x2e,
+  0x43, 0xb5, 0xd1, 0x22, 0xf5, 0x36, 0x5d, 0x6d, 0xe2, 0x93, 0xf0, 0x2b, 0xfe, 0x11, 0x76, 0xf8,
+  0x30, 0x71, 0x59, 0x55, 0xfd, 0x6a, 0x3d, 0x59, 0xe6, 0x61, 0x57, 0xf0, 0x67, 0x6b, 0x25, 0x36,
+  0x43, 0x53, 0x2d, 0x02, 0x7f, 0x37, 0xfa, 0xe1, 0x71, 0x57, 0xe8, 0x13, 0xd8, 0x1e, 0xc7, 0xfe,
+  0x7a, 0x23, 0xb8, 0xa9, 0xd7, 0x33, 0xda, 0x12, 0x1c, 0x08, 0xe5, 0x0b, 0x3a, 0xed, 0xaf, 0xa2,
+  0x16, 0x15, 0x5d, 0x26, 0x32, 0x0b, 0xce, 0x52, 0xc1, 0xa3, 0x48, 0xfa, 0x3f, 0x3e, 0xab, 0x02,
+  0xda, 0x75, 0x5d, 0x31, 0xe5, 0x4c, 0x6c, 0x72, 0xe6, 0x4a, 0x35, 0x6d, 0xe9, 0x57, 0x40, 0x0b,
+  0xe7, 0x61, 0x4c, 0xdb, 0xaf, 0xc6, 0x46, 0x63, 0xf6, 0xb8, 0xb5, 0xcb, 0x83, 0x79, 0x13, 0xee,
+  0xab, 0x83, 0x39, 0xc8, 0x1e, 0xf2, 0x75, 0xd3, 0xdc, 0x3a, 0xf5, 0xcd, 0x1a, 0xd4, 0x5a, 0x8d,
+  0xd9, 0x5f, 0x5b, 0x2a, 0x80, 0xe4, 0x79, 0xd3, 0xe8, 0x2d, 0x62, 0x5d, 0xde, 0x17, 0x6c, 0xf7,
+  0x3a, 0x52, 0x88, 0x64, 0x1a, 0xc1, 0x3f, 0xf5, 0x50, 0x2b, 0xaa, 0x4c, 0xa0, 0xb5, 0x35, 0x14,
+  0x4f, 0xd3, 0x35, 0xf8, 0xcc, 0x35, 0xdd, 0xad, 0xaa, 0x82, 0xda, 0xb5, 0x9d, 0xb3, 0x19, 0xcf,
+  0xd4, 0x41, 0xe0, 0x9f, 0x83, 0x7f, 0xbf, 0xfc, 0x54, 0xcb, 0x66, 0x76, 0x25, 0x22, 0x3f, 0xa4,
+  0x9b, 0x80, 0x2d, 0xf3, 0xd9, 0x52, 0x9c, 0xe2, 0x11, 0x16, 0x1e, 0xc4, 0x41, 0xb6, 0xad, 0x65,
+  0x34, 0xb7, 0x1a, 0xd1, 0x1f, 0xb4, 0x7e, 0xb5, 0x06, 0x12, 0x1f, 0x36, 0xa6, 0x33, 0xa7, 0xba,
+  0xab, 0x3d, 0xb4, 0xf0, 0x9b, 0xb4, 0xe6, 0x0e, 0x45, 0x45, 0xa7, 0xc5, 0x4c, 0x4b, 0x5d, 0x48,
+  0x48, 0xdb, 0x9f, 0xb3, 0x9a, 0x69, 0xf1, 0x4d, 0x1e, 0xea, 0xd6, 0xa2, 0x5e, 0x3f, 0xb4, 0x9e,
+  0x1d, 0x2d, 0xfb, 0x0c, 0x79, 0xd2, 0x86, 0x9c, 0x5d, 0x6f, 0x81, 0x3d, 0x7c, 0xdf, 0xba, 0x07,
+  0x7c, 0xd1, 0xf6, 0x49, 0xc6, 0xe2, 0x74, 0x3e, 0x07, 0x6e, 0x54, 0x45, 0x77, 0x6b, 0xbf, 0x7c,
+  0xd3, 0xa5, 0xc9, 0xd7, 0xad, 0xbb, 0xae, 0x0a, 0x79, 0xd3, 0x97, 0x36, 0x72, 0x49, 0xd0, 0xab,
+  0x64, 0x5d, 0x39, 0x81, 0x1a, 0xb7, 0xe7, 0x5e, 0x3b, 0x8e, 0x70, 0xce, 0x60, 0xc6, 0xdd, 0xf8,
+  0x56, 0x09, 0xa2, 0x79, 0xd3, 0xb8, 0x2d, 0xdd, 0xb2, 0x05, 0x5b, 0xf4, 0x5d, 0xa7, 0x58, 0x16,
+  0x9d, 0xaf, 0xd0, 0xa3, 0xf1, 0xe7, 0x70, 0xad, 0x12, 0xce, 0x21, 0x44, 0x6d, 0x36, 0x42, 0x8d,
+  0xf4, 0xaa, 0x5f, 0xd5, 0xcf, 0x30, 0xa1, 0x36, 0x80, 0x8d, 0xbc, 0xca, 0x02, 0xac, 0xb3, 0x9f,
+  0xf1, 0xe7, 0xd1, 0xa9, 0x12, 0xb2, 0x4a, 0x77, 0xda, 0xa8, 0xb9, 0x89, 0x42, 0xf5, 0x1b, 0x60,
+  0x89, 0xea, 0x74, 0x02, 0x75, 0xa8, 0x53, 0x13, 0xa4, 0x21, 0x38, 0x9d, 0x40, 0x2b, 0xa4, 0xc9,
+  0x82, 0x2d, 0x18, 0x4e, 0x1b, 0xbc, 0x1a, 0x4f, 0xb2, 0x80, 0x6c, 0x66, 0xd3, 0x6a, 0x1b, 0xdd,
+  0xc0, 0x92, 0x2a, 0x70, 0x16, 0x59, 0x69, 0x8b, 0xd8, 0xc0, 0x91, 0x5c, 0x1b, 0x3a, 0xfc, 0xa3,
+  0xa5, 0x0d, 0x1b, 0x99, 0x8f, 0x05, 0xdb, 0xc0, 0x3f, 0xda, 0x20, 0x37, 0x51, 0x1a, 0x0b, 0xb5,
+  0x4a, 0x40, 0xc6, 0x9d, 0x68, 0x8c, 0x35, 0x68, 0x8b, 0x73, 0x8c, 0xbb, 0x12, 0x17, 0x2b, 0x3d,
+  0xd8, 0x0c, 0xa3, 0x55, 0x7a, 0x68, 0xe2, 0x2b, 0x76, 0x7a, 0x70, 0x69, 0x45, 0xab, 0x04, 0xd1,
+  0x4c, 0x54, 0x2c, 0x50, 0x87, 0x51, 0x8c, 0x3b, 0x13, 0x93, 0x2a, 0x10, 0x90, 0x88, 0x71, 0x07,
+  0x06, 0x52, 0x15, 0x27, 0x36, 0x31, 0xee, 0xc4, 0x39, 0xaa, 0x10, 0x5d, 0x1c, 0xaa, 0x99, 0x83,
+  0xd4, 0xac, 0x63, 0x13, 0x85, 0xf6, 0xb0, 0x4d, 0x04, 0xc4, 0x82, 0x76, 0x59, 0x42, 0x1b, 0xd8,
+  0x66, 0xd6, 0xd1, 0xb7, 0x2f, 0x47, 0x6f, 0x3e, 0xba, 0xf9, 0xb3, 0x4f, 0xc9, 0xf2, 0x8e, 0xff,
+  0x7f, 0xcf, 0xc6, 0x0c, 0xad, 0xba, 0xe3, 0x70, 0x4c, 0x5f, 0x9d, 0x3d, 0x14, 0x57, 0xf4, 0xea,
+  0xda, 0x7a, 0xbb, 0x4f, 0xa7, 0xec, 0xe9, 0xb2, 0xe7, 0x1d, 0xa4, 0x82, 0xad, 0xe5, 0x8a, 0x61,
+  0x46, 0xa3, 0x1f, 0xd7, 0x3c, 0x56, 0x4c, 0x49, 0x23, 0x4a, 0xd7, 0x50, 0x02, 0x92, 0x7f, 0xea,
+  0xf5, 0xed, 0xa3, 0xe7, 0x3b, 0xe7, 0xe9, 0xb6, 0xb9, 0xfa, 0x82, 0xf9, 0xda, 0x7c, 0xb2, 0xa9,
+  0x35, 0x1e, 0x33, 0x95, 0xae, 0x84, 0xc5, 0x56, 0x6f, 0xaa, 0x87, 0x79, 0xbd, 0x86, 0xb7, 0xb5,
+  0xc6, 0xc8, 0xda, 0x52, 0xf8, 0x8d, 0x85, 0x06, 0xc3, 0x4b, 0x4e, 0x83, 0x81, 0xd7, 0xe6, 0x2a,
+  0x46, 0x23, 0x9e, 0x9e, 0xb4, 0x02, 0xcb, 0x58, 0xb2, 0x3a, 0x6b, 0xf6, 0xc1, 0x31, 0x5d, 0x60,
+  0xd7, 0x0c, 0xf8, 0xc5, 0xf1, 0xc9, 0xd1, 0xf4, 0xfd, 0xd9, 0xd1, 0xf9, 0xfb, 0xb3, 0x83, 0xbf,
+  0x1f, 0x01, 0x0f, 0x7e, 0x68, 0xbe, 0x5f, 0x9b, 0x87, 0x91, 0x09, 0xa3, 0xf2, 0x9b, 0x36, 0x2c,
+  0xa3, 0x0b, 0xa7, 0xba, 0xa8, 0x74, 0x01, 0x7f, 0xc1, 0xe3, 0x4b, 0x81, 0x1f, 0xb6, 0x9c, 0x81,
+  0xcb, 0xf5, 0x82, 0x30, 0x15, 0x54, 0xe1, 0xb2, 0xed, 0x58, 0x5f, 0x18, 0xb4, 0x90, 0xef, 0xb3,
+  0xa2, 0x29, 0xfb, 0xb6, 0xa2, 0x4b, 0x79, 0x85, 0x9a, 0xe4, 0xf6, 0xf1, 0xf2, 0xf4, 0xbd, 0x7b,
+  0x1a, 0x64, 0xaf, 0x54, 0xc5, 0x71, 0x17, 0x5b, 0xe7, 0xd8, 0xb9, 0x69, 0xd7, 0xf4, 0xed, 0xcd,
+  0x4d, 0xc5, 0x8d, 0xed, 0x16, 0x0d, 0x67, 0xbc, 0x88, 0x9e, 0x3d, 0x95, 0x84, 0x4f, 0xf7, 0x9c,
+  0x9c, 0x81, 0x78, 0xf7, 0xca, 0xab, 0x51, 0x15, 0xa3, 0xd2, 0xed, 0x28, 0x99, 0xaa, 0x09, 0xbe,
+  0xd2, 0xb8, 0x07, 0xc9, 0x4e, 0xa4, 0x93, 0x40, 0x64, 0xfe, 0xd7, 0x3f, 0x2c, 0xb6, 0x27, 0x48,
+  0x6f, 0xb4, 0xea, 0xd7, 0x83, 0xf5, 0x5c, 0x24, 0x30, 0x4f, 0xb8, 0xed, 0x79, 0xc5, 0xd5, 0x62,
+  0xb0, 0xe4, 0x1f, 0x7b, 0x0f, 0x76, 0xf4, 0x6f, 0x5f, 0x84, 0x51, 0xaf, 0x94, 0x65, 0xc3, 0xca,
+  0x68, 0xfa, 0x6d, 0x6f, 0xd2, 0xa1, 0x2e, 0xbb, 0x49, 0xc3, 0xd5, 0xe6, 0xda, 0x9b, 0x12, 0x0f,
+  0x9d, 0x46, 0xbf, 0xe4, 0x27, 0x15, 0xe6, 0x91, 0x84, 0x4d, 0x9e, 0x65, 0xdd, 0x9a, 0x0e, 0xc5,
+  0x05, 0x05, 0x26, 0xe7, 0x24, 0x48, 0xc3, 0x79, 0xd2, 0xe9, 0xb2, 0x05, 0x4d, 0x67, 0xf1, 0x26,
+  0x1c, 0x9f, 0x3a, 0xdc, 0xaf, 0xa0, 0xc1, 0xb5, 0xb8, 0x5d, 0x91, 0x25, 0x3c, 0xde, 0xcf, 0x7d,
+  0xa5, 0xb8, 0x0f, 0xa0, 0xaf, 0xab, 0x52, 0x11, 0x7e, 0x6b, 0x43, 0x45, 0xf8, 0x63, 0x87, 0x15,
+  0xe5, 0x59, 0xf8, 0x49, 0x37, 0x9d, 0x21, 0x77, 0xef, 0xef, 0x0d, 0x35, 0xd2, 0x6d, 0x7d, 0xcd,
+  0x56, 0x4a, 0xd1, 0xf7, 0x1a, 0x3e, 0xe4, 0xb5, 0x0f, 0x93, 0x6d, 0xfc, 0x82, 0x0b, 0xb7, 0xc8,
+  0xe8, 0xd1, 0xbd, 0x5f, 0xbc, 0x9a, 0x16, 0xbf, 0x78, 0xfd, 0xed, 0xfd, 0x43, 0xd3, 0x68, 0x6f,
+  0xa8, 0xc5, 0xbf, 0xfc, 0x55, 0xed, 0xed, 0x0e, 0x11, 0x85, 0x59, 0xd3, 0x05, 0x1d, 0xeb, 0x4e,
+  0x25, 0x79, 0x36, 0x4d, 0x0e, 0x9b, 0xcb, 0x55, 0x1c, 0x7c, 0x95, 0xab, 0x94, 0x84, 0xb7, 0xe1,
+  0x7c, 0xc0, 0xb1, 0x13, 0x36, 0x8c, 0xad, 0x4f, 0x53, 0xcd, 0x17, 0x6e, 0xf8, 0x61, 0x97, 0x49,
+  0x03, 0x79, 0xf3, 0xa7, 0xd8, 0x94, 0xc2, 0x1d, 0xb6, 0x41, 0x32, 0x10, 0x6f, 0xce, 0x8f, 0x61,
+  0x6b, 0x08, 0x31, 0x8b, 0x97, 0xdc, 0x0a, 0x18, 0x98, 0xd2, 0xf7, 0xb3, 0x88, 0xc7, 0x1f, 0xbc,
+  0x4a, 0xaf, 0xb4, 0xd3, 0x7d, 0x46, 0xbb, 0x53, 0xf7, 0x9b, 0xba, 0x62, 0xd5, 0x7c, 0x81, 0x2d,
+  0xcc, 0x8e, 0x57, 0x04, 0xda, 0x2e, 0xb0, 0x66, 0x4e, 0x0f, 0x91, 0x7e, 0x07, 0x2c, 0x96, 0xd7,
+  0x95, 0xd5, 0xb2, 0x7e, 0xb7, 0xad, 0x9e, 0xc3, 0x10, 0xf3, 0x16, 0xa6, 0xf3, 0x87, 0x52, 0x11,
+  0x9a, 0x64, 0x3d, 0x64, 0x3d, 0x7c, 0xfc, 0x58, 0x71, 0xe5, 0xfb, 0x50, 0x8b, 0x5f, 0x32, 0xae,
+  0xed, 0x25, 0xd0, 0xf9, 0x6c, 0x94, 0xee, 0xb0, 0x9e, 0xeb, 0xfc, 0x9c, 0x7f, 0xef, 0x08, 0x96,
+  0xc0, 0xaf, 0x89, 0x81, 0x7f, 0xe2, 0x75, 0xe9, 0xc0, 0xd8, 0x89, 0xd1, 0x2d, 0xfe, 0xce, 0x8c,
+  0x87, 0xb4, 0x41, 0x3f, 0xd1, 0x28, 0x77, 0x31, 0x1e, 0xe7, 0x1a, 0xbf, 0xb9, 0x8f, 0xe1, 0x2e,
+  0x75, 0x01, 0x9e, 0x44, 0x9b, 0xec, 0xaa, 0xd3, 0x99, 0x69, 0x06, 0xb9, 0x8c, 0xae, 0x4e, 0x18,
+  0x64, 0xdd, 0x7a, 0x21, 0x57, 0x69, 0xa5, 0x79, 0xd1, 0xfe, 0x2f, 0xa6, 0x3d, 0x08, 0x3e, 0x7a,
+  0x5c, 0x91, 0x5b, 0x86, 0xf1, 0x66, 0x31, 0x6a, 0x0d, 0x52, 0x8f, 0x47, 0xf6, 0xcd, 0x61, 0x7d,
+  0x83, 0x16, 0x94, 0xab, 0xdc, 0x34, 0xd5, 0xbe, 0xa3, 0xf5, 0x86, 0xdc, 0x10, 0x90, 0x05, 0xb4,
+  0x5e, 0xf0, 0xb8, 0xa0, 0x47, 0xea, 0x0e, 0x9e, 0x96, 0x9e, 0xf3, 0xcd, 0x2e, 0x42, 0xea, 0x96,
+  0xcd, 0x98, 0xed, 0x50, 0x6a, 0x62, 0xb5, 0x76, 0xe6, 0xfb, 0xd8, 0xe3, 0x38, 0x54, 0x21, 0x8f,
+  0x30, 0x3f, 0xe2, 0xd7, 0x77, 0xe8, 0x57, 0xe8, 0x2c, 0x5b, 0x45, 0xde, 0xa9, 0x7f, 0xd8, 0x79,
+  0x78, 0xfa, 0xca, 0xac, 0x3e, 0xf8, 0x3d, 0x33, 0x6c, 0xce, 0x76, 0x58, 0x3e, 0x97, 0x45, 0xec,
+  0xe5, 0x9f, 0xa6, 0xdb, 0x9f, 0x31, 0xc3, 0xac, 0xc3, 0xdf, 0xff, 0x01, 0x14, 0x4f, 0xe8, 0x39,
+  0x3a, 0x40, 0x00, 0x00,
+};
+
+// index.html: 10618 bytes, 2570 gzipped
+static const uint8_t WEB_INDEX_HTML[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xb5, 0x5a, 0xdb, 0x72, 0xdb, 0x38,
+  0x12, 0x7d, 0x9f, 0xaf, 0xc0, 0xf2, 0x25, 0x4a, 0x95, 0x65, 0xeb, 0x62, 0xcb, 0x76, 0x62, 0x69,
+  0xcb, 0x97, 0x78, 0x33, 0x15, 0x7b, 0xec, 0xb2, 0xec, 0x4c, 0xed, 0x23, 0x44, 0x42, 0x12, 0xc6,
+  0x24, 0xc1, 0x21, 0x40, 0xc9, 0xca, 0x37, 0x6c, 0xd5, 0x7e, 0xc2, 0xd6, 0xfe, 0xc5, 0xfe, 0xd5,
+  0xee, 0x27, 0xec, 0x69, 0x80, 0xba, 0x5f, 0x2c, 0xca, 0xb1, 0x1f, 0x12, 0x89, 0x6a, 0x34, 0x0e,
+  0x1a, 0xdd, 0xa7, 0xbb, 0x01, 0x9e, 0xfd, 0xe5, 0xea, 0xee, 0xf2, 0xf1, 0xef, 0xf7, 0x5f, 0x58,
+  0xdf, 0x44, 0x61, 0xeb, 0x97, 0xb3, 0xf1, 0x7f, 0x82, 0x07, 0xad, 0x5f, 0x18, 0xfe, 0xce, 0x22,
+  0x61, 0x38, 0xf3, 0xfb, 0x3c, 0xd5, 0xc2, 0x34, 0xbd, 0xa7, 0xc7, 0xeb, 0xf2, 0x89, 0x37, 0xfb,
+  0x53, 0xcc, 0x23, 0xd1, 0xf4, 0x06, 0x52, 0x0c, 0x13, 0x95, 0x1a, 0x8f, 0xf9, 0x2a, 0x36, 0x22,
+  0x86, 0xe8, 0x50, 0x06, 0xa6, 0xdf, 0x0c, 0xc4, 0x40, 0xfa, 0xa2, 0x6c, 0xbf, 0xec, 0x31, 0x19,
+  0x4b, 0x23, 0x79, 0x58, 0xd6, 0x3e, 0x0f, 0x45, 0xb3, 0xba, 0x5f, 0x19, 0xab, 0x32, 0xd2, 0x84,
+  0xa2, 0x75, 0x17, 0xc5, 0xf2, 0x46, 0xf5, 0x7a, 0x22, 0x65, 0x57, 0x5c, 0xf7, 0x3b, 0x8a, 0xa7,
+  0xc1, 0xd9, 0x81, 0xfb, 0xcd, 0xc9, 0x85, 0x32, 0x7e, 0x66, 0xa9, 0x08, 0x9b, 0x9e, 0x36, 0xa3,
+  0x50, 0xe8, 0xbe, 0x10, 0x98, 0xb3, 0x9f, 0x8a, 0x6e, 0xd3, 0x3b, 0xb0, 0x8f, 0xf6, 0x7d, 0xad,
+  0xff, 0x3a, 0x68, 0x56, 0x4f, 0x8e, 0x6b, 0xfc, 0xf8, 0xf4, 0xb8, 0x76, 0xdc, 0x39, 0xea, 0x54,
+  0x8f, 0xeb, 0x98, 0xe8, 0xec, 0xc0, 0x2d, 0xeb, 0xac, 0xa3, 0x82, 0x51, 0xae, 0x2f, 0x90, 0x03,
+  0xe6, 0x87, 0x5c, 0xeb, 0xa6, 0x47, 0xc0, 0xb9, 0x8c, 0x45, 0x9a, 0x63, 0xb2, 0xbf, 0xd3, 0x08,
+  0x91, 0x4e, 0x1f, 0xb8, 0x87, 0xd5, 0xd6, 0xff, 0xfe, 0xf5, 0x8f, 0x7f, 0xff, 0xf7, 0x3f, 0xff,
+  0x64, 0x53, 0xc4, 0xd0, 0x5e, 0x5d, 0x90, 0x4b, 0x5a, 0x6d, 0x11, 0xc9, 0xf2, 0x53, 0x2c, 0x07,
+  0x22, 0xd5, 0x3c, 0xc4, 0xa2, 0x60, 0xb0, 0xb1, 0x78, 0x32, 0x33, 0xcd, 0xc1, 0xe2, 0x3c, 0xd3,
+  0x9f, 0x62, 0x3e, 0x58, 0x50, 0xdb, 0xc9, 0x8c, 0x51, 0x31, 0x53, 0xb1, 0x1f, 0x4a, 0xff, 0x19,
+  0x96, 0xe8, 0xab, 0xe1, 0x23, 0xef, 0x94, 0x3e, 0x04, 0x63, 0x9b, 0x7d, 0xf8, 0xe8, 0x8d, 0x57,
+  0x65, 0x78, 0xa7, 0xdc, 0x31, 0x31, 0xe3, 0xbe, 0x01, 0x0a, 0x8f, 0xc9, 0xc0, 0x3d, 0x9b, 0xc8,
+  0x7a, 0xad, 0x19, 0x53, 0x3b, 0xd5, 0xdb, 0xce, 0xa7, 0x45, 0xac, 0x55, 0xaa, 0x97, 0x67, 0x9b,
+  0x4e, 0x93, 0x8b, 0x78, 0xb0, 0x84, 0xfd, 0x50, 0x7c, 0x0a, 0x63, 0x64, 0xdc, 0x7b, 0x65, 0x0e,
+  0x27, 0x43, 0x93, 0xb8, 0x4f, 0x45, 0x67, 0x09, 0xb0, 0x2f, 0x9b, 0x66, 0xa0, 0xdf, 0xc9, 0x4e,
+  0x86, 0x2f, 0x6b, 0x3e, 0x3b, 0x98, 0xdb, 0xa1, 0xe9, 0x73, 0x72, 0x2d, 0x52, 0x30, 0xb5, 0xf4,
+  0xac, 0xfe, 0x3c, 0x4c, 0xc6, 0xfb, 0xb2, 0xe8, 0x61, 0xb5, 0x56, 0x7b, 0xa4, 0x8d, 0x88, 0x58,
+  0xdb, 0x70, 0x93, 0x61, 0x41, 0x78, 0x32, 0x2f, 0x32, 0xe3, 0xb9, 0x1a, 0x32, 0xba, 0xdc, 0x4b,
+  0x65, 0xb0, 0xa0, 0x67, 0x95, 0x60, 0xd9, 0xb7, 0x9b, 0xbe, 0x24, 0xe7, 0xe6, 0xad, 0xdb, 0x55,
+  0xb2, 0x7b, 0x25, 0x63, 0x43, 0xb3, 0xd6, 0xd7, 0x08, 0x26, 0x73, 0x2a, 0x07, 0x3c, 0xcc, 0x72,
+  0xdf, 0x22, 0x53, 0x25, 0x76, 0xb4, 0xd7, 0x2a, 0xcf, 0x39, 0xf9, 0xd4, 0x60, 0x40, 0xf4, 0x76,
+  0x9c, 0x17, 0xdc, 0x18, 0x91, 0x8e, 0xd8, 0x77, 0x15, 0x1a, 0xde, 0x13, 0xbb, 0x60, 0xed, 0x38,
+  0x15, 0xef, 0x0c, 0xb4, 0x6d, 0x54, 0x0a, 0x80, 0xec, 0x49, 0x8b, 0x60, 0x17, 0x94, 0xda, 0x8d,
+  0x7f, 0x6f, 0x94, 0x57, 0xec, 0x12, 0x12, 0xec, 0xab, 0xe0, 0xa1, 0xe9, 0xef, 0x84, 0x33, 0xe8,
+  0xdb, 0xb1, 0xef, 0x0c, 0xf4, 0xdc, 0x06, 0x0c, 0x9b, 0xf0, 0xc9, 0x0e, 0x40, 0xed, 0x50, 0x5f,
+  0x65, 0xb1, 0x79, 0x67, 0xac, 0x4f, 0x89, 0x91, 0xd1, 0x4e, 0xae, 0x99, 0xd9, 0x91, 0xef, 0x1d,
+  0x42, 0x59, 0xb7, 0x8b, 0x54, 0x3b, 0xa1, 0x98, 0xe2, 0x01, 0x64, 0x15, 0xbc, 0x33, 0xca, 0xdf,
+  0xe5, 0xb5, 0x7c, 0x03, 0xc6, 0xa1, 0xec, 0x4a, 0x6d, 0x47, 0x17, 0xc0, 0xb9, 0xe2, 0xd1, 0x32,
+  0xfb, 0xda, 0x72, 0xa3, 0xe9, 0x45, 0x3c, 0xed, 0xc9, 0xf8, 0x13, 0xab, 0x55, 0x92, 0x17, 0x56,
+  0xf9, 0xbc, 0x8a, 0x82, 0x17, 0x13, 0x4f, 0x37, 0xcc, 0x74, 0xdf, 0x59, 0xbf, 0x34, 0x4d, 0x3b,
+  0x48, 0x39, 0xe5, 0x24, 0x95, 0xd0, 0x07, 0x4a, 0xba, 0x26, 0x11, 0x96, 0xef, 0x90, 0x51, 0x2c,
+  0x8f, 0xcf, 0x35, 0x99, 0xed, 0x35, 0xb8, 0x30, 0xdb, 0x65, 0x96, 0xa6, 0x94, 0x70, 0x1e, 0x50,
+  0x69, 0xb8, 0x1c, 0xb9, 0x68, 0xcb, 0x49, 0xc6, 0x4a, 0x73, 0x91, 0x09, 0xb2, 0xc9, 0x83, 0x15,
+  0x6b, 0x4b, 0x5a, 0x37, 0xca, 0xfe, 0xba, 0xbf, 0xbf, 0xbf, 0x64, 0xde, 0x6d, 0x80, 0x3d, 0x08,
+  0x9f, 0x70, 0xb5, 0x79, 0x94, 0xa0, 0xa0, 0xdb, 0x08, 0x8b, 0x04, 0x7f, 0x3a, 0xa8, 0x85, 0xaf,
+  0xcb, 0x09, 0x7c, 0x5c, 0xc3, 0xac, 0x48, 0xdf, 0xab, 0xf2, 0xb6, 0x95, 0x66, 0x97, 0x2a, 0xee,
+  0xca, 0x5e, 0x96, 0x72, 0x23, 0x55, 0xbc, 0x22, 0x7d, 0x27, 0xad, 0xb1, 0x84, 0x60, 0x59, 0x42,
+  0x3b, 0x7c, 0xc2, 0xf2, 0x89, 0xf6, 0xd9, 0x65, 0x9f, 0xc7, 0x3d, 0xa1, 0x51, 0xe8, 0xfe, 0x99,
+  0x49, 0x08, 0x70, 0x7c, 0xea, 0x28, 0x65, 0x48, 0xcc, 0xf0, 0x67, 0xc1, 0x04, 0xdc, 0xc2, 0x37,
+  0x2b, 0x96, 0x36, 0x8f, 0x99, 0x60, 0x62, 0x8e, 0x9f, 0xb1, 0x6d, 0xcb, 0xc5, 0x13, 0x1f, 0x88,
+  0x9c, 0x84, 0xd7, 0xf9, 0x70, 0x9b, 0x4f, 0x88, 0x7a, 0xd1, 0x1e, 0xcb, 0x55, 0xd4, 0xab, 0x9b,
+  0x90, 0x17, 0x79, 0x5b, 0xee, 0x42, 0x5e, 0x3d, 0x4d, 0x0a, 0xc2, 0x8d, 0xf5, 0x53, 0x2e, 0x55,
+  0xee, 0xaa, 0x34, 0x5a, 0x65, 0xac, 0x59, 0x16, 0x02, 0xfc, 0xa5, 0xcd, 0x5d, 0x41, 0x4a, 0x67,
+  0x21, 0xef, 0x88, 0x30, 0x1f, 0xd6, 0xfe, 0xf5, 0xea, 0xd3, 0xd9, 0x81, 0x7b, 0xb2, 0x2c, 0x29,
+  0xe3, 0x24, 0xc3, 0xd6, 0x8e, 0x12, 0x90, 0x89, 0x11, 0x2f, 0x66, 0xca, 0x5b, 0x34, 0xd0, 0x63,
+  0x49, 0xc8, 0x7d, 0xd1, 0x57, 0x21, 0x1a, 0x84, 0xa6, 0xf7, 0x9b, 0x30, 0x43, 0x95, 0x3e, 0xdb,
+  0xb6, 0x6b, 0x05, 0xd4, 0x8d, 0x38, 0xee, 0xb1, 0x5a, 0x0c, 0x0e, 0xb6, 0xc4, 0x92, 0xe4, 0xe2,
+  0x53, 0x3c, 0xf7, 0x93, 0x27, 0x73, 0x98, 0x26, 0x8f, 0xb7, 0xc1, 0x33, 0xb6, 0xe5, 0xb9, 0xef,
+  0x0b, 0xad, 0x5d, 0xa5, 0x59, 0xc0, 0xa0, 0xe7, 0xf7, 0xbb, 0x99, 0x93, 0x27, 0x2b, 0x8c, 0x39,
+  0x87, 0xa1, 0xa0, 0x45, 0x01, 0xe4, 0x4d, 0xf6, 0xe4, 0xc9, 0x1a, 0x6b, 0xce, 0x28, 0x66, 0xa5,
+  0x48, 0xc6, 0x20, 0x06, 0x6a, 0xbf, 0xd1, 0x28, 0xa0, 0x89, 0x44, 0xa4, 0xe1, 0x51, 0x28, 0xe2,
+  0x1e, 0x7a, 0x6b, 0xef, 0x64, 0x5b, 0x8b, 0xdb, 0xa2, 0xde, 0x25, 0x13, 0x38, 0x3a, 0x2b, 0xdd,
+  0x25, 0x64, 0x68, 0x1e, 0x7e, 0xdc, 0x68, 0xeb, 0x2f, 0x31, 0xef, 0x84, 0x82, 0xcd, 0x0f, 0xde,
+  0x72, 0xb1, 0x7e, 0x5f, 0xf8, 0xcf, 0x1d, 0xf5, 0x32, 0x5b, 0x28, 0x60, 0xb4, 0x53, 0xb9, 0xb2,
+  0x4f, 0xd1, 0x09, 0x8f, 0x6d, 0xb1, 0x2c, 0x18, 0x35, 0x11, 0x0c, 0x2b, 0x8f, 0x44, 0xa4, 0x50,
+  0xe2, 0xf3, 0x38, 0x60, 0x36, 0x65, 0xb2, 0x04, 0x4a, 0x54, 0x20, 0x7d, 0x1e, 0x86, 0xa3, 0xb3,
+  0x03, 0x3b, 0x62, 0xeb, 0x0d, 0x73, 0x19, 0xf5, 0x57, 0x30, 0x46, 0x8a, 0xf2, 0x80, 0x95, 0xb4,
+  0x00, 0x7d, 0x04, 0xfa, 0xe3, 0x96, 0x0b, 0x8a, 0xb3, 0xa8, 0x83, 0x5a, 0xc7, 0x2e, 0xc7, 0x82,
+  0x19, 0x6b, 0xb2, 0x3b, 0xd2, 0xf4, 0xaa, 0x1e, 0xb3, 0x55, 0x47, 0xd3, 0xab, 0x57, 0x2a, 0x6b,
+  0xd7, 0xf7, 0x55, 0x0d, 0x99, 0xea, 0x82, 0xb4, 0x88, 0xca, 0x87, 0xa9, 0x34, 0x82, 0x39, 0xdb,
+  0x88, 0xc0, 0xad, 0xda, 0xa5, 0x7a, 0xdf, 0xa6, 0xfa, 0x62, 0xeb, 0x9b, 0x54, 0x73, 0xb6, 0x5d,
+  0xd8, 0xb0, 0x2a, 0x2d, 0x42, 0x24, 0x8f, 0x99, 0x7d, 0xb9, 0xe0, 0xfe, 0xb3, 0x88, 0xd7, 0xd6,
+  0x60, 0xca, 0x3a, 0xcb, 0x78, 0x75, 0x15, 0xaa, 0x4d, 0xd0, 0xd2, 0xb2, 0x3f, 0x54, 0x96, 0xc6,
+  0xd6, 0x90, 0x59, 0x3a, 0x40, 0x49, 0xae, 0x59, 0xa2, 0x86, 0x00, 0x10, 0x2a, 0xad, 0xe1, 0x57,
+  0x6e, 0xd4, 0x56, 0x2a, 0xab, 0x5e, 0xeb, 0xbe, 0xfd, 0x70, 0x7e, 0xcb, 0x4a, 0x5d, 0x0e, 0xda,
+  0x4e, 0xf7, 0x48, 0x87, 0x41, 0xaa, 0xd9, 0x4e, 0x23, 0x0c, 0x65, 0x57, 0xb4, 0xce, 0xe6, 0xbf,
+  0xf7, 0x61, 0xde, 0xa9, 0x99, 0x51, 0x46, 0x20, 0xb4, 0x34, 0xe3, 0x78, 0xf8, 0x2c, 0x12, 0xc3,
+  0x4a, 0x79, 0x9a, 0xd5, 0x79, 0x96, 0xfd, 0xb8, 0xbd, 0xe5, 0x11, 0x3c, 0x7f, 0x4b, 0x15, 0xf2,
+  0xf7, 0xa5, 0x8a, 0x22, 0x69, 0xb6, 0x89, 0xa6, 0x59, 0xf9, 0x9d, 0x62, 0xa9, 0x47, 0x0a, 0xdc,
+  0xf8, 0xd7, 0xa2, 0xe9, 0x9b, 0x10, 0x28, 0x2d, 0xfa, 0x14, 0x50, 0x23, 0xd6, 0x95, 0x98, 0x5d,
+  0x25, 0x70, 0x3d, 0x8a, 0x27, 0xdf, 0x2a, 0x98, 0x18, 0x03, 0xc1, 0x86, 0x6e, 0x18, 0x13, 0xe9,
+  0xa2, 0x6e, 0xe7, 0x90, 0xb0, 0x73, 0x38, 0x75, 0x8a, 0xe2, 0xd2, 0xaa, 0xdb, 0x21, 0xa4, 0x1c,
+  0x9e, 0x5b, 0xfe, 0x92, 0xab, 0x98, 0x46, 0x55, 0xc4, 0x5f, 0xf0, 0x7f, 0x05, 0x41, 0x35, 0x09,
+  0xb0, 0x9a, 0xb7, 0x23, 0xbe, 0x8b, 0x91, 0x11, 0x6f, 0x42, 0x67, 0x15, 0xe4, 0xd8, 0x8e, 0xaa,
+  0xb5, 0x1c, 0x5d, 0xe3, 0xe8, 0xa8, 0xde, 0x98, 0xc0, 0x3b, 0xac, 0x9c, 0x36, 0x0a, 0x00, 0x84,
+  0xd6, 0xdc, 0x1d, 0xd8, 0x0d, 0x07, 0x33, 0xf8, 0xa3, 0x37, 0x71, 0xd3, 0x04, 0x6a, 0xae, 0x6c,
+  0xc1, 0x90, 0xf5, 0xc6, 0xac, 0x21, 0xd7, 0x13, 0x55, 0xbe, 0x0d, 0x2c, 0x46, 0xd5, 0x39, 0x12,
+  0x26, 0xf7, 0x17, 0x83, 0xf8, 0xa1, 0xb8, 0x99, 0x8f, 0xcf, 0x2e, 0x97, 0x21, 0xea, 0xd8, 0x42,
+  0x61, 0x73, 0xa3, 0x7a, 0xec, 0x1a, 0xe5, 0x16, 0xdf, 0x1c, 0x34, 0x57, 0x70, 0xdc, 0x6b, 0x72,
+  0x5c, 0x27, 0xbb, 0x1d, 0xab, 0x85, 0xaa, 0xe7, 0xc4, 0xb7, 0x66, 0xb4, 0xcb, 0xf6, 0x77, 0x46,
+  0xb5, 0x02, 0x2b, 0xed, 0xfb, 0x7a, 0x50, 0x98, 0xbd, 0xb0, 0x7d, 0x09, 0xf2, 0x33, 0xeb, 0xc8,
+  0x18, 0x85, 0x2f, 0x94, 0xe0, 0xc3, 0x1b, 0x08, 0xeb, 0xc2, 0xa9, 0xa1, 0x80, 0x75, 0x34, 0x05,
+  0x67, 0x18, 0x88, 0x94, 0x8c, 0x8f, 0xf4, 0x40, 0x58, 0x31, 0x7b, 0xa0, 0x86, 0x71, 0x88, 0x12,
+  0xbe, 0x68, 0xbc, 0xde, 0xa3, 0x6f, 0x0a, 0x43, 0xe5, 0xc3, 0x3b, 0xd8, 0xd8, 0xba, 0x9a, 0x95,
+  0xbe, 0x5d, 0xec, 0xb1, 0x0a, 0x6b, 0x22, 0x39, 0x75, 0x77, 0xf1, 0x3a, 0x1d, 0x8c, 0xf5, 0x7e,
+  0xbb, 0xc8, 0x3d, 0xae, 0x92, 0x7b, 0x9c, 0x0d, 0x87, 0x19, 0x5b, 0xaf, 0x75, 0x38, 0x8d, 0x74,
+  0x0a, 0x28, 0xf8, 0xe6, 0xa3, 0xe5, 0xa1, 0x13, 0x71, 0xa0, 0xc9, 0xe9, 0x0b, 0x99, 0x11, 0xc5,
+  0x39, 0x5a, 0x6e, 0x6a, 0xfa, 0xe0, 0x72, 0x2e, 0x75, 0x86, 0xce, 0xc5, 0x8b, 0x9a, 0x00, 0x09,
+  0xd6, 0x1d, 0x73, 0xa1, 0xd1, 0x02, 0xb3, 0x2e, 0xd7, 0x04, 0x6f, 0x36, 0x85, 0xea, 0x88, 0x85,
+  0xf2, 0x60, 0x6c, 0x8d, 0x93, 0xc6, 0xe1, 0x4c, 0x00, 0x36, 0x36, 0x94, 0x0a, 0x94, 0x95, 0x89,
+  0xeb, 0x41, 0xd6, 0x6e, 0xb5, 0x60, 0x1e, 0x63, 0xb9, 0x3b, 0xd3, 0xf0, 0x04, 0x67, 0x26, 0x64,
+  0x2d, 0x9f, 0xc7, 0x9f, 0x81, 0xd7, 0x26, 0x09, 0x4d, 0xfd, 0x19, 0x8c, 0x67, 0xc9, 0x8e, 0x2c,
+  0x47, 0x85, 0x04, 0x93, 0x9a, 0x45, 0x74, 0xda, 0x25, 0x82, 0x1d, 0xc8, 0xdd, 0x3a, 0xf6, 0xd4,
+  0x51, 0x1c, 0x8f, 0x96, 0x90, 0x50, 0xde, 0x66, 0x25, 0xdf, 0x69, 0xb6, 0xea, 0xa0, 0x5d, 0x2f,
+  0x98, 0xa9, 0xde, 0x38, 0x9a, 0x18, 0xe9, 0x78, 0xad, 0x89, 0x2e, 0xc1, 0x43, 0x30, 0x05, 0x45,
+  0xc4, 0x34, 0x58, 0x7a, 0x3f, 0x64, 0x92, 0xe0, 0x29, 0x52, 0x1a, 0x59, 0xa0, 0x33, 0x35, 0x63,
+  0xc9, 0x1e, 0xc3, 0x6b, 0x36, 0x94, 0xd8, 0x7a, 0x5b, 0x71, 0xec, 0xd9, 0xeb, 0x2a, 0x19, 0x67,
+  0x2a, 0x23, 0x1b, 0x05, 0xa2, 0x58, 0xee, 0xb7, 0x95, 0xf1, 0x53, 0x42, 0x97, 0x52, 0xdb, 0xa4,
+  0x7e, 0x27, 0xb9, 0x53, 0xd2, 0xcf, 0xec, 0xd0, 0xd7, 0xf2, 0xfd, 0xfd, 0x5d, 0xfb, 0x11, 0xdc,
+  0xdc, 0xeb, 0x51, 0x99, 0xa3, 0x86, 0x9a, 0xe8, 0x82, 0x33, 0x1b, 0x57, 0x29, 0xd9, 0x83, 0x8c,
+  0x0e, 0x8f, 0x21, 0x9b, 0xe5, 0xd9, 0x7e, 0x8f, 0x3c, 0x28, 0x8b, 0xa8, 0x29, 0x70, 0x4e, 0xa3,
+  0x32, 0x3a, 0x4d, 0x2f, 0x5c, 0x05, 0xb8, 0xa5, 0xb1, 0xa7, 0x87, 0x9b, 0xc2, 0x9d, 0x99, 0x5b,
+  0xda, 0x53, 0x1a, 0x2e, 0xf4, 0x41, 0x7d, 0x63, 0x12, 0xfd, 0xe9, 0xe0, 0x40, 0xbc, 0xd8, 0x93,
+  0xa1, 0x7d, 0x80, 0x3f, 0x90, 0x74, 0x2c, 0x62, 0xac, 0x8f, 0x8c, 0x7b, 0xa0, 0x6a, 0xed, 0xd8,
+  0x2b, 0x8c, 0xf3, 0x51, 0xa1, 0xe0, 0xdd, 0xa9, 0x6d, 0x73, 0x68, 0xed, 0xf8, 0x05, 0xbc, 0x17,
+  0x02, 0xde, 0x47, 0x67, 0x75, 0xf8, 0x89, 0x95, 0xd4, 0xb8, 0xc3, 0x9a, 0x03, 0xdb, 0xa8, 0x17,
+  0xc3, 0x0a, 0x7e, 0x5f, 0xc5, 0x4e, 0xd5, 0x4a, 0xd9, 0xf2, 0xc8, 0x2e, 0x81, 0xe7, 0x16, 0xb0,
+  0xd8, 0xbc, 0xac, 0xa6, 0xa7, 0xd3, 0x0d, 0xf4, 0x74, 0x6e, 0x23, 0x0b, 0xce, 0x46, 0xf4, 0xa2,
+  0xe9, 0x04, 0xcf, 0xba, 0x54, 0xee, 0x46, 0xf6, 0xf3, 0x67, 0x0a, 0xc0, 0x98, 0x65, 0x76, 0x1d,
+  0x08, 0x3b, 0x8e, 0x12, 0xc7, 0xf4, 0x21, 0x1e, 0xaa, 0xb8, 0x57, 0xd4, 0xc3, 0x1e, 0xc8, 0x9f,
+  0x13, 0xaa, 0xe1, 0xec, 0x34, 0xa5, 0x6a, 0xf9, 0xa8, 0xf2, 0x16, 0x0b, 0x58, 0x35, 0xab, 0x8b,
+  0xcd, 0xa3, 0xd9, 0x62, 0xf3, 0x68, 0xa5, 0x0d, 0x56, 0xd2, 0xc1, 0xad, 0xe0, 0xe8, 0x85, 0x44,
+  0x64, 0x8f, 0x33, 0xa7, 0x27, 0x4f, 0xeb, 0x79, 0x61, 0x76, 0xc0, 0x4f, 0x69, 0x4c, 0x23, 0x28,
+  0x5c, 0xdb, 0x97, 0x36, 0xd6, 0x6f, 0xe6, 0x93, 0xa5, 0x84, 0xd1, 0xf8, 0x04, 0xd2, 0x32, 0xa4,
+  0xa2, 0x19, 0xfa, 0x42, 0x82, 0x13, 0x86, 0x31, 0xd8, 0xc3, 0x69, 0x2d, 0x9c, 0x41, 0x78, 0x8a,
+  0x52, 0xe6, 0x06, 0x7d, 0x1d, 0xfb, 0x4e, 0x30, 0x76, 0x62, 0x3f, 0x9f, 0x94, 0xa0, 0xa4, 0x1b,
+  0xae, 0xbe, 0x29, 0x18, 0x17, 0x10, 0x89, 0xe0, 0xc6, 0xf2, 0x1d, 0x2d, 0xe2, 0x03, 0xdc, 0x8c,
+  0x66, 0xcd, 0x8f, 0x89, 0x89, 0xfe, 0x2c, 0x25, 0x0e, 0x6d, 0x37, 0x08, 0x4f, 0x1c, 0x72, 0x1d,
+  0x7f, 0x30, 0x2c, 0xc8, 0x04, 0xbd, 0x97, 0x60, 0x2b, 0x0b, 0xaa, 0x37, 0x42, 0xc1, 0x07, 0x56,
+  0xde, 0x30, 0x11, 0x25, 0xa6, 0x70, 0x71, 0x71, 0x45, 0x3d, 0x57, 0x3b, 0xa4, 0x7f, 0x6f, 0x91,
+  0x50, 0x76, 0x5a, 0x6f, 0x80, 0xd1, 0x56, 0xc5, 0xda, 0xc5, 0xe6, 0x19, 0x85, 0x04, 0x99, 0xb6,
+  0x93, 0x75, 0x84, 0x19, 0x0a, 0x41, 0x67, 0x26, 0x13, 0x9f, 0x42, 0x59, 0x97, 0x5f, 0x71, 0x16,
+  0xcd, 0x6d, 0xf9, 0x89, 0x09, 0xd9, 0xef, 0x1c, 0x24, 0x86, 0x20, 0x77, 0xc7, 0xf3, 0xec, 0x81,
+  0xca, 0xc6, 0xd2, 0xd7, 0x1f, 0x7b, 0xac, 0x51, 0xad, 0x96, 0x4f, 0xea, 0xf8, 0xdb, 0xe9, 0x00,
+  0x05, 0x9a, 0xcf, 0x03, 0x9f, 0xb4, 0x7d, 0xfd, 0x91, 0x3b, 0x2a, 0x14, 0x8e, 0x49, 0x88, 0xd4,
+  0x4e, 0xdc, 0xb6, 0x56, 0xa9, 0x6c, 0xa0, 0xa1, 0x76, 0x9f, 0xa7, 0xce, 0x77, 0x51, 0x7d, 0x32,
+  0xd2, 0x8b, 0x12, 0xc9, 0x22, 0xce, 0x7d, 0xf9, 0xb3, 0x3d, 0x31, 0xd7, 0xf9, 0x91, 0x79, 0x4e,
+  0x4f, 0xae, 0xd1, 0x2f, 0x7c, 0xc2, 0x72, 0xfb, 0xa5, 0x76, 0x52, 0x61, 0x77, 0xf6, 0x6d, 0x8e,
+  0x88, 0x58, 0xa4, 0xb7, 0xe5, 0x31, 0x4b, 0x24, 0x66, 0x07, 0x79, 0xdb, 0xf6, 0x15, 0x2f, 0x55,
+  0x56, 0x3a, 0x8d, 0x1c, 0xed, 0xb9, 0x1e, 0x40, 0x43, 0xa0, 0x58, 0x7b, 0x82, 0x5e, 0xf9, 0xa5,
+  0x06, 0xba, 0x6c, 0x44, 0x05, 0x4f, 0x65, 0x0e, 0x31, 0xf0, 0x90, 0x95, 0xea, 0x95, 0xa2, 0x03,
+  0x4f, 0x30, 0xf0, 0x84, 0x95, 0x8e, 0x4e, 0x8a, 0x0e, 0xac, 0x36, 0x68, 0xc9, 0x0d, 0x80, 0xad,
+  0xd6, 0xa3, 0xb7, 0x9c, 0xf8, 0xdc, 0xd2, 0x21, 0xa2, 0x76, 0x17, 0x4a, 0x0b, 0xc6, 0xa3, 0xf8,
+  0x88, 0x41, 0x0d, 0x74, 0xee, 0x1b, 0x2b, 0xa9, 0xe9, 0x60, 0xc8, 0x20, 0x3c, 0x30, 0x80, 0x6e,
+  0x5c, 0xdd, 0xd9, 0x88, 0xbb, 0x2a, 0xfb, 0x29, 0x9e, 0x03, 0xf6, 0x7f, 0x24, 0xbd, 0x5b, 0xe5,
+  0x03, 0x92, 0xfc, 0xa1, 0x62, 0xc1, 0xee, 0xba, 0x5d, 0x8d, 0xa6, 0xbb, 0x04, 0x12, 0x06, 0x1b,
+  0x77, 0x53, 0x15, 0xb1, 0xa7, 0xc7, 0xcb, 0x5d, 0x22, 0xcd, 0xe4, 0x2a, 0x9d, 0xc6, 0x3c, 0xd4,
+  0xca, 0x93, 0x93, 0x8b, 0xea, 0xe1, 0xc6, 0xd6, 0xec, 0xf5, 0xab, 0x4c, 0x77, 0x0d, 0xe4, 0xd6,
+  0xf6, 0xca, 0x3d, 0xd0, 0xa6, 0x77, 0x73, 0x56, 0xea, 0x76, 0xb6, 0xbe, 0xb2, 0x6f, 0x90, 0x2d,
+  0xe8, 0x46, 0x26, 0x88, 0x6d, 0x24, 0x3d, 0xb8, 0x8b, 0x31, 0x27, 0xb4, 0xd5, 0xed, 0xe8, 0xab,
+  0x57, 0x4d, 0xf6, 0x6d, 0x9f, 0xed, 0xae, 0x99, 0x6c, 0x03, 0x60, 0x1b, 0xa3, 0x15, 0x37, 0x4c,
+  0xcb, 0xcb, 0xe9, 0xa2, 0xd8, 0xee, 0x5b, 0xf1, 0x85, 0xe5, 0xb8, 0x94, 0x6f, 0x8d, 0xf5, 0xe0,
+  0xa4, 0xd6, 0x2c, 0x65, 0x8c, 0x91, 0xda, 0x9d, 0x72, 0x28, 0xb5, 0xf9, 0x29, 0x77, 0x7b, 0x73,
+  0x5a, 0x13, 0xd4, 0xff, 0xe9, 0x36, 0xb7, 0xd8, 0xbe, 0xbd, 0xa5, 0xa4, 0xe5, 0xdc, 0x63, 0x48,
+  0xa9, 0x5c, 0x5d, 0xbb, 0xa6, 0xfb, 0x14, 0xdb, 0xa3, 0xb2, 0x4d, 0x7b, 0x4f, 0xf1, 0x34, 0x8f,
+  0xc1, 0x6b, 0xad, 0x8b, 0xb2, 0xd7, 0x90, 0xac, 0x07, 0xf2, 0x1b, 0xba, 0x8e, 0xa2, 0x4e, 0x32,
+  0xf3, 0xd1, 0x7d, 0xd7, 0x7e, 0x2a, 0x13, 0xc3, 0x74, 0xea, 0xd3, 0x3b, 0x87, 0xf6, 0xcb, 0xfe,
+  0x1f, 0xf4, 0xce, 0x61, 0xf7, 0xb4, 0x16, 0x04, 0xa7, 0xd5, 0xca, 0x71, 0xa3, 0x22, 0xea, 0x87,
+  0xa7, 0xdc, 0xae, 0xc0, 0xfe, 0x4e, 0x2f, 0x1f, 0xba, 0xb7, 0x0e, 0xe1, 0x27, 0xf6, 0x15, 0xcb,
+  0xff, 0x03, 0x1d, 0x87, 0x56, 0x82, 0x7a, 0x29, 0x00, 0x00,
+};
+
+static const WebAsset WEB_ASSETS[] = {
+  {"/style.css", "text/css", WEB_STYLE_CSS, sizeof(WEB_STYLE_CSS), "\"1872a79727b5b173\"", true},
+  {"/script.js", "application/javascript", WEB_SCRIPT_JS, sizeof(WEB_SCRIPT_JS), "\"f92dd910760e349a\"", true},
+  {"/", "text/html", WEB_INDEX_HTML, sizeof(WEB_INDEX_HTML), "\"ba32a481cc3d408c\"", false},
+};
+
+#endif // WEB_ASSETS_H
@@ -24,9 +24,23 @@
 #include <Arduino.h>
 #include <WebServer.h>
 #include <ArduinoJson.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
 #include "config.h"
 #include "sensors.h"
 #include "datalogger.h"
+#include "recent_samples.h"
+#include "rollup.h"
+#include "sample_batch.h"
+#include "status_cache.h"
+#include "web_assets.h"
+#include "live_events.h"
+#include "transfer_pump.h"
+#include "uplink.h"
+#include "network_manager.h"
+#include "metrics.h"
+#include "json_stream.h"
+#include "row_format.h"
 
 // Custom allocator that uses PSRAM when available for large allocations
 struct PsramAllocator {
@@ -59,37 +73,110 @@ using PsramJsonDocument = BasicJsonDocument<PsramAllocator>;
 class WebServerManager {
 public:
   WebServerManager() : server(80), config(nullptr), sensors(nullptr), logger(nullptr), 
-                       getBatteryVoltage(nullptr), getWiFiEnabled(nullptr) {}
+                       recent(nullptr), getBatteryVoltage(nullptr), getWiFiEnabled(nullptr),
+                       storageLock(nullptr), wakeStats(nullptr), sampleBatch(nullptr),
+                       statusCache(nullptr), uplink(nullptr), network(nullptr) {}
   
-  void begin(Config* cfg, SensorManager* sens, DataLogger* log, 
+  void begin(Config* cfg, SensorManager* sens, DataLogger* log, RecentSamples* rec,
              float (*batteryVoltageFn)() = nullptr, bool (*wifiEnabledFn)() = nullptr) {
     config = cfg;
     sensors = sens;
     logger = log;
+    recent = rec;
     getBatteryVoltage = batteryVoltageFn;
     getWiFiEnabled = wifiEnabledFn;
     
-    // Setup routes
-    server.on("/", HTTP_GET, [this]() { handleRoot(); });
-    server.on("/api/status", HTTP_GET, [this]() { handleStatus(); });
-    server.on("/api/sensors", HTTP_GET, [this]() { handleGetSensors(); });
-    server.on("/api/sensors", HTTP_POST, [this]() { handleSetSensors(); });
-    server.on("/api/settings", HTTP_GET, [this]() { handleGetSettings(); });
-    server.on("/api/settings", HTTP_POST, [this]() { handleSetSettings(); });
-    server.on("/api/data", HTTP_GET, [this]() { handleGetData(); });
-    server.on("/api/files", HTTP_GET, [this]() { handleListFiles(); });
-    server.on("/api/download", HTTP_GET, [this]() { handleDownload(); });
-    server.on("/api/flush", HTTP_POST, [this]() { handleFlushBuffer(); });
-    server.on("/style.css", HTTP_GET, [this]() { handleCSS(); });
-    server.on("/script.js", HTTP_GET, [this]() { handleJS(); });
+    // Setup routes, each timing its handler for /api/metrics
+    for (const WebAsset& asset : WEB_ASSETS) {
+      server.on(asset.path, HTTP_GET, [this, &asset]() { ScopedTimer timer(METRIC_HTTP_ASSET); sendAsset(asset); });
+    }
+    server.on("/api/status", HTTP_GET, [this]() { ScopedTimer timer(METRIC_HTTP_STATUS); handleStatus(); });
+    server.on("/api/sensors", HTTP_GET, [this]() { ScopedTimer timer(METRIC_HTTP_SENSORS); handleGetSensors(); });
+    server.on("/api/sensors", HTTP_POST, [this]() { ScopedTimer timer(METRIC_HTTP_SENSORS); handleSetSensors(); });
+    server.on("/api/settings", HTTP_GET, [this]() { ScopedTimer timer(METRIC_HTTP_SETTINGS); handleGetSettings(); });
+    server.on("/api/settings", HTTP_POST, [this]() { ScopedTimer timer(METRIC_HTTP_SETTINGS); handleSetSettings(); });
+    server.on("/api/data", HTTP_GET, [this]() { ScopedTimer timer(METRIC_HTTP_DATA); handleGetData(); });
+    server.on("/api/recent", HTTP_GET, [this]() { ScopedTimer timer(METRIC_HTTP_RECENT); handleRecent(); });
+    server.on("/api/events", HTTP_GET, [this]() { ScopedTimer timer(METRIC_HTTP_EVENTS); handleEvents(); });
+    server.on("/api/files", HTTP_GET, [this]() { ScopedTimer timer(METRIC_HTTP_FILES); handleListFiles(); });
+    server.on("/api/download", HTTP_GET, [this]() { ScopedTimer timer(METRIC_HTTP_DOWNLOAD); handleDownload(); });
+    server.on("/api/archive", HTTP_GET, [this]() { ScopedTimer timer(METRIC_HTTP_ARCHIVE); handleArchive(); });
+    server.on("/api/metrics", HTTP_GET, [this]() { ScopedTimer timer(METRIC_HTTP_METRICS); handleMetrics(); });
+    server.on("/api/flush", HTTP_POST, [this]() { ScopedTimer timer(METRIC_HTTP_FLUSH); handleFlushBuffer(); });
     server.onNotFound([this]() { handleNotFound(); });
     
+    // Cache revalidation of the web UI, resumed and compressed downloads
+    const char* headers[] = {"If-None-Match", "Range", "If-Range", "Accept-Encoding"};
+    server.collectHeaders(headers, 4);
+    
     server.begin();
     Serial.println("HTTP server started on port 80");
   }
   
+  // Requests run with the storage lock held, so handlers can use the logger
+  // while the storage task writes to it
+  void setStorageLock(SemaphoreHandle_t lock) {
+    storageLock = lock;
+  }
+  
+  // Deep sleep wake statistics and the RTC sample batch for /api/status
+  void setWakeInfo(const WakeStats* stats, const SampleBatch* batch) {
+    wakeStats = stats;
+    sampleBatch = batch;
+  }
+  
+  // Battery and SD health for /api/status come from the cache when set
+  void setStatusCache(const StatusCache* cache) {
+    statusCache = cache;
+  }
+  
+  // Upload progress for /api/status
+  void setUplink(const Uplink* up) {
+    uplink = up;
+  }
+  
+  // Link state and NTP sync for /api/status
+  void setNetwork(const NetworkManager* net) {
+    network = net;
+  }
+  
+  // Transfers still reading day files
+  int getActiveDownloads() const {
+    return downloads.activeCount();
+  }
+  
   void handleClient() {
+    if (storageLock) {
+      xSemaphoreTake(storageLock, portMAX_DELAY);
+    }
     server.handleClient();
+    events.service();
+    downloads.service();
+    if (storageLock) {
+      xSemaphoreGive(storageLock);
+    }
+  }
+  
+  // Push a logged sample to /api/events subscribers: its /api/recent row and
+  // the counters that change with it. Call with the storage lock held.
+  void publishSample(uint32_t seq) {
+    RecentSample sample;
+    if (events.clientCount() == 0 || !recent || !recent->get(seq, sample)) {
+      return;
+    }
+    
+    EventBuffer payload;
+    JsonStreamWriter json(payload);
+    json.beginObject();
+    json.key("row");
+    writeRecentRow(json, sample);
+    json.field("datapoints", logger->getDataPointCount());
+    json.field("bufferCount", logger->getBufferCount());
+    json.endObject();
+    
+    if (!payload.truncated()) {
+      events.publish("sample", payload.data(), payload.length());
+    }
   }
 
 private:
@@ -97,666 +184,210 @@ private:
   Config* config;
   SensorManager* sensors;
   DataLogger* logger;
+  RecentSamples* recent;
   float (*getBatteryVoltage)();
   bool (*getWiFiEnabled)();
+  SemaphoreHandle_t storageLock;
+  const WakeStats* wakeStats;
+  const SampleBatch* sampleBatch;
+  const StatusCache* statusCache;
+  const Uplink* uplink;
+  const NetworkManager* network;
+  LiveEvents events;
+  TransferPump downloads;
   
-  void handleRoot() {
-    String html = R"rawliteral(<!DOCTYPE html>
-<html>
-<head>
-    <meta charset="UTF-8">
-    <meta name="viewport" content="width=device-width, initial-scale=1.0">
-    <title>OmniLogger Dashboard</title>
-    <link rel="stylesheet" href="/style.css">
-</head>
-<body>
-    <div class="container">
-        <header>
-            <h1>🌡️ OmniLogger</h1>
-            <p>Semi-Universal Data Logger</p>
-        </header>
-        
-        <nav>
-            <button onclick="showTab('dashboard')" class="tab-btn active" id="tab-dashboard">Dashboard</button>
-            <button onclick="showTab('sensors')" class="tab-btn" id="tab-sensors">Sensors</button>
-            <button onclick="showTab('settings')" class="tab-btn" id="tab-settings">Settings</button>
-            <button onclick="showTab('data')" class="tab-btn" id="tab-data">Data</button>
-        </nav>
-        
-        <div id="dashboard" class="tab-content active">
-            <h2>System Status</h2>
-            <div class="stats-grid">
-                <div class="stat-card">
-                    <h3>Data Points</h3>
-                    <p class="stat-value" id="datapoints">-</p>
-                </div>
-                <div class="stat-card">
-                    <h3>Battery Voltage</h3>
-                    <p class="stat-value" id="battery">-</p>
-                </div>
-                <div class="stat-card">
-                    <h3>Storage Used</h3>
-                    <p class="stat-value" id="storage">-</p>
-                </div>
-                <div class="stat-card">
-                    <h3>SD Card Health</h3>
-                    <p class="stat-value" id="sdhealth">-</p>
-                </div>
-                <div class="stat-card">
-                    <h3>Active Sensors</h3>
-                    <p class="stat-value" id="sensorcount">-</p>
-                </div>
-                <div class="stat-card">
-                    <h3>Uptime</h3>
-                    <p class="stat-value" id="uptime">-</p>
-                </div>
-                <div class="stat-card">
-                    <h3>Buffer Status</h3>
-                    <p class="stat-value" id="buffer">-</p>
-                </div>
-                <div class="stat-card">
-                    <h3>WiFi Status</h3>
-                    <p class="stat-value" id="wifistatus">-</p>
-                </div>
-            </div>
-            
-            <div style="margin: 20px 0;">
-                <button onclick="flushBuffer()" class="btn-primary">Flush Buffer to SD Card</button>
-            </div>
-            
-            <h3>Current Readings</h3>
-            <div id="readings" class="readings">
-                <p>Loading...</p>
-            </div>
-        </div>
-        
-        <div id="sensors" class="tab-content">
-            <h2>Sensor Configuration</h2>
-            <p>Configure up to 8 sensors. Changes require a reboot to take effect.</p>
-            <div id="sensor-config">
-                <p>Loading...</p>
-            </div>
-            <button onclick="saveSensors()" class="btn-primary">Save Sensor Configuration</button>
-        </div>
-        
-        <div id="settings" class="tab-content">
-            <h2>System Settings</h2>
-            <div class="settings-form">
-                <h3>WiFi Station Configuration</h3>
-                <label>WiFi SSID:</label>
-                <input type="text" id="wifiSSID" placeholder="Network name">
-                
-                <label>WiFi Password:</label>
-                <input type="password" id="wifiPassword" placeholder="Password">
-                
-                <h3>WiFi Access Point Configuration</h3>
-                <label>AP SSID:</label>
-                <input type="text" id="apSSID" placeholder="Access Point name">
-                
-                <label>AP Password:</label>
-                <input type="password" id="apPassword" placeholder="AP Password (min 8 characters)" minlength="8">
-                
-                <h3>Data Buffering (Optional)</h3>
-                <label>Enable Data Buffering:</label>
-                <input type="checkbox" id="bufferingEnabled">
-                <span>Store data in memory and flush periodically</span>
-                
-                <label>Flush Interval (seconds):</label>
-                <input type="number" id="flushInterval" min="1" value="300">
-                <span>How often to write buffered data to SD card</span>
-                
-                <h3>Measurement Settings</h3>
-                <label>Measurement Interval (seconds):</label>
-                <input type="number" id="measInterval" min="1" value="60">
-                
-                <label>Deep Sleep Mode:</label>
-                <input type="checkbox" id="deepSleep">
-                <span>Enable deep sleep between measurements (battery mode)</span>
-                
-                <h3>Time Settings</h3>
-                <label>Timezone Offset (hours from UTC):</label>
-                <input type="number" id="timezoneOffset" min="-12" max="14" value="0">
-                
-                <button onclick="saveSettings()" class="btn-primary">Save Settings</button>
-                <button onclick="rebootDevice()" class="btn-warning">Reboot Device</button>
-            </div>
-        </div>
-        
-        <div id="data" class="tab-content">
-            <h2>Data Files</h2>
-            <button onclick="refreshFiles()" class="btn-secondary">Refresh</button>
-            <div id="file-list">
-                <p>Loading...</p>
-            </div>
-        </div>
-    </div>
-    
-    <script src="/script.js"></script>
-</body>
-</html>)rawliteral";
-    
-    server.send(200, "text/html", html);
-  }
-  
-  void handleCSS() {
-    String css = R"rawliteral(
-* {
-    margin: 0;
-    padding: 0;
-    box-sizing: border-box;
-}
-
-body {
-    font-family: 'Segoe UI', Tahoma, Geneva, Verdana, sans-serif;
-    background: linear-gradient(135deg, #667eea 0%, #764ba2 100%);
-    min-height: 100vh;
-    padding: 20px;
-}
-
-.container {
-    max-width: 1200px;
-    margin: 0 auto;
-    background: white;
-    border-radius: 10px;
-    box-shadow: 0 10px 40px rgba(0,0,0,0.2);
-    overflow: hidden;
-}
-
-header {
-    background: linear-gradient(135deg, #667eea 0%, #764ba2 100%);
-    color: white;
-    padding: 30px;
-    text-align: center;
-}
-
-header h1 {
-    font-size: 2.5em;
-    margin-bottom: 10px;
-}
-
-nav {
-    display: flex;
-    background: #f5f5f5;
-    border-bottom: 2px solid #ddd;
-}
-
-.tab-btn {
-    flex: 1;
-    padding: 15px;
-    border: none;
-    background: none;
-    cursor: pointer;
-    font-size: 16px;
-    font-weight: 500;
-    transition: all 0.3s;
-}
-
-.tab-btn:hover {
-    background: #e0e0e0;
-}
-
-.tab-btn.active {
-    background: white;
-    border-bottom: 3px solid #667eea;
-}
-
-.tab-content {
-    display: none;
-    padding: 30px;
-    animation: fadeIn 0.3s;
-}
-
-.tab-content.active {
-    display: block;
-}
-
-@keyframes fadeIn {
-    from { opacity: 0; }
-    to { opacity: 1; }
-}
-
-.stats-grid {
-    display: grid;
-    grid-template-columns: repeat(auto-fit, minmax(200px, 1fr));
-    gap: 20px;
-    margin: 20px 0;
-}
-
-.stat-card {
-    background: linear-gradient(135deg, #667eea 0%, #764ba2 100%);
-    color: white;
-    padding: 20px;
-    border-radius: 10px;
-    text-align: center;
-    box-shadow: 0 4px 6px rgba(0,0,0,0.1);
-}
-
-.stat-card h3 {
-    font-size: 14px;
-    margin-bottom: 10px;
-    opacity: 0.9;
-}
-
-.stat-value {
-    font-size: 24px;
-    font-weight: bold;
-}
-
-.readings {
-    background: #f9f9f9;
-    padding: 20px;
-    border-radius: 8px;
-    margin-top: 20px;
-}
-
-.sensor-item {
-    background: white;
-    padding: 15px;
-    margin: 10px 0;
-    border-radius: 8px;
-    border-left: 4px solid #667eea;
-}
-
-.settings-form label {
-    display: block;
-    margin-top: 15px;
-    margin-bottom: 5px;
-    font-weight: 500;
-}
-
-.settings-form input[type="text"],
-.settings-form input[type="password"],
-.settings-form input[type="number"],
-.settings-form select {
-    width: 100%;
-    padding: 10px;
-    border: 1px solid #ddd;
-    border-radius: 5px;
-    font-size: 14px;
-}
-
-.settings-form h3 {
-    margin-top: 25px;
-    margin-bottom: 15px;
-    color: #667eea;
-}
-
-.btn-primary, .btn-secondary, .btn-warning {
-    padding: 12px 24px;
-    border: none;
-    border-radius: 5px;
-    font-size: 16px;
-    cursor: pointer;
-    margin: 10px 5px 0 0;
-    transition: all 0.3s;
-}
-
-.btn-primary {
-    background: #667eea;
-    color: white;
-}
-
-.btn-primary:hover {
-    background: #5568d3;
-}
-
-.btn-secondary {
-    background: #6c757d;
-    color: white;
-}
-
-.btn-secondary:hover {
-    background: #5a6268;
-}
-
-.btn-warning {
-    background: #ffc107;
-    color: #000;
-}
-
-.btn-warning:hover {
-    background: #e0a800;
-}
-
-#file-list {
-    background: #f9f9f9;
-    padding: 20px;
-    border-radius: 8px;
-    margin-top: 20px;
-}
-
-.file-item {
-    background: white;
-    padding: 12px;
-    margin: 8px 0;
-    border-radius: 5px;
-    display: flex;
-    justify-content: space-between;
-    align-items: center;
-}
-
-.file-item button {
-    padding: 6px 12px;
-    background: #667eea;
-    color: white;
-    border: none;
-    border-radius: 4px;
-    cursor: pointer;
-}
-
-.file-item button:hover {
-    background: #5568d3;
-}
-)rawliteral";
-    
-    server.send(200, "text/css", css);
+  // Web UI files are stored gzipped in flash (web/, embedded by
+  // tools/embed_web_assets.py) and sent straight from there without a copy
+  void sendAsset(const WebAsset& asset) {
+    server.sendHeader("ETag", asset.etag);
+    server.sendHeader("Cache-Control", asset.versioned ? "public, max-age=31536000, immutable" : "no-cache");
+    if (server.header("If-None-Match").indexOf(asset.etag) >= 0) {
+      server.send(304);
+      return;
+    }
+    server.sendHeader("Content-Encoding", "gzip");
+    server.send_P(200, asset.contentType, (PGM_P)asset.data, asset.length);
   }
   
-  void handleJS() {
-    String js = R"rawliteral(
-let statusInterval;
-
-function showTab(tabName) {
-    // Hide all tabs
-    document.querySelectorAll('.tab-content').forEach(tab => {
-        tab.classList.remove('active');
-    });
-    document.querySelectorAll('.tab-btn').forEach(btn => {
-        btn.classList.remove('active');
-    });
-    
-    // Show selected tab
-    document.getElementById(tabName).classList.add('active');
-    document.getElementById('tab-' + tabName).classList.add('active');
+  void handleStatus() {
+    ChunkedResponse response(server, 200, "application/json");
+    JsonStreamWriter json(response);
+    json.beginObject();
     
-    // Load tab-specific data
-    if (tabName === 'dashboard') {
-        loadStatus();
-        if (!statusInterval) {
-            statusInterval = setInterval(loadStatus, 5000);
-        }
+    // System stats
+    json.field("datapoints", logger->getDataPointCount());
+    if (statusCache) {
+      json.field("battery", statusCache->getBatteryVoltage());
+      json.field("statusAgeMs", statusCache->getAgeMs());
     } else {
-        if (statusInterval) {
-            clearInterval(statusInterval);
-            statusInterval = null;
-        }
-        
-        if (tabName === 'sensors') {
-            loadSensors();
-        } else if (tabName === 'settings') {
-            loadSettings();
-        } else if (tabName === 'data') {
-            refreshFiles();
-        }
-    }
-}
-
-function loadStatus() {
-    fetch('/api/status')
-        .then(response => response.json())
-        .then(data => {
-            document.getElementById('datapoints').textContent = data.datapoints.toLocaleString();
-            document.getElementById('battery').textContent = data.battery.toFixed(2) + 'V';
-            document.getElementById('storage').textContent = data.storageUsed + ' / ' + data.storageTotal;
-            document.getElementById('sdhealth').textContent = data.sdHealthy ? '✓ Healthy' : '✗ Error';
-            document.getElementById('sensorcount').textContent = data.sensorCount;
-            document.getElementById('uptime').textContent = formatUptime(data.uptime);
-            document.getElementById('buffer').textContent = data.bufferCount + ' / ' + data.bufferCapacity;
-            document.getElementById('wifistatus').textContent = data.wifiEnabled ? '✓ Enabled' : '✗ Disabled';
-            
-            // Update readings
-            let readingsHTML = '';
-            data.readings.forEach(reading => {
-                readingsHTML += '<div class="sensor-item">';
-                readingsHTML += '<h4>' + reading.name + '</h4>';
-                readingsHTML += '<p>' + reading.data + '</p>';
-                readingsHTML += '</div>';
-            });
-            document.getElementById('readings').innerHTML = readingsHTML || '<p>No sensor readings available</p>';
-        })
-        .catch(err => console.error('Error loading status:', err));
-}
-
-function loadSensors() {
-    fetch('/api/sensors')
-        .then(response => response.json())
-        .then(data => {
-            let html = '';
-            data.sensors.forEach((sensor, index) => {
-                html += '<div class="sensor-item">';
-                html += '<h4>Sensor ' + (index + 1) + '</h4>';
-                html += '<label>Enabled:</label>';
-                html += '<input type="checkbox" id="s' + index + '_enabled" ' + (sensor.enabled ? 'checked' : '') + '><br>';
-                html += '<label>Name:</label>';
-                html += '<input type="text" id="s' + index + '_name" value="' + sensor.name + '"><br>';
-                html += '<label>Type:</label>';
-                html += '<select id="s' + index + '_type">';
-                html += '<option value="0"' + (sensor.type === 0 ? ' selected' : '') + '>None</option>';
-                html += '<option value="1"' + (sensor.type === 1 ? ' selected' : '') + '>BME280 (I2C)</option>';
-                html += '<option value="2"' + (sensor.type === 2 ? ' selected' : '') + '>DHT22</option>';
-                html += '<option value="3"' + (sensor.type === 3 ? ' selected' : '') + '>DS18B20</option>';
-                html += '<option value="4"' + (sensor.type === 4 ? ' selected' : '') + '>Analog</option>';
-                html += '</select><br>';
-                html += '<label>Pin (for digital/analog sensors):</label>';
-                html += '<input type="number" id="s' + index + '_pin" value="' + sensor.pin + '">';
-                html += '</div>';
-            });
-            document.getElementById('sensor-config').innerHTML = html;
-        })
-        .catch(err => console.error('Error loading sensors:', err));
-}
-
-function saveSensors() {
-    let sensors = [];
-    for (let i = 0; i < 8; i++) {
-        let enabled = document.getElementById('s' + i + '_enabled');
-        if (enabled) {
-            sensors.push({
-                enabled: enabled.checked,
-                name: document.getElementById('s' + i + '_name').value,
-                type: parseInt(document.getElementById('s' + i + '_type').value),
-                pin: parseInt(document.getElementById('s' + i + '_pin').value)
-            });
-        }
+      json.field("battery", getBatteryVoltage ? getBatteryVoltage() : 0.0f);
     }
+    char size[16];
+    RowWriter(size, sizeof(size)).number((uint32_t)(logger->getTotalSize() / (1024*1024))).text("MB");
+    json.field("storageTotal", (const char*)size);
+    RowWriter(size, sizeof(size)).number((uint32_t)(logger->getUsedSize() / (1024*1024))).text("MB");
+    json.field("storageUsed", (const char*)size);
+    json.field("sdHealthy", logger->isHealthy());
+    json.field("sensorCount", sensors->getSensorCount());
+    json.field("uptime", millis() / 1000);  // Note: Resets after ~49.7 days due to millis() overflow
     
-    fetch('/api/sensors', {
-        method: 'POST',
-        headers: {'Content-Type': 'application/json'},
-        body: JSON.stringify({sensors: sensors})
-    })
-    .then(response => response.json())
-    .then(data => {
-        alert(data.message);
-    })
-    .catch(err => {
-        alert('Error saving sensors: ' + err);
-    });
-}
-
-function loadSettings() {
-    fetch('/api/settings')
-        .then(response => response.json())
-        .then(data => {
-            document.getElementById('wifiSSID').value = data.wifiSSID || '';
-            document.getElementById('wifiPassword').value = '';
-            document.getElementById('apSSID').value = data.apSSID || '';
-            document.getElementById('apPassword').value = '';
-            document.getElementById('bufferingEnabled').checked = data.bufferingEnabled || false;
-            document.getElementById('flushInterval').value = data.flushInterval || 300;
-            document.getElementById('measInterval').value = data.measurementInterval;
-            document.getElementById('deepSleep').checked = data.deepSleepEnabled;
-            document.getElementById('timezoneOffset').value = data.timezoneOffset;
-        })
-        .catch(err => console.error('Error loading settings:', err));
-}
-
-function saveSettings() {
-    const settings = {
-        wifiSSID: document.getElementById('wifiSSID').value,
-        wifiPassword: document.getElementById('wifiPassword').value,
-        apSSID: document.getElementById('apSSID').value,
-        apPassword: document.getElementById('apPassword').value,
-        bufferingEnabled: document.getElementById('bufferingEnabled').checked,
-        flushInterval: parseInt(document.getElementById('flushInterval').value),
-        measurementInterval: parseInt(document.getElementById('measInterval').value),
-        deepSleepEnabled: document.getElementById('deepSleep').checked,
-        timezoneOffset: parseInt(document.getElementById('timezoneOffset').value)
-    };
+    // Buffer stats
+    json.field("bufferCount", logger->getBufferCount());
+    json.field("bufferCapacity", logger->getBufferCapacity());
     
-    fetch('/api/settings', {
-        method: 'POST',
-        headers: {'Content-Type': 'application/json'},
-        body: JSON.stringify(settings)
-    })
-    .then(response => response.json())
-    .then(data => {
-        alert(data.message);
-    })
-    .catch(err => {
-        alert('Error saving settings: ' + err);
-    });
-}
-
-function rebootDevice() {
-    if (confirm('Are you sure you want to reboot the device?')) {
-        fetch('/api/settings', {
-            method: 'POST',
-            headers: {'Content-Type': 'application/json'},
-            body: JSON.stringify({reboot: true})
-        })
-        .then(() => {
-            alert('Device is rebooting...');
-        })
-        .catch(err => {
-            alert('Error rebooting device: ' + err);
-        });
-    }
-}
-
-function refreshFiles() {
-    fetch('/api/files')
-        .then(response => response.json())
-        .then(data => {
-            let html = '';
-            data.files.forEach(file => {
-                html += '<div class="file-item">';
-                html += '<span>' + file.name + ' (' + file.size + ' bytes)</span>';
-                html += '<button onclick="downloadFile(\'' + file.name + '\')">Download</button>';
-                html += '</div>';
-            });
-            document.getElementById('file-list').innerHTML = html || '<p>No data files found</p>';
-        })
-        .catch(err => console.error('Error loading files:', err));
-}
-
-function downloadFile(filename) {
-    window.open('/api/download?file=' + encodeURIComponent(filename), '_blank');
-}
-
-function flushBuffer() {
-    if (!confirm('Flush buffered data to SD card now?')) {
-        return;
-    }
+    // SD write latency (block writes and commit flushes)
+    writeLatency(json, "sdWrite", logger->getWriteStats());
+    writeLatency(json, "sdCommit", logger->getCommitStats());
     
-    fetch('/api/flush', {
-        method: 'POST'
-    })
-    .then(response => response.json())
-    .then(data => {
-        alert(data.message || 'Buffer flushed successfully');
-        loadStatus();  // Refresh status to show updated buffer count
-    })
-    .catch(err => {
-        alert('Error flushing buffer: ' + err);
-    });
-}
-
-function formatUptime(seconds) {
-    const days = Math.floor(seconds / 86400);
-    const hours = Math.floor((seconds % 86400) / 3600);
-    const mins = Math.floor((seconds % 3600) / 60);
+    // SPI clock of the card and the throughput measured when it was calibrated
+    const SdClockProfile& sdClock = logger->getSdClock();
+    json.beginObject("sdClock");
+    json.field("clockKHz", sdClock.clockHz / 1000);
+    json.field("readKBps", sdClock.readKBps);
+    json.field("writeKBps", sdClock.writeKBps);
+    json.field("calibrated", logger->isSdClockCalibrated());
+    json.endObject();
     
-    if (days > 0) {
-        return days + 'd ' + hours + 'h ' + mins + 'm';
-    } else if (hours > 0) {
-        return hours + 'h ' + mins + 'm';
-    } else {
-        return mins + 'm';
+    // WiFi status
+    json.field("wifiEnabled", getWiFiEnabled ? getWiFiEnabled() : true);
+    json.field("liveClients", events.clientCount());
+    json.field("activeDownloads", downloads.activeCount());
+    if (network) {
+      json.beginObject("network");
+      json.field("state", network->getStateName());
+      json.field("failures", network->getFailures());
+      json.field("timeSynced", network->isTimeSynced());
+      json.field("lastSyncAge", network->getLastSyncAge());
+      json.endObject();
     }
-}
-
-// Initialize on page load
-document.addEventListener('DOMContentLoaded', function() {
-    showTab('dashboard');
-});
-)rawliteral";
-    
-    server.send(200, "application/javascript", js);
-  }
-  
-  void handleStatus() {
-    // Use PSRAM-backed JSON document for larger allocations
-    PsramJsonDocument doc(2048);
     
-    // System stats
-    doc["datapoints"] = logger->getDataPointCount();
-    doc["battery"] = getBatteryVoltage ? getBatteryVoltage() : 0.0f;
-    doc["storageTotal"] = String(logger->getTotalSize() / (1024*1024)) + "MB";
-    doc["storageUsed"] = String(logger->getUsedSize() / (1024*1024)) + "MB";
-    doc["sdHealthy"] = logger->isHealthy();
-    doc["sensorCount"] = sensors->getSensorCount();
-    doc["uptime"] = millis() / 1000;  // Note: Resets after ~49.7 days due to millis() overflow
+    // Deep sleep: time awake per wake and samples waiting in RTC memory
+    if (wakeStats && sampleBatch) {
+      json.beginObject("wake");
+      json.field("fastWakes", wakeStats->fastWakes);
+      json.field("fastAvgMs", wakeStats->averageFastMs());
+      json.field("fastLastMs", wakeStats->lastFastUs / 1000);
+      json.field("fullWakes", wakeStats->fullWakes);
+      json.field("fullAvgMs", wakeStats->averageFullMs());
+      json.field("fullLastMs", wakeStats->lastFullUs / 1000);
+      json.field("batchFlushes", wakeStats->batchFlushes);
+      json.field("batched", (unsigned int)sampleBatch->count);
+      json.field("batchBytes", (unsigned int)sampleBatch->used);
+      json.field("batchCapacity", (unsigned int)SampleBatch::CAPACITY);
+      json.endObject();
+    }
     
-    // Buffer stats
-    doc["bufferCount"] = logger->getBufferCount();
-    doc["bufferCapacity"] = logger->getBufferCapacity();
+    // Store-and-forward upload: cursor and counters since boot
+    if (uplink && config->uplinkEnabled) {
+      json.beginObject("uplink");
+      json.field("file", uplink->getCursor().name);
+      json.field("offset", uplink->getCursor().offset);
+      json.field("recordsSent", uplink->getRecordsSent());
+      json.field("batchesSent", uplink->getBatchesSent());
+      json.field("bytesSent", uplink->getBytesSent());
+      json.field("failures", uplink->getFailures());
+      json.field("lastStatus", uplink->getLastStatus());
+      json.field("lastSuccessAge", uplink->getLastSuccessAge());
+      json.endObject();
+    }
     
-    // WiFi status
-    doc["wifiEnabled"] = getWiFiEnabled ? getWiFiEnabled() : true;
+    // Day file compaction since boot
+    if (config->compactAfterDays > 0) {
+      json.beginObject("compaction");
+      json.field("active", logger->isCompacting());
+      json.field("files", logger->getCompactedFiles());
+      json.field("bytesSaved", logger->getCompactedBytesSaved());
+      json.endObject();
+    }
     
     // Current sensor readings
-    JsonArray readings = doc.createNestedArray("readings");
+    json.beginArray("readings");
     for (int i = 0; i < Config::MAX_SENSORS; i++) {
-      SensorType type = sensors->getSensorType(i);
-      if (type == SENSOR_NONE) continue;
+      if (sensors->getSensorType(i) == SENSOR_NONE || !sensors->isReadingValid(i)) continue;
       
-      SensorReading reading = sensors->getReading(i);
-      if (!reading.valid) continue;
+      char data[128];
+      sensors->formatReading(i, data, sizeof(data));
       
-      JsonObject r = readings.createNestedObject();
-      r["name"] = sensors->getSensorName(i);
-      
-      String data = "";
-      switch (type) {
-        case SENSOR_BME280:
-          data = "Temp: " + String(reading.temperature, 1) + "°C, " +
-                 "Humidity: " + String(reading.humidity, 1) + "%, " +
-                 "Pressure: " + String(reading.pressure, 1) + "hPa";
-          break;
-        case SENSOR_DHT22:
-          data = "Temp: " + String(reading.temperature, 1) + "°C, " +
-                 "Humidity: " + String(reading.humidity, 1) + "%";
-          break;
-        case SENSOR_DS18B20:
-          data = "Temp: " + String(reading.temperature, 1) + "°C";
-          break;
-        case SENSOR_ANALOG:
-          data = "Value: " + String(reading.value, 2);
-          break;
-        default:
-          break;
-      }
-      r["data"] = data;
+      json.beginObject();
+      json.field("name", sensors->getSensorName(i));
+      json.field("data", (const char*)data);
+      json.endObject();
     }
+    json.endArray();
     
-    String response;
-    serializeJson(doc, response);
-    server.send(200, "application/json", response);
+    json.endObject();
+  }
+  
+  // Prometheus text exposition of the latency histograms and memory gauges
+  void handleMetrics() {
+    ChunkedResponse response(server, 200, "text/plain; version=0.0.4");
+    Metrics::beginHistograms(response);
+    for (int i = 0; i < METRIC_COUNT; i++) {
+      Metrics::writeHistogram(response, Metrics::name((MetricId)i), Metrics::get((MetricId)i));
+    }
+    Metrics::writeHistogram(response, "sd_write", logger->getWriteStats());
+    Metrics::writeHistogram(response, "sd_commit", logger->getCommitStats());
+    
+    Metrics::writeMemory(response);
+    Metrics::writeGauge(response, "omnilogger_uptime_seconds", "Seconds since boot", millis() / 1000);
+    Metrics::writeGauge(response, "omnilogger_buffered_records", "Records waiting in the buffer journal",
+                        logger->getBufferCount());
+    Metrics::writeGauge(response, "omnilogger_active_downloads", "Downloads in progress", downloads.activeCount());
+    Metrics::writeCounter(response, "omnilogger_live_events_dropped_total", "Events skipped for a slow live client",
+                          events.getDroppedEvents());
+    Metrics::writeGauge(response, "omnilogger_sd_clock_hz", "SPI clock of the SD card", logger->getSdClock().clockHz);
+    Metrics::writeGauge(response, "omnilogger_sd_read_bytes_per_second", "Sequential SD read rate at calibration",
+                        logger->getSdClock().readKBps * 1024.0);
+    Metrics::writeGauge(response, "omnilogger_sd_write_bytes_per_second", "Sequential SD write rate at calibration",
+                        logger->getSdClock().writeKBps * 1024.0);
+    Metrics::writeCounter(response, "omnilogger_datapoints_total", "Rows logged to the SD card",
+                          logger->getDataPointCount());
+    if (network) {
+      Metrics::writeCounter(response, "omnilogger_wifi_failures_total", "WiFi links lost and connect attempts timed out",
+                            network->getFailures());
+    }
+    if (uplink) {
+      Metrics::writeCounter(response, "omnilogger_uplink_records_total", "Rows acknowledged by the uplink server",
+                            uplink->getRecordsSent());
+      Metrics::writeCounter(response, "omnilogger_uplink_bytes_total", "Uplink payload bytes sent",
+                            uplink->getBytesSent());
+    }
+    Metrics::writeCounter(response, "omnilogger_compacted_files_total", "Day files compacted to gzip",
+                          logger->getCompactedFiles());
+    Metrics::writeCounter(response, "omnilogger_compaction_saved_bytes_total", "Card space freed by compaction",
+                          logger->getCompactedBytesSaved());
+  }
+  
+  void writeLatency(JsonStreamWriter& json, const char* name, const LatencyStats& stats) {
+    json.beginObject(name);
+    json.field("count", stats.count);
+    json.field("avgUs", stats.averageUs());
+    json.field("maxUs", stats.maxUs);
+    json.beginArray("hist");
+    for (int i = 0; i < LatencyStats::BUCKETS; i++) {
+      json.value(stats.histogram[i]);
+    }
+    json.endArray();
+    json.endObject();
   }
   
   void handleGetSensors() {
-    PsramJsonDocument doc(2048);
+    PsramJsonDocument doc(1024 + Config::MAX_SENSORS * 160);
+    
+    // Types and their channels for the type selector
+    JsonArray types = doc.createNestedArray("types");
+    for (int t = SENSOR_NONE; t < SENSOR_TYPE_COUNT; t++) {
+      const SensorTypeInfo& info = SensorTypes::info((SensorType)t);
+      JsonObject type = types.createNestedObject();
+      type["id"] = t;
+      type["label"] = info.label;
+      JsonArray channels = type.createNestedArray("channels");
+      for (int c = 0; c < info.channelCount; c++) {
+        channels.add(info.channels[c].label);
+      }
+    }
+    doc["maxChannels"] = Config::MAX_CHANNELS;
+    
     JsonArray sensorsArray = doc.createNestedArray("sensors");
     
     for (int i = 0; i < Config::MAX_SENSORS; i++) {
@@ -765,6 +396,7 @@ document.addEventListener('DOMContentLoaded', function() {
       s["name"] = config->sensors[i].name;
       s["type"] = (int)config->sensors[i].type;
       s["pin"] = config->sensors[i].pin;
+      s["interval"] = config->sensors[i].interval;
     }
     
     String response;
@@ -774,7 +406,7 @@ document.addEventListener('DOMContentLoaded', function() {
   
   void handleSetSensors() {
     if (server.hasArg("plain")) {
-      PsramJsonDocument doc(2048);
+      PsramJsonDocument doc(512 + Config::MAX_SENSORS * 192);
       DeserializationError error = deserializeJson(doc, server.arg("plain"));
       
       if (error) {
@@ -804,7 +436,7 @@ document.addEventListener('DOMContentLoaded', function() {
           // Validate and update sensor type
           if (s.containsKey("type")) {
             int type = s["type"];
-            if (type >= SENSOR_NONE && type <= SENSOR_ANALOG) {
+            if (SensorTypes::isKnown(type)) {
               config->sensors[i].type = (SensorType)type;
             }
           }
@@ -816,6 +448,14 @@ document.addEventListener('DOMContentLoaded', function() {
               config->sensors[i].pin = pin;
             }
           }
+          
+          // Validate and update the sensor's own interval
+          if (s.containsKey("interval")) {
+            unsigned int interval = s["interval"];
+            if (config->validateSensorInterval(interval)) {
+              config->sensors[i].interval = interval;
+            }
+          }
         }
       }
       
@@ -834,15 +474,32 @@ document.addEventListener('DOMContentLoaded', function() {
   }
   
   void handleGetSettings() {
-    PsramJsonDocument doc(512);
+    PsramJsonDocument doc(1024);
     
     doc["wifiSSID"] = config->wifiSSID;
     doc["apSSID"] = config->apSSID;
     // Don't send passwords
     doc["bufferingEnabled"] = config->bufferingEnabled;
     doc["flushInterval"] = config->flushInterval;
+    doc["bufferBackend"] = (int)config->bufferBackend;
+    doc["logFormat"] = (int)config->logFormat;
+    doc["sdPreallocKB"] = config->sdPreallocKB;
+    doc["sdProbeInterval"] = config->sdProbeInterval;
+    doc["groupCommitEnabled"] = config->groupCommitEnabled;
+    doc["commitMaxRecords"] = config->commitMaxRecords;
+    doc["commitMaxBytes"] = config->commitMaxBytes;
+    doc["commitMaxLatency"] = config->commitMaxLatency;
     doc["measurementInterval"] = config->measurementInterval;
     doc["deepSleepEnabled"] = config->deepSleepEnabled;
+    doc["carryForward"] = config->carryForward;
+    doc["fastAdcRateHz"] = config->fastAdcRateHz;
+    doc["bmeOversampling"] = config->bmeOversampling;
+    doc["uplinkEnabled"] = config->uplinkEnabled;
+    doc["uplinkUrl"] = config->uplinkUrl;
+    doc["uplinkInterval"] = config->uplinkInterval;
+    doc["uplinkBatchRecords"] = config->uplinkBatchRecords;
+    doc["compactAfterDays"] = config->compactAfterDays;
+    // Don't send the uplink token either
     doc["timezoneOffset"] = config->timezoneOffset;
     
     String response;
@@ -852,7 +509,7 @@ document.addEventListener('DOMContentLoaded', function() {
   
   void handleSetSettings() {
     if (server.hasArg("plain")) {
-      PsramJsonDocument doc(512);
+      PsramJsonDocument doc(1024);
       DeserializationError error = deserializeJson(doc, server.arg("plain"));
       
       if (error) {
@@ -861,6 +518,7 @@ document.addEventListener('DOMContentLoaded', function() {
       }
       
       if (doc.containsKey("reboot") && doc["reboot"]) {
+        logger->flush();  // Don't lose records waiting for commit
         server.send(200, "application/json", "{\"message\":\"Rebooting...\"}");
         delay(1000);
         ESP.restart();
@@ -916,6 +574,129 @@ document.addEventListener('DOMContentLoaded', function() {
         }
       }
       
+      // Buffer backend takes effect after reboot
+      if (doc.containsKey("bufferBackend")) {
+        unsigned int backend = doc["bufferBackend"];
+        if (backend <= BUFFER_PSRAM) {
+          config->bufferBackend = (BufferBackend)backend;
+        }
+      }
+      
+      // Update group commit settings
+      if (doc.containsKey("groupCommitEnabled")) {
+        config->groupCommitEnabled = doc["groupCommitEnabled"];
+      }
+      
+      if (doc.containsKey("commitMaxRecords")) {
+        unsigned int records = doc["commitMaxRecords"];
+        if (config->validateCommitMaxRecords(records)) {
+          config->commitMaxRecords = records;
+        }
+      }
+      
+      if (doc.containsKey("commitMaxBytes")) {
+        unsigned int bytes = doc["commitMaxBytes"];
+        if (config->validateCommitMaxBytes(bytes)) {
+          config->commitMaxBytes = bytes;
+        }
+      }
+      
+      if (doc.containsKey("commitMaxLatency")) {
+        unsigned int latency = doc["commitMaxLatency"];
+        if (config->validateCommitMaxLatency(latency)) {
+          config->commitMaxLatency = latency;
+        }
+      }
+      
+      // Fast analog sampling is configured once at boot
+      if (doc.containsKey("fastAdcRateHz")) {
+        unsigned int rate = doc["fastAdcRateHz"];
+        if (config->validateFastAdcRate(rate)) {
+          config->fastAdcRateHz = rate;
+        }
+      }
+      
+      // BME280 oversampling is set when the sensors start
+      if (doc.containsKey("bmeOversampling")) {
+        unsigned int samples = doc["bmeOversampling"];
+        if (config->validateBmeOversampling(samples)) {
+          config->bmeOversampling = samples;
+        }
+      }
+      
+      // Uplink settings apply from the next upload
+      if (doc.containsKey("uplinkEnabled")) {
+        config->uplinkEnabled = doc["uplinkEnabled"];
+      }
+      
+      if (doc.containsKey("uplinkUrl")) {
+        const char* url = doc["uplinkUrl"];
+        if (config->validateUplinkUrl(url)) {
+          strncpy(config->uplinkUrl, url, sizeof(config->uplinkUrl) - 1);
+          config->uplinkUrl[sizeof(config->uplinkUrl) - 1] = '\0';
+        }
+      }
+      
+      if (doc.containsKey("uplinkToken") && strlen(doc["uplinkToken"]) > 0) {
+        const char* token = doc["uplinkToken"];
+        if (strlen(token) < sizeof(config->uplinkToken)) {
+          strncpy(config->uplinkToken, token, sizeof(config->uplinkToken) - 1);
+          config->uplinkToken[sizeof(config->uplinkToken) - 1] = '\0';
+        }
+      }
+      
+      if (doc.containsKey("uplinkInterval")) {
+        unsigned int interval = doc["uplinkInterval"];
+        if (config->validateUplinkInterval(interval)) {
+          config->uplinkInterval = interval;
+        }
+      }
+      
+      if (doc.containsKey("uplinkBatchRecords")) {
+        unsigned int records = doc["uplinkBatchRecords"];
+        if (config->validateUplinkBatchRecords(records)) {
+          config->uplinkBatchRecords = records;
+        }
+      }
+      
+      // Compaction picks up the new age at its next look for a file
+      if (doc.containsKey("compactAfterDays")) {
+        unsigned int days = doc["compactAfterDays"];
+        if (config->validateCompactAfterDays(days)) {
+          config->compactAfterDays = days;
+        }
+      }
+      
+      // Commit policy takes effect immediately
+      logger->setCommitPolicy(config->groupCommitEnabled, config->commitMaxRecords,
+                              config->commitMaxBytes, config->commitMaxLatency);
+      
+      // Log format takes effect immediately (buffered records are flushed first)
+      if (doc.containsKey("logFormat")) {
+        unsigned int format = doc["logFormat"];
+        if (format <= LOG_BINARY) {
+          config->logFormat = (LogFormat)format;
+          logger->setLogFormat(config->logFormat);
+        }
+      }
+      
+      // Preallocation step applies from the next extent
+      if (doc.containsKey("sdPreallocKB")) {
+        unsigned int kb = doc["sdPreallocKB"];
+        if (config->validatePreallocKB(kb)) {
+          config->sdPreallocKB = kb;
+          logger->setPreallocation(kb);
+        }
+      }
+      
+      // Health probe interval applies from the next probe
+      if (doc.containsKey("sdProbeInterval")) {
+        unsigned int seconds = doc["sdProbeInterval"];
+        if (config->validateSdProbeInterval(seconds)) {
+          config->sdProbeInterval = seconds;
+        }
+      }
+      
       // Validate and update measurement interval
       if (doc.containsKey("measurementInterval")) {
         unsigned int interval = doc["measurementInterval"];
@@ -929,6 +710,12 @@ document.addEventListener('DOMContentLoaded', function() {
         config->deepSleepEnabled = doc["deepSleepEnabled"];
       }
       
+      // Carry forward applies from the next row
+      if (doc.containsKey("carryForward")) {
+        config->carryForward = doc["carryForward"];
+        sensors->setCarryForward(config->carryForward);
+      }
+      
       // Validate and update timezone offset
       if (doc.containsKey("timezoneOffset")) {
         int offset = doc["timezoneOffset"];
@@ -952,14 +739,32 @@ document.addEventListener('DOMContentLoaded', function() {
   }
   
   void handleGetData() {
-    // Get query parameters
+    // Query: file, from/to (epoch seconds or "YYYY-MM-DD HH:MM:SS" local time),
+    // offset (rows to skip within the window), limit, resolution=raw|1m|1h
     String filename = server.arg("file");
     int limit = server.hasArg("limit") ? server.arg("limit").toInt() : 100;
+    int offset = server.hasArg("offset") ? server.arg("offset").toInt() : 0;
+    uint32_t from = parseTimeArg("from");
+    uint32_t to = parseTimeArg("to");
     
     // Validate limit parameter
     if (limit < 1 || limit > 1000) {
       limit = 100;  // Default to safe value
     }
+    if (offset < 0) {
+      offset = 0;
+    }
+    
+    // Aggregates come from the rollup files and need no file parameter
+    String resolution = server.arg("resolution");
+    if (resolution == "1m" || resolution == "1h") {
+      handleRollupData(resolution == "1m" ? ROLLUP_1M : ROLLUP_1H, from, to, offset, limit);
+      return;
+    }
+    if (resolution.length() > 0 && resolution != "raw") {
+      server.send(400, "application/json", "{\"error\":\"Invalid resolution\"}");
+      return;
+    }
     
     if (filename.length() == 0) {
       // If no file specified, return error
@@ -978,136 +783,240 @@ document.addEventListener('DOMContentLoaded', function() {
       filename = "/" + filename;
     }
     
-    // Stream file directly instead of loading into memory
-    // For this version, we'll use a safer approach with streaming
-    // Note: For large files, consider pagination or streaming API
-    
-    // Calculate JSON document size based on limit
-    // Each line might have ~200 bytes in JSON, plus overhead
-    // With PSRAM, we can handle much larger documents safely
-    size_t docSize = psramFound() 
-        ? std::min((size_t)65536, (size_t)(limit * 250 + 512))  // Up to 64KB with PSRAM
-        : std::min((size_t)16384, (size_t)(limit * 250 + 512)); // 16KB without PSRAM
-    PsramJsonDocument doc(docSize);
-    JsonArray dataArray = doc.createNestedArray("data");
-    
-    // Open file for reading
-    String content;
-    if (!logger->downloadFile(filename.c_str(), content)) {
+    if (!logger->fileExists(filename.c_str())) {
       server.send(404, "application/json", "{\"error\":\"File not found\"}");
       return;
     }
     
-    // Check if content is too large
-    if (content.length() > 50000) {  // ~50KB limit for safety
-      server.send(413, "application/json", "{\"error\":\"File too large, use download instead\"}");
+    // Rows go from the SD reader to the socket through the chunk buffer,
+    // so memory use is the same for any limit
+    ChunkedResponse response(server, 200, "application/json");
+    JsonStreamWriter json(response);
+    json.beginObject();
+    json.field("file", filename);
+    json.beginArray("data");
+    
+    static_assert(CsvRowObjects::MAX_COLUMNS >= BinLog::MAX_CHANNELS + 1, "Row objects need a name per column");
+    String header;
+    CsvRowObjects rows(json, header);
+    uint32_t count = 0;
+    bool more = false;
+    
+    bool ok = logger->queryData(filename.c_str(), from, to, offset, limit, header, more,
+        [&](const char* line, size_t len) {
+      rows.write(line, len);
+      count++;
+    });
+    
+    json.endArray();
+    json.field("count", count);
+    json.field("offset", offset);
+    json.field("more", more);
+    if (!ok) {
+      json.field("error", "Read failed");
+    }
+    json.endObject();
+  }
+  
+  // Buckets as [start, [mean, min, max, count] or null per column]. Without
+  // bounds the last day (1m) or 30 days (1h) up to now is returned.
+  void handleRollupData(RollupTier tier, uint32_t from, uint32_t to, int offset, int limit) {
+    if (!logger->initSDCard()) {
+      server.send(503, "application/json", "{\"error\":\"SD card unavailable\"}");
       return;
     }
+    if (to == 0) {
+      to = time(nullptr);
+    }
+    if (from == 0) {
+      uint32_t span = tier == ROLLUP_1M ? 86400UL : 30 * 86400UL;
+      from = to > span ? to - span : 1;
+    }
     
-    // Split content into lines
-    int lineCount = 0;
-    int startPos = 0;
-    int endPos = content.indexOf('\n');
-    String header = "";
+    ChunkedResponse response(server, 200, "application/json");
+    JsonStreamWriter json(response);
+    json.beginObject();
+    json.field("resolution", tier == ROLLUP_1M ? "1m" : "1h");
+    json.field("from", from);
+    json.field("to", to);
+    json.beginArray("data");
     
-    while (endPos != -1 && lineCount < limit) {
-      String line = content.substring(startPos, endPos);
-      line.trim();
-      
-      if (line.length() > 0) {
-        if (lineCount == 0) {
-          // First line is header
-          header = line;
-        } else {
-          // Data lines
-          JsonObject row = dataArray.createNestedObject();
-          
-          // Parse CSV values
-          int colIndex = 0;
-          int valueStart = 0;
-          int valueEnd = line.indexOf(',');
-          int headerStart = 0;
-          int headerEnd = header.indexOf(',');
-          
-          // Improved loop condition to prevent infinite loops
-          while (valueStart < (int)line.length() && colIndex < 50) {  // Max 50 columns for safety
-            // Get column name from header
-            String colName;
-            if (headerEnd != -1) {
-              colName = header.substring(headerStart, headerEnd);
-              headerStart = headerEnd + 1;
-              headerEnd = header.indexOf(',', headerStart);
-            } else if (headerStart < (int)header.length()) {
-              colName = header.substring(headerStart);
-            } else {
-              break;  // No more header columns
-            }
-            colName.trim();
-            
-            // Get value
-            String value;
-            if (valueEnd != -1) {
-              value = line.substring(valueStart, valueEnd);
-              valueStart = valueEnd + 1;
-              valueEnd = line.indexOf(',', valueStart);
-            } else {
-              value = line.substring(valueStart);
-              valueStart = line.length();  // This will end the loop
-            }
-            value.trim();
-            
-            // Add to JSON object
-            if (colName.length() > 0) {
-              row[colName] = value;
-            }
-            
-            colIndex++;
-          }
+    String header;
+    uint32_t count = 0;
+    bool more = false;
+    bool ok = RollupManager::query(tier, from, to, offset, limit, header, more,
+        [&](uint32_t start, const RollupChannel* channels, uint16_t channelCount) {
+      json.beginArray();
+      json.value(start);
+      for (uint16_t i = 0; i < channelCount; i++) {
+        if (channels[i].count == 0) {
+          json.raw("null", 4);
+          continue;
         }
-        lineCount++;
+        json.beginArray();
+        json.value(channels[i].mean);
+        json.value(channels[i].min);
+        json.value(channels[i].max);
+        json.value(channels[i].count);
+        json.endArray();
       }
-      
-      startPos = endPos + 1;
-      endPos = content.indexOf('\n', startPos);
+      json.endArray();
+      count++;
+    });
+    json.endArray();
+    
+    // Columns of the first file read (files with another schema are skipped)
+    const int MAX_COLUMNS = RollupManager::MAX_CHANNELS + 1;
+    String columns[MAX_COLUMNS];
+    int columnCount = header.length() > 0 ? CsvRowObjects::splitColumns(header, columns, MAX_COLUMNS) : 0;
+    json.beginArray("columns");
+    for (int col = 1; col < columnCount; col++) {
+      json.value(columns[col]);
+    }
+    json.endArray();
+    
+    json.field("count", count);
+    json.field("offset", offset);
+    json.field("more", more);
+    if (!ok) {
+      json.field("error", "Out of memory");
+    }
+    json.endObject();
+  }
+  
+  void handleRecent() {
+    // Query: since=<seq> (0 = start over), limit (1-500)
+    uint32_t since = server.hasArg("since") ? strtoul(server.arg("since").c_str(), nullptr, 10) : 0;
+    int limit = server.hasArg("limit") ? server.arg("limit").toInt() : 100;
+    if (limit < 1 || limit > 500) limit = 100;
+    
+    uint32_t first = recent->firstSeq();
+    uint32_t last = recent->lastSeq();
+    
+    // A sequence number ahead of ours means the device rebooted
+    bool restart = since == 0 || since > last;
+    if (restart) {
+      since = 0;
     }
     
-    doc["count"] = dataArray.size();
-    doc["file"] = filename;
+    ChunkedResponse response(server, 200, "application/json");
+    JsonStreamWriter json(response);
+    json.beginObject();
+    json.field("first", first);
+    json.field("last", last);
+    json.field("restart", restart);
     
-    String response;
-    serializeJson(doc, response);
-    server.send(200, "application/json", response);
+    // Column names only when the client starts over; they can't change without a reboot
+    if (restart) {
+      const int MAX_COLUMNS = RecentSample::MAX_CHANNELS + 1;
+      String columns[MAX_COLUMNS];
+      int columnCount = CsvRowObjects::splitColumns(sensors->getCSVHeader(), columns, MAX_COLUMNS);
+      json.beginArray("columns");
+      for (int col = 1; col < columnCount; col++) {
+        json.value(columns[col]);
+      }
+      json.endArray();
+    }
+    
+    // Rows are [seq, timestamp, value...]; timestamp is null before time sync.
+    // Starting over returns the newest samples.
+    json.beginArray("samples");
+    uint32_t seq = std::max(since + 1, first);
+    if (restart && last >= first + limit) {
+      seq = last - limit + 1;
+    }
+    int sent = 0;
+    RecentSample sample;
+    for (; seq <= last && sent < limit; seq++, sent++) {
+      if (recent->get(seq, sample)) {
+        writeRecentRow(json, sample);
+      }
+    }
+    json.endArray();
+    json.field("more", seq <= last);
+    json.endObject();
+  }
+  
+  void writeRecentRow(JsonStreamWriter& json, const RecentSample& sample) {
+    json.beginArray();
+    json.value(sample.seq);
+    if (sample.synced) {
+      json.value(sample.timestamp);
+    } else {
+      json.raw("null", 4);
+    }
+    for (int i = 0; i < sample.channels; i++) {
+      if (sample.validMask & (1ULL << i)) {
+        json.value(sample.values[i]);
+      } else {
+        json.raw("null", 4);
+      }
+    }
+    json.endArray();
+  }
+  
+  // Server-Sent Events: one "sample" event per logged sample
+  void handleEvents() {
+    if (!events.subscribe(server)) {
+      server.send(503, "application/json", "{\"error\":\"Too many live clients\"}");
+    }
+  }
+  
+  uint32_t parseTimeArg(const char* name) {
+    if (!server.hasArg(name)) {
+      return 0;
+    }
+    String value = server.arg(name);
+    value.trim();
+    if (value.indexOf('-') > 0) {
+      return FileManifest::parseTimestamp(value.c_str());
+    }
+    return strtoul(value.c_str(), nullptr, 10);
   }
   
   void handleListFiles() {
-    String fileList;
-    logger->listFiles(fileList);
+    // Query: offset, limit (1-100), sort=name|size|rows|first|last, order=asc|desc
+    int offset = server.hasArg("offset") ? server.arg("offset").toInt() : 0;
+    int limit = server.hasArg("limit") ? server.arg("limit").toInt() : 50;
+    if (offset < 0) offset = 0;
+    if (limit < 1 || limit > 100) limit = 50;
     
-    PsramJsonDocument doc(2048);
-    JsonArray filesArray = doc.createNestedArray("files");
+    String sortArg = server.arg("sort");
+    ManifestSort sort = SORT_NAME;
+    if (sortArg == "size") sort = SORT_SIZE;
+    else if (sortArg == "rows") sort = SORT_ROWS;
+    else if (sortArg == "first") sort = SORT_FIRST;
+    else if (sortArg == "last") sort = SORT_LAST;
+    bool descending = server.arg("order") == "desc";
     
-    // Parse file list
-    int startPos = 0;
-    int endPos = fileList.indexOf('\n');
-    while (endPos != -1) {
-      String line = fileList.substring(startPos, endPos);
-      int sizePos = line.lastIndexOf('(');
-      if (sizePos != -1) {
-        String filename = line.substring(0, sizePos - 1);
-        String sizeStr = line.substring(sizePos + 1, line.indexOf(' ', sizePos));
-        
-        JsonObject file = filesArray.createNestedObject();
-        file["name"] = filename;
-        file["size"] = sizeStr;
-      }
-      
-      startPos = endPos + 1;
-      endPos = fileList.indexOf('\n', startPos);
+    ManifestEntry* entries = (ManifestEntry*)malloc(limit * sizeof(ManifestEntry));
+    if (!entries) {
+      server.send(500, "application/json", "{\"error\":\"Out of memory\"}");
+      return;
     }
+    uint32_t count = logger->listFiles(entries, offset, limit, sort, descending);
     
-    String response;
-    serializeJson(doc, response);
-    server.send(200, "application/json", response);
+    ChunkedResponse response(server, 200, "application/json");
+    JsonStreamWriter json(response);
+    json.beginObject();
+    json.field("total", logger->getFileCount());
+    json.field("offset", offset);
+    json.field("limit", limit);
+    json.beginArray("files");
+    
+    for (uint32_t i = 0; i < count; i++) {
+      json.beginObject();
+      json.field("name", (const char*)entries[i].name);
+      json.field("size", entries[i].bytes);
+      json.field("rows", entries[i].rows);
+      json.field("first", entries[i].firstTs);
+      json.field("last", entries[i].lastTs);
+      json.endObject();
+    }
+    free(entries);
+    
+    json.endArray();
+    json.endObject();
   }
   
   void handleDownload() {
@@ -1124,17 +1033,233 @@ document.addEventListener('DOMContentLoaded', function() {
       if (!filename.startsWith("/")) {
         filename = "/" + filename;
       }
+      // A compacted day file is still found under its .csv name
+      if (filename.endsWith(".csv") && !logger->fileExists(filename.c_str()) &&
+          logger->fileExists((filename + ".gz").c_str())) {
+        filename += ".gz";
+      }
+      if (filename.length() >= sizeof(ArchiveEntry::name)) {
+        server.send(404, "text/plain", "File not found");
+        return;
+      }
       
-      if (logger->streamFile(filename.c_str(), server)) {
-        // File streamed successfully
-      } else {
+      // raw=1 returns binary and compacted day files as stored instead of as CSV
+      bool raw = server.hasArg("raw") && server.arg("raw") == "1";
+      
+      if (!downloads.hasSlot()) {
+        server.sendHeader("Retry-After", "5");
+        server.send(503, "text/plain", "Too many downloads in progress");
+        return;
+      }
+      
+      // The body is sent in the background by downloads.service()
+      File file;
+      uint32_t length;
+      if (!logger->openDownload(filename.c_str(), file, length)) {
         server.send(404, "text/plain", "File not found");
+        return;
+      }
+      ArchiveEntry* entry = (ArchiveEntry*)malloc(sizeof(ArchiveEntry));
+      if (!entry) {
+        file.close();
+        server.send(500, "text/plain", "Out of memory");
+        return;
+      }
+      strncpy(entry->name, filename.c_str(), sizeof(entry->name));
+      entry->size = length;
+      entry->mtime = 0;
+      
+      // A compacted file goes out as stored with Content-Encoding: gzip to
+      // clients that accept it, and is inflated on the fly for the rest
+      bool binary = BinLog::isBinaryFile(filename.c_str());
+      bool compressed = Gzip::isCompressed(filename.c_str());
+      bool gzip = compressed && !raw && server.header("Accept-Encoding").indexOf("gzip") >= 0;
+      TransferKind kind = (binary || compressed) && !raw && !gzip ? TRANSFER_CSV : TRANSFER_RAW;
+      const char* contentType = "text/csv";
+      if (raw && binary) {
+        contentType = "application/octet-stream";
+      } else if (raw && compressed) {
+        contentType = "application/gzip";
+      }
+      String head;
+      uint32_t first = 0;
+      bool deflate = false;
+      
+      if (kind == TRANSFER_CSV) {
+        // Converted on the fly: no length, so no ranges either
+        deflate = wantsDeflate();
+        head = transferHead("200 OK", contentType, -1, deflate);
+      } else {
+        // Day files only grow, so size and modification time identify the
+        // content a range was taken from
+        char etag[24];
+        snprintf(etag, sizeof(etag), "\"%lx-%lx\"", (unsigned long)length, (unsigned long)file.getLastWrite());
+        uint32_t last;
+        int status = parseRange(server.header("Range"), length, first, last);
+        if (server.hasHeader("If-Range") && server.header("If-Range") != etag) {
+          status = 200;  // Changed since the first part (or a date): send it all
+          first = 0;
+          last = length - 1;
+        }
+        if (status == 416) {
+          file.close();
+          free(entry);
+          server.sendHeader("Content-Range", String("bytes */") + length);
+          server.send(416, "text/plain", "Range not satisfiable");
+          return;
+        }
+        
+        String extra;
+        deflate = !compressed && status == 200 && wantsDeflate();
+        if (!deflate) {
+          extra = String("Accept-Ranges: bytes\r\nETag: ") + etag + "\r\n";
+        }
+        if (gzip) {
+          // Saved under the plain name once the browser has decoded it
+          String plain = filename.substring(1, filename.length() - 3);
+          extra += "Content-Encoding: gzip\r\nContent-Disposition: attachment; filename=\"" + plain + "\"\r\n";
+        }
+        if (status == 206) {
+          extra += String("Content-Range: bytes ") + first + "-" + last + "/" + length + "\r\n";
+          entry->size = last + 1;
+        }
+        head = transferHead(status == 206 ? "206 Partial Content" : "200 OK", contentType,
+                            length > 0 ? last + 1 - first : 0, deflate, extra);
+      }
+      
+      if (!downloads.start(server, head, kind, entry, 1, file, first, deflate)) {
+        file.close();
+        server.send(500, "text/plain", "Could not start download");
       }
     } else {
       server.send(400, "text/plain", "Missing file parameter");
     }
   }
   
+  // Day files overlapping [from, to] in one response, oldest first
+  void handleArchive() {
+    // Query: from, to (default: all files), format=tar|csv, compress=1
+    uint32_t from = parseTimeArg("from");
+    uint32_t to = parseTimeArg("to");
+    bool csv = server.arg("format") == "csv";
+    
+    if (!downloads.hasSlot()) {
+      server.sendHeader("Retry-After", "5");
+      server.send(503, "text/plain", "Too many downloads in progress");
+      return;
+    }
+    
+    uint32_t total = logger->getFileCount();
+    size_t listSize = total * sizeof(ManifestEntry);
+    ManifestEntry* files = (ManifestEntry*)(psramFound() ? ps_malloc(listSize) : malloc(listSize));
+    ArchiveEntry* entries = (ArchiveEntry*)malloc(total * sizeof(ArchiveEntry));
+    if (total == 0 || !files || !entries) {
+      free(files);
+      free(entries);
+      server.send(total == 0 ? 404 : 500, "text/plain", total == 0 ? "No data files" : "Out of memory");
+      return;
+    }
+    
+    // Sizes from the manifest are the committed data, so commit first
+    logger->commit();
+    uint32_t listed = logger->listFiles(files, 0, total, SORT_NAME);
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < listed; i++) {
+      // Unknown times (0) always match
+      if ((from && files[i].lastTs && files[i].lastTs < from) || (to && files[i].firstTs && files[i].firstTs > to)) {
+        continue;
+      }
+      memcpy(entries[count].name, files[i].name, sizeof(entries[count].name));
+      entries[count].size = files[i].bytes;
+      entries[count].mtime = files[i].lastTs;
+      count++;
+    }
+    free(files);
+    if (count == 0) {
+      free(entries);
+      server.send(404, "text/plain", "No data files in range");
+      return;
+    }
+    
+    bool deflate = wantsDeflate();
+    String head;
+    if (csv) {
+      head = transferHead("200 OK", "text/csv", -1, deflate,
+                          "Content-Disposition: attachment; filename=\"omnilogger.csv\"\r\n");
+    } else {
+      head = transferHead("200 OK", "application/x-tar", TransferPump::tarSize(entries, count), deflate,
+                          "Content-Disposition: attachment; filename=\"omnilogger.tar\"\r\n");
+    }
+    File none;
+    if (!downloads.start(server, head, csv ? TRANSFER_CSV : TRANSFER_TAR, entries, count, none, 0, deflate)) {
+      server.send(500, "text/plain", "Could not start download");
+    }
+  }
+  
+  // Status line and headers for a body sent by the transfer pump. A
+  // deflated body (or one of unknown length) ends when the connection closes.
+  static String transferHead(const char* status, const char* contentType, int64_t length, bool deflate,
+                             const String& extra = String()) {
+    String head = String("HTTP/1.1 ") + status + "\r\nContent-Type: " + contentType + "\r\n";
+    if (deflate) {
+      head += "Content-Encoding: deflate\r\n";
+    } else if (length >= 0) {
+      head += "Content-Length: " + String((unsigned long)length) + "\r\n";
+    }
+    head += extra;
+    head += "Connection: close\r\n\r\n";
+    return head;
+  }
+  
+  // compress=1 asks for a deflated body; only if the client accepts it and
+  // no other transfer holds the compressor memory
+  bool wantsDeflate() {
+    return server.arg("compress") == "1" && server.header("Accept-Encoding").indexOf("deflate") >= 0 &&
+           downloads.canCompress();
+  }
+  
+  // A single "bytes=a-b", "bytes=a-" or "bytes=-n" range. Returns 206 with
+  // first/last set, 416 if it starts past the end, or 200 for the whole file
+  // (no header, several ranges or anything else).
+  static int parseRange(const String& range, uint32_t length, uint32_t& first, uint32_t& last) {
+    first = 0;
+    last = length > 0 ? length - 1 : 0;
+    if (!range.startsWith("bytes=") || range.indexOf(',') != -1 || length == 0) {
+      return 200;
+    }
+    int dash = range.indexOf('-');
+    if (dash == -1) {
+      return 200;
+    }
+    String start = range.substring(6, dash);
+    String end = range.substring(dash + 1);
+    start.trim();
+    end.trim();
+    
+    if (start.length() == 0) {
+      // Suffix: the last n bytes
+      uint32_t n = strtoul(end.c_str(), nullptr, 10);
+      if (n == 0) {
+        return 416;
+      }
+      first = n < length ? length - n : 0;
+      return 206;
+    }
+    first = strtoul(start.c_str(), nullptr, 10);
+    if (first >= length) {
+      return 416;
+    }
+    if (end.length() > 0) {
+      last = std::min((uint32_t)strtoul(end.c_str(), nullptr, 10), length - 1);
+      if (last < first) {
+        first = 0;
+        last = length - 1;
+        return 200;
+      }
+    }
+    return 206;
+  }
+  
   void handleFlushBuffer() {
     PsramJsonDocument doc(256);
     
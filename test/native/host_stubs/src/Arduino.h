@@ -0,0 +1,340 @@
+/*
+ * Host stubs for OmniLogger
+ * Arduino core subset for the native test build: String, Print, Serial,
+ * timing and PSRAM allocation on top of the C++ standard library
+ *
+ * Copyright (C) 2024 NortonTech3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include <algorithm>
+#include <string>
+
+typedef uint8_t byte;
+
+#define PROGMEM
+#define RTC_DATA_ATTR
+#define RTC_NOINIT_ATTR
+#define F(x) x
+#define PSTR(x) x
+#define FPSTR(x) (x)
+typedef const char* PGM_P;
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+
+using std::min;
+using std::max;
+
+template<typename T, typename L, typename H>
+T constrain(T x, L low, H high) {
+  return x < low ? low : (x > high ? high : x);
+}
+
+// Arduino String over std::string. Only what the firmware headers use.
+class String {
+public:
+  String() {}
+  String(const char* text) : s(text ? text : "") {}
+  String(const std::string& text) : s(text) {}
+  explicit String(char c) : s(1, c) {}
+  String(int n, unsigned char base = 10) : s(format(n, base)) {}
+  String(unsigned int n, unsigned char base = 10) : s(format(n, base)) {}
+  String(long n, unsigned char base = 10) : s(format(n, base)) {}
+  String(unsigned long n, unsigned char base = 10) : s(format(n, base)) {}
+  String(long long n) : s(std::to_string(n)) {}
+  String(unsigned long long n) : s(std::to_string(n)) {}
+  String(float f, unsigned int decimals = 2) : s(fixed(f, decimals)) {}
+  String(double d, unsigned int decimals = 2) : s(fixed(d, decimals)) {}
+
+  bool reserve(unsigned int size) {
+    s.reserve(size);
+    return true;
+  }
+
+  unsigned int length() const { return s.size(); }
+  bool isEmpty() const { return s.empty(); }
+  const char* c_str() const { return s.c_str(); }
+  char operator[](unsigned int i) const { return i < s.size() ? s[i] : '\0'; }
+  char& operator[](unsigned int i) { return s[i]; }
+  char charAt(unsigned int i) const { return (*this)[i]; }
+
+  bool concat(const String& other) { s += other.s; return true; }
+  bool concat(const char* text) { if (text) s += text; return text != nullptr; }
+  bool concat(const char* text, unsigned int len) { if (text) s.append(text, len); return text != nullptr; }
+  bool concat(char c) { s += c; return true; }
+  template<typename T>
+  bool concat(T n) { s += String(n).s; return true; }
+
+  template<typename T>
+  String& operator+=(const T& other) { concat(other); return *this; }
+
+  friend String operator+(const String& a, const String& b) { return String(a.s + b.s); }
+  friend String operator+(const String& a, const char* b) { return String(a.s + b); }
+  friend String operator+(const char* a, const String& b) { return String(a + b.s); }
+  friend String operator+(const String& a, char b) { return String(a.s + b); }
+  template<typename T>
+  friend String operator+(const String& a, T n) { return String(a.s + String(n).s); }
+
+  bool operator==(const String& other) const { return s == other.s; }
+  bool operator==(const char* other) const { return s == (other ? other : ""); }
+  bool operator!=(const String& other) const { return s != other.s; }
+  bool operator!=(const char* other) const { return !(*this == other); }
+  bool operator<(const String& other) const { return s < other.s; }
+  bool equals(const String& other) const { return s == other.s; }
+  bool equalsIgnoreCase(const String& other) const {
+    return s.size() == other.s.size() && strcasecmp(s.c_str(), other.s.c_str()) == 0;
+  }
+
+  int indexOf(char c, unsigned int from = 0) const { return found(s.find(c, from)); }
+  int indexOf(const char* text, unsigned int from = 0) const { return found(s.find(text, from)); }
+  int indexOf(const String& text, unsigned int from = 0) const { return found(s.find(text.s, from)); }
+  int lastIndexOf(char c) const { return found(s.rfind(c)); }
+  int lastIndexOf(const char* text) const { return found(s.rfind(text)); }
+  bool startsWith(const String& prefix) const { return s.compare(0, prefix.s.size(), prefix.s) == 0; }
+  bool endsWith(const String& suffix) const {
+    return s.size() >= suffix.s.size() && s.compare(s.size() - suffix.s.size(), suffix.s.size(), suffix.s) == 0;
+  }
+
+  String substring(unsigned int from) const { return from < s.size() ? String(s.substr(from)) : String(); }
+  String substring(unsigned int from, unsigned int to) const {
+    if (from > to) std::swap(from, to);
+    return from < s.size() ? String(s.substr(from, to - from)) : String();
+  }
+
+  void trim() {
+    size_t start = s.find_first_not_of(" \t\r\n");
+    if (start == std::string::npos) {
+      s.clear();
+      return;
+    }
+    s = s.substr(start, s.find_last_not_of(" \t\r\n") - start + 1);
+  }
+  void toLowerCase() { for (char& c : s) c = tolower((unsigned char)c); }
+  void toUpperCase() { for (char& c : s) c = toupper((unsigned char)c); }
+  void replace(const String& find, const String& with) {
+    if (find.s.empty()) return;
+    for (size_t pos = s.find(find.s); pos != std::string::npos; pos = s.find(find.s, pos + with.s.size())) {
+      s.replace(pos, find.s.size(), with.s);
+    }
+  }
+  void remove(unsigned int index) { if (index < s.size()) s.erase(index); }
+  void remove(unsigned int index, unsigned int count) { if (index < s.size()) s.erase(index, count); }
+
+  long toInt() const { return strtol(s.c_str(), nullptr, 10); }
+  float toFloat() const { return strtof(s.c_str(), nullptr); }
+  void toCharArray(char* buf, unsigned int size) const {
+    if (size == 0) return;
+    size_t n = std::min((size_t)size - 1, s.size());
+    memcpy(buf, s.data(), n);
+    buf[n] = '\0';
+  }
+
+private:
+  std::string s;
+
+  static int found(size_t pos) {
+    return pos == std::string::npos ? -1 : (int)pos;
+  }
+
+  static std::string format(unsigned long long n, unsigned char base, bool negative = false) {
+    char buf[66];
+    char* p = buf + sizeof(buf);
+    *--p = '\0';
+    do {
+      *--p = "0123456789abcdefghijklmnopqrstuvwxyz"[n % base];
+      n /= base;
+    } while (n > 0);
+    if (negative) *--p = '-';
+    return p;
+  }
+
+  static std::string format(long long n, unsigned char base) {
+    if (base == 10) return std::to_string(n);
+    return format((unsigned long long)(unsigned long)n, base);
+  }
+
+  static std::string format(int n, unsigned char base) { return format((long long)n, base); }
+  static std::string format(long n, unsigned char base) { return format((long long)n, base); }
+  static std::string format(unsigned int n, unsigned char base) { return format((unsigned long long)n, base); }
+  static std::string format(unsigned long n, unsigned char base) { return format((unsigned long long)n, base); }
+
+  static std::string fixed(double d, unsigned int decimals) {
+    char buf[48];
+    snprintf(buf, sizeof(buf), "%.*f", (int)decimals, d);
+    return buf;
+  }
+};
+
+class Print {
+public:
+  virtual ~Print() {}
+
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* data, size_t len) {
+    size_t n = 0;
+    while (len--) {
+      n += write(*data++);
+    }
+    return n;
+  }
+  size_t write(const char* text) { return text ? write((const uint8_t*)text, strlen(text)) : 0; }
+  size_t write(const char* data, size_t len) { return write((const uint8_t*)data, len); }
+  virtual void flush() {}
+
+  size_t print(const char* text) { return write(text); }
+  size_t print(const String& text) { return write(text.c_str(), text.length()); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(int n, int base = 10) { return print(String(n, base)); }
+  size_t print(unsigned int n, int base = 10) { return print(String(n, base)); }
+  size_t print(long n, int base = 10) { return print(String(n, base)); }
+  size_t print(unsigned long n, int base = 10) { return print(String(n, base)); }
+  size_t print(long long n) { return print(String(n)); }
+  size_t print(unsigned long long n) { return print(String(n)); }
+  size_t print(double d, int decimals = 2) { return print(String(d, decimals)); }
+
+  size_t println() { return write("\r\n"); }
+  template<typename T>
+  size_t println(const T& value) { return print(value) + println(); }
+  template<typename T>
+  size_t println(const T& value, int format) { return print(value, format) + println(); }
+
+  // Same as the core: a small stack buffer, the heap for longer output
+  size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+    char loc[64];
+    va_list arg;
+    va_start(arg, format);
+    va_list copy;
+    va_copy(copy, arg);
+    int len = vsnprintf(loc, sizeof(loc), format, copy);
+    va_end(copy);
+    if (len < 0) {
+      va_end(arg);
+      return 0;
+    }
+    char* temp = loc;
+    if ((size_t)len >= sizeof(loc)) {
+      temp = (char*)malloc(len + 1);
+      if (!temp) {
+        va_end(arg);
+        return 0;
+      }
+      vsnprintf(temp, len + 1, format, arg);
+    }
+    va_end(arg);
+    len = write((const uint8_t*)temp, len);
+    if (temp != loc) {
+      free(temp);
+    }
+    return len;
+  }
+};
+
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+  void setTimeout(unsigned long) {}
+
+  size_t readBytes(uint8_t* buf, size_t len) {
+    size_t n = 0;
+    int c;
+    while (n < len && (c = read()) >= 0) {
+      buf[n++] = (uint8_t)c;
+    }
+    return n;
+  }
+  size_t readBytes(char* buf, size_t len) { return readBytes((uint8_t*)buf, len); }
+};
+
+// USB CDC console. Output goes to stdout when HOST_SERIAL is set in the
+// environment and is dropped otherwise, so benchmarks don't time the terminal.
+class HWCDC : public Stream {
+public:
+  void begin(unsigned long) {}
+  operator bool() const { return true; }
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t* data, size_t len) override;
+  using Print::write;
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+};
+extern HWCDC Serial;
+
+// Time runs on the host's monotonic clock. delay() advances it without
+// sleeping, so polling loops (sensor conversions, SD retries) finish at once.
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+uint16_t analogRead(uint8_t pin);
+uint32_t analogReadMilliVolts(uint8_t pin);
+
+uint32_t getCpuFrequencyMhz();
+long random(long howbig);
+
+// PSRAM is the host heap; allocations are counted like any other (host_alloc.h)
+bool psramFound();
+void* ps_malloc(size_t size);
+void* ps_calloc(size_t n, size_t size);
+void* ps_realloc(void* ptr, size_t size);
+
+class EspClass {
+public:
+  uint32_t getCycleCount();
+  uint32_t getFreeHeap();
+  uint32_t getMinFreeHeap();
+  uint32_t getMaxAllocHeap();
+  uint32_t getHeapSize();
+  uint32_t getFreePsram();
+  uint32_t getPsramSize();
+  void restart();
+};
+extern EspClass ESP;
+
+#include "esp_attr.h"
+#include "esp_err.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+#endif // HOST_ARDUINO_H
@@ -0,0 +1,61 @@
+/*
+ * Host stubs for OmniLogger
+ * DS18B20 driver with DEVICES sensors on every bus; each conversion moves the temperatures
+ *
+ * Copyright (C) 2024 NortonTech3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOST_DALLAS_TEMPERATURE_H
+#define HOST_DALLAS_TEMPERATURE_H
+
+#include "OneWire.h"
+
+#define DEVICE_DISCONNECTED_C -127
+
+typedef uint8_t DeviceAddress[8];
+
+class DallasTemperature {
+public:
+  static const uint8_t DEVICES = 4;
+
+  explicit DallasTemperature(OneWire* wire) : wire(wire), conversions(0) {}
+
+  void begin() {}
+  bool setResolution(uint8_t) { return true; }
+  void setWaitForConversion(bool) {}
+  uint8_t getDeviceCount() { return DEVICES; }
+
+  bool getAddress(uint8_t* address, uint8_t index) {
+    if (index >= DEVICES) return false;
+    const uint8_t rom[8] = {0x28, wire->getPin(), index, 0, 0, 0, 0, (uint8_t)(0x5A ^ index)};
+    memcpy(address, rom, sizeof(rom));
+    return true;
+  }
+
+  void requestTemperatures() { conversions++; }
+  bool isConversionComplete() { return true; }
+
+  // 10-bit steps of 0.25°C in a slow sawtooth, offset per device
+  float getTempC(const uint8_t* address) {
+    return 18.0f + address[2] * 1.5f + (conversions % 40) * 0.25f;
+  }
+
+private:
+  OneWire* wire;
+  uint32_t conversions;
+};
+
+#endif // HOST_DALLAS_TEMPERATURE_H
@@ -0,0 +1,101 @@
+/*
+ * Host stubs for OmniLogger
+ * Arduino FS API over an in-memory card (host_fs.cpp)
+ *
+ * Copyright (C) 2024 NortonTech3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOST_FS_H
+#define HOST_FS_H
+
+#include <Arduino.h>
+#include <memory>
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+#define FILE_APPEND "a"
+
+namespace fs {
+
+enum SeekMode {
+  SeekSet = 0,
+  SeekCur = 1,
+  SeekEnd = 2
+};
+
+struct FileImpl;
+
+// Handle to an open file or directory. Copies share the position, as on
+// the device; a removed file stays readable through handles opened before.
+class File : public Stream {
+public:
+  File() {}
+  explicit File(std::shared_ptr<FileImpl> impl) : impl(impl) {}
+
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t* data, size_t len) override;
+  using Print::write;
+  int available() override;
+  int read() override;
+  int peek() override;
+  void flush() override {}
+
+  size_t read(uint8_t* buf, size_t len);
+  bool seek(uint32_t pos, SeekMode mode = SeekSet);
+  size_t position() const;
+  size_t size() const;
+  bool setBufferSize(size_t) { return true; }
+  void close();
+  operator bool() const;
+  time_t getLastWrite();
+  const char* path() const;
+  const char* name() const;
+  bool isDirectory() const;
+  File openNextFile(const char* mode = FILE_READ);
+  void rewindDirectory();
+
+private:
+  std::shared_ptr<FileImpl> impl;
+};
+
+class FS {
+public:
+  File open(const char* path, const char* mode = FILE_READ, bool create = false);
+  File open(const String& path, const char* mode = FILE_READ, bool create = false) {
+    return open(path.c_str(), mode, create);
+  }
+  bool exists(const char* path);
+  bool exists(const String& path) { return exists(path.c_str()); }
+  bool remove(const char* path);
+  bool remove(const String& path) { return remove(path.c_str()); }
+  bool rename(const char* from, const char* to);
+  bool rename(const String& from, const String& to) { return rename(from.c_str(), to.c_str()); }
+  bool mkdir(const char* path);
+  bool mkdir(const String& path) { return mkdir(path.c_str()); }
+  bool rmdir(const char* path);
+  bool rmdir(const String& path) { return rmdir(path.c_str()); }
+};
+
+}  // namespace fs
+
+using fs::File;
+using fs::FS;
+using fs::SeekMode;
+using fs::SeekSet;
+using fs::SeekCur;
+using fs::SeekEnd;
+
+#endif // HOST_FS_H
@@ -0,0 +1,36 @@
+/*
+ * Host stubs for OmniLogger
+ * 1-Wire bus; DallasTemperature.h simulates the devices on it
+ *
+ * Copyright (C) 2024 NortonTech3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOST_ONEWIRE_H
+#define HOST_ONEWIRE_H
+
+#include <Arduino.h>
+
+class OneWire {
+public:
+  explicit OneWire(uint8_t pin) : pin(pin) {}
+
+  uint8_t getPin() const { return pin; }
+
+private:
+  uint8_t pin;
+};
+
+#endif // HOST_ONEWIRE_H
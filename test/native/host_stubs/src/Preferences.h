@@ -0,0 +1,126 @@
+/*
+ * Host stubs for OmniLogger
+ * NVS preferences in memory, kept for the life of the process
+ *
+ * Copyright (C) 2024 NortonTech3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOST_PREFERENCES_H
+#define HOST_PREFERENCES_H
+
+#include <Arduino.h>
+#include <map>
+#include <vector>
+
+class Preferences {
+public:
+  Preferences() : space(nullptr), readOnly(true) {}
+
+  bool begin(const char* name, bool readOnly = false, const char* partition = nullptr) {
+    space = &storage()[name];
+    this->readOnly = readOnly;
+    return true;
+  }
+  void end() { space = nullptr; }
+
+  bool clear() {
+    if (!writable()) return false;
+    space->clear();
+    return true;
+  }
+  bool remove(const char* key) { return writable() && space->erase(key) > 0; }
+  bool isKey(const char* key) { return space && space->count(key) > 0; }
+
+  size_t putBytes(const char* key, const void* value, size_t len) {
+    if (!writable()) return 0;
+    const uint8_t* bytes = (const uint8_t*)value;
+    (*space)[key].assign(bytes, bytes + len);
+    return len;
+  }
+  size_t getBytes(const char* key, void* buf, size_t maxLen) {
+    const std::vector<uint8_t>* value = find(key);
+    if (!value || value->size() > maxLen) return 0;
+    memcpy(buf, value->data(), value->size());
+    return value->size();
+  }
+  size_t getBytesLength(const char* key) {
+    const std::vector<uint8_t>* value = find(key);
+    return value ? value->size() : 0;
+  }
+
+  size_t putString(const char* key, const char* value) { return putBytes(key, value, strlen(value) + 1) ? strlen(value) : 0; }
+  size_t putString(const char* key, const String& value) { return putString(key, value.c_str()); }
+  String getString(const char* key, const String& defaultValue = String()) {
+    const std::vector<uint8_t>* value = find(key);
+    return value ? String((const char*)value->data()) : defaultValue;
+  }
+  size_t getString(const char* key, char* buf, size_t maxLen) {
+    const std::vector<uint8_t>* value = find(key);
+    if (!value || value->size() > maxLen) return 0;
+    memcpy(buf, value->data(), value->size());
+    return value->size();
+  }
+
+  size_t putBool(const char* key, bool value) { return put(key, (uint8_t)value); }
+  bool getBool(const char* key, bool defaultValue = false) { return get(key, (uint8_t)defaultValue) != 0; }
+  size_t putUChar(const char* key, uint8_t value) { return put(key, value); }
+  uint8_t getUChar(const char* key, uint8_t defaultValue = 0) { return get(key, defaultValue); }
+  size_t putInt(const char* key, int32_t value) { return put(key, value); }
+  int32_t getInt(const char* key, int32_t defaultValue = 0) { return get(key, defaultValue); }
+  size_t putUInt(const char* key, uint32_t value) { return put(key, value); }
+  uint32_t getUInt(const char* key, uint32_t defaultValue = 0) { return get(key, defaultValue); }
+  size_t putULong64(const char* key, uint64_t value) { return put(key, value); }
+  uint64_t getULong64(const char* key, uint64_t defaultValue = 0) { return get(key, defaultValue); }
+  size_t putFloat(const char* key, float value) { return put(key, value); }
+  float getFloat(const char* key, float defaultValue = 0) { return get(key, defaultValue); }
+
+private:
+  typedef std::map<std::string, std::vector<uint8_t>> Namespace;
+
+  Namespace* space;
+  bool readOnly;
+
+  static std::map<std::string, Namespace>& storage() {
+    static std::map<std::string, Namespace> namespaces;
+    return namespaces;
+  }
+
+  bool writable() const {
+    return space && !readOnly;
+  }
+
+  const std::vector<uint8_t>* find(const char* key) const {
+    if (!space) return nullptr;
+    Namespace::const_iterator it = space->find(key);
+    return it == space->end() ? nullptr : &it->second;
+  }
+
+  template<typename T>
+  size_t put(const char* key, T value) {
+    return putBytes(key, &value, sizeof(value));
+  }
+
+  template<typename T>
+  T get(const char* key, T defaultValue) {
+    const std::vector<uint8_t>* value = find(key);
+    if (!value || value->size() != sizeof(T)) return defaultValue;
+    T result;
+    memcpy(&result, value->data(), sizeof(T));
+    return result;
+  }
+};
+
+#endif // HOST_PREFERENCES_H
@@ -0,0 +1,53 @@
+/*
+ * Host stubs for OmniLogger
+ * SD card over the in-memory card of FS.h, mounted at /sd
+ *
+ * Copyright (C) 2024 NortonTech3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOST_SD_H
+#define HOST_SD_H
+
+#include "FS.h"
+#include "SPI.h"
+
+typedef enum {
+  CARD_NONE,
+  CARD_MMC,
+  CARD_SD,
+  CARD_SDHC,
+  CARD_UNKNOWN
+} sdcard_type_t;
+
+namespace fs {
+
+class SDFS : public FS {
+public:
+  bool begin(uint8_t ssPin = 5, SPIClass& spi = SPI, uint32_t frequency = 4000000,
+             const char* mountpoint = "/sd", uint8_t maxFiles = 5, bool formatIfEmpty = false);
+  void end();
+  sdcard_type_t cardType();
+  uint64_t cardSize();
+  uint64_t totalBytes();
+  uint64_t usedBytes();
+};
+
+}  // namespace fs
+
+extern fs::SDFS SD;
+using fs::SDFS;
+
+#endif // HOST_SD_H
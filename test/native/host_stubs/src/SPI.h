@@ -0,0 +1,53 @@
+/*
+ * Host stubs for OmniLogger
+ * SPI bus with nothing attached: every transfer reads 0xFF
+ *
+ * Copyright (C) 2024 NortonTech3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOST_SPI_H
+#define HOST_SPI_H
+
+#include <Arduino.h>
+
+#define FSPI 0
+#define HSPI 1
+#define SPI_MODE0 0
+#define MSBFIRST 1
+
+class SPISettings {
+public:
+  SPISettings(uint32_t clock = 1000000, uint8_t bitOrder = MSBFIRST, uint8_t dataMode = SPI_MODE0) {}
+};
+
+class SPIClass {
+public:
+  SPIClass(uint8_t bus = FSPI) {}
+  void begin(int8_t sck = -1, int8_t miso = -1, int8_t mosi = -1, int8_t ss = -1) {}
+  void end() {}
+  void setFrequency(uint32_t) {}
+  void beginTransaction(SPISettings) {}
+  void endTransaction() {}
+  uint8_t transfer(uint8_t) { return 0xFF; }
+  void transferBytes(const uint8_t* out, uint8_t* in, uint32_t len) {
+    if (in) memset(in, 0xFF, len);
+  }
+  void writeBytes(const uint8_t*, uint32_t) {}
+};
+
+extern SPIClass SPI;
+
+#endif // HOST_SPI_H
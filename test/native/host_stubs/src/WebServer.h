@@ -0,0 +1,72 @@
+/*
+ * Host stubs for OmniLogger
+ * Web server that keeps the response instead of sending it
+ *
+ * Copyright (C) 2024 NortonTech3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOST_WEBSERVER_H
+#define HOST_WEBSERVER_H
+
+#include <Arduino.h>
+
+#define CONTENT_LENGTH_UNKNOWN ((size_t)-1)
+#define CONTENT_LENGTH_NOT_SET ((size_t)-2)
+
+// Responses are counted and the first CAPTURE_SIZE bytes of the body are
+// kept in a fixed buffer, so collecting one costs no heap allocation
+class WebServer {
+public:
+  static const size_t CAPTURE_SIZE = 64 * 1024;
+
+  WebServer(int port = 80) : code(0), length(0), captured(0) {}
+
+  void setContentLength(size_t) {}
+  void sendHeader(const String&, const String&, bool first = false) {}
+
+  void send(int code, const char* contentType = nullptr, const String& content = String()) {
+    this->code = code;
+    length = 0;
+    captured = 0;
+    sendContent(content.c_str(), content.length());
+  }
+  void send(int code, const char* contentType, const char* content) {
+    send(code, contentType, String(content));
+  }
+
+  void sendContent(const char* data, size_t len) {
+    size_t keep = std::min(len, CAPTURE_SIZE - captured);
+    memcpy(capture + captured, data, keep);
+    captured += keep;
+    length += len;
+  }
+  void sendContent(const char* text) { sendContent(text, strlen(text)); }
+  void sendContent(const String& text) { sendContent(text.c_str(), text.length()); }
+
+  // Last response: status, body bytes sent and the start of the body
+  int responseCode() const { return code; }
+  size_t responseLength() const { return length; }
+  const char* responseBody() const { return capture; }
+  size_t responseCaptured() const { return captured; }
+
+private:
+  int code;
+  size_t length;
+  size_t captured;
+  char capture[CAPTURE_SIZE];
+};
+
+#endif // HOST_WEBSERVER_H
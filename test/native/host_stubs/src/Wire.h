@@ -0,0 +1,57 @@
+/*
+ * Host stubs for OmniLogger
+ * I2C bus with a BME280 answering at 0x76 and 0x77 (host_wire.cpp)
+ *
+ * Copyright (C) 2024 NortonTech3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOST_WIRE_H
+#define HOST_WIRE_H
+
+#include <Arduino.h>
+
+class TwoWire : public Stream {
+public:
+  TwoWire() : txAddress(0), txLength(0), rxLength(0), rxIndex(0) {}
+
+  bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0) { return true; }
+  bool end() { return true; }
+  bool setClock(uint32_t) { return true; }
+
+  void beginTransmission(uint8_t address);
+  uint8_t endTransmission(bool sendStop = true);
+  uint8_t requestFrom(uint8_t address, uint8_t len, bool sendStop = true);
+
+  size_t write(uint8_t c) override;
+  using Print::write;
+  int available() override { return rxLength - rxIndex; }
+  int read() override { return rxIndex < rxLength ? rxBuffer[rxIndex++] : -1; }
+  int peek() override { return rxIndex < rxLength ? rxBuffer[rxIndex] : -1; }
+
+private:
+  static const size_t BUFFER_SIZE = 128;
+
+  uint8_t txAddress;
+  uint8_t txBuffer[BUFFER_SIZE];
+  size_t txLength;
+  uint8_t rxBuffer[BUFFER_SIZE];
+  size_t rxLength;
+  size_t rxIndex;
+};
+
+extern TwoWire Wire;
+
+#endif // HOST_WIRE_H
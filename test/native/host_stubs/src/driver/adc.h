@@ -0,0 +1,77 @@
+/*
+ * Host stubs for OmniLogger
+ * ADC continuous driver; initializing it fails, so fast analog inputs stay unavailable
+ *
+ * Copyright (C) 2024 NortonTech3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOST_DRIVER_ADC_H
+#define HOST_DRIVER_ADC_H
+
+#include <stdint.h>
+#include "esp_err.h"
+
+#define SOC_ADC_DIGI_MAX_BITWIDTH 13
+
+typedef enum { ADC_UNIT_1 = 1, ADC_UNIT_2 = 2 } adc_unit_t;
+typedef enum { ADC_ATTEN_DB_0 = 0, ADC_ATTEN_DB_12 = 3 } adc_atten_t;
+typedef enum { ADC_WIDTH_BIT_13 = 4 } adc_bits_width_t;
+typedef enum { ADC_CONV_SINGLE_UNIT_1 = 1 } adc_digi_convert_mode_t;
+typedef enum { ADC_DIGI_OUTPUT_FORMAT_TYPE1, ADC_DIGI_OUTPUT_FORMAT_TYPE2 } adc_digi_output_format_t;
+
+typedef struct {
+  uint8_t atten;
+  uint8_t channel;
+  uint8_t unit;
+  uint8_t bit_width;
+} adc_digi_pattern_config_t;
+
+typedef struct {
+  bool conv_limit_en;
+  uint32_t conv_limit_num;
+  uint32_t pattern_num;
+  adc_digi_pattern_config_t* adc_pattern;
+  uint32_t sample_freq_hz;
+  adc_digi_convert_mode_t conv_mode;
+  adc_digi_output_format_t format;
+} adc_digi_configuration_t;
+
+typedef struct {
+  uint32_t max_store_buf_size;
+  uint32_t conv_num_each_intr;
+  uint32_t adc1_chan_mask;
+  uint32_t adc2_chan_mask;
+} adc_digi_init_config_t;
+
+typedef struct {
+  union {
+    struct {
+      uint16_t data : 11;
+      uint16_t channel : 4;
+      uint16_t unit : 1;
+    } type2;
+    uint16_t val;
+  };
+} adc_digi_output_data_t;
+
+esp_err_t adc_digi_initialize(const adc_digi_init_config_t* config);
+esp_err_t adc_digi_controller_configure(const adc_digi_configuration_t* config);
+esp_err_t adc_digi_start();
+esp_err_t adc_digi_stop();
+esp_err_t adc_digi_read_bytes(uint8_t* buf, uint32_t length, uint32_t* outLength, uint32_t timeoutMs);
+esp_err_t adc_digi_deinitialize();
+
+#endif // HOST_DRIVER_ADC_H
@@ -0,0 +1,39 @@
+/*
+ * Host stubs for OmniLogger
+ * GPIO driver; pins are not connected on the host
+ *
+ * Copyright (C) 2024 NortonTech3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOST_DRIVER_GPIO_H
+#define HOST_DRIVER_GPIO_H
+
+#include <stdint.h>
+#include "esp_err.h"
+
+typedef int gpio_num_t;
+
+typedef enum {
+  GPIO_MODE_INPUT = 1,
+  GPIO_MODE_OUTPUT = 2,
+  GPIO_MODE_INPUT_OUTPUT_OD = 7
+} gpio_mode_t;
+
+esp_err_t gpio_set_direction(gpio_num_t pin, gpio_mode_t mode);
+esp_err_t gpio_set_level(gpio_num_t pin, uint32_t level);
+esp_err_t gpio_pullup_en(gpio_num_t pin);
+
+#endif // HOST_DRIVER_GPIO_H
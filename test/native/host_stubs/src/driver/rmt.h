@@ -0,0 +1,63 @@
+/*
+ * Host stubs for OmniLogger
+ * RMT driver; installing it fails, so DHT22 sensors stay unavailable
+ *
+ * Copyright (C) 2024 NortonTech3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOST_DRIVER_RMT_H
+#define HOST_DRIVER_RMT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "driver/gpio.h"
+#include "freertos/ringbuf.h"
+
+typedef enum { RMT_CHANNEL_0, RMT_CHANNEL_1, RMT_CHANNEL_2, RMT_CHANNEL_3, RMT_CHANNEL_MAX } rmt_channel_t;
+typedef enum { RMT_MODE_TX, RMT_MODE_RX } rmt_mode_t;
+
+typedef struct {
+  uint32_t duration0 : 15;
+  uint32_t level0 : 1;
+  uint32_t duration1 : 15;
+  uint32_t level1 : 1;
+} rmt_item32_t;
+
+typedef struct {
+  uint16_t idle_threshold;
+  uint8_t filter_ticks_thresh;
+  bool filter_en;
+} rmt_rx_config_t;
+
+typedef struct {
+  rmt_mode_t rmt_mode;
+  rmt_channel_t channel;
+  gpio_num_t gpio_num;
+  uint8_t clk_div;
+  uint8_t mem_block_num;
+  rmt_rx_config_t rx_config;
+} rmt_config_t;
+
+esp_err_t rmt_config(const rmt_config_t* config);
+esp_err_t rmt_driver_install(rmt_channel_t channel, size_t ringbufSize, int flags);
+esp_err_t rmt_driver_uninstall(rmt_channel_t channel);
+esp_err_t rmt_get_ringbuf_handle(rmt_channel_t channel, RingbufHandle_t* ringbuf);
+esp_err_t rmt_rx_start(rmt_channel_t channel, bool reset);
+esp_err_t rmt_rx_stop(rmt_channel_t channel);
+esp_err_t rmt_set_gpio(rmt_channel_t channel, rmt_mode_t mode, gpio_num_t pin, bool invert);
+
+#endif // HOST_DRIVER_RMT_H
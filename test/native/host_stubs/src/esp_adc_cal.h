@@ -0,0 +1,40 @@
+/*
+ * Host stubs for OmniLogger
+ * ADC calibration: a linear 0-3.3V response
+ *
+ * Copyright (C) 2024 NortonTech3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOST_ESP_ADC_CAL_H
+#define HOST_ESP_ADC_CAL_H
+
+#include <stdint.h>
+#include "driver/adc.h"
+
+typedef enum { ESP_ADC_CAL_VAL_EFUSE_VREF = 0, ESP_ADC_CAL_VAL_EFUSE_TP = 1, ESP_ADC_CAL_VAL_DEFAULT_VREF = 2 } esp_adc_cal_value_t;
+
+typedef struct {
+  adc_unit_t adc_num;
+  adc_atten_t atten;
+  adc_bits_width_t bit_width;
+  uint32_t vref;
+} esp_adc_cal_characteristics_t;
+
+esp_adc_cal_value_t esp_adc_cal_characterize(adc_unit_t unit, adc_atten_t atten, adc_bits_width_t width,
+                                             uint32_t vref, esp_adc_cal_characteristics_t* chars);
+uint32_t esp_adc_cal_raw_to_voltage(uint32_t raw, const esp_adc_cal_characteristics_t* chars);
+
+#endif // HOST_ESP_ADC_CAL_H
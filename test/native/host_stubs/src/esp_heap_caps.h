@@ -0,0 +1,39 @@
+/*
+ * Host stubs for OmniLogger
+ * Capability-based allocation over the host heap
+ *
+ * Copyright (C) 2024 NortonTech3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOST_ESP_HEAP_CAPS_H
+#define HOST_ESP_HEAP_CAPS_H
+
+#include <stddef.h>
+
+#define MALLOC_CAP_8BIT (1 << 2)
+#define MALLOC_CAP_DMA (1 << 3)
+#define MALLOC_CAP_SPIRAM (1 << 10)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+#define MALLOC_CAP_DEFAULT (1 << 12)
+
+void* heap_caps_malloc(size_t size, unsigned caps);
+void* heap_caps_calloc(size_t n, size_t size, unsigned caps);
+void heap_caps_free(void* ptr);
+size_t heap_caps_get_free_size(unsigned caps);
+size_t heap_caps_get_minimum_free_size(unsigned caps);
+size_t heap_caps_get_largest_free_block(unsigned caps);
+
+#endif // HOST_ESP_HEAP_CAPS_H
@@ -0,0 +1,51 @@
+/*
+ * Host stubs for OmniLogger
+ * Flash partitions: a 1.25MB journal partition in memory with NOR semantics
+ *
+ * Copyright (C) 2024 NortonTech3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOST_ESP_PARTITION_H
+#define HOST_ESP_PARTITION_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+typedef enum {
+  ESP_PARTITION_TYPE_APP = 0x00,
+  ESP_PARTITION_TYPE_DATA = 0x01
+} esp_partition_type_t;
+
+typedef enum {
+  ESP_PARTITION_SUBTYPE_ANY = 0xFF
+} esp_partition_subtype_t;
+
+typedef struct {
+  esp_partition_type_t type;
+  esp_partition_subtype_t subtype;
+  uint32_t address;
+  uint32_t size;
+  char label[17];
+} esp_partition_t;
+
+const esp_partition_t* esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype,
+                                                const char* label);
+esp_err_t esp_partition_read(const esp_partition_t* partition, size_t offset, void* dst, size_t len);
+esp_err_t esp_partition_write(const esp_partition_t* partition, size_t offset, const void* src, size_t len);
+esp_err_t esp_partition_erase_range(const esp_partition_t* partition, size_t offset, size_t len);
+
+#endif // HOST_ESP_PARTITION_H
@@ -0,0 +1,28 @@
+/*
+ * Host stubs for OmniLogger
+ * ROM CRC routines
+ *
+ * Copyright (C) 2024 NortonTech3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOST_ESP_ROM_CRC_H
+#define HOST_ESP_ROM_CRC_H
+
+#include <stdint.h>
+
+uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t* buf, uint32_t len);
+
+#endif // HOST_ESP_ROM_CRC_H
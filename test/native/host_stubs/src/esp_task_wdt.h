@@ -0,0 +1,30 @@
+/*
+ * Host stubs for OmniLogger
+ * Task watchdog; nothing to feed on the host
+ *
+ * Copyright (C) 2024 NortonTech3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOST_ESP_TASK_WDT_H
+#define HOST_ESP_TASK_WDT_H
+
+#include "esp_err.h"
+
+inline esp_err_t esp_task_wdt_reset() {
+  return ESP_OK;
+}
+
+#endif // HOST_ESP_TASK_WDT_H
@@ -0,0 +1,32 @@
+/*
+ * Host stubs for OmniLogger
+ * FreeRTOS ring buffers (RMT receive)
+ *
+ * Copyright (C) 2024 NortonTech3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOST_FREERTOS_RINGBUF_H
+#define HOST_FREERTOS_RINGBUF_H
+
+#include <stddef.h>
+#include "FreeRTOS.h"
+
+typedef void* RingbufHandle_t;
+
+void* xRingbufferReceive(RingbufHandle_t ringbuf, size_t* size, TickType_t wait);
+void vRingbufferReturnItem(RingbufHandle_t ringbuf, void* item);
+
+#endif // HOST_FREERTOS_RINGBUF_H
@@ -0,0 +1,34 @@
+/*
+ * Host stubs for OmniLogger
+ * FreeRTOS tasks; creating one fails, so callers take their no-task path
+ *
+ * Copyright (C) 2024 NortonTech3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOST_FREERTOS_TASK_H
+#define HOST_FREERTOS_TASK_H
+
+#include "FreeRTOS.h"
+
+typedef void* TaskHandle_t;
+typedef void (*TaskFunction_t)(void*);
+
+BaseType_t xTaskCreate(TaskFunction_t entry, const char* name, uint32_t stack, void* arg,
+                       UBaseType_t priority, TaskHandle_t* handle);
+void vTaskDelete(TaskHandle_t task);
+void vTaskDelay(TickType_t ticks);
+
+#endif // HOST_FREERTOS_TASK_H
@@ -0,0 +1,421 @@
+/*
+ * Host stubs for OmniLogger
+ * Core runtime for the native build: clock, console, heap accounting and
+ * the ESP-IDF drivers that have nothing to drive on the host
+ *
+ * Copyright (C) 2024 NortonTech3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <Arduino.h>
+#include <SPI.h>
+#include <esp_adc_cal.h>
+#include <esp_rom_crc.h>
+#include <driver/adc.h>
+#include <driver/gpio.h>
+#include <driver/rmt.h>
+#include <freertos/ringbuf.h>
+#include <malloc.h>
+#include <chrono>
+#include <new>
+#include "host_stubs.h"
+
+// === Heap accounting ===
+// malloc and friends reach these through the linker's --wrap; operator new
+// is replaced below and goes through the same counters
+
+extern "C" {
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t n, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+void __real_free(void* ptr);
+}
+
+static HostAllocStats heapStats;
+
+static void countAlloc(void* ptr, size_t size) {
+  if (!ptr) return;
+  heapStats.allocations++;
+  heapStats.bytes += size;
+  heapStats.live += malloc_usable_size(ptr);
+  heapStats.peak = std::max(heapStats.peak, heapStats.live);
+}
+
+static void countFree(void* ptr) {
+  if (ptr) {
+    heapStats.live -= malloc_usable_size(ptr);
+  }
+}
+
+extern "C" {
+
+void* __wrap_malloc(size_t size) {
+  void* ptr = __real_malloc(size);
+  countAlloc(ptr, size);
+  return ptr;
+}
+
+void* __wrap_calloc(size_t n, size_t size) {
+  void* ptr = __real_calloc(n, size);
+  countAlloc(ptr, n * size);
+  return ptr;
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+  size_t before = ptr ? malloc_usable_size(ptr) : 0;
+  void* moved = __real_realloc(ptr, size);
+  if (moved || size == 0) {
+    heapStats.live -= before;
+  }
+  countAlloc(moved, size);
+  return moved;
+}
+
+void __wrap_free(void* ptr) {
+  countFree(ptr);
+  __real_free(ptr);
+}
+
+}  // extern "C"
+
+void* operator new(size_t size) {
+  void* ptr = malloc(size ? size : 1);
+  if (!ptr) throw std::bad_alloc();
+  return ptr;
+}
+
+void* operator new[](size_t size) {
+  return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+  return malloc(size ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+  return malloc(size ? size : 1);
+}
+
+void operator delete(void* ptr) noexcept {
+  free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+  free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+  free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept {
+  free(ptr);
+}
+
+namespace Host {
+
+HostAllocStats allocStats() {
+  return heapStats;
+}
+
+void resetAllocPeak() {
+  heapStats.peak = heapStats.live;
+}
+
+}  // namespace Host
+
+bool psramFound() {
+  return true;
+}
+
+void* ps_malloc(size_t size) {
+  return malloc(size);
+}
+
+void* ps_calloc(size_t n, size_t size) {
+  return calloc(n, size);
+}
+
+void* ps_realloc(void* ptr, size_t size) {
+  return realloc(ptr, size);
+}
+
+void* heap_caps_malloc(size_t size, unsigned caps) {
+  return malloc(size);
+}
+
+void* heap_caps_calloc(size_t n, size_t size, unsigned caps) {
+  return calloc(n, size);
+}
+
+void heap_caps_free(void* ptr) {
+  free(ptr);
+}
+
+// Gauges report the S2's 320KB SRAM and 2MB PSRAM less what is held now
+static size_t freeOf(unsigned caps) {
+  int64_t total = (caps & MALLOC_CAP_SPIRAM) ? 2 * 1024 * 1024 : 320 * 1024;
+  return (size_t)std::max<int64_t>(0, total - heapStats.live);
+}
+
+size_t heap_caps_get_free_size(unsigned caps) {
+  return freeOf(caps);
+}
+
+size_t heap_caps_get_minimum_free_size(unsigned caps) {
+  return freeOf(caps);
+}
+
+size_t heap_caps_get_largest_free_block(unsigned caps) {
+  return freeOf(caps);
+}
+
+// === Console ===
+
+HWCDC Serial;
+
+static bool serialEnabled() {
+  static const bool enabled = getenv("HOST_SERIAL") != nullptr;
+  return enabled;
+}
+
+size_t HWCDC::write(uint8_t c) {
+  return write(&c, 1);
+}
+
+size_t HWCDC::write(const uint8_t* data, size_t len) {
+  if (serialEnabled()) {
+    fwrite(data, 1, len, stdout);
+  }
+  return len;
+}
+
+// === Clock ===
+
+static const std::chrono::steady_clock::time_point bootTime = std::chrono::steady_clock::now();
+static uint64_t skippedUs = 0;  // Time passed by delay()
+
+unsigned long micros() {
+  auto elapsed = std::chrono::steady_clock::now() - bootTime;
+  return (unsigned long)(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count() + skippedUs);
+}
+
+unsigned long millis() {
+  return micros() / 1000;
+}
+
+void delay(uint32_t ms) {
+  skippedUs += (uint64_t)ms * 1000;
+}
+
+void delayMicroseconds(uint32_t us) {
+  skippedUs += us;
+}
+
+void yield() {}
+
+int64_t esp_timer_get_time() {
+  return micros();
+}
+
+uint32_t getCpuFrequencyMhz() {
+  return 240;
+}
+
+long random(long howbig) {
+  return howbig > 0 ? ::random() % howbig : 0;
+}
+
+EspClass ESP;
+
+uint32_t EspClass::getCycleCount() {
+  return (uint32_t)((uint64_t)micros() * getCpuFrequencyMhz());
+}
+
+uint32_t EspClass::getFreeHeap() {
+  return freeOf(MALLOC_CAP_INTERNAL);
+}
+
+uint32_t EspClass::getMinFreeHeap() {
+  return freeOf(MALLOC_CAP_INTERNAL);
+}
+
+uint32_t EspClass::getMaxAllocHeap() {
+  return freeOf(MALLOC_CAP_INTERNAL);
+}
+
+uint32_t EspClass::getHeapSize() {
+  return 320 * 1024;
+}
+
+uint32_t EspClass::getFreePsram() {
+  return freeOf(MALLOC_CAP_SPIRAM);
+}
+
+uint32_t EspClass::getPsramSize() {
+  return 2 * 1024 * 1024;
+}
+
+void EspClass::restart() {
+  exit(0);
+}
+
+uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t* buf, uint32_t len) {
+  crc = ~crc;
+  while (len--) {
+    crc ^= *buf++;
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+    }
+  }
+  return ~crc;
+}
+
+// === Pins and ADC ===
+// One-shot analog reads return a slow ramp per pin, so logged rows differ
+
+static uint32_t analogReads = 0;
+
+void pinMode(uint8_t pin, uint8_t mode) {}
+
+void digitalWrite(uint8_t pin, uint8_t value) {}
+
+int digitalRead(uint8_t pin) {
+  return HIGH;  // Released bus lines read high
+}
+
+uint32_t analogReadMilliVolts(uint8_t pin) {
+  return 1200 + pin * 100 + (analogReads++ / 8) % 250;
+}
+
+uint16_t analogRead(uint8_t pin) {
+  return analogReadMilliVolts(pin) * 8191 / 3300;
+}
+
+esp_adc_cal_value_t esp_adc_cal_characterize(adc_unit_t unit, adc_atten_t atten, adc_bits_width_t width,
+                                             uint32_t vref, esp_adc_cal_characteristics_t* chars) {
+  chars->adc_num = unit;
+  chars->atten = atten;
+  chars->bit_width = width;
+  chars->vref = vref;
+  return ESP_ADC_CAL_VAL_DEFAULT_VREF;
+}
+
+uint32_t esp_adc_cal_raw_to_voltage(uint32_t raw, const esp_adc_cal_characteristics_t* chars) {
+  return raw * 3300 / 8191;
+}
+
+esp_err_t adc_digi_initialize(const adc_digi_init_config_t* config) {
+  return ESP_FAIL;
+}
+
+esp_err_t adc_digi_controller_configure(const adc_digi_configuration_t* config) {
+  return ESP_FAIL;
+}
+
+esp_err_t adc_digi_start() {
+  return ESP_FAIL;
+}
+
+esp_err_t adc_digi_stop() {
+  return ESP_FAIL;
+}
+
+esp_err_t adc_digi_read_bytes(uint8_t* buf, uint32_t length, uint32_t* outLength, uint32_t timeoutMs) {
+  *outLength = 0;
+  return ESP_ERR_TIMEOUT;
+}
+
+esp_err_t adc_digi_deinitialize() {
+  return ESP_OK;
+}
+
+// === GPIO and RMT (DHT22) ===
+
+esp_err_t gpio_set_direction(gpio_num_t pin, gpio_mode_t mode) {
+  return ESP_OK;
+}
+
+esp_err_t gpio_set_level(gpio_num_t pin, uint32_t level) {
+  return ESP_OK;
+}
+
+esp_err_t gpio_pullup_en(gpio_num_t pin) {
+  return ESP_OK;
+}
+
+esp_err_t rmt_config(const rmt_config_t* config) {
+  return ESP_FAIL;
+}
+
+esp_err_t rmt_driver_install(rmt_channel_t channel, size_t ringbufSize, int flags) {
+  return ESP_FAIL;
+}
+
+esp_err_t rmt_driver_uninstall(rmt_channel_t channel) {
+  return ESP_OK;
+}
+
+esp_err_t rmt_get_ringbuf_handle(rmt_channel_t channel, RingbufHandle_t* ringbuf) {
+  *ringbuf = nullptr;
+  return ESP_FAIL;
+}
+
+esp_err_t rmt_rx_start(rmt_channel_t channel, bool reset) {
+  return ESP_FAIL;
+}
+
+esp_err_t rmt_rx_stop(rmt_channel_t channel) {
+  return ESP_OK;
+}
+
+esp_err_t rmt_set_gpio(rmt_channel_t channel, rmt_mode_t mode, gpio_num_t pin, bool invert) {
+  return ESP_OK;
+}
+
+void* xRingbufferReceive(RingbufHandle_t ringbuf, size_t* size, TickType_t wait) {
+  return nullptr;
+}
+
+void vRingbufferReturnItem(RingbufHandle_t ringbuf, void* item) {}
+
+// === FreeRTOS ===
+// No second task ever runs, so a mutex is always free
+
+BaseType_t xTaskCreate(TaskFunction_t entry, const char* name, uint32_t stack, void* arg,
+                       UBaseType_t priority, TaskHandle_t* handle) {
+  return pdFAIL;
+}
+
+void vTaskDelete(TaskHandle_t task) {}
+
+void vTaskDelay(TickType_t ticks) {
+  delay(ticks * portTICK_PERIOD_MS);
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex() {
+  static int mutex;
+  return &mutex;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t mutex, TickType_t wait) {
+  return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t mutex) {
+  return pdTRUE;
+}
+
+SPIClass SPI;
@@ -0,0 +1,93 @@
+/*
+ * Host stubs for OmniLogger
+ * Journal flash partition in memory, and the ROM compression entry points
+ *
+ * Copyright (C) 2024 NortonTech3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <esp_partition.h>
+#include <rom/miniz.h>
+#include <string.h>
+
+// Same size as the journal entry in partitions.csv
+static const uint32_t JOURNAL_SIZE = 0x140000;
+static const uint32_t SECTOR_SIZE = 4096;
+
+// Erased flash reads 0xFF and a write can only clear bits, as on NOR flash
+static uint8_t journalFlash[JOURNAL_SIZE];
+static bool journalErased = false;
+
+static const esp_partition_t journalPartition = {
+  ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, 0x2C0000, JOURNAL_SIZE, "journal"
+};
+
+const esp_partition_t* esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype,
+                                                const char* label) {
+  if (type != ESP_PARTITION_TYPE_DATA || !label || strcmp(label, journalPartition.label) != 0) {
+    return nullptr;
+  }
+  if (!journalErased) {
+    memset(journalFlash, 0xFF, sizeof(journalFlash));
+    journalErased = true;
+  }
+  return &journalPartition;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t* partition, size_t offset, void* dst, size_t len) {
+  if (partition != &journalPartition || offset + len > JOURNAL_SIZE) {
+    return ESP_FAIL;
+  }
+  memcpy(dst, journalFlash + offset, len);
+  return ESP_OK;
+}
+
+esp_err_t esp_partition_write(const esp_partition_t* partition, size_t offset, const void* src, size_t len) {
+  if (partition != &journalPartition || offset + len > JOURNAL_SIZE) {
+    return ESP_FAIL;
+  }
+  const uint8_t* bytes = (const uint8_t*)src;
+  for (size_t i = 0; i < len; i++) {
+    journalFlash[offset + i] &= bytes[i];
+  }
+  return ESP_OK;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t* partition, size_t offset, size_t len) {
+  if (partition != &journalPartition || offset % SECTOR_SIZE != 0 || len % SECTOR_SIZE != 0 ||
+      offset + len > JOURNAL_SIZE) {
+    return ESP_FAIL;
+  }
+  memset(journalFlash + offset, 0xFF, len);
+  return ESP_OK;
+}
+
+tdefl_status tdefl_init(tdefl_compressor* d, tdefl_put_buf_func_ptr putBuf, void* user, int flags) {
+  return TDEFL_STATUS_BAD_PARAM;
+}
+
+tdefl_status tdefl_compress(tdefl_compressor* d, const void* in, size_t* inSize, void* out, size_t* outSize,
+                            tdefl_flush flush) {
+  *inSize = 0;
+  *outSize = 0;
+  return TDEFL_STATUS_BAD_PARAM;
+}
+
+tinfl_status tinfl_decompress(tinfl_decompressor* r, const uint8_t* in, size_t* inSize, uint8_t* outStart,
+                              uint8_t* outNext, size_t* outSize, uint32_t flags) {
+  *inSize = 0;
+  *outSize = 0;
+  return TINFL_STATUS_FAILED;
+}
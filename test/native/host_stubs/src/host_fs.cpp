@@ -0,0 +1,392 @@
+/*
+ * Host stubs for OmniLogger
+ * In-memory SD card behind the Arduino FS and SD APIs
+ *
+ * Copyright (C) 2024 NortonTech3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <SD.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <map>
+#include <vector>
+#include "host_stubs.h"
+
+extern "C" {
+void* __real_malloc(size_t size);
+void __real_free(void* ptr);
+}
+
+// The card's own storage bypasses the heap counters: file contents live on
+// the card, not in the logger's RAM. Handles are counted (one allocation
+// per open, as the device's VFS file object).
+template<typename T>
+struct CardAllocator {
+  typedef T value_type;
+
+  CardAllocator() {}
+  template<typename U>
+  CardAllocator(const CardAllocator<U>&) {}
+
+  T* allocate(size_t n) {
+    T* p = (T*)__real_malloc(n * sizeof(T));
+    if (!p) throw std::bad_alloc();
+    return p;
+  }
+  void deallocate(T* p, size_t) {
+    __real_free(p);
+  }
+
+  template<typename U>
+  bool operator==(const CardAllocator<U>&) const { return true; }
+  template<typename U>
+  bool operator!=(const CardAllocator<U>&) const { return false; }
+};
+
+typedef std::basic_string<char, std::char_traits<char>, CardAllocator<char>> CardPath;
+
+struct CardNode {
+  bool directory;
+  std::vector<uint8_t, CardAllocator<uint8_t>> data;
+  time_t modified;
+};
+
+typedef std::map<CardPath, std::shared_ptr<CardNode>, std::less<CardPath>,
+                 CardAllocator<std::pair<const CardPath, std::shared_ptr<CardNode>>>> CardTree;
+
+// Absolute paths without a trailing slash; "/" itself is never stored
+static CardTree& card() {
+  static CardTree tree;
+  return tree;
+}
+
+static CardPath normalize(const char* path) {
+  CardPath p = path && path[0] == '/' ? CardPath(path) : CardPath("/") + (path ? path : "");
+  while (p.size() > 1 && p.back() == '/') {
+    p.pop_back();
+  }
+  return p;
+}
+
+static CardPath parentOf(const CardPath& path) {
+  size_t slash = path.rfind('/');
+  return slash == 0 ? CardPath("/") : path.substr(0, slash);
+}
+
+static std::shared_ptr<CardNode> lookup(const CardPath& path) {
+  CardTree::iterator it = card().find(path);
+  return it == card().end() ? nullptr : it->second;
+}
+
+static bool isDirectoryPath(const CardPath& path) {
+  if (path == "/") return true;
+  std::shared_ptr<CardNode> node = lookup(path);
+  return node && node->directory;
+}
+
+static std::shared_ptr<CardNode> newNode(bool directory) {
+  std::shared_ptr<CardNode> node = std::allocate_shared<CardNode>(CardAllocator<CardNode>());
+  node->directory = directory;
+  node->modified = time(nullptr);
+  return node;
+}
+
+namespace fs {
+
+struct FileImpl {
+  std::shared_ptr<CardNode> node;  // nullptr for the root directory
+  CardPath path;
+  size_t pos;
+  bool readable;
+  bool writable;
+  bool append;
+  bool open;
+  CardPath lastChild;  // Directory listing position
+};
+
+static const uint8_t* contents(const FileImpl& f) {
+  return f.node->data.data();
+}
+
+size_t File::write(uint8_t c) {
+  return write(&c, 1);
+}
+
+size_t File::write(const uint8_t* data, size_t len) {
+  if (!impl || !impl->open || !impl->writable || !impl->node || impl->node->directory) {
+    return 0;
+  }
+  std::vector<uint8_t, CardAllocator<uint8_t>>& bytes = impl->node->data;
+  if (impl->append) {
+    impl->pos = bytes.size();
+  }
+  if (impl->pos + len > bytes.size()) {
+    bytes.resize(impl->pos + len);
+  }
+  memcpy(bytes.data() + impl->pos, data, len);
+  impl->pos += len;
+  impl->node->modified = time(nullptr);
+  return len;
+}
+
+size_t File::read(uint8_t* buf, size_t len) {
+  if (!impl || !impl->open || !impl->readable || !impl->node || impl->node->directory) {
+    return 0;
+  }
+  size_t size = impl->node->data.size();
+  size_t n = impl->pos < size ? std::min(len, size - impl->pos) : 0;
+  memcpy(buf, contents(*impl) + impl->pos, n);
+  impl->pos += n;
+  return n;
+}
+
+int File::read() {
+  uint8_t c;
+  return read(&c, 1) == 1 ? c : -1;
+}
+
+int File::peek() {
+  if (!impl || !impl->open || !impl->readable || !impl->node || impl->pos >= impl->node->data.size()) {
+    return -1;
+  }
+  return contents(*impl)[impl->pos];
+}
+
+int File::available() {
+  if (!impl || !impl->open || !impl->readable || !impl->node) {
+    return 0;
+  }
+  size_t size = impl->node->data.size();
+  return impl->pos < size ? (int)(size - impl->pos) : 0;
+}
+
+bool File::seek(uint32_t pos, SeekMode mode) {
+  if (!impl || !impl->open || !impl->node) {
+    return false;
+  }
+  int64_t base = mode == SeekCur ? impl->pos : (mode == SeekEnd ? impl->node->data.size() : 0);
+  impl->pos = (size_t)(base + pos);
+  return true;
+}
+
+size_t File::position() const {
+  return impl && impl->open ? impl->pos : 0;
+}
+
+size_t File::size() const {
+  return impl && impl->open && impl->node ? impl->node->data.size() : 0;
+}
+
+void File::close() {
+  if (impl) {
+    impl->open = false;
+  }
+  impl.reset();
+}
+
+File::operator bool() const {
+  return impl && impl->open;
+}
+
+time_t File::getLastWrite() {
+  return impl && impl->node ? impl->node->modified : 0;
+}
+
+const char* File::path() const {
+  return impl ? impl->path.c_str() : nullptr;
+}
+
+const char* File::name() const {
+  if (!impl) return nullptr;
+  size_t slash = impl->path.rfind('/');
+  return impl->path.c_str() + (impl->path.size() > 1 ? slash + 1 : 0);
+}
+
+bool File::isDirectory() const {
+  return impl && impl->open && (!impl->node || impl->node->directory);
+}
+
+// Children of a directory in name order (FAT lists creation order; nothing
+// in the firmware depends on either)
+File File::openNextFile(const char* mode) {
+  if (!isDirectory()) {
+    return File();
+  }
+  CardPath prefix = impl->path == "/" ? CardPath("/") : impl->path + "/";
+  CardTree::iterator it = impl->lastChild.empty() ? card().lower_bound(prefix) : card().upper_bound(impl->lastChild);
+  for (; it != card().end() && it->first.compare(0, prefix.size(), prefix) == 0; ++it) {
+    if (it->first.find('/', prefix.size()) != CardPath::npos) {
+      continue;  // Deeper level
+    }
+    impl->lastChild = it->first;
+    return SD.open(it->first.c_str(), mode);
+  }
+  impl->lastChild = prefix + "\xFF";
+  return File();
+}
+
+void File::rewindDirectory() {
+  if (impl) {
+    impl->lastChild.clear();
+  }
+}
+
+File FS::open(const char* path, const char* mode, bool create) {
+  CardPath p = normalize(path);
+  bool plus = strchr(mode, '+') != nullptr;
+  std::shared_ptr<CardNode> node = p == "/" ? nullptr : lookup(p);
+
+  std::shared_ptr<FileImpl> impl = std::make_shared<FileImpl>();
+  impl->path = p;
+  impl->pos = 0;
+  impl->open = true;
+  impl->append = false;
+
+  if (mode[0] == 'r') {
+    if (!node && p != "/") {
+      return File();
+    }
+    impl->readable = true;
+    impl->writable = plus && node && !node->directory;
+  } else if (mode[0] == 'w' || mode[0] == 'a') {
+    if ((node && node->directory) || p == "/" || !isDirectoryPath(parentOf(p))) {
+      return File();
+    }
+    if (!node) {
+      node = newNode(false);
+      card()[p] = node;
+    } else if (mode[0] == 'w') {
+      node->data.clear();
+      node->modified = time(nullptr);
+    }
+    impl->readable = plus;
+    impl->writable = true;
+    impl->append = mode[0] == 'a';
+    impl->pos = impl->append ? node->data.size() : 0;
+  } else {
+    return File();
+  }
+  impl->node = node;
+  return File(impl);
+}
+
+bool FS::exists(const char* path) {
+  CardPath p = normalize(path);
+  return p == "/" || lookup(p) != nullptr;
+}
+
+bool FS::remove(const char* path) {
+  CardPath p = normalize(path);
+  std::shared_ptr<CardNode> node = lookup(p);
+  if (!node || node->directory) {
+    return false;
+  }
+  card().erase(p);
+  return true;
+}
+
+bool FS::rename(const char* from, const char* to) {
+  CardPath source = normalize(from);
+  CardPath target = normalize(to);
+  std::shared_ptr<CardNode> node = lookup(source);
+  if (!node || node->directory || lookup(target) || !isDirectoryPath(parentOf(target))) {
+    return false;
+  }
+  card().erase(source);
+  card()[target] = node;
+  return true;
+}
+
+bool FS::mkdir(const char* path) {
+  CardPath p = normalize(path);
+  if (p == "/" || lookup(p) || !isDirectoryPath(parentOf(p))) {
+    return false;
+  }
+  card()[p] = newNode(true);
+  return true;
+}
+
+bool FS::rmdir(const char* path) {
+  CardPath p = normalize(path);
+  std::shared_ptr<CardNode> node = lookup(p);
+  if (!node || !node->directory) {
+    return false;
+  }
+  CardTree::iterator child = card().lower_bound(p + "/");
+  if (child != card().end() && child->first.compare(0, p.size() + 1, p + "/") == 0) {
+    return false;  // Not empty
+  }
+  card().erase(p);
+  return true;
+}
+
+// A 32GB SDHC card, always present
+static const uint64_t CARD_BYTES = 32ULL * 1024 * 1024 * 1024;
+
+bool SDFS::begin(uint8_t ssPin, SPIClass& spi, uint32_t frequency, const char* mountpoint,
+                 uint8_t maxFiles, bool formatIfEmpty) {
+  return true;
+}
+
+void SDFS::end() {}
+
+sdcard_type_t SDFS::cardType() {
+  return CARD_SDHC;
+}
+
+uint64_t SDFS::cardSize() {
+  return CARD_BYTES;
+}
+
+uint64_t SDFS::totalBytes() {
+  return CARD_BYTES;
+}
+
+uint64_t SDFS::usedBytes() {
+  uint64_t used = 0;
+  for (CardTree::iterator it = card().begin(); it != card().end(); ++it) {
+    used += it->second->data.size();
+  }
+  return used;
+}
+
+}  // namespace fs
+
+fs::SDFS SD;
+
+namespace Host {
+
+void formatCard() {
+  card().clear();
+}
+
+}  // namespace Host
+
+// The firmware trims day files with POSIX truncate() on the VFS path
+// ("/sd/..."); those calls land on the card, anything else on the host
+extern "C" int truncate(const char* path, off_t length) noexcept {
+  static const char MOUNT[] = "/sd/";
+  if (strncmp(path, MOUNT, sizeof(MOUNT) - 1) != 0) {
+    return syscall(SYS_truncate, path, length);
+  }
+  std::shared_ptr<CardNode> node = lookup(normalize(path + sizeof(MOUNT) - 2));
+  if (!node || node->directory || length < 0) {
+    return -1;
+  }
+  node->data.resize(length);
+  node->modified = time(nullptr);
+  return 0;
+}
@@ -0,0 +1,46 @@
+/*
+ * Host stubs for OmniLogger
+ * Controls for tests: heap counters and the in-memory card
+ *
+ * Copyright (C) 2024 NortonTech3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOST_STUBS_H
+#define HOST_STUBS_H
+
+#include <stdint.h>
+
+// Heap use since start, counted by the malloc/calloc/realloc/free wrappers
+// (linked with -Wl,--wrap) and the global operator new/delete. Memory the
+// C++ runtime allocates for itself is not seen.
+struct HostAllocStats {
+  uint64_t allocations;  // Blocks handed out, including by realloc
+  uint64_t bytes;        // Bytes requested by those calls
+  int64_t live;          // Bytes held now (usable size of each block)
+  int64_t peak;          // Highest live since resetAllocPeak()
+};
+
+namespace Host {
+
+HostAllocStats allocStats();
+void resetAllocPeak();
+
+// Remove every file and directory from the card
+void formatCard();
+
+}  // namespace Host
+
+#endif // HOST_STUBS_H
@@ -0,0 +1,129 @@
+/*
+ * Host stubs for OmniLogger
+ * I2C bus with a register model of a BME280 at both of its addresses
+ *
+ * Copyright (C) 2024 NortonTech3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <Wire.h>
+
+// Calibration and raw values of the datasheet's compensation example
+// (25.08°C, 1006.5hPa), with humidity trim from a typical part. Every
+// forced conversion moves the raw values a little, so rows differ.
+class Bme280Model {
+public:
+  explicit Bme280Model(uint8_t seed) : pointer(0), conversions(seed * 16) {
+    memset(regs, 0, sizeof(regs));
+    regs[0xD0] = 0x60;  // Chip ID
+    const int16_t tp[12] = {27504, 26435, -1000, (int16_t)36477, -10685, 3024, 2855, 140, -7, 15500, -14600, 6000};
+    for (int i = 0; i < 12; i++) {
+      regs[0x88 + 2 * i] = tp[i] & 0xFF;
+      regs[0x89 + 2 * i] = (tp[i] >> 8) & 0xFF;
+    }
+    const int16_t h2 = 370, h4 = 313, h5 = 50;
+    regs[0xA1] = 75;  // H1
+    regs[0xE1] = h2 & 0xFF;
+    regs[0xE2] = h2 >> 8;
+    regs[0xE3] = 0;   // H3
+    regs[0xE4] = h4 >> 4;
+    regs[0xE5] = (h4 & 0x0F) | ((h5 & 0x0F) << 4);
+    regs[0xE6] = h5 >> 4;
+    regs[0xE7] = 30;  // H6
+    setRaw(0x80000, 0x80000, 0x8000);  // Skipped until the first conversion
+  }
+
+  // First byte of a write sets the register pointer, the rest are data
+  void write(const uint8_t* data, size_t len) {
+    if (len == 0) return;
+    pointer = data[0];
+    for (size_t i = 1; i < len; i++) {
+      uint8_t reg = pointer++;
+      regs[reg] = data[i];
+      if (reg == 0xF4 && (data[i] & 0x03) == 0x01) {
+        convert();
+      }
+    }
+  }
+
+  size_t read(uint8_t* out, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+      out[i] = regs[pointer++];
+    }
+    return len;
+  }
+
+private:
+  uint8_t regs[256];
+  uint8_t pointer;
+  uint32_t conversions;
+
+  // Forced mode finishes at once: status never shows "measuring"
+  void convert() {
+    int32_t step = conversions++ % 64;
+    setRaw(415148 + step * 40, 519888 + step * 160, 26000 + step * 20);
+    regs[0xF4] &= ~0x03;
+  }
+
+  void setRaw(int32_t adcP, int32_t adcT, int32_t adcH) {
+    regs[0xF7] = adcP >> 12;
+    regs[0xF8] = (adcP >> 4) & 0xFF;
+    regs[0xF9] = (adcP & 0x0F) << 4;
+    regs[0xFA] = adcT >> 12;
+    regs[0xFB] = (adcT >> 4) & 0xFF;
+    regs[0xFC] = (adcT & 0x0F) << 4;
+    regs[0xFD] = adcH >> 8;
+    regs[0xFE] = adcH & 0xFF;
+  }
+};
+
+static Bme280Model* deviceAt(uint8_t address) {
+  static Bme280Model primary(0);
+  static Bme280Model secondary(1);
+  return address == 0x76 ? &primary : (address == 0x77 ? &secondary : nullptr);
+}
+
+TwoWire Wire;
+
+void TwoWire::beginTransmission(uint8_t address) {
+  txAddress = address;
+  txLength = 0;
+}
+
+size_t TwoWire::write(uint8_t c) {
+  if (txLength == BUFFER_SIZE) {
+    return 0;
+  }
+  txBuffer[txLength++] = c;
+  return 1;
+}
+
+// 2 = address not acknowledged, as the ESP32 core reports it
+uint8_t TwoWire::endTransmission(bool sendStop) {
+  Bme280Model* device = deviceAt(txAddress);
+  if (!device) {
+    return 2;
+  }
+  device->write(txBuffer, txLength);
+  txLength = 0;
+  return 0;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t len, bool sendStop) {
+  Bme280Model* device = deviceAt(address);
+  rxIndex = 0;
+  rxLength = device ? device->read(rxBuffer, std::min((size_t)len, BUFFER_SIZE)) : 0;
+  return rxLength;
+}
@@ -0,0 +1,81 @@
+/*
+ * Host stubs for OmniLogger
+ * ROM deflate/inflate entry points. They fail on the host, so gzip day files
+ * and compressed downloads are outside the native build
+ *
+ * Copyright (C) 2024 NortonTech3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOST_ROM_MINIZ_H
+#define HOST_ROM_MINIZ_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+enum {
+  TDEFL_DEFAULT_MAX_PROBES = 128,
+  TDEFL_WRITE_ZLIB_HEADER = 0x01000,
+  TDEFL_GREEDY_PARSING_FLAG = 0x04000
+};
+
+typedef enum {
+  TDEFL_STATUS_BAD_PARAM = -2,
+  TDEFL_STATUS_PUT_BUF_FAILED = -1,
+  TDEFL_STATUS_OKAY = 0,
+  TDEFL_STATUS_DONE = 1
+} tdefl_status;
+
+typedef enum {
+  TDEFL_NO_FLUSH = 0,
+  TDEFL_SYNC_FLUSH = 2,
+  TDEFL_FULL_FLUSH = 3,
+  TDEFL_FINISH = 4
+} tdefl_flush;
+
+typedef int (*tdefl_put_buf_func_ptr)(const void* buf, int len, void* user);
+
+typedef struct {
+  uint32_t flags;
+} tdefl_compressor;
+
+tdefl_status tdefl_init(tdefl_compressor* d, tdefl_put_buf_func_ptr putBuf, void* user, int flags);
+tdefl_status tdefl_compress(tdefl_compressor* d, const void* in, size_t* inSize, void* out, size_t* outSize,
+                            tdefl_flush flush);
+
+#define TINFL_LZ_DICT_SIZE 32768
+
+enum {
+  TINFL_FLAG_PARSE_ZLIB_HEADER = 1,
+  TINFL_FLAG_HAS_MORE_INPUT = 2
+};
+
+typedef enum {
+  TINFL_STATUS_FAILED = -1,
+  TINFL_STATUS_DONE = 0,
+  TINFL_STATUS_NEEDS_MORE_INPUT = 1,
+  TINFL_STATUS_HAS_MORE_OUTPUT = 2
+} tinfl_status;
+
+typedef struct {
+  uint32_t m_state;
+} tinfl_decompressor;
+
+#define tinfl_init(r) do { (r)->m_state = 0; } while (0)
+
+tinfl_status tinfl_decompress(tinfl_decompressor* r, const uint8_t* in, size_t* inSize, uint8_t* outStart,
+                              uint8_t* outNext, size_t* outSize, uint32_t flags);
+
+#endif // HOST_ROM_MINIZ_H
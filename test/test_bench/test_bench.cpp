@@ -0,0 +1,461 @@
+/*
+ * Benchmarks for OmniLogger
+ * Logging and query paths over synthetic day files, compared with baseline.json
+ *
+ * Copyright (C) 2024 NortonTech3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Two synthetic days at a 1 s interval from 8 sensors (2 BME280, 4 DS18B20
+// and 2 analog inputs, 12 value columns) go through the firmware's own
+// code against the host stubs: an in-memory card, the journal partition in
+// RAM and a web server that keeps the response. Each benchmark reports
+// rows per second, heap allocations and peak heap above its starting
+// point, and fails when it is worse than baseline.json:
+//   - throughput lower by more than BENCH_TOLERANCE (default 0.30)
+//   - allocations or peak heap higher by more than 5%
+// BENCH_SAVE_BASELINE=1 writes the results as the new baseline instead.
+
+#include <unity.h>
+#include <SD.h>
+#include <time.h>
+#include <string>
+#include <vector>
+#include "host_stubs.h"
+#include "config.h"
+#include "sensors.h"
+#include "datalogger.h"
+#include "json_stream.h"
+#include "manifest.h"
+
+static const uint32_t ROWS_PER_DAY = 86400;
+static const time_t DAY1 = 1767484800;  // 2026-01-04 00:00:00 UTC
+static const time_t DAY2 = DAY1 + ROWS_PER_DAY;
+static const char* DAY1_FILE = "/data_20260104.csv";
+static const char* DAY2_FILE = "/data_20260105.csv";
+static const uint32_t PAGE_ROWS = 1000;  // The /api/data limit
+static const size_t ROW_MAX = 512;       // SAMPLE_RECORD_MAX in main.cpp
+static const double MEMORY_TOLERANCE = 0.05;
+static const int ROUNDS = 3;  // Runs of each repeatable benchmark
+
+struct BenchResult {
+  std::string name;
+  uint32_t rows;
+  double seconds;
+  uint64_t allocations;
+  int64_t peakBytes;
+
+  double rowsPerSecond() const {
+    return seconds > 0 ? rows / seconds : 0;
+  }
+};
+
+static std::vector<BenchResult> results;
+
+// CPU time (steadier than wall time on a shared host) and heap use over
+// the running parts of one benchmark; setup work between pause() and
+// resume() is left out of both. A repeatable benchmark ends each run with
+// endRound(): the fastest run counts, and the most heap any run used.
+class Measurement {
+public:
+  explicit Measurement(const char* name)
+      : name(name), elapsed(0), allocations(0), peak(0), running(false), started(0),
+        rounds(0), bestElapsed(0), maxAllocations(0), maxPeak(0) {
+    resume();
+  }
+
+  void pause() {
+    if (!running) return;
+    HostAllocStats now = Host::allocStats();
+    elapsed += cpuSeconds() - started;
+    allocations += now.allocations - startStats.allocations;
+    peak = std::max(peak, now.peak - startStats.live);
+    running = false;
+  }
+
+  void resume() {
+    if (running) return;
+    Host::resetAllocPeak();
+    startStats = Host::allocStats();
+    started = cpuSeconds();
+    running = true;
+  }
+
+  void endRound() {
+    pause();
+    bestElapsed = rounds == 0 ? elapsed : std::min(bestElapsed, elapsed);
+    maxAllocations = std::max(maxAllocations, allocations);
+    maxPeak = std::max(maxPeak, peak);
+    rounds++;
+    elapsed = 0;
+    allocations = 0;
+    peak = 0;
+  }
+
+  // rows: processed by one run
+  const BenchResult& finish(uint32_t rows) {
+    if (rounds == 0) {
+      endRound();
+    }
+    BenchResult result = {name, rows, bestElapsed, maxAllocations, maxPeak};
+    results.push_back(result);
+    printf("%-16s %8u rows  %12.0f rows/s  %8llu allocs  %8lld peak bytes\n", name, rows,
+           result.rowsPerSecond(), (unsigned long long)maxAllocations, (long long)maxPeak);
+    return results.back();
+  }
+
+private:
+  const char* name;
+  double elapsed;
+  uint64_t allocations;
+  int64_t peak;
+  bool running;
+  HostAllocStats startStats;
+  double started;
+  int rounds;
+  double bestElapsed;
+  uint64_t maxAllocations;
+  int64_t maxPeak;
+
+  static double cpuSeconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+  }
+};
+
+// === Baseline ===
+
+static std::string baselinePath() {
+  const char* path = getenv("BENCH_BASELINE");
+  if (path) return path;
+  std::string source = __FILE__;
+  size_t slash = source.rfind('/');
+  return (slash == std::string::npos ? std::string(".") : source.substr(0, slash)) + "/baseline.json";
+}
+
+static std::string readFile(const std::string& path) {
+  std::string text;
+  FILE* f = fopen(path.c_str(), "r");
+  if (!f) return text;
+  char buf[4096];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
+    text.append(buf, n);
+  }
+  fclose(f);
+  return text;
+}
+
+// Number under "bench": {... "key": n ...} in the baseline's flat layout
+static bool baselineValue(const std::string& json, const std::string& bench, const char* key, double& value) {
+  size_t start = json.find("\"" + bench + "\"");
+  if (start == std::string::npos) return false;
+  size_t end = json.find('}', start);
+  size_t at = json.find(std::string("\"") + key + "\"", start);
+  if (at == std::string::npos || at > end) return false;
+  at = json.find(':', at);
+  value = strtod(json.c_str() + at + 1, nullptr);
+  return true;
+}
+
+static void saveBaseline() {
+  FILE* f = fopen(baselinePath().c_str(), "w");
+  TEST_ASSERT_NOT_NULL_MESSAGE(f, "Cannot write the baseline");
+  fprintf(f, "{\n");
+  for (size_t i = 0; i < results.size(); i++) {
+    const BenchResult& r = results[i];
+    fprintf(f, "  \"%s\": {\"rows\": %u, \"rows_per_s\": %.0f, \"allocations\": %llu, \"peak_bytes\": %lld}%s\n",
+            r.name.c_str(), r.rows, r.rowsPerSecond(), (unsigned long long)r.allocations, (long long)r.peakBytes,
+            i + 1 < results.size() ? "," : "");
+  }
+  fprintf(f, "}\n");
+  fclose(f);
+  printf("Baseline written to %s\n", baselinePath().c_str());
+}
+
+static void checkBaseline(const BenchResult& r) {
+  if (getenv("BENCH_SAVE_BASELINE")) {
+    return;  // Compared with nothing; saved by the last test
+  }
+  std::string json = readFile(baselinePath());
+  TEST_ASSERT_TRUE_MESSAGE(!json.empty(), "No baseline.json - run with BENCH_SAVE_BASELINE=1 first");
+
+  double rowsPerSecond, allocations, peakBytes;
+  std::string missing = r.name + ": not in the baseline";
+  TEST_ASSERT_TRUE_MESSAGE(baselineValue(json, r.name, "rows_per_s", rowsPerSecond) &&
+                           baselineValue(json, r.name, "allocations", allocations) &&
+                           baselineValue(json, r.name, "peak_bytes", peakBytes), missing.c_str());
+
+  const char* tolerance = getenv("BENCH_TOLERANCE");
+  double speedTolerance = tolerance ? atof(tolerance) : 0.30;
+  char message[160];
+  snprintf(message, sizeof(message), "%s: %.0f rows/s, baseline %.0f", r.name.c_str(), r.rowsPerSecond(), rowsPerSecond);
+  TEST_ASSERT_TRUE_MESSAGE(r.rowsPerSecond() >= rowsPerSecond * (1 - speedTolerance), message);
+  snprintf(message, sizeof(message), "%s: %llu allocations, baseline %.0f", r.name.c_str(),
+           (unsigned long long)r.allocations, allocations);
+  TEST_ASSERT_TRUE_MESSAGE(r.allocations <= allocations * (1 + MEMORY_TOLERANCE), message);
+  snprintf(message, sizeof(message), "%s: %lld peak bytes, baseline %.0f", r.name.c_str(), (long long)r.peakBytes, peakBytes);
+  TEST_ASSERT_TRUE_MESSAGE(r.peakBytes <= peakBytes * (1 + MEMORY_TOLERANCE), message);
+}
+
+// === Fixture ===
+
+static Config config;
+static SensorManager sensors;
+static DataLogger logger;
+static WebServer server;
+
+static void configureSensors() {
+  const struct { SensorType type; int pin; const char* name; } layout[] = {
+    {SENSOR_BME280, 0, "Indoor"},
+    {SENSOR_BME280, 1, "Outdoor"},
+    {SENSOR_DS18B20, 4, "Tank1"},
+    {SENSOR_DS18B20, 4, "Tank2"},
+    {SENSOR_DS18B20, 4, "Tank3"},
+    {SENSOR_DS18B20, 4, "Tank4"},
+    {SENSOR_ANALOG, 5, "Soil1"},
+    {SENSOR_ANALOG, 6, "Soil2"},
+  };
+  for (size_t i = 0; i < sizeof(layout) / sizeof(layout[0]); i++) {
+    config.sensors[i].type = layout[i].type;
+    config.sensors[i].pin = layout[i].pin;
+    config.sensors[i].enabled = true;
+    strncpy(config.sensors[i].name, layout[i].name, sizeof(config.sensors[i].name) - 1);
+  }
+}
+
+static size_t formatRow(time_t t, char* row, size_t rowSize) {
+  char timestamp[24];
+  struct tm timeinfo;
+  localtime_r(&t, &timeinfo);
+  strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", &timeinfo);
+  return sensors.getCSVData(timestamp, row, rowSize);
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+// === Benchmarks ===
+
+// Formatting a sample into a CSV row, done once per measurement
+void test_csv_row() {
+  const int passes = 10;
+  char row[ROW_MAX];
+  size_t total = 0;
+
+  Measurement m("csv_row");
+  for (int round = 0; round < ROUNDS; round++) {
+    m.resume();
+    for (int pass = 0; pass < passes; pass++) {
+      for (uint32_t i = 0; i < ROWS_PER_DAY; i++) {
+        total += formatRow(DAY1 + i, row, sizeof(row));
+      }
+    }
+    m.endRound();
+  }
+  const BenchResult& r = m.finish(passes * ROWS_PER_DAY);
+
+  TEST_ASSERT_TRUE(total > 0);
+  TEST_ASSERT_EQUAL_UINT64_MESSAGE(0, r.allocations, "getCSVData must not allocate");
+  checkBaseline(r);
+}
+
+// A day of samples written straight to the card with the default commit
+// policy (one commit per record); sensors are read once a minute, untimed
+void test_log_direct() {
+  char row[ROW_MAX];
+  Measurement m("log_direct");
+  for (uint32_t i = 0; i < ROWS_PER_DAY; i++) {
+    if (i % 60 == 0) {
+      m.pause();
+      sensors.readAllSensors();
+      m.resume();
+    }
+    size_t len = formatRow(DAY1 + i, row, sizeof(row));
+    TEST_ASSERT_TRUE(logger.logData(row, len, DAY1 + i));
+  }
+  const BenchResult& r = m.finish(ROWS_PER_DAY);
+
+  TEST_ASSERT_TRUE(SD.exists(DAY1_FILE));
+  TEST_ASSERT_EQUAL_UINT32(ROWS_PER_DAY, logger.getDataPointCount());
+  checkBaseline(r);
+}
+
+// A day of samples through the flash journal, flushed every flushInterval
+// records as the device does; only the flushes are timed
+void test_flush_buffer() {
+  char row[ROW_MAX];
+  logger.setBufferingEnabled(true);
+
+  Measurement m("flush_buffer");
+  m.pause();
+  for (uint32_t i = 0; i < ROWS_PER_DAY; i++) {
+    if (i % 60 == 0) {
+      sensors.readAllSensors();
+    }
+    size_t len = formatRow(DAY2 + i, row, sizeof(row));
+    TEST_ASSERT_TRUE(logger.logData(row, len, DAY2 + i));
+    if ((i + 1) % config.flushInterval == 0) {
+      m.resume();
+      TEST_ASSERT_TRUE(logger.flushBuffer());
+      m.pause();
+    }
+  }
+  m.resume();
+  TEST_ASSERT_TRUE(logger.flushBuffer());
+  const BenchResult& r = m.finish(ROWS_PER_DAY);
+
+  logger.setBufferingEnabled(false);
+  TEST_ASSERT_EQUAL_INT(0, logger.getBufferCount());
+  TEST_ASSERT_EQUAL_UINT32(2 * ROWS_PER_DAY, logger.getDataPointCount());
+  checkBaseline(r);
+}
+
+// One /api/data request: rows from the query path rendered as the handler
+// does, through the chunk buffer into the server
+static uint32_t apiData(const char* file, uint32_t from, uint32_t offset, bool& more) {
+  ChunkedResponse response(server, 200, "application/json");
+  JsonStreamWriter json(response);
+  json.beginObject();
+  json.field("file", file);
+  json.beginArray("data");
+  String header;
+  CsvRowObjects rows(json, header);
+  uint32_t count = 0;
+  bool ok = logger.queryData(file, from, 0, offset, PAGE_ROWS, header, more,
+      [&](const char* line, size_t len) {
+    rows.write(line, len);
+    count++;
+  });
+  json.endArray();
+  json.field("count", count);
+  json.field("offset", offset);
+  json.field("more", more);
+  json.endObject();
+  response.end();
+  TEST_ASSERT_TRUE(ok);
+  return count;
+}
+
+// Pages at the start, middle and end of a day file, each found by time
+void test_api_data() {
+  const uint32_t starts[] = {0, (uint32_t)DAY1 + ROWS_PER_DAY / 2, (uint32_t)DAY1 + ROWS_PER_DAY - PAGE_ROWS};
+  const int repeats = 20;
+  bool more;
+
+  Measurement m("api_data");
+  for (int round = 0; round < ROUNDS; round++) {
+    m.resume();
+    for (int i = 0; i < repeats; i++) {
+      for (uint32_t from : starts) {
+        TEST_ASSERT_EQUAL_UINT32(PAGE_ROWS, apiData(DAY1_FILE, from, 0, more));
+      }
+    }
+    m.endRound();
+  }
+  const BenchResult& r = m.finish(repeats * 3 * PAGE_ROWS);
+
+  TEST_ASSERT_FALSE(more);
+  TEST_ASSERT_EQUAL_INT(200, server.responseCode());
+  TEST_ASSERT_TRUE(strstr(server.responseBody(), "{\"Timestamp\":\"2026-01-04 23:43:20\",\"Indoor_Temp_C\":") != nullptr);
+  checkBaseline(r);
+}
+
+// A whole day file read page by page with offset, as a client exports it
+void test_api_data_paged() {
+  uint32_t rows = 0;
+
+  Measurement m("api_data_paged");
+  for (int round = 0; round < ROUNDS; round++) {
+    m.resume();
+    rows = 0;
+    bool more = true;
+    for (uint32_t offset = 0; more; offset += PAGE_ROWS) {
+      rows += apiData(DAY1_FILE, 0, offset, more);
+    }
+    m.endRound();
+  }
+  const BenchResult& r = m.finish(rows);
+
+  TEST_ASSERT_EQUAL_UINT32(ROWS_PER_DAY, rows);
+  checkBaseline(r);
+}
+
+// Boot-time rebuild of a lost manifest: every day file is scanned
+void test_day_scan() {
+  const int repeats = 10;
+  uint32_t rows = 0;
+
+  Measurement m("day_scan");
+  for (int round = 0; round < ROUNDS; round++) {
+    for (int i = 0; i < repeats; i++) {
+      TEST_ASSERT_TRUE(SD.remove(FileManifest::PATH));
+      FileManifest rebuilt;
+      m.resume();
+      rebuilt.begin();
+      m.pause();
+      rows = rebuilt.totalRows();
+    }
+    m.endRound();
+  }
+  const BenchResult& r = m.finish(repeats * rows);
+
+  FileManifest manifest;  // Loads what the last scan saved
+  manifest.begin();
+
+  TEST_ASSERT_EQUAL_UINT32(2, manifest.size());
+  TEST_ASSERT_EQUAL_UINT32(2 * ROWS_PER_DAY, manifest.totalRows());
+  const ManifestEntry* entry = manifest.get(DAY2_FILE);
+  TEST_ASSERT_NOT_NULL(entry);
+  TEST_ASSERT_EQUAL_UINT32(DAY2, entry->firstTs);
+  TEST_ASSERT_EQUAL_UINT32(DAY2 + ROWS_PER_DAY - 1, entry->lastTs);
+  checkBaseline(r);
+}
+
+void test_save_baseline() {
+  if (!getenv("BENCH_SAVE_BASELINE")) {
+    TEST_IGNORE_MESSAGE("Set BENCH_SAVE_BASELINE=1 to write baseline.json");
+  }
+  saveBaseline();
+}
+
+int main(int argc, char** argv) {
+  setenv("TZ", "UTC0", 1);
+  tzset();
+  Host::formatCard();
+
+  configureSensors();
+  sensors.begin(config);
+  sensors.readAllSensors();
+
+  logger.begin(config.sdCardCS, config.bufferBackend, config.logFormat);
+  logger.setCommitPolicy(config.groupCommitEnabled, config.commitMaxRecords,
+                         config.commitMaxBytes, config.commitMaxLatency);
+  logger.setPreallocation(config.sdPreallocKB);
+  logger.initSDCard();
+  logger.writeHeader(sensors.getCSVHeader(), sensors.getChannelDecimals());
+
+  UNITY_BEGIN();
+  RUN_TEST(test_csv_row);
+  RUN_TEST(test_log_direct);
+  RUN_TEST(test_flush_buffer);
+  RUN_TEST(test_api_data);
+  RUN_TEST(test_api_data_paged);
+  RUN_TEST(test_day_scan);
+  RUN_TEST(test_save_baseline);
+  return UNITY_END();
+}
@@ -0,0 +1,108 @@
+"""
+Embed the web UI in the firmware as gzip-compressed PROGMEM arrays.
+
+Reads web/index.html, web/style.css and web/script.js and writes
+src/web_assets.h. Runs before every PlatformIO build (extra_scripts) and
+can be run by hand: python3 tools/embed_web_assets.py
+
+Each asset gets a strong ETag from the hash of its compressed bytes. The
+page links the stylesheet and script with their ETag as a query string, so
+those URLs change whenever the content does and can be cached for a year,
+while the page itself is revalidated on every load.
+"""
+
+import gzip
+import hashlib
+import os
+
+try:
+    Import("env")  # noqa: F821 - provided by PlatformIO
+    PROJECT_DIR = env.subst("$PROJECT_DIR")  # noqa: F821
+except NameError:
+    PROJECT_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+WEB_DIR = os.path.join(PROJECT_DIR, "web")
+OUTPUT = os.path.join(PROJECT_DIR, "src", "web_assets.h")
+
+# (URL path, source file, content type, versioned)
+ASSETS = [
+    ("/style.css", "style.css", "text/css", True),
+    ("/script.js", "script.js", "application/javascript", True),
+    ("/", "index.html", "text/html", False),  # Last - links the others
+]
+
+
+def compress(data):
+    # mtime=0 keeps the output (and the ETag) the same for the same input
+    return gzip.compress(data, compresslevel=9, mtime=0)
+
+
+def c_name(filename):
+    return "WEB_" + filename.upper().replace(".", "_")
+
+
+def c_array(name, data):
+    lines = []
+    for i in range(0, len(data), 16):
+        lines.append("  " + ", ".join("0x%02x" % b for b in data[i:i + 16]) + ",")
+    return "static const uint8_t %s[] PROGMEM = {\n%s\n};\n" % (name, "\n".join(lines))
+
+
+def build():
+    etags = {}
+    arrays = []
+    entries = []
+    for path, filename, content_type, versioned in ASSETS:
+        with open(os.path.join(WEB_DIR, filename), "rb") as f:
+            data = f.read()
+        if filename == "index.html":
+            for linked, tag in etags.items():
+                data = data.replace(('"%s"' % linked).encode(),
+                                    ('"%s?v=%s"' % (linked, tag)).encode())
+        gz = compress(data)
+        tag = hashlib.sha256(gz).hexdigest()[:16]
+        etags[path] = tag
+        name = c_name(filename)
+        arrays.append("// %s: %d bytes, %d gzipped\n%s" % (filename, len(data), len(gz), c_array(name, gz)))
+        entries.append('  {"%s", "%s", %s, sizeof(%s), "\\"%s\\"", %s},'
+                       % (path, content_type, name, name, tag, "true" if versioned else "false"))
+
+    return """// Generated by tools/embed_web_assets.py from web/ - do not edit
+
+#ifndef WEB_ASSETS_H
+#define WEB_ASSETS_H
+
+#include <Arduino.h>
+
+// A gzip-compressed static file of the web UI
+struct WebAsset {
+  const char* path;
+  const char* contentType;
+  const uint8_t* data;
+  size_t length;
+  const char* etag;  // Strong ETag, quoted
+  bool versioned;    // Linked with ?v=<etag>, so it can be cached for good
+};
+
+%s
+static const WebAsset WEB_ASSETS[] = {
+%s
+};
+
+#endif // WEB_ASSETS_H
+""" % ("\n".join(arrays), "\n".join(entries))
+
+
+def main():
+    text = build()
+    old = None
+    if os.path.exists(OUTPUT):
+        with open(OUTPUT) as f:
+            old = f.read()
+    if text != old:  # Don't touch the file (and trigger a rebuild) if nothing changed
+        with open(OUTPUT, "w") as f:
+            f.write(text)
+        print("Embedded web assets in %s" % os.path.relpath(OUTPUT, PROJECT_DIR))
+
+
+main()
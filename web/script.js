@@ -0,0 +1,395 @@
+let statusInterval;
+let statusPeriod = 0;
+let liveSource = null;
+let bufferCapacity = 0;
+let recentSeq = 0;
+let recentColumns = [];
+let recentRows = [];
+let sensorSlots = 0;  // Sensor entries on the Sensors tab
+const RECENT_ROWS = 10;
+const STATUS_POLL_MS = 5000;   // Without live events
+const STATUS_LIVE_MS = 30000;  // Battery, storage and readings while live events arrive
+
+function showTab(tabName) {
+    // Hide all tabs
+    document.querySelectorAll('.tab-content').forEach(tab => {
+        tab.classList.remove('active');
+    });
+    document.querySelectorAll('.tab-btn').forEach(btn => {
+        btn.classList.remove('active');
+    });
+    
+    // Show selected tab
+    document.getElementById(tabName).classList.add('active');
+    document.getElementById('tab-' + tabName).classList.add('active');
+    
+    // Load tab-specific data
+    if (tabName === 'dashboard') {
+        loadStatus();
+        startLive();
+    } else {
+        stopLive();
+        
+        if (tabName === 'sensors') {
+            loadSensors();
+        } else if (tabName === 'settings') {
+            loadSettings();
+        } else if (tabName === 'data') {
+            refreshFiles();
+        }
+    }
+}
+
+// New samples are pushed by /api/events; the full status is polled slowly
+// alongside, and at the old rate whenever the event stream is down
+function startLive() {
+    if (!window.EventSource) {
+        pollStatus(STATUS_POLL_MS);
+        return;
+    }
+    if (liveSource) {
+        return;
+    }
+    liveSource = new EventSource('/api/events');
+    liveSource.addEventListener('sample', e => onLiveSample(JSON.parse(e.data)));
+    liveSource.onopen = () => {
+        loadRecent();  // Catch up on samples missed while disconnected
+        pollStatus(STATUS_LIVE_MS);
+    };
+    liveSource.onerror = () => pollStatus(STATUS_POLL_MS);  // The browser keeps retrying
+    pollStatus(STATUS_POLL_MS);
+}
+
+function stopLive() {
+    if (liveSource) {
+        liveSource.close();
+        liveSource = null;
+    }
+    if (statusInterval) {
+        clearInterval(statusInterval);
+        statusInterval = null;
+        statusPeriod = 0;
+    }
+}
+
+function pollStatus(period) {
+    if (statusInterval && statusPeriod === period) {
+        return;
+    }
+    clearInterval(statusInterval);
+    statusPeriod = period;
+    statusInterval = setInterval(loadStatus, period);
+}
+
+function onLiveSample(data) {
+    document.getElementById('datapoints').textContent = data.datapoints.toLocaleString();
+    document.getElementById('buffer').textContent = data.bufferCount + ' / ' + bufferCapacity;
+    
+    // A gap (or a reboot) means samples were missed - fetch them instead
+    const row = data.row;
+    if (recentSeq === 0 || row[0] !== recentSeq + 1) {
+        loadRecent();
+        return;
+    }
+    recentRows = recentRows.concat([row]).slice(-RECENT_ROWS);
+    recentSeq = row[0];
+    renderRecent();
+}
+
+function loadStatus() {
+    fetch('/api/status')
+        .then(response => response.json())
+        .then(data => {
+            document.getElementById('datapoints').textContent = data.datapoints.toLocaleString();
+            document.getElementById('battery').textContent = data.battery.toFixed(2) + 'V';
+            document.getElementById('storage').textContent = data.storageUsed + ' / ' + data.storageTotal;
+            let sdText = data.sdHealthy ? '✓ Healthy' : '✗ Error';
+            if (data.sdHealthy && data.sdClock) {
+                sdText += ' (' + (data.sdClock.clockKHz / 1000) + ' MHz)';
+            }
+            document.getElementById('sdhealth').textContent = sdText;
+            document.getElementById('sensorcount').textContent = data.sensorCount;
+            document.getElementById('uptime').textContent = formatUptime(data.uptime);
+            document.getElementById('buffer').textContent = data.bufferCount + ' / ' + data.bufferCapacity;
+            bufferCapacity = data.bufferCapacity;
+            let wifiText = data.wifiEnabled ? '✓ Enabled' : '✗ Disabled';
+            if (data.wifiEnabled && data.network) {
+                wifiText += ' (' + data.network.state + (data.network.timeSynced ? '' : ', clock not synced') + ')';
+            }
+            document.getElementById('wifistatus').textContent = wifiText;
+            
+            // Update readings
+            let readingsHTML = '';
+            data.readings.forEach(reading => {
+                readingsHTML += '<div class="sensor-item">';
+                readingsHTML += '<h4>' + reading.name + '</h4>';
+                readingsHTML += '<p>' + reading.data + '</p>';
+                readingsHTML += '</div>';
+            });
+            document.getElementById('readings').innerHTML = readingsHTML || '<p>No sensor readings available</p>';
+        })
+        .catch(err => console.error('Error loading status:', err));
+    
+    loadRecent();
+}
+
+function loadRecent() {
+    // Only samples newer than the last one seen are sent
+    fetch('/api/recent?limit=' + RECENT_ROWS + '&since=' + recentSeq)
+        .then(response => response.json())
+        .then(data => {
+            if (data.restart) {
+                recentColumns = data.columns;
+                recentRows = [];
+            }
+            recentRows = recentRows.concat(data.samples).slice(-RECENT_ROWS);
+            if (recentRows.length > 0) {
+                recentSeq = recentRows[recentRows.length - 1][0];
+            }
+            renderRecent();
+        })
+        .catch(err => console.error('Error loading recent samples:', err));
+}
+
+function renderRecent() {
+    if (recentRows.length === 0) {
+        document.getElementById('recent').innerHTML = '<p>No samples yet</p>';
+        return;
+    }
+    let html = '<table><tr><th>Time</th>';
+    recentColumns.forEach(col => html += '<th>' + col + '</th>');
+    html += '</tr>';
+    recentRows.slice().reverse().forEach(row => {
+        html += '<tr><td>' + (row[1] !== null ? new Date(row[1] * 1000).toLocaleTimeString() : '-') + '</td>';
+        row.slice(2).forEach(v => html += '<td>' + (v !== null ? v : '-') + '</td>');
+        html += '</tr>';
+    });
+    html += '</table>';
+    document.getElementById('recent').innerHTML = html;
+}
+
+function loadSensors() {
+    fetch('/api/sensors')
+        .then(response => response.json())
+        .then(data => {
+            let html = '';
+            data.sensors.forEach((sensor, index) => {
+                html += '<div class="sensor-item">';
+                html += '<h4>Sensor ' + (index + 1) + '</h4>';
+                html += '<label>Enabled:</label>';
+                html += '<input type="checkbox" id="s' + index + '_enabled" ' + (sensor.enabled ? 'checked' : '') + '><br>';
+                html += '<label>Name:</label>';
+                html += '<input type="text" id="s' + index + '_name" value="' + sensor.name + '"><br>';
+                html += '<label>Type:</label>';
+                html += '<select id="s' + index + '_type">';
+                data.types.forEach(type => {
+                    html += '<option value="' + type.id + '"' + (sensor.type === type.id ? ' selected' : '') + '>' + type.label + '</option>';
+                });
+                html += '</select><br>';
+                html += '<label>Pin (for digital/analog sensors):</label>';
+                html += '<input type="number" id="s' + index + '_pin" value="' + sensor.pin + '"><br>';
+                html += '<label>Interval (seconds, 0 = measurement interval):</label>';
+                html += '<input type="number" id="s' + index + '_interval" min="0" max="86400" value="' + (sensor.interval || 0) + '">';
+                html += '</div>';
+            });
+            sensorSlots = data.sensors.length;
+            document.getElementById('sensor-config').innerHTML = html;
+        })
+        .catch(err => console.error('Error loading sensors:', err));
+}
+
+function saveSensors() {
+    let sensors = [];
+    for (let i = 0; i < sensorSlots; i++) {
+        let enabled = document.getElementById('s' + i + '_enabled');
+        if (enabled) {
+            sensors.push({
+                enabled: enabled.checked,
+                name: document.getElementById('s' + i + '_name').value,
+                type: parseInt(document.getElementById('s' + i + '_type').value),
+                pin: parseInt(document.getElementById('s' + i + '_pin').value),
+                interval: parseInt(document.getElementById('s' + i + '_interval').value) || 0
+            });
+        }
+    }
+    
+    fetch('/api/sensors', {
+        method: 'POST',
+        headers: {'Content-Type': 'application/json'},
+        body: JSON.stringify({sensors: sensors})
+    })
+    .then(response => response.json())
+    .then(data => {
+        alert(data.message);
+    })
+    .catch(err => {
+        alert('Error saving sensors: ' + err);
+    });
+}
+
+function loadSettings() {
+    fetch('/api/settings')
+        .then(response => response.json())
+        .then(data => {
+            document.getElementById('wifiSSID').value = data.wifiSSID || '';
+            document.getElementById('wifiPassword').value = '';
+            document.getElementById('apSSID').value = data.apSSID || '';
+            document.getElementById('apPassword').value = '';
+            document.getElementById('bufferingEnabled').checked = data.bufferingEnabled || false;
+            document.getElementById('flushInterval').value = data.flushInterval || 300;
+            document.getElementById('bufferBackend').value = data.bufferBackend || 0;
+            document.getElementById('groupCommitEnabled').checked = data.groupCommitEnabled || false;
+            document.getElementById('commitMaxRecords').value = data.commitMaxRecords || 32;
+            document.getElementById('commitMaxBytes').value = data.commitMaxBytes || 4096;
+            document.getElementById('commitMaxLatency').value = data.commitMaxLatency || 30;
+            document.getElementById('logFormat').value = data.logFormat || 0;
+            document.getElementById('sdPreallocKB').value = data.sdPreallocKB || 0;
+            document.getElementById('sdProbeInterval').value = data.sdProbeInterval !== undefined ? data.sdProbeInterval : 600;
+            document.getElementById('compactAfterDays').value = data.compactAfterDays !== undefined ? data.compactAfterDays : 7;
+            document.getElementById('measInterval').value = data.measurementInterval;
+            document.getElementById('deepSleep').checked = data.deepSleepEnabled;
+            document.getElementById('carryForward').checked = data.carryForward || false;
+            document.getElementById('fastAdcRateHz').value = data.fastAdcRateHz || 20000;
+            document.getElementById('bmeOversampling').value = data.bmeOversampling || 1;
+            document.getElementById('uplinkEnabled').checked = data.uplinkEnabled || false;
+            document.getElementById('uplinkUrl').value = data.uplinkUrl || '';
+            document.getElementById('uplinkToken').value = '';
+            document.getElementById('uplinkInterval').value = data.uplinkInterval || 900;
+            document.getElementById('uplinkBatchRecords').value = data.uplinkBatchRecords || 500;
+            document.getElementById('timezoneOffset').value = data.timezoneOffset;
+        })
+        .catch(err => console.error('Error loading settings:', err));
+}
+
+function saveSettings() {
+    const settings = {
+        wifiSSID: document.getElementById('wifiSSID').value,
+        wifiPassword: document.getElementById('wifiPassword').value,
+        apSSID: document.getElementById('apSSID').value,
+        apPassword: document.getElementById('apPassword').value,
+        bufferingEnabled: document.getElementById('bufferingEnabled').checked,
+        flushInterval: parseInt(document.getElementById('flushInterval').value),
+        bufferBackend: parseInt(document.getElementById('bufferBackend').value),
+        groupCommitEnabled: document.getElementById('groupCommitEnabled').checked,
+        commitMaxRecords: parseInt(document.getElementById('commitMaxRecords').value),
+        commitMaxBytes: parseInt(document.getElementById('commitMaxBytes').value),
+        commitMaxLatency: parseInt(document.getElementById('commitMaxLatency').value),
+        logFormat: parseInt(document.getElementById('logFormat').value),
+        sdPreallocKB: parseInt(document.getElementById('sdPreallocKB').value),
+        sdProbeInterval: parseInt(document.getElementById('sdProbeInterval').value),
+        compactAfterDays: parseInt(document.getElementById('compactAfterDays').value),
+        measurementInterval: parseInt(document.getElementById('measInterval').value),
+        deepSleepEnabled: document.getElementById('deepSleep').checked,
+        carryForward: document.getElementById('carryForward').checked,
+        fastAdcRateHz: parseInt(document.getElementById('fastAdcRateHz').value),
+        bmeOversampling: parseInt(document.getElementById('bmeOversampling').value),
+        uplinkEnabled: document.getElementById('uplinkEnabled').checked,
+        uplinkUrl: document.getElementById('uplinkUrl').value,
+        uplinkToken: document.getElementById('uplinkToken').value,
+        uplinkInterval: parseInt(document.getElementById('uplinkInterval').value),
+        uplinkBatchRecords: parseInt(document.getElementById('uplinkBatchRecords').value),
+        timezoneOffset: parseInt(document.getElementById('timezoneOffset').value)
+    };
+    
+    fetch('/api/settings', {
+        method: 'POST',
+        headers: {'Content-Type': 'application/json'},
+        body: JSON.stringify(settings)
+    })
+    .then(response => response.json())
+    .then(data => {
+        alert(data.message);
+    })
+    .catch(err => {
+        alert('Error saving settings: ' + err);
+    });
+}
+
+function rebootDevice() {
+    if (confirm('Are you sure you want to reboot the device?')) {
+        fetch('/api/settings', {
+            method: 'POST',
+            headers: {'Content-Type': 'application/json'},
+            body: JSON.stringify({reboot: true})
+        })
+        .then(() => {
+            alert('Device is rebooting...');
+        })
+        .catch(err => {
+            alert('Error rebooting device: ' + err);
+        });
+    }
+}
+
+const FILES_PER_PAGE = 20;
+let fileOffset = 0;
+let fileTotal = 0;
+
+function changeFilePage(direction) {
+    const next = fileOffset + direction * FILES_PER_PAGE;
+    if (next >= 0 && next < fileTotal) {
+        fileOffset = next;
+        refreshFiles();
+    }
+}
+
+function refreshFiles() {
+    fetch('/api/files?offset=' + fileOffset + '&limit=' + FILES_PER_PAGE + '&sort=name&order=desc')
+        .then(response => response.json())
+        .then(data => {
+            fileTotal = data.total;
+            const pages = Math.max(1, Math.ceil(data.total / FILES_PER_PAGE));
+            document.getElementById('file-page').textContent =
+                'Page ' + (Math.floor(fileOffset / FILES_PER_PAGE) + 1) + ' of ' + pages;
+            let html = '';
+            data.files.forEach(file => {
+                html += '<div class="file-item">';
+                html += '<span>' + file.name + ' (' + file.rows + ' rows, ' + file.size + ' bytes)</span>';
+                html += '<button onclick="downloadFile(\'' + file.name + '\')">Download</button>';
+                html += '</div>';
+            });
+            document.getElementById('file-list').innerHTML = html || '<p>No data files found</p>';
+        })
+        .catch(err => console.error('Error loading files:', err));
+}
+
+function downloadFile(filename) {
+    window.open('/api/download?file=' + encodeURIComponent(filename), '_blank');
+}
+
+function flushBuffer() {
+    if (!confirm('Flush buffered data to SD card now?')) {
+        return;
+    }
+    
+    fetch('/api/flush', {
+        method: 'POST'
+    })
+    .then(response => response.json())
+    .then(data => {
+        alert(data.message || 'Buffer flushed successfully');
+        loadStatus();  // Refresh status to show updated buffer count
+    })
+    .catch(err => {
+        alert('Error flushing buffer: ' + err);
+    });
+}
+
+function formatUptime(seconds) {
+    const days = Math.floor(seconds / 86400);
+    const hours = Math.floor((seconds % 86400) / 3600);
+    const mins = Math.floor((seconds % 3600) / 60);
+    
+    if (days > 0) {
+        return days + 'd ' + hours + 'h ' + mins + 'm';
+    } else if (hours > 0) {
+        return hours + 'h ' + mins + 'm';
+    } else {
+        return mins + 'm';
+    }
+}
+
+// Initialize on page load
+document.addEventListener('DOMContentLoaded', function() {
+    showTab('dashboard');
+});